@@ -14,9 +14,12 @@
 #include "id.hpp"
 #include "quetzal/common/Elements.hpp"
 #include "quetzal/common/Properties.hpp"
+#include <algorithm>
+#include <execution>
 #include <functional>
 #include <limits>
 #include <map>
+#include <numeric>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -129,11 +132,17 @@ namespace quetzal::brep
 
         id_type create_face(id_type idSurface, id_type idHalfedge, const face_attributes_type& attributes = {});
 
+        // Bulk construction: faces assigned directly in the face store, possibly in parallel, are added to their surfaces and submeshes in one pass
+        void link_faces(id_type idFaceFirst);
+
         void unlink_face(id_type idFace); // Unlink face from its surface and submesh, delete them if empty
         void delete_face(id_type idFace); // Delete face resulting in an open area with border edges
 
         void move_face(id_type idFace, id_type idSurface);
 
+        // Bulk move_face, perimeters of the surfaces involved and their neighbors are regenerated on next use rather than updated per face
+        void move_faces(const std::vector<id_type>& idFaces, id_type idSurface);
+
         id_type surface_id(id_type idSubmesh, const std::string& name) const;
 
         const surface_type& surface(id_type idSubmesh, const std::string& name) const;
@@ -224,6 +233,7 @@ namespace quetzal::brep
         void link_surface_submesh(id_type idSurface, id_type idSubmesh);
 
         void append(const Mesh& mesh);
+        void append(Mesh&& mesh); // Takes the contents of mesh without copying if this is empty
         void pack();
 
         bool empty() const;
@@ -722,6 +732,48 @@ quetzal::id_type quetzal::brep::Mesh<Traits>::create_face(id_type idSurface, id_
     return idFace;
 }
 
+//------------------------------------------------------------------------------
+template<typename Traits>
+void quetzal::brep::Mesh<Traits>::link_faces(id_type idFaceFirst)
+{
+    std::vector<std::vector<id_type>> idFacesSurface(m_surface_store.size());
+    std::vector<std::vector<id_type>> idFacesSubmesh(m_submesh_store.size());
+
+    for (id_type idFace = idFaceFirst; idFace < m_face_store.size(); ++idFace)
+    {
+        const face_type& f = m_face_store[idFace];
+        assert(f.id() == idFace);
+
+        if (f.surface_id() != nullid)
+        {
+            idFacesSurface[f.surface_id()].push_back(idFace);
+        }
+
+        if (f.submesh_id() != nullid)
+        {
+            idFacesSubmesh[f.submesh_id()].push_back(idFace);
+        }
+    }
+
+    for (id_type idSurface = 0; idSurface < idFacesSurface.size(); ++idSurface)
+    {
+        if (!idFacesSurface[idSurface].empty())
+        {
+            surface(idSurface).add_faces(idFacesSurface[idSurface]);
+        }
+    }
+
+    for (id_type idSubmesh = 0; idSubmesh < idFacesSubmesh.size(); ++idSubmesh)
+    {
+        if (!idFacesSubmesh[idSubmesh].empty())
+        {
+            submesh(idSubmesh).add_faces(idFacesSubmesh[idSubmesh]);
+        }
+    }
+
+    return;
+}
+
 //------------------------------------------------------------------------------
 template<typename Traits>
 void quetzal::brep::Mesh<Traits>::unlink_face(id_type idFace)
@@ -823,6 +875,92 @@ void quetzal::brep::Mesh<Traits>::move_face(id_type idFace, id_type idSurface)
     return;
 }
 
+//------------------------------------------------------------------------------
+template<typename Traits>
+void quetzal::brep::Mesh<Traits>::move_faces(const std::vector<id_type>& idFaces, id_type idSurface)
+{
+    assert(idSurface != nullid);
+    id_type idSubmesh = surface(idSurface).submesh_id();
+
+    std::vector<id_type> idFacesMoved;
+    std::vector<id_type> idSurfacesOrig;
+    std::vector<id_type> idSubmeshesOrig;
+
+    for (id_type idFace : idFaces)
+    {
+        auto& f = face(idFace);
+        id_type idSurfaceOrig = f.surface_id();
+        id_type idSubmeshOrig = f.submesh_id();
+        assert(idSurfaceOrig == nullid || idSubmeshOrig == f.surface().submesh_id());
+
+        if (idSurfaceOrig == idSurface)
+        {
+            continue;
+        }
+
+        if (idSubmeshOrig != nullid)
+        {
+            submesh(idSubmeshOrig).face_ids().erase(idFace);
+            idSubmeshesOrig.push_back(idSubmeshOrig);
+        }
+
+        if (idSurfaceOrig != nullid)
+        {
+            surface(idSurfaceOrig).face_ids().erase(idFace);
+            idSurfacesOrig.push_back(idSurfaceOrig);
+        }
+
+        f.set_surface_id(idSurface);
+        f.set_submesh_id(idSubmesh);
+        idFacesMoved.push_back(idFace);
+
+        // Seams shared with neighboring surfaces change too
+        for (const auto& halfedge : f.halfedges())
+        {
+            if (!halfedge.border() && halfedge.partner().face().surface_id() != nullid)
+            {
+                halfedge.partner().face().surface().set_regenerate_perimeters();
+            }
+        }
+    }
+
+    if (idFacesMoved.empty())
+    {
+        return;
+    }
+
+    std::sort(idSurfacesOrig.begin(), idSurfacesOrig.end());
+    idSurfacesOrig.erase(std::unique(idSurfacesOrig.begin(), idSurfacesOrig.end()), idSurfacesOrig.end());
+    for (id_type idSurfaceOrig : idSurfacesOrig)
+    {
+        surface(idSurfaceOrig).set_regenerate_perimeters();
+        if (surface(idSurfaceOrig).empty())
+        {
+            delete_surface(idSurfaceOrig);
+        }
+    }
+
+    std::sort(idSubmeshesOrig.begin(), idSubmeshesOrig.end());
+    idSubmeshesOrig.erase(std::unique(idSubmeshesOrig.begin(), idSubmeshesOrig.end()), idSubmeshesOrig.end());
+    for (id_type idSubmeshOrig : idSubmeshesOrig)
+    {
+        if (submesh(idSubmeshOrig).empty() && !submesh(idSubmeshOrig).deleted() && idSubmeshOrig != idSubmesh)
+        {
+            delete_submesh(idSubmeshOrig);
+        }
+    }
+
+    std::sort(idFacesMoved.begin(), idFacesMoved.end());
+    surface(idSurface).add_faces(idFacesMoved);
+
+    if (idSubmesh != nullid)
+    {
+        submesh(idSubmesh).add_faces(idFacesMoved);
+    }
+
+    return;
+}
+
 //------------------------------------------------------------------------------
 template<typename Traits>
 quetzal::id_type quetzal::brep::Mesh<Traits>::surface_id(id_type idSubmesh, const std::string& name) const
@@ -1040,6 +1178,12 @@ void quetzal::brep::Mesh<Traits>::delete_surface(id_type idSurface)
         delete_face(*i++);
     }
 
+    // Deleting the last face already deleted the surface, and its submesh if that emptied
+    if (s.deleted())
+    {
+        return;
+    }
+
     if (idSubmesh != nullid)
     {
         s.submesh().unlink_surface(idSurface);
@@ -1793,6 +1937,22 @@ void quetzal::brep::Mesh<Traits>::append(const Mesh& mesh)
     return;
 }
 
+//------------------------------------------------------------------------------
+template<typename Traits>
+void quetzal::brep::Mesh<Traits>::append(Mesh&& mesh)
+{
+    if (!empty())
+    {
+        append(static_cast<const Mesh&>(mesh));
+        return;
+    }
+
+    swap(*this, mesh);
+    reassign_mesh();
+    mesh.clear();
+    return;
+}
+
 //------------------------------------------------------------------------------
 template<typename Traits>
 void quetzal::brep::Mesh<Traits>::pack()
@@ -2103,22 +2263,20 @@ return true; // ...
 template<typename Traits>
 typename quetzal::brep::Mesh<Traits>::size_type quetzal::brep::Mesh<Traits>::error_count() const
 {
-    size_type n = 0;
-
-    for (const halfedge_type halfedge : m_halfedge_store)
+    size_type n = std::transform_reduce(std::execution::par, m_halfedge_store.begin(), m_halfedge_store.end(), size_type(0), std::plus<>(), [](const halfedge_type& halfedge) -> size_type
     {
-        n += halfedge.error_count();
-    }
+        return halfedge.error_count();
+    });
 
-    for (const vertex_type vertex : m_vertex_store)
+    n += std::transform_reduce(std::execution::par, m_vertex_store.begin(), m_vertex_store.end(), size_type(0), std::plus<>(), [](const vertex_type& vertex) -> size_type
     {
-        n += vertex.check() ? 0 : 1;
-    }
+        return vertex.check() ? 0 : 1;
+    });
 
-    for (const face_type face : m_face_store)
+    n += std::transform_reduce(std::execution::par, m_face_store.begin(), m_face_store.end(), size_type(0), std::plus<>(), [](const face_type& face) -> size_type
     {
-        n += face.check() ? 0 : 1;
-    }
+        return face.check() ? 0 : 1;
+    });
 
     return n;
 }
@@ -57,6 +57,9 @@ namespace quetzal::brep
         const halfedges_type& halfedges() const;
         halfedges_type& halfedges();
 
+        // Ids of the halfedges on this perimeter in order, recorded when the perimeter is generated
+        const std::vector<id_type>& halfedge_ids() const;
+
         size_type seam_count() const;
         const seams_type& seams() const;
         seams_type& seams();
@@ -76,12 +79,14 @@ namespace quetzal::brep
         mesh_type& mesh();
         void set_mesh(mesh_type& mesh);
         void check_mesh(const mesh_type* const pmesh) const;
+        void add_halfedge_id(id_type idHalfedge);
 
     private:
 
         mesh_type* m_pmesh;
         id_type m_idSurface;
         halfedges_type m_halfedges;
+        std::vector<id_type> m_halfedge_ids;
         seams_type m_seams;
         Properties m_properties;
 
@@ -107,6 +112,7 @@ quetzal::brep::Perimeter<Traits, M>::Perimeter() :
     m_pmesh(nullptr),
     m_idSurface(nullid),
     m_halfedges(m_halfedges_size, m_halfedges_first, m_halfedges_last, m_halfedges_end, m_halfedges_forward, m_halfedges_reverse, m_halfedges_element, m_halfedges_const_element),
+    m_halfedge_ids(),
     m_seams(),
     m_properties()
 {
@@ -120,6 +126,7 @@ quetzal::brep::Perimeter<Traits, M>::Perimeter(mesh_type& mesh, id_type idSurfac
     m_pmesh(&mesh),
     m_idSurface(idSurface),
     m_halfedges(m_halfedges_size, m_halfedges_first, m_halfedges_last, m_halfedges_end, m_halfedges_forward, m_halfedges_reverse, m_halfedges_element, m_halfedges_const_element),
+    m_halfedge_ids(),
     m_seams(),
     m_properties()
 {
@@ -188,6 +195,13 @@ typename quetzal::brep::Perimeter<Traits, M>::halfedges_type& quetzal::brep::Per
     return m_halfedges;
 }
 
+//------------------------------------------------------------------------------
+template<typename Traits, typename M>
+const std::vector<quetzal::id_type>& quetzal::brep::Perimeter<Traits, M>::halfedge_ids() const
+{
+    return m_halfedge_ids;
+}
+
 //------------------------------------------------------------------------------
 template<typename Traits, typename M>
 typename quetzal::brep::Perimeter<Traits, M>::size_type quetzal::brep::Perimeter<Traits, M>::seam_count() const
@@ -303,6 +317,14 @@ void quetzal::brep::Perimeter<Traits, M>::check_mesh(const mesh_type* const pmes
     return;
 }
 
+//------------------------------------------------------------------------------
+template<typename Traits, typename M>
+void quetzal::brep::Perimeter<Traits, M>::add_halfedge_id(id_type idHalfedge)
+{
+    m_halfedge_ids.push_back(idHalfedge);
+    return;
+}
+
 //------------------------------------------------------------------------------
 template<typename Traits, typename M>
 typename quetzal::brep::Perimeter<Traits, M>::halfedges_type::size_function_type quetzal::brep::Perimeter<Traits, M>::m_halfedges_size = [](const Perimeter<Traits, M>& perimeter) -> size_t
@@ -73,6 +73,7 @@ namespace quetzal::brep
         halfedges_type& halfedges();
 
         id_type perimeter_id() const;
+        void set_perimeter_id(id_type idPerimeter);
 
         const Perimeter<Traits, M>& perimeter() const;
         Perimeter<Traits, M>& perimeter();
@@ -82,6 +83,8 @@ namespace quetzal::brep
         const surface_type& surface() const;
         surface_type& surface();
 
+        id_type partner_surface_id() const;
+
         const Properties& properties() const;
         Properties& properties();
 
@@ -200,7 +203,7 @@ template<typename Traits, typename M>
 const typename quetzal::brep::Seam<Traits, M>& quetzal::brep::Seam<Traits, M>::next() const
 {
     assert(m_pmesh != nullptr);
-    return m_pmesh->seam(m_idNext);
+    return perimeter().seams()[m_idNext];
 }
 
 //------------------------------------------------------------------------------
@@ -208,7 +211,7 @@ template<typename Traits, typename M>
 typename quetzal::brep::Seam<Traits, M>& quetzal::brep::Seam<Traits, M>::next()
 {
     assert(m_pmesh != nullptr);
-    return m_pmesh->seam(m_idNext);
+    return perimeter().seams()[m_idNext];
 }
 
 //------------------------------------------------------------------------------
@@ -231,7 +234,7 @@ template<typename Traits, typename M>
 const typename quetzal::brep::Seam<Traits, M>& quetzal::brep::Seam<Traits, M>::prev() const
 {
     assert(m_pmesh != nullptr);
-    return m_pmesh->seam(m_idPrev);
+    return perimeter().seams()[m_idPrev];
 }
 
 //------------------------------------------------------------------------------
@@ -239,7 +242,7 @@ template<typename Traits, typename M>
 typename quetzal::brep::Seam<Traits, M>& quetzal::brep::Seam<Traits, M>::prev()
 {
     assert(m_pmesh != nullptr);
-    return m_pmesh->seam(m_idPrev);
+    return perimeter().seams()[m_idPrev];
 }
 
 //------------------------------------------------------------------------------
@@ -280,18 +283,26 @@ quetzal::id_type quetzal::brep::Seam<Traits, M>::perimeter_id() const
     return m_idPerimeter;
 }
 
+//------------------------------------------------------------------------------
+template<typename Traits, typename M>
+void quetzal::brep::Seam<Traits, M>::set_perimeter_id(id_type idPerimeter)
+{
+    m_idPerimeter = idPerimeter;
+    return;
+}
+
 //------------------------------------------------------------------------------
 template<typename Traits, typename M>
 const quetzal::brep::Perimeter<Traits, M>&  quetzal::brep::Seam<Traits, M>::perimeter() const
 {
-    return surface().perimeter(m_idPerimeter);
+    return surface().perimeters()[m_idPerimeter];
 }
 
 //------------------------------------------------------------------------------
 template<typename Traits, typename M>
 quetzal::brep::Perimeter<Traits, M>&  quetzal::brep::Seam<Traits, M>::perimeter()
 {
-    return surface.perimeter(m_idPerimeter);
+    return surface().perimeters()[m_idPerimeter];
 }
 
 //------------------------------------------------------------------------------
@@ -340,6 +351,13 @@ typename quetzal::brep::Seam<Traits, M>::surface_type& quetzal::brep::Seam<Trait
     return m_pmesh->surface(surface_id());
 }
 
+//------------------------------------------------------------------------------
+template<typename Traits, typename M>
+quetzal::id_type quetzal::brep::Seam<Traits, M>::partner_surface_id() const
+{
+    return halfedge().partner_surface_id();
+}
+
 //------------------------------------------------------------------------------
 template<typename Traits, typename M>
 typename const quetzal::Properties& quetzal::brep::Seam<Traits, M>::properties() const
@@ -13,6 +13,7 @@
 #include <iostream>
 #include <set>
 #include <string>
+#include <vector>
 #include <cassert>
 
 namespace quetzal::brep
@@ -70,6 +71,7 @@ namespace quetzal::brep
 
         bool contains_face(id_type idFace) const;
         void add_face(id_type idFace); // add face to list
+        void add_faces(const std::vector<id_type>& idFaces); // add faces to list, bulk insertion at the end when ascending and greater than existing ids
         void link_face(id_type idFace); // add face to list and set face submesh id
         void unlink_face(id_type idFace); // remove face from list and clear face submesh id
 
@@ -286,6 +288,19 @@ void quetzal::brep::Submesh<Traits, M>::add_face(id_type idFace)
     return;
 }
 
+//------------------------------------------------------------------------------
+template<typename Traits, typename M>
+void quetzal::brep::Submesh<Traits, M>::add_faces(const std::vector<id_type>& idFaces)
+{
+    for (id_type idFace : idFaces)
+    {
+        assert(!m_face_ids.contains(idFace));
+        m_face_ids.insert(m_face_ids.end(), idFace);
+    }
+
+    return;
+}
+
 //------------------------------------------------------------------------------
 template<typename Traits, typename M>
 void quetzal::brep::Submesh<Traits, M>::link_face(id_type idFace)
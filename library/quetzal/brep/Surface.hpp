@@ -17,6 +17,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <cassert>
 
@@ -87,6 +88,10 @@ namespace quetzal::brep
         const perimeters_type& perimeters() const;
         perimeters_type& perimeters();
 
+        // Number of times all perimeters were generated from scratch and number of local perimeter updates, for profiling
+        size_type perimeter_regeneration_count() const;
+        size_type perimeter_update_count() const;
+
 //        perimeter_type& perimeter(id_type idPerimeter); // only useful on generation? ...
 
         std::vector<id_type> find_seams(id_type idSurfacePartner);
@@ -99,26 +104,37 @@ namespace quetzal::brep
 
         bool contains_face(id_type idFace) const;
         void add_face(id_type idFace); // add face to list
-        void link_face(id_type idFace); // add face to list and set face surface
-        void unlink_face(id_type idFace); // remove face from list and clear face surface
+        void add_faces(const std::vector<id_type>& idFaces); // add faces to list, bulk insertion at the end when ascending and greater than existing ids
+        void link_face(id_type idFace); // add face to list and set face surface, update perimeters here and in neighboring surfaces
+        void unlink_face(id_type idFace); // remove face from list and clear face surface, update perimeters here and in neighboring surfaces
 
         void append(const Surface& surface, id_type idFaceOffset);
 
+        // Discard all perimeters, they are generated again on next use
         void set_regenerate_perimeters(bool b = true);
 
+        // Regenerate only the perimeters passing through the corners of this face after a local edit, nothing to do if all are to be regenerated
+        void update_perimeters(id_type idFace);
+
         // Internal use, only by Mesh
         void set_mesh(mesh_type& mesh);
         void set_id(id_type id);
         void check_mesh(const mesh_type* const pmesh) const;
 
+        // Internal use, by Perimeter and Seam
+        void check_regenerate_perimeters() const;
+
     private:
 
-        id_type create_perimeter();
+        id_type create_perimeter() const;
+        void delete_perimeter(id_type idPerimeter) const;
 
-        void check_regenerate_perimeters();
-        void generate_perimeters();
-        void generate_perimeter(id_type idHalfedge);
-        std::array<id_type, 2> generate_seam(id_type idNext, id_type idPrev, id_type idHalfedge, id_type idPerimeter);
+        void generate_perimeters() const;
+        void generate_perimeter(id_type idHalfedge) const;
+        std::array<id_type, 2> generate_seam(id_type idNext, id_type idPrev, id_type idHalfedge, id_type idPerimeter) const;
+
+        void update_partner_perimeters(id_type idFace);
+        std::vector<id_type> corner_halfedge_ids(id_type idFace) const;
 
         mesh_type* m_pmesh;
         id_type m_id;
@@ -129,10 +145,14 @@ namespace quetzal::brep
         Properties m_properties;
 
         faces_type m_faces;
-        perimeters_type m_perimeters;
 
-        bool m_bRegeneratePerimeters;
-        bool m_bGeneratingPerimeters;
+        // Perimeters are generated on demand
+        mutable perimeters_type m_perimeters;
+        mutable std::unordered_map<id_type, id_type> m_perimeter_ids; // Perimeter of each halfedge on a perimeter
+        mutable bool m_bRegeneratePerimeters;
+        mutable bool m_bGeneratingPerimeters;
+        mutable size_type m_nPerimeterRegenerations;
+        size_type m_nPerimeterUpdates;
 
         static faces_type::size_function_type m_faces_size;
         static faces_type::terminal_function_type m_faces_first;
@@ -162,8 +182,11 @@ quetzal::brep::Surface<Traits, M>::Surface() :
     m_properties(),
     m_faces(*m_pmesh, nullid, m_faces_size, m_faces_first, m_faces_last, m_faces_end, m_faces_forward, m_faces_reverse, m_faces_element, m_faces_const_element),
     m_perimeters(),
-    m_bRegeneratePerimeters(false),
-    m_bGeneratingPerimeters(false)
+    m_perimeter_ids(),
+    m_bRegeneratePerimeters(true),
+    m_bGeneratingPerimeters(false),
+    m_nPerimeterRegenerations(0),
+    m_nPerimeterUpdates(0)
 {
 }
 
@@ -180,8 +203,11 @@ quetzal::brep::Surface<Traits, M>::Surface(mesh_type& mesh, id_type id, const st
     m_properties(properties),
     m_faces(mesh, id, m_faces_size, m_faces_first, m_faces_last, m_faces_end, m_faces_forward, m_faces_reverse, m_faces_element, m_faces_const_element),
     m_perimeters(),
-    m_bRegeneratePerimeters(false),
-    m_bGeneratingPerimeters(false)
+    m_perimeter_ids(),
+    m_bRegeneratePerimeters(true),
+    m_bGeneratingPerimeters(false),
+    m_nPerimeterRegenerations(0),
+    m_nPerimeterUpdates(0)
 {
 }
 
@@ -340,6 +366,20 @@ typename quetzal::brep::Surface<Traits, M>::perimeters_type& quetzal::brep::Surf
     return m_perimeters;
 }
 
+//------------------------------------------------------------------------------
+template<typename Traits, typename M>
+typename quetzal::brep::Surface<Traits, M>::size_type quetzal::brep::Surface<Traits, M>::perimeter_regeneration_count() const
+{
+    return m_nPerimeterRegenerations;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits, typename M>
+typename quetzal::brep::Surface<Traits, M>::size_type quetzal::brep::Surface<Traits, M>::perimeter_update_count() const
+{
+    return m_nPerimeterUpdates;
+}
+
 //------------------------------------------------------------------------------
 template<typename Traits, typename M>
 std::vector<quetzal::id_type> quetzal::brep::Surface<Traits, M>::find_seams(id_type idSurfacePartner)
@@ -347,7 +387,7 @@ std::vector<quetzal::id_type> quetzal::brep::Surface<Traits, M>::find_seams(id_t
     check_regenerate_perimeters();
     std::vector<id_type> ids;
 
-    for (const auto& perimeter : m_perimeters)
+    for (auto& perimeter : m_perimeters)
     {
         auto idsFound = perimeter.find_seams(idSurfacePartner);
         ids.insert(end(ids), begin(idsFound), end(idsFound));
@@ -364,7 +404,7 @@ std::vector<quetzal::id_type> quetzal::brep::Surface<Traits, M>::find_seams(cons
     check_regenerate_perimeters();
     std::vector<id_type> ids;
 
-    for (const auto& perimeter : m_perimeters)
+    for (auto& perimeter : m_perimeters)
     {
         auto idsFound = perimeter.find_seams(nameSurfacePartner);
         ids.insert(end(ids), begin(idsFound), end(idsFound));
@@ -387,6 +427,7 @@ void quetzal::brep::Surface<Traits, M>::clear()
     m_idSubmesh = nullid;
     m_face_ids.clear();
     m_perimeters.clear();
+    m_perimeter_ids.clear();
     m_bRegeneratePerimeters = false;
     return;
 }
@@ -430,13 +471,34 @@ void quetzal::brep::Surface<Traits, M>::add_face(id_type idFace)
     return;
 }
 
+//------------------------------------------------------------------------------
+template<typename Traits, typename M>
+void quetzal::brep::Surface<Traits, M>::add_faces(const std::vector<id_type>& idFaces)
+{
+    for (id_type idFace : idFaces)
+    {
+        assert(idFace != nullid);
+        assert(!m_face_ids.contains(idFace));
+        m_face_ids.insert(m_face_ids.end(), idFace);
+    }
+
+    set_regenerate_perimeters();
+    return;
+}
+
 //------------------------------------------------------------------------------
 template<typename Traits, typename M>
 void quetzal::brep::Surface<Traits, M>::link_face(id_type idFace)
 {
     assert(m_pmesh != nullptr);
-    add_face(idFace);
+    assert(idFace != nullid);
+    assert(!m_face_ids.contains(idFace));
+
+    m_face_ids.insert(idFace);
     m_pmesh->face(idFace).set_surface_id(m_id);
+
+    update_perimeters(idFace);
+    update_partner_perimeters(idFace);
     return;
 }
 
@@ -451,7 +513,8 @@ void quetzal::brep::Surface<Traits, M>::unlink_face(id_type idFace)
     m_face_ids.erase(idFace);
     m_pmesh->face(idFace).set_surface_id(nullid);
 
-    set_regenerate_perimeters();
+    update_perimeters(idFace);
+    update_partner_perimeters(idFace);
     return;
 }
 
@@ -471,6 +534,53 @@ void quetzal::brep::Surface<Traits, M>::set_regenerate_perimeters(bool b)
     return;
 }
 
+//------------------------------------------------------------------------------
+template<typename Traits, typename M>
+void quetzal::brep::Surface<Traits, M>::update_perimeters(id_type idFace)
+{
+    assert(m_pmesh != nullptr);
+
+    if (m_bRegeneratePerimeters || m_bGeneratingPerimeters)
+    {
+        return;
+    }
+
+    m_bGeneratingPerimeters = true;
+
+    // Only perimeters passing through the corners of the face can have changed
+    std::vector<id_type> idHalfedges = corner_halfedge_ids(idFace);
+
+    std::set<id_type> idPerimeters;
+    for (id_type idHalfedge : idHalfedges)
+    {
+        auto i = m_perimeter_ids.find(idHalfedge);
+        if (i != m_perimeter_ids.end())
+        {
+            idPerimeters.insert(i->second);
+        }
+    }
+
+    // Descending so that the perimeter moved into a vacated position is never one still to be deleted
+    for (auto i = idPerimeters.rbegin(); i != idPerimeters.rend(); ++i)
+    {
+        delete_perimeter(*i);
+    }
+
+    // Any perimeter replacing a deleted one also passes through these corners
+    for (id_type idHalfedge : idHalfedges)
+    {
+        const auto& halfedge = m_pmesh->halfedge(idHalfedge);
+        if (halfedge.surface_id() == m_id && halfedge.surface_seam() && !m_perimeter_ids.contains(idHalfedge))
+        {
+            generate_perimeter(idHalfedge);
+        }
+    }
+
+    ++m_nPerimeterUpdates;
+    m_bGeneratingPerimeters = false;
+    return;
+}
+
 //------------------------------------------------------------------------------
 template<typename Traits, typename M>
 void quetzal::brep::Surface<Traits, M>::set_mesh(mesh_type& mesh)
@@ -518,7 +628,7 @@ void quetzal::brep::Surface<Traits, M>::check_mesh(const mesh_type* const pmesh)
 
 //------------------------------------------------------------------------------
 template<typename Traits, typename M>
-void quetzal::brep::Surface<Traits, M>::check_regenerate_perimeters()
+void quetzal::brep::Surface<Traits, M>::check_regenerate_perimeters() const
 {
     if (m_bRegeneratePerimeters && !m_bGeneratingPerimeters)
     {
@@ -533,7 +643,7 @@ void quetzal::brep::Surface<Traits, M>::check_regenerate_perimeters()
 
 //------------------------------------------------------------------------------
 template<typename Traits, typename M>
-quetzal::id_type quetzal::brep::Surface<Traits, M>::create_perimeter()
+quetzal::id_type quetzal::brep::Surface<Traits, M>::create_perimeter() const
 {
     id_type idPerimeter = m_perimeters.size();
     m_perimeters.emplace_back(*m_pmesh, m_id);
@@ -542,51 +652,88 @@ quetzal::id_type quetzal::brep::Surface<Traits, M>::create_perimeter()
 
 //------------------------------------------------------------------------------
 template<typename Traits, typename M>
-void quetzal::brep::Surface<Traits, M>::generate_perimeters()
+void quetzal::brep::Surface<Traits, M>::delete_perimeter(id_type idPerimeter) const
 {
-    reset();
+    assert(idPerimeter < m_perimeters.size());
 
-    for (const auto& face : faces())
+    for (id_type idHalfedge : m_perimeters[idPerimeter].halfedge_ids())
     {
-        for (const auto& halfedge : face.halfedges())
+        m_perimeter_ids.erase(idHalfedge);
+    }
+
+    // Move the last perimeter into the vacated position
+    id_type idPerimeterLast = m_perimeters.size() - 1;
+    if (idPerimeter != idPerimeterLast)
+    {
+        auto& perimeter = m_perimeters[idPerimeter];
+        perimeter = std::move(m_perimeters[idPerimeterLast]);
+
+        for (auto& seam : perimeter.seams())
         {
-            if (halfedge.marked())
-            {
-                continue;
-            }
+            seam.set_perimeter_id(idPerimeter);
+        }
 
-            if (halfedge.border() || halfedge.partner_surface_id() != m_id)
-            {
-                generate_perimeter(halfedge.id());
-            }
-            else
+        for (id_type idHalfedge : perimeter.halfedge_ids())
+        {
+            m_perimeter_ids[idHalfedge] = idPerimeter;
+        }
+    }
+
+    m_perimeters.pop_back();
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits, typename M>
+void quetzal::brep::Surface<Traits, M>::generate_perimeters() const
+{
+    assert(m_pmesh != nullptr);
+
+    m_perimeters.clear();
+    m_perimeter_ids.clear();
+
+    for (id_type idFace : m_face_ids)
+    {
+        id_type idHalfedge0 = m_pmesh->face(idFace).halfedge_id();
+        id_type idHalfedge = idHalfedge0;
+        do
+        {
+            const auto& halfedge = m_pmesh->halfedge(idHalfedge);
+            if (halfedge.surface_seam() && !m_perimeter_ids.contains(idHalfedge))
             {
-                halfedge.set_marked();
-                halfedge.partner().set_marked();
+                generate_perimeter(idHalfedge);
             }
-        }
+
+            idHalfedge = halfedge.next_id();
+        } while (idHalfedge != idHalfedge0);
     }
 
+    ++m_nPerimeterRegenerations;
     return;
 }
 
 //------------------------------------------------------------------------------
 template<typename Traits, typename M>
-void quetzal::brep::Surface<Traits, M>::generate_perimeter(id_type idHalfedge)
+void quetzal::brep::Surface<Traits, M>::generate_perimeter(id_type idHalfedge) const
 {
     assert(m_pmesh != nullptr);
-    assert(m_pmesh->halfedge(idHalfedge).surface_id() != m_pmesh->halfedge(idHalfedge).partner_surface_id());
+    assert(m_pmesh->halfedge(idHalfedge).surface_seam());
 
-    id_type idHalfedgePrev = prev_surface_halfedge_id(*m_pmesh, idHalfedge);
+    // Back up to the start of a seam, if the whole perimeter is not a single seam
     id_type idHalfedge0 = idHalfedge;
-    while (idHalfedge != idHalfedge0 && idHalfedge != idHalfedgePrev)
+    id_type idSurfacePartner = m_pmesh->halfedge(idHalfedge).partner_surface_id();
+    do
     {
-        idHalfedgePrev = idHalfedge;
-        idHalfedge = next_surface_halfedge_id(*m_pmesh, idHalfedge);
-    }
+        id_type idHalfedgePrev = prev_surface_halfedge_id(*m_pmesh, idHalfedge);
+        if (m_pmesh->halfedge(idHalfedgePrev).partner_surface_id() != idSurfacePartner)
+        {
+            break;
+        }
+
+        idHalfedge = idHalfedgePrev;
+    } while (idHalfedge != idHalfedge0);
 
     id_type idPerimeter = create_perimeter();
-    auto& perimeter = perimeters()[idPerimeter];
 
     idHalfedge0 = idHalfedge;
     id_type idSeam0 = nullid;
@@ -597,7 +744,10 @@ void quetzal::brep::Surface<Traits, M>::generate_perimeter(id_type idHalfedge)
 
         if (idSeamPrev != nullid)
         {
-            perimeter.seams()[idSeamPrev].set_next_id(idSeam);
+            m_perimeters[idPerimeter].seams()[idSeamPrev].set_next_id(idSeam);
+        }
+        else
+        {
             idSeam0 = idSeam;
         }
 
@@ -605,33 +755,106 @@ void quetzal::brep::Surface<Traits, M>::generate_perimeter(id_type idHalfedge)
         idHalfedge = idHalfedgeNext;
     } while (idHalfedge != idHalfedge0);
 
-    perimeter.seams()[idSeam0].set_prev_id(idSeamPrev);
-    perimeter.seams()[idSeamPrev].set_next_id(idSeam0);
+    m_perimeters[idPerimeter].seams()[idSeam0].set_prev_id(idSeamPrev);
+    m_perimeters[idPerimeter].seams()[idSeamPrev].set_next_id(idSeam0);
 
     return;
 }
 
 //------------------------------------------------------------------------------
 template<typename Traits, typename M>
-std::array<quetzal::id_type, 2> quetzal::brep::Surface<Traits, M>::generate_seam(id_type idNext, id_type idPrev, id_type idHalfedge, id_type idPerimeter)
+std::array<quetzal::id_type, 2> quetzal::brep::Surface<Traits, M>::generate_seam(id_type idNext, id_type idPrev, id_type idHalfedge, id_type idPerimeter) const
 {
     assert(m_pmesh != nullptr);
     assert(m_pmesh->halfedge(idHalfedge).surface_seam());
 
-    auto& perimeter = perimeters()[idPerimeter];
+    auto& perimeter = m_perimeters[idPerimeter];
     id_type idSeam = perimeter.create_seam(idNext, idPrev, idHalfedge, idPerimeter);
 
     id_type idHalfedge0 = idHalfedge;
+    id_type idSurfacePartner = m_pmesh->halfedge(idHalfedge).partner_surface_id();
 
     do
     {
-        m_pmesh->halfedge(idHalfedge).set_marked();
+        perimeter.add_halfedge_id(idHalfedge);
+        m_perimeter_ids[idHalfedge] = idPerimeter;
         idHalfedge = next_surface_halfedge_id(*m_pmesh, idHalfedge);
-    } while (idHalfedge != idHalfedge0 && m_pmesh->halfedge(idHalfedge).surface_id() == m_id);
+    } while (idHalfedge != idHalfedge0 && m_pmesh->halfedge(idHalfedge).partner_surface_id() == idSurfacePartner);
 
     return {idSeam, idHalfedge};
 }
 
+//------------------------------------------------------------------------------
+template<typename Traits, typename M>
+void quetzal::brep::Surface<Traits, M>::update_partner_perimeters(id_type idFace)
+{
+    assert(m_pmesh != nullptr);
+
+    // Seams along the edges of the face have changed in the surfaces on the other side
+    std::vector<id_type> idSurfaces;
+
+    id_type idHalfedge0 = m_pmesh->face(idFace).halfedge_id();
+    id_type idHalfedge = idHalfedge0;
+    do
+    {
+        const auto& halfedge = m_pmesh->halfedge(idHalfedge);
+        if (!halfedge.border())
+        {
+            id_type idSurface = halfedge.partner().surface_id();
+            if (idSurface != nullid && idSurface != m_id && std::find(idSurfaces.begin(), idSurfaces.end(), idSurface) == idSurfaces.end())
+            {
+                idSurfaces.push_back(idSurface);
+            }
+        }
+
+        idHalfedge = halfedge.next_id();
+    } while (idHalfedge != idHalfedge0);
+
+    for (id_type idSurface : idSurfaces)
+    {
+        m_pmesh->surface(idSurface).update_perimeters(idFace);
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits, typename M>
+std::vector<quetzal::id_type> quetzal::brep::Surface<Traits, M>::corner_halfedge_ids(id_type idFace) const
+{
+    assert(m_pmesh != nullptr);
+
+    // Outgoing and incoming halfedges around each corner, walking the other way from a border if one is reached
+    std::vector<id_type> ids;
+
+    id_type idHalfedge0 = m_pmesh->face(idFace).halfedge_id();
+    id_type idHalfedge = idHalfedge0;
+    do
+    {
+        id_type id = idHalfedge;
+        do
+        {
+            ids.push_back(id);
+            ids.push_back(m_pmesh->halfedge(id).prev_id());
+            id = m_pmesh->halfedge(id).prev().partner_id();
+        } while (id != nullid && id != idHalfedge);
+
+        if (id == nullid)
+        {
+            for (id = m_pmesh->halfedge(idHalfedge).partner_id(); id != nullid; id = m_pmesh->halfedge(id).partner_id())
+            {
+                id = m_pmesh->halfedge(id).next_id();
+                ids.push_back(id);
+                ids.push_back(m_pmesh->halfedge(id).prev_id());
+            }
+        }
+
+        idHalfedge = m_pmesh->halfedge(idHalfedge).next_id();
+    } while (idHalfedge != idHalfedge0);
+
+    return ids;
+}
+
 //------------------------------------------------------------------------------
 template<typename Traits, typename M>
 typename quetzal::brep::Surface<Traits, M>::faces_type::size_function_type quetzal::brep::Surface<Traits, M>::m_faces_size = [](const mesh_type& mesh, id_type id) -> size_t
@@ -0,0 +1,191 @@
+//------------------------------------------------------------------------------
+// brep
+// ValidationError.cpp
+//------------------------------------------------------------------------------
+
+#include "ValidationError.hpp"
+#include <iostream>
+#include <cassert>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+ostream& quetzal::brep::operator<<(ostream& os, const ValidationCode& code)
+{
+    switch (code)
+    {
+        case ValidationCode::HalfedgeId:
+            os << "HalfedgeId";
+            break;
+
+        case ValidationCode::HalfedgePartner:
+            os << "HalfedgePartner";
+            break;
+
+        case ValidationCode::HalfedgeNext:
+            os << "HalfedgeNext";
+            break;
+
+        case ValidationCode::HalfedgePrev:
+            os << "HalfedgePrev";
+            break;
+
+        case ValidationCode::HalfedgeVertex:
+            os << "HalfedgeVertex";
+            break;
+
+        case ValidationCode::HalfedgeFace:
+            os << "HalfedgeFace";
+            break;
+
+        case ValidationCode::HalfedgePartnerPartner:
+            os << "HalfedgePartnerPartner";
+            break;
+
+        case ValidationCode::HalfedgeNextPrev:
+            os << "HalfedgeNextPrev";
+            break;
+
+        case ValidationCode::HalfedgePrevNext:
+            os << "HalfedgePrevNext";
+            break;
+
+        case ValidationCode::HalfedgeNextFace:
+            os << "HalfedgeNextFace";
+            break;
+
+        case ValidationCode::HalfedgePartnerPosition:
+            os << "HalfedgePartnerPosition";
+            break;
+
+        case ValidationCode::VertexId:
+            os << "VertexId";
+            break;
+
+        case ValidationCode::VertexHalfedge:
+            os << "VertexHalfedge";
+            break;
+
+        case ValidationCode::VertexHalfedgeVertex:
+            os << "VertexHalfedgeVertex";
+            break;
+
+        case ValidationCode::VertexPosition:
+            os << "VertexPosition";
+            break;
+
+        case ValidationCode::VertexAttributes:
+            os << "VertexAttributes";
+            break;
+
+        case ValidationCode::FaceId:
+            os << "FaceId";
+            break;
+
+        case ValidationCode::FaceHalfedge:
+            os << "FaceHalfedge";
+            break;
+
+        case ValidationCode::FaceHalfedgeFace:
+            os << "FaceHalfedgeFace";
+            break;
+
+        case ValidationCode::FaceSurface:
+            os << "FaceSurface";
+            break;
+
+        case ValidationCode::FaceSubmesh:
+            os << "FaceSubmesh";
+            break;
+
+        case ValidationCode::FaceSurfaceSubmesh:
+            os << "FaceSurfaceSubmesh";
+            break;
+
+        case ValidationCode::FaceEdgeCount:
+            os << "FaceEdgeCount";
+            break;
+
+        case ValidationCode::FaceNormal:
+            os << "FaceNormal";
+            break;
+
+        case ValidationCode::FaceDuplicatePosition:
+            os << "FaceDuplicatePosition";
+            break;
+
+        case ValidationCode::FaceNotInSurface:
+            os << "FaceNotInSurface";
+            break;
+
+        case ValidationCode::FaceNotInSubmesh:
+            os << "FaceNotInSubmesh";
+            break;
+
+        case ValidationCode::SurfaceEmpty:
+            os << "SurfaceEmpty";
+            break;
+
+        case ValidationCode::SurfaceSubmesh:
+            os << "SurfaceSubmesh";
+            break;
+
+        case ValidationCode::SurfaceFace:
+            os << "SurfaceFace";
+            break;
+
+        case ValidationCode::SurfaceFaceSurface:
+            os << "SurfaceFaceSurface";
+            break;
+
+        case ValidationCode::SurfaceFaceShared:
+            os << "SurfaceFaceShared";
+            break;
+
+        case ValidationCode::SurfaceIndex:
+            os << "SurfaceIndex";
+            break;
+
+        case ValidationCode::SubmeshEmpty:
+            os << "SubmeshEmpty";
+            break;
+
+        case ValidationCode::SubmeshSurface:
+            os << "SubmeshSurface";
+            break;
+
+        case ValidationCode::SubmeshFace:
+            os << "SubmeshFace";
+            break;
+
+        case ValidationCode::SubmeshFaceSubmesh:
+            os << "SubmeshFaceSubmesh";
+            break;
+
+        case ValidationCode::SubmeshFaceShared:
+            os << "SubmeshFaceShared";
+            break;
+
+        case ValidationCode::SubmeshIndex:
+            os << "SubmeshIndex";
+            break;
+
+        default:
+            assert(false);
+    }
+
+    return os;
+}
+
+//------------------------------------------------------------------------------
+ostream& quetzal::brep::operator<<(ostream& os, const ValidationError& error)
+{
+    os << error.code << " " << error.id;
+
+    if (error.idOther != nullid)
+    {
+        os << " " << error.idOther;
+    }
+
+    return os;
+}
@@ -0,0 +1,79 @@
+#if !defined(QUETZAL_BREP_VALIDATIONERROR_HPP)
+#define QUETZAL_BREP_VALIDATIONERROR_HPP
+//------------------------------------------------------------------------------
+// brep
+// ValidationError.hpp
+//------------------------------------------------------------------------------
+
+#include "id.hpp"
+#include <iosfwd>
+
+namespace quetzal::brep
+{
+
+    //--------------------------------------------------------------------------
+    enum class ValidationMode
+    {
+        Invariants, // Ids and connectivity only, constant time per element without allocation
+        Full // Invariants plus geometry, attributes, surfaces and submeshes
+    };
+
+    //--------------------------------------------------------------------------
+    // The prefix names the kind of element identified by ValidationError::id
+    enum class ValidationCode
+    {
+        HalfedgeId, // Stored id does not match position in the store
+        HalfedgePartner, // Partner out of range or deleted
+        HalfedgeNext, // Next out of range or deleted
+        HalfedgePrev, // Prev out of range or deleted
+        HalfedgeVertex, // Vertex out of range or deleted
+        HalfedgeFace, // Face out of range or deleted
+        HalfedgePartnerPartner, // Partner is this halfedge or its partner is not this halfedge
+        HalfedgeNextPrev, // Prev of next is not this halfedge
+        HalfedgePrevNext, // Next of prev is not this halfedge
+        HalfedgeNextFace, // Next is in another face
+        HalfedgePartnerPosition, // Position differs from the end of the partner
+        VertexId,
+        VertexHalfedge, // Halfedge out of range or deleted
+        VertexHalfedgeVertex, // Halfedge does not start at this vertex
+        VertexPosition, // Coordinate out of range
+        VertexAttributes, // Attributes failed their own validation
+        FaceId,
+        FaceHalfedge, // Halfedge out of range or deleted
+        FaceHalfedgeFace, // Halfedge belongs to another face
+        FaceSurface, // Surface out of range or deleted
+        FaceSubmesh, // Submesh out of range or deleted
+        FaceSurfaceSubmesh, // Submesh differs from the submesh of the surface
+        FaceEdgeCount, // Fewer than three edges
+        FaceNormal, // Normal is not a unit vector
+        FaceDuplicatePosition, // Consecutive vertices at the same position, other id is the second halfedge
+        FaceNotInSurface, // Face is not in the face list of its surface
+        FaceNotInSubmesh, // Face is not in the face list of its submesh
+        SurfaceEmpty,
+        SurfaceSubmesh, // Submesh out of range, deleted or does not list this surface
+        SurfaceFace, // Listed face out of range or deleted, other id is the face
+        SurfaceFaceSurface, // Listed face belongs to another surface, other id is the face
+        SurfaceFaceShared, // Listed face is also listed by an earlier surface, other id is the face
+        SurfaceIndex, // Surface index size does not match the surface count, id is nullid
+        SubmeshEmpty,
+        SubmeshSurface, // Listed surface out of range, deleted or in another submesh, other id is the surface
+        SubmeshFace, // Listed face out of range or deleted, other id is the face
+        SubmeshFaceSubmesh, // Listed face belongs to another submesh, other id is the face
+        SubmeshFaceShared, // Listed face is also listed by an earlier submesh, other id is the face
+        SubmeshIndex // Submesh index size does not match the submesh count, id is nullid
+    };
+
+    //--------------------------------------------------------------------------
+    struct ValidationError
+    {
+        ValidationCode code;
+        id_type id; // Id of the element checked
+        id_type idOther = nullid; // Id of the element found to be inconsistent with it, if any
+    };
+
+    std::ostream& operator<<(std::ostream& os, const ValidationCode& code);
+    std::ostream& operator<<(std::ostream& os, const ValidationError& error);
+
+} // namespace quetzal::brep
+
+#endif // QUETZAL_BREP_VALIDATIONERROR_HPP
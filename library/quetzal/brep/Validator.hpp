@@ -0,0 +1,525 @@
+#if !defined(QUETZAL_BREP_VALIDATOR_HPP)
+#define QUETZAL_BREP_VALIDATOR_HPP
+//------------------------------------------------------------------------------
+// brep
+// Validator.hpp
+//------------------------------------------------------------------------------
+
+#include "ValidationError.hpp"
+#include "id.hpp"
+#include "validation.hpp"
+#include "quetzal/math/floating_point.hpp"
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <numeric>
+#include <vector>
+#include <cassert>
+
+namespace quetzal::brep
+{
+
+    //--------------------------------------------------------------------------
+    // Collects errors rather than printing them
+    // Elements are checked in parallel over ranges of ids, errors are reported in id order within each kind of element
+    // Surface and submesh face lists are checked with dense arrays indexed by face id
+    template<typename M>
+    class Validator
+    {
+    public:
+
+        using mesh_type = M;
+        using errors_type = std::vector<ValidationError>;
+
+        explicit Validator(ValidationMode mode = ValidationMode::Full, size_t nRange = 4096);
+        Validator(const Validator&) = default;
+        Validator(Validator&&) noexcept = default;
+        ~Validator() = default;
+
+        Validator& operator=(const Validator&) = default;
+        Validator& operator=(Validator&&) = default;
+
+        ValidationMode mode() const;
+        void set_mode(ValidationMode mode);
+
+        // Replaces any errors from a previous call, returns true if none were found
+        bool validate(const M& mesh);
+
+        const errors_type& errors() const;
+        size_t error_count() const;
+
+    private:
+
+        // Calls check(id, errors) for each id in [0, n), one task per range of ids
+        template<typename F>
+        void check_ranges(size_t n, F check);
+
+        void check_halfedge(const M& mesh, id_type idHalfedge, errors_type& errors) const;
+        void check_vertex(const M& mesh, id_type idVertex, errors_type& errors) const;
+        void check_face(const M& mesh, id_type idFace, errors_type& errors) const;
+        void check_surfaces(const M& mesh);
+        void check_submeshes(const M& mesh);
+
+        ValidationMode m_mode;
+        size_t m_nRange;
+        errors_type m_errors;
+
+        // Full mode, surface and submesh listing each face, nullid if none
+        std::vector<id_type> m_idFaceSurfaces;
+        std::vector<id_type> m_idFaceSubmeshes;
+    };
+
+    // Validate with a temporary Validator and return the errors found
+    template<typename M>
+    std::vector<ValidationError> validate(const M& mesh, ValidationMode mode);
+
+} // namespace quetzal::brep
+
+//------------------------------------------------------------------------------
+template<typename M>
+quetzal::brep::Validator<M>::Validator(ValidationMode mode, size_t nRange) :
+    m_mode(mode),
+    m_nRange(nRange),
+    m_errors(),
+    m_idFaceSurfaces(),
+    m_idFaceSubmeshes()
+{
+    assert(nRange > 0);
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+quetzal::brep::ValidationMode quetzal::brep::Validator<M>::mode() const
+{
+    return m_mode;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::Validator<M>::set_mode(ValidationMode mode)
+{
+    m_mode = mode;
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+bool quetzal::brep::Validator<M>::validate(const M& mesh)
+{
+    m_errors.clear();
+
+    check_ranges(mesh.halfedge_store_count(), [&](id_type id, errors_type& errors) { check_halfedge(mesh, id, errors); });
+    check_ranges(mesh.vertex_store_count(), [&](id_type id, errors_type& errors) { check_vertex(mesh, id, errors); });
+
+    if (m_mode == ValidationMode::Full)
+    {
+        check_surfaces(mesh);
+        check_submeshes(mesh);
+    }
+
+    check_ranges(mesh.face_store_count(), [&](id_type id, errors_type& errors) { check_face(mesh, id, errors); });
+
+    return m_errors.empty();
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+const typename quetzal::brep::Validator<M>::errors_type& quetzal::brep::Validator<M>::errors() const
+{
+    return m_errors;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+size_t quetzal::brep::Validator<M>::error_count() const
+{
+    return m_errors.size();
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+template<typename F>
+void quetzal::brep::Validator<M>::check_ranges(size_t n, F check)
+{
+    size_t nRanges = (n + m_nRange - 1) / m_nRange;
+
+    // Errors are rare, so the per range vectors normally stay empty and never allocate
+    std::vector<errors_type> errors(nRanges);
+    std::vector<size_t> ranges(nRanges);
+    std::iota(ranges.begin(), ranges.end(), size_t(0));
+
+    std::for_each(std::execution::par, ranges.begin(), ranges.end(), [&](size_t i)
+    {
+        id_type idEnd = std::min(n, (i + 1) * m_nRange);
+        for (id_type id = i * m_nRange; id < idEnd; ++id)
+        {
+            check(id, errors[i]);
+        }
+    });
+
+    for (const auto& errorsRange : errors)
+    {
+        m_errors.insert(m_errors.end(), errorsRange.begin(), errorsRange.end());
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::Validator<M>::check_halfedge(const M& mesh, id_type idHalfedge, errors_type& errors) const
+{
+    const auto& halfedges = mesh.halfedge_store();
+    const auto& halfedge = halfedges[idHalfedge];
+    if (halfedge.deleted())
+    {
+        return;
+    }
+
+    if (halfedge.id() != idHalfedge)
+    {
+        errors.push_back({ValidationCode::HalfedgeId, idHalfedge, halfedge.id()});
+    }
+
+    bool bPartner = halfedge.partner_id() != nullid;
+    if (bPartner && !good(halfedge.partner_id(), halfedges))
+    {
+        errors.push_back({ValidationCode::HalfedgePartner, idHalfedge, halfedge.partner_id()});
+        bPartner = false;
+    }
+
+    bool bNext = good(halfedge.next_id(), halfedges);
+    if (!bNext)
+    {
+        errors.push_back({ValidationCode::HalfedgeNext, idHalfedge, halfedge.next_id()});
+    }
+
+    bool bPrev = good(halfedge.prev_id(), halfedges);
+    if (!bPrev)
+    {
+        errors.push_back({ValidationCode::HalfedgePrev, idHalfedge, halfedge.prev_id()});
+    }
+
+    bool bVertex = good(halfedge.vertex_id(), mesh.vertex_store());
+    if (!bVertex)
+    {
+        errors.push_back({ValidationCode::HalfedgeVertex, idHalfedge, halfedge.vertex_id()});
+    }
+
+    if (!good(halfedge.face_id(), mesh.face_store()))
+    {
+        errors.push_back({ValidationCode::HalfedgeFace, idHalfedge, halfedge.face_id()});
+    }
+
+    // A consistent partner relation also rules out an edge shared by more than two faces
+    if (bPartner)
+    {
+        const auto& partner = halfedges[halfedge.partner_id()];
+        if (halfedge.partner_id() == idHalfedge || partner.partner_id() != idHalfedge)
+        {
+            errors.push_back({ValidationCode::HalfedgePartnerPartner, idHalfedge, halfedge.partner_id()});
+        }
+        else if (m_mode == ValidationMode::Full && bVertex && good(partner.next_id(), halfedges) && good(halfedges[partner.next_id()].vertex_id(), mesh.vertex_store()))
+        {
+            const auto& position = mesh.vertex_store()[halfedge.vertex_id()].attributes().position();
+            const auto& positionPartner = mesh.vertex_store()[halfedges[partner.next_id()].vertex_id()].attributes().position();
+            if (!vector_eq(position, positionPartner, v_ulp))
+            {
+                errors.push_back({ValidationCode::HalfedgePartnerPosition, idHalfedge, halfedge.partner_id()});
+            }
+        }
+    }
+
+    if (bNext)
+    {
+        const auto& next = halfedges[halfedge.next_id()];
+        if (next.prev_id() != idHalfedge)
+        {
+            errors.push_back({ValidationCode::HalfedgeNextPrev, idHalfedge, halfedge.next_id()});
+        }
+
+        if (next.face_id() != halfedge.face_id())
+        {
+            errors.push_back({ValidationCode::HalfedgeNextFace, idHalfedge, halfedge.next_id()});
+        }
+    }
+
+    if (bPrev && halfedges[halfedge.prev_id()].next_id() != idHalfedge)
+    {
+        errors.push_back({ValidationCode::HalfedgePrevNext, idHalfedge, halfedge.prev_id()});
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::Validator<M>::check_vertex(const M& mesh, id_type idVertex, errors_type& errors) const
+{
+    const auto& vertex = mesh.vertex_store()[idVertex];
+    if (vertex.deleted())
+    {
+        return;
+    }
+
+    if (vertex.id() != idVertex)
+    {
+        errors.push_back({ValidationCode::VertexId, idVertex, vertex.id()});
+    }
+
+    if (!good(vertex.halfedge_id(), mesh.halfedge_store()))
+    {
+        errors.push_back({ValidationCode::VertexHalfedge, idVertex, vertex.halfedge_id()});
+    }
+    else if (mesh.halfedge_store()[vertex.halfedge_id()].vertex_id() != idVertex)
+    {
+        errors.push_back({ValidationCode::VertexHalfedgeVertex, idVertex, vertex.halfedge_id()});
+    }
+
+    if (m_mode == ValidationMode::Full)
+    {
+        const auto& position = vertex.attributes().position();
+        typename M::value_type coordMax = v_max<M>;
+        if (std::abs(position.x()) > coordMax || std::abs(position.y()) > coordMax || std::abs(position.z()) > coordMax)
+        {
+            errors.push_back({ValidationCode::VertexPosition, idVertex});
+        }
+
+        if (!vertex.attributes().validate())
+        {
+            errors.push_back({ValidationCode::VertexAttributes, idVertex});
+        }
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::Validator<M>::check_face(const M& mesh, id_type idFace, errors_type& errors) const
+{
+    const auto& face = mesh.face_store()[idFace];
+    if (face.deleted())
+    {
+        return;
+    }
+
+    if (face.id() != idFace)
+    {
+        errors.push_back({ValidationCode::FaceId, idFace, face.id()});
+    }
+
+    const auto& halfedges = mesh.halfedge_store();
+    bool bHalfedge = good(face.halfedge_id(), halfedges);
+    if (!bHalfedge)
+    {
+        errors.push_back({ValidationCode::FaceHalfedge, idFace, face.halfedge_id()});
+    }
+    else if (halfedges[face.halfedge_id()].face_id() != idFace)
+    {
+        errors.push_back({ValidationCode::FaceHalfedgeFace, idFace, face.halfedge_id()});
+        bHalfedge = false;
+    }
+
+    bool bSurface = face.surface_id() != nullid;
+    if (bSurface && !good(face.surface_id(), mesh.surface_store()))
+    {
+        errors.push_back({ValidationCode::FaceSurface, idFace, face.surface_id()});
+        bSurface = false;
+    }
+
+    bool bSubmesh = face.submesh_id() != nullid;
+    if (bSubmesh && !good(face.submesh_id(), mesh.submesh_store()))
+    {
+        errors.push_back({ValidationCode::FaceSubmesh, idFace, face.submesh_id()});
+        bSubmesh = false;
+    }
+
+    if (bSurface && face.submesh_id() != mesh.surface_store()[face.surface_id()].submesh_id())
+    {
+        errors.push_back({ValidationCode::FaceSurfaceSubmesh, idFace, face.surface_id()});
+    }
+
+    if (m_mode != ValidationMode::Full)
+    {
+        return;
+    }
+
+    if (math::float_ne(face.attributes().normal().norm(), M::val(1)))
+    {
+        errors.push_back({ValidationCode::FaceNormal, idFace});
+    }
+
+    if (bSurface && m_idFaceSurfaces[idFace] != face.surface_id())
+    {
+        errors.push_back({ValidationCode::FaceNotInSurface, idFace, face.surface_id()});
+    }
+
+    if (bSubmesh && m_idFaceSubmeshes[idFace] != face.submesh_id())
+    {
+        errors.push_back({ValidationCode::FaceNotInSubmesh, idFace, face.submesh_id()});
+    }
+
+    if (!bHalfedge)
+    {
+        return;
+    }
+
+    // Bounded in case the loop does not close, which the halfedge checks will have reported
+    const auto& vertices = mesh.vertex_store();
+    size_t n = 0;
+    id_type idHalfedge0 = face.halfedge_id();
+    id_type idHalfedge = idHalfedge0;
+    do
+    {
+        const auto& halfedge = halfedges[idHalfedge];
+        if (!good(halfedge.next_id(), halfedges) || !good(halfedge.vertex_id(), vertices))
+        {
+            return;
+        }
+
+        const auto& next = halfedges[halfedge.next_id()];
+        if (good(next.vertex_id(), vertices) && vector_eq(vertices[halfedge.vertex_id()].attributes().position(), vertices[next.vertex_id()].attributes().position()))
+        {
+            errors.push_back({ValidationCode::FaceDuplicatePosition, idFace, halfedge.next_id()});
+        }
+
+        ++n;
+        idHalfedge = halfedge.next_id();
+    } while (idHalfedge != idHalfedge0 && n <= halfedges.size());
+
+    if (n < 3)
+    {
+        errors.push_back({ValidationCode::FaceEdgeCount, idFace});
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::Validator<M>::check_surfaces(const M& mesh)
+{
+    m_idFaceSurfaces.assign(mesh.face_store_count(), nullid);
+
+    const auto& faces = mesh.face_store();
+    const auto& surfaces = mesh.surface_store();
+
+    for (id_type idSurface = 0; idSurface < surfaces.size(); ++idSurface)
+    {
+        const auto& surface = surfaces[idSurface];
+        if (surface.deleted())
+        {
+            continue;
+        }
+
+        if (surface.empty())
+        {
+            m_errors.push_back({ValidationCode::SurfaceEmpty, idSurface});
+        }
+
+        if (surface.submesh_id() != nullid && (!good(surface.submesh_id(), mesh.submesh_store()) || !mesh.submesh_store()[surface.submesh_id()].contains_surface(idSurface)))
+        {
+            m_errors.push_back({ValidationCode::SurfaceSubmesh, idSurface, surface.submesh_id()});
+        }
+
+        for (id_type idFace : surface.face_ids())
+        {
+            if (!good(idFace, faces))
+            {
+                m_errors.push_back({ValidationCode::SurfaceFace, idSurface, idFace});
+            }
+            else if (m_idFaceSurfaces[idFace] != nullid)
+            {
+                m_errors.push_back({ValidationCode::SurfaceFaceShared, idSurface, idFace});
+            }
+            else
+            {
+                m_idFaceSurfaces[idFace] = idSurface;
+
+                if (faces[idFace].surface_id() != idSurface)
+                {
+                    m_errors.push_back({ValidationCode::SurfaceFaceSurface, idSurface, idFace});
+                }
+            }
+        }
+    }
+
+    if (mesh.surface_index_count() != mesh.surface_count())
+    {
+        m_errors.push_back({ValidationCode::SurfaceIndex, nullid});
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::Validator<M>::check_submeshes(const M& mesh)
+{
+    m_idFaceSubmeshes.assign(mesh.face_store_count(), nullid);
+
+    const auto& faces = mesh.face_store();
+    const auto& submeshes = mesh.submesh_store();
+
+    for (id_type idSubmesh = 0; idSubmesh < submeshes.size(); ++idSubmesh)
+    {
+        const auto& submesh = submeshes[idSubmesh];
+        if (submesh.deleted())
+        {
+            continue;
+        }
+
+        if (submesh.empty())
+        {
+            m_errors.push_back({ValidationCode::SubmeshEmpty, idSubmesh});
+        }
+
+        for (id_type idSurface : submesh.surface_ids())
+        {
+            if (!good(idSurface, mesh.surface_store()) || mesh.surface_store()[idSurface].submesh_id() != idSubmesh)
+            {
+                m_errors.push_back({ValidationCode::SubmeshSurface, idSubmesh, idSurface});
+            }
+        }
+
+        for (id_type idFace : submesh.face_ids())
+        {
+            if (!good(idFace, faces))
+            {
+                m_errors.push_back({ValidationCode::SubmeshFace, idSubmesh, idFace});
+            }
+            else if (m_idFaceSubmeshes[idFace] != nullid)
+            {
+                m_errors.push_back({ValidationCode::SubmeshFaceShared, idSubmesh, idFace});
+            }
+            else
+            {
+                m_idFaceSubmeshes[idFace] = idSubmesh;
+
+                if (faces[idFace].submesh_id() != idSubmesh)
+                {
+                    m_errors.push_back({ValidationCode::SubmeshFaceSubmesh, idSubmesh, idFace});
+                }
+            }
+        }
+    }
+
+    if (mesh.submesh_index_count() != mesh.submesh_count())
+    {
+        m_errors.push_back({ValidationCode::SubmeshIndex, nullid});
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+std::vector<quetzal::brep::ValidationError> quetzal::brep::validate(const M& mesh, ValidationMode mode)
+{
+    Validator<M> validator(mode);
+    validator.validate(mesh);
+    return validator.errors();
+}
+
+#endif // QUETZAL_BREP_VALIDATOR_HPP
@@ -12,11 +12,18 @@
 #include "mesh_geometry.hpp"
 #include "mesh_util.hpp"
 #include "mesh_inversion.hpp"
+#include "triangulation.hpp"
+#include "quetzal/geometry/AxisAlignedBoundingBox.hpp"
+#include "quetzal/geometry/SpatialHash.hpp"
 #include "quetzal/geometry/intersect.hpp"
+#include "quetzal/geometry/triangle_intersection.hpp"
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <execution>
 #include <functional>
 #include <iterator>
+#include <numeric>
 #include <unordered_map>
 #include <vector>
 
@@ -41,47 +48,110 @@ namespace quetzal::brep
     template<typename Traits>
     using inclusion_function_type = std::function<void (Mesh<Traits>&, id_type, id_type, bool)>;
 
+    // Incremental: each edge of one submesh is tested against the faces of the other near it, found through a grid of face bounds
+    // Triangulated: both submeshes are triangulated, then all intersecting face pairs are computed in parallel before any topology edits,
+    // and each edge is only tested against the faces paired with its own faces
+    enum class BooleanMode
+    {
+        Incremental,
+        Triangulated
+    };
+
+    // Intersection of a face of submesh A with a face of submesh B
+    template<typename Traits>
+    struct FaceIntersection
+    {
+        id_type idFaceA;
+        id_type idFaceB;
+        geometry::Intersection<typename Traits::vector_traits> intersection;
+    };
+
+    // Faces of the other submesh paired with each face
+    using face_candidates_type = std::unordered_map<id_type, std::vector<id_type>>;
+
     // A || B
     template<typename Traits>
-    id_type boolean_union(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name);
+    id_type boolean_union(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name, BooleanMode mode = BooleanMode::Incremental);
 
     // A && B
     template<typename Traits>
-    id_type boolean_intersection(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name);
+    id_type boolean_intersection(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name, BooleanMode mode = BooleanMode::Incremental);
 
     // A && !B
     template<typename Traits>
-    id_type boolean_difference(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name);
+    id_type boolean_difference(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name, BooleanMode mode = BooleanMode::Incremental);
 
     // A && !B || !A && B
     template<typename Traits>
-    id_type boolean_symmetric_difference(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name);
+    id_type boolean_symmetric_difference(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name, BooleanMode mode = BooleanMode::Incremental);
+
+    // A || B || C || ..., all operands at once
+    // Operands are grouped by their crossings, each group crosses no operand outside it, so one winding number classifies it whole
+    // Groups inside another operand are deleted before any edits, the operands of each remaining group are combined pairwise by the binary operation
+    // Returns nullid if the operands of a crossing group could not be combined, other groups are still combined and named for the result
+    template<typename Traits>
+    id_type boolean_union(Mesh<Traits>& mesh, const std::vector<id_type>& idSubmeshes, const std::string& name, BooleanMode mode = BooleanMode::Incremental);
+
+    // A && !(B || C || ...), all cutters at once
+    // Cutters are grouped by their crossings with each other, groups inside another cutter are deleted, groups that do not cross A are deleted or become cavities,
+    // and the others are combined pairwise and subtracted once each, all classified by winding number before any edits
+    // Returns nullid with all operands deleted if A lies inside a cutter group that does not cross it
+    // Returns nullid if a crossing group could not be combined or subtracted, its cutters are kept and the other groups are still applied
+    template<typename Traits>
+    id_type boolean_difference(Mesh<Traits>& mesh, id_type idSubmeshA, const std::vector<id_type>& idSubmeshesB, const std::string& name, BooleanMode mode = BooleanMode::Incremental);
 
     // Create a new or use an existing submesh with name for the result
     // Surface names in the result will typically consist of some from each original submesh
-    // Returns submesh id of the result
+    // Returns submesh id of the result, or nullid if the intersection curves cannot be split (see splittable),
+    // in which case the operands keep their names and surfaces and are only changed by edges split where they cross
+    template<typename Traits>
+    id_type boolean_operation(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name, connect_function_type<Traits> connect, disjoint_function_type<Traits> disjoint, inclusion_function_type<Traits> inclusion, BooleanMode mode = BooleanMode::Incremental);
+
+    // All intersecting face pairs of submeshes A and B, no topology edits
+    // All faces must be triangles, candidate pairs come from a grid over the faces of B and overlap of face bounds, and pairs are tested in parallel
     template<typename Traits>
-    id_type boolean_operation(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name, connect_function_type<Traits> connect, disjoint_function_type<Traits> disjoint, inclusion_function_type<Traits> inclusion);
+    std::vector<FaceIntersection<Traits>> face_intersections(const Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB);
 
     // Implementation functions
 
     template<typename Traits>
-    std::vector<std::vector<quetzal::id_type>> ordered_intersections(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB);
+    std::vector<std::vector<quetzal::id_type>> ordered_intersections(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, BooleanMode mode = BooleanMode::Incremental);
 
-    // find intersections of submeshB edges with submeshA faces, and split edges
+    // Pairs of operands whose surfaces cross, as indices into idSubmeshes with the lower first, read only
+    // The faces of all operands share one grid, and each edge is tested against the faces of other operands near it
     template<typename Traits>
-    void split_submesh_intersections(Mesh<Traits>& mesh, const Submesh<Traits>& submeshA, Submesh<Traits>& submeshB, intersections_type& intersections);
+    std::vector<std::array<size_t, 2>> crossing_operands(const Mesh<Traits>& mesh, const std::vector<id_type>& idSubmeshes);
 
+    // Triangulates the faces of a submesh that are not already triangles
     template<typename Traits>
-    void halfedge_intersection(Mesh<Traits>& mesh, const Submesh<Traits>& submesh, Halfedge<Traits>& halfedge, intersections_type& intersections);
+    void triangulate_submesh(Mesh<Traits>& mesh, id_type idSubmesh);
 
+    // Intersection of an edge with a face of the other submesh, t is the position of the point along the edge
     template<typename Traits>
-    std::tuple<quetzal::id_type, typename Traits::point_type> face_intersection(const Submesh<Traits>& submesh, const Halfedge<Traits>& halfedge);
+    struct EdgeIntersection
+    {
+        typename Traits::value_type t;
+        id_type idFace;
+        typename Traits::point_type point;
+    };
 
+    // find intersections of submeshB edges with submeshA faces, and split edges
+    // All intersections are found before any edge is split, then each edge is split once at all of its points, edges in halfedge id order
+    // When pCandidates is given, an edge is only tested against the submeshA faces paired with its faces, otherwise against those near it in a grid
     template<typename Traits>
-    void split_intersection(Mesh<Traits>& mesh, id_type idFaceA, id_type idHalfedgeB, typename Traits::point_type point, intersections_type& intersections);
+    void split_submesh_intersections(Mesh<Traits>& mesh, const Submesh<Traits>& submeshA, Submesh<Traits>& submeshB, intersections_type& intersections, const face_candidates_type* pCandidates = nullptr);
+
+    // Intersections of an edge with faces, no topology edits, ordered along the edge and then by face id
+    template<typename Traits>
+    std::vector<EdgeIntersection<Traits>> edge_intersections(const Mesh<Traits>& mesh, id_type idHalfedge, const std::vector<id_type>& idFaces);
+
+    // Split an edge at all of its interior intersection points, and add an intersection for each point and face
+    // Intersections at the edge endpoints are added without splitting
+    template<typename Traits>
+    void split_edge_intersections(Mesh<Traits>& mesh, id_type idHalfedge, const std::vector<EdgeIntersection<Traits>>& hits, intersections_type& intersections);
 
     // intersections are consumed in the process of ordering them into sets
+    // A curve that closes within a single face gives an empty set
     template<typename Traits>
     std::vector<std::vector<quetzal::id_type>> order_intersections(const Mesh<Traits>& mesh, intersections_type& intersections);
 
@@ -89,6 +159,11 @@ namespace quetzal::brep
     template<typename Traits>
     std::array<id_type, 2> split_submesh(Mesh<Traits>& mesh, id_type idSubmesh, const std::vector<id_type>& idHalfedges);
 
+    // True if split_submesh can cut idSubmesh along every set of ordered intersections, no topology edits
+    // Crossings must alternate between the two submeshes, consecutive crossings of idSubmesh edges must bound a single face, and no face may be cut twice
+    template<typename Traits>
+    bool splittable(const Mesh<Traits>& mesh, id_type idSubmesh, const std::vector<std::vector<id_type>>& idSets, bool bReverse);
+
     template<typename Traits>
     void connect_border_sections(Mesh<Traits>& mesh, id_type idHalfedgeA, id_type idHalfedgeB);
 
@@ -96,6 +171,7 @@ namespace quetzal::brep
     template<typename Traits>
     void delete_border_section(Mesh<Traits>& mesh, id_type idHalfedge, bool bReset = true);
 
+    // Empty if there is no submesh transition in the face
     template<typename Traits, typename InputIterator>
     std::vector<id_type> order_face_halfedges(const Mesh<Traits>& mesh, InputIterator first, InputIterator last);
 
@@ -113,11 +189,40 @@ namespace quetzal::brep
     template<typename Traits>
     void dump_border(Mesh<Traits>& mesh, id_type idHalfedge);
 
+namespace internal
+{
+
+    // Faces entered at the center of each grid cell their bounds overlap, cells are the average face size, deleted faces are skipped
+    template<typename Traits>
+    geometry::SpatialHash<typename Traits::vector_traits, id_type> face_grid(const Mesh<Traits>& mesh, const std::vector<id_type>& idFaces);
+
+    // Faces in the grid cells a segment passes through, ascending and unique
+    template<typename Traits>
+    void grid_faces(const geometry::SpatialHash<Traits, id_type>& grid, const geometry::Segment<Traits>& segment, std::vector<id_type>& idFaces);
+
+    // Operands connected by crossings, each group ordered so that every operand after the first crosses an earlier one
+    // Groups are ordered by their lowest operand, operands that cross nothing are groups of one
+    std::vector<std::vector<size_t>> crossing_groups(size_t nOperands, const std::vector<std::array<size_t, 2>>& pairs);
+
+    template<typename Traits>
+    geometry::AxisAlignedBoundingBox<typename Traits::vector_traits> submesh_bounds(const Mesh<Traits>& mesh, id_type idSubmesh);
+
+    // Position of the first vertex of the first face
+    template<typename Traits>
+    typename Traits::point_type submesh_point(const Mesh<Traits>& mesh, id_type idSubmesh);
+
+    // Union of the operands of a crossing group, in group order, returns the submesh id of the result or nullid if a union failed
+    // Surfaces of a group of one are prefixed with its submesh name, as boolean_operation does for its operands
+    template<typename Traits>
+    id_type union_group(Mesh<Traits>& mesh, const std::vector<id_type>& idSubmeshes, const std::vector<size_t>& group, BooleanMode mode);
+
+} // namespace internal
+
 } // namespace quetzal::brep
 
 //------------------------------------------------------------------------------
 template<typename Traits>
-quetzal::id_type quetzal::brep::boolean_union(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name)
+quetzal::id_type quetzal::brep::boolean_union(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name, BooleanMode mode)
 {
     connect_function_type<Traits> connect = [](Mesh<Traits>& mesh, id_type idHalfedgeInteriorA, id_type idHalfedgeExteriorA, id_type idHalfedgeInteriorB, id_type idHalfedgeExteriorB) -> void
     {
@@ -138,12 +243,12 @@ quetzal::id_type quetzal::brep::boolean_union(Mesh<Traits>& mesh, id_type idSubm
         return;
     };
 
-    return boolean_operation(mesh, idSubmeshA, idSubmeshB, name, connect, disjoint, inclusion);
+    return boolean_operation(mesh, idSubmeshA, idSubmeshB, name, connect, disjoint, inclusion, mode);
 }
 
 //------------------------------------------------------------------------------
 template<typename Traits>
-quetzal::id_type quetzal::brep::boolean_intersection(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name)
+quetzal::id_type quetzal::brep::boolean_intersection(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name, BooleanMode mode)
 {
     connect_function_type<Traits> connect = [](Mesh<Traits>& mesh, id_type idHalfedgeInteriorA, id_type idHalfedgeExteriorA, id_type idHalfedgeInteriorB, id_type idHalfedgeExteriorB) -> void
     {
@@ -166,12 +271,12 @@ quetzal::id_type quetzal::brep::boolean_intersection(Mesh<Traits>& mesh, id_type
         return;
     };
 
-    return boolean_operation(mesh, idSubmeshA, idSubmeshB, name, connect, disjoint, inclusion);
+    return boolean_operation(mesh, idSubmeshA, idSubmeshB, name, connect, disjoint, inclusion, mode);
 }
 
 //------------------------------------------------------------------------------
 template<typename Traits>
-quetzal::id_type quetzal::brep::boolean_difference(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name)
+quetzal::id_type quetzal::brep::boolean_difference(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name, BooleanMode mode)
 {
     connect_function_type<Traits> connect = [](Mesh<Traits>& mesh, id_type idHalfedgeInteriorA, id_type idHalfedgeExteriorA, id_type idHalfedgeInteriorB, id_type idHalfedgeExteriorB) -> void
     {
@@ -201,12 +306,12 @@ quetzal::id_type quetzal::brep::boolean_difference(Mesh<Traits>& mesh, id_type i
         return;
     };
 
-    return boolean_operation(mesh, idSubmeshA, idSubmeshB, name, connect, disjoint, inclusion);
+    return boolean_operation(mesh, idSubmeshA, idSubmeshB, name, connect, disjoint, inclusion, mode);
 }
 
 //------------------------------------------------------------------------------
 template<typename Traits>
-quetzal::id_type quetzal::brep::boolean_symmetric_difference(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name)
+quetzal::id_type quetzal::brep::boolean_symmetric_difference(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name, BooleanMode mode)
 {
     connect_function_type<Traits> connect = [](Mesh<Traits>& mesh, id_type idHalfedgeInteriorA, id_type idHalfedgeExteriorA, id_type idHalfedgeInteriorB, id_type idHalfedgeExteriorB) -> void
     {
@@ -230,15 +335,240 @@ quetzal::id_type quetzal::brep::boolean_symmetric_difference(Mesh<Traits>& mesh,
         return;
     };
 
-    return boolean_operation(mesh, idSubmeshA, idSubmeshB, name, connect, disjoint, inclusion);
+    return boolean_operation(mesh, idSubmeshA, idSubmeshB, name, connect, disjoint, inclusion, mode);
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+quetzal::id_type quetzal::brep::boolean_union(Mesh<Traits>& mesh, const std::vector<id_type>& idSubmeshes, const std::string& name, BooleanMode mode)
+{
+    using point_type = Traits::point_type;
+    using value_type = Traits::value_type;
+
+    std::vector<std::vector<size_t>> groups = internal::crossing_groups(idSubmeshes.size(), crossing_operands(mesh, idSubmeshes));
+
+    std::vector<size_t> iGroups(idSubmeshes.size());
+    for (size_t g = 0; g < groups.size(); ++g)
+    {
+        for (size_t i : groups[g])
+        {
+            iGroups[i] = g;
+        }
+    }
+
+    std::vector<geometry::AxisAlignedBoundingBox<typename Traits::vector_traits>> boxes;
+    for (id_type idSubmesh : idSubmeshes)
+    {
+        boxes.push_back(internal::submesh_bounds(mesh, idSubmesh));
+    }
+
+    // Every operand of a group is connected to the others by crossings and crosses nothing outside the group,
+    // so the group is entirely inside or outside each other operand and any point of it classifies it
+    // Only operands whose bounds contain the point can wind around it, all groups are classified before any edits
+    std::vector<char> bInterior(groups.size(), 0); // char rather than bool, written in parallel
+    std::vector<size_t> indices(groups.size());
+    std::iota(indices.begin(), indices.end(), size_t(0));
+
+    std::for_each(std::execution::par, indices.begin(), indices.end(), [&](size_t g)
+    {
+        const point_type point = internal::submesh_point(mesh, idSubmeshes[groups[g].front()]);
+
+        value_type w = Traits::val(0);
+        for (size_t j = 0; j < idSubmeshes.size(); ++j)
+        {
+            if (iGroups[j] != g && boxes[j].contains(point))
+            {
+                w += winding_number(mesh, idSubmeshes[j], point);
+            }
+        }
+
+        bInterior[g] = w > Traits::val(0.5);
+    });
+
+    std::vector<id_type> idResults;
+    bool bFailed = false;
+    for (size_t g = 0; g < groups.size(); ++g)
+    {
+        if (bInterior[g])
+        {
+            for (size_t i : groups[g])
+            {
+                mesh.delete_submesh(idSubmeshes[i]);
+            }
+
+            continue;
+        }
+
+        id_type idResult = internal::union_group(mesh, idSubmeshes, groups[g], mode);
+        if (idResult == nullid)
+        {
+            bFailed = true;
+            continue;
+        }
+
+        idResults.push_back(idResult);
+    }
+
+    for (id_type idResult : idResults)
+    {
+        if (mesh.submesh(idResult).name() != name)
+        {
+            mesh.rename_submesh(idResult, name);
+        }
+    }
+
+    return bFailed ? nullid : mesh.submesh_id(name);
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+quetzal::id_type quetzal::brep::boolean_difference(Mesh<Traits>& mesh, id_type idSubmeshA, const std::vector<id_type>& idSubmeshesB, const std::string& name, BooleanMode mode)
+{
+    using point_type = Traits::point_type;
+    using value_type = Traits::value_type;
+
+    // Operand 0 is A, cutters are grouped by their crossings with each other only
+    std::vector<id_type> idSubmeshes = {idSubmeshA};
+    idSubmeshes.insert(idSubmeshes.end(), idSubmeshesB.begin(), idSubmeshesB.end());
+
+    std::vector<std::array<size_t, 2>> pairs = crossing_operands(mesh, idSubmeshes);
+    std::vector<bool> bCrossesA(idSubmeshes.size(), false);
+    std::vector<std::array<size_t, 2>> pairsB;
+    for (const auto& pair : pairs)
+    {
+        if (pair[0] == 0)
+        {
+            bCrossesA[pair[1]] = true;
+        }
+        else
+        {
+            pairsB.push_back(pair);
+        }
+    }
+
+    std::vector<std::vector<size_t>> groups = internal::crossing_groups(idSubmeshes.size(), pairsB);
+    assert(groups.front() == std::vector<size_t>{0});
+
+    std::vector<size_t> iGroups(idSubmeshes.size());
+    for (size_t g = 0; g < groups.size(); ++g)
+    {
+        for (size_t i : groups[g])
+        {
+            iGroups[i] = g;
+        }
+    }
+
+    std::vector<geometry::AxisAlignedBoundingBox<typename Traits::vector_traits>> boxes;
+    for (id_type idSubmesh : idSubmeshes)
+    {
+        boxes.push_back(internal::submesh_bounds(mesh, idSubmesh));
+    }
+
+    std::vector<bool> bCrosses(groups.size(), false);
+    for (size_t i = 1; i < idSubmeshes.size(); ++i)
+    {
+        bCrosses[iGroups[i]] = bCrosses[iGroups[i]] || bCrossesA[i];
+    }
+
+    // Winding number around point of the operands for which bCounted is true, split into A and cutters
+    auto windings = [&](const point_type& point, auto bCounted) -> std::array<value_type, 2>
+    {
+        std::array<value_type, 2> w = {Traits::val(0), Traits::val(0)};
+        for (size_t j = 0; j < idSubmeshes.size(); ++j)
+        {
+            if (bCounted(j) && boxes[j].contains(point))
+            {
+                w[j == 0 ? 0 : 1] += winding_number(mesh, idSubmeshes[j], point);
+            }
+        }
+
+        return w;
+    };
+
+    // A is entirely inside or outside each group that does not cross it, whether or not others do
+    auto bOutsideA = [&](size_t j) { return j != 0 && !bCrosses[iGroups[j]]; };
+    if (windings(internal::submesh_point(mesh, idSubmeshA), bOutsideA)[1] > Traits::val(0.5))
+    {
+        for (id_type idSubmesh : idSubmeshes)
+        {
+            mesh.delete_submesh(idSubmesh);
+        }
+
+        return nullid;
+    }
+
+    // Each cutter group is entirely inside or outside each operand outside it, and inside or outside A as well if it does not cross A
+    // Group 0 is A itself, all are classified before any edits
+    std::vector<char> bEnclosed(groups.size(), 0); // char rather than bool, written in parallel
+    std::vector<char> bCavity(groups.size(), 0);
+    std::vector<size_t> indices(groups.size() - 1);
+    std::iota(indices.begin(), indices.end(), size_t(1));
+
+    std::for_each(std::execution::par, indices.begin(), indices.end(), [&](size_t g)
+    {
+        auto w = windings(internal::submesh_point(mesh, idSubmeshes[groups[g].front()]), [&](size_t j) { return iGroups[j] != g; });
+        bEnclosed[g] = w[1] > Traits::val(0.5);
+        bCavity[g] = !bCrosses[g] && !bEnclosed[g] && w[0] > Traits::val(0.5);
+    });
+
+    std::vector<id_type> idCavities;
+    bool bFailed = false;
+    for (size_t g = 1; g < groups.size(); ++g)
+    {
+        if (bEnclosed[g] || (!bCrosses[g] && !bCavity[g]))
+        {
+            for (size_t i : groups[g])
+            {
+                mesh.delete_submesh(idSubmeshes[i]);
+            }
+
+            continue;
+        }
+
+        id_type idGroup = internal::union_group(mesh, idSubmeshes, groups[g], mode);
+        if (idGroup == nullid)
+        {
+            bFailed = true;
+            continue;
+        }
+
+        if (bCavity[g])
+        {
+            invert_submesh(mesh, idGroup);
+            idCavities.push_back(idGroup);
+            continue;
+        }
+
+        bFailed = boolean_difference(mesh, idSubmeshA, idGroup, mesh.submesh(idSubmeshA).name(), mode) == nullid || bFailed;
+    }
+
+    for (id_type idResult : idCavities)
+    {
+        mesh.rename_submesh(idResult, mesh.submesh(idSubmeshA).name());
+    }
+
+    if (mesh.submesh(idSubmeshA).name() != name)
+    {
+        mesh.rename_submesh(idSubmeshA, name);
+    }
+
+    return bFailed ? nullid : mesh.submesh_id(name);
 }
 
 //------------------------------------------------------------------------------
 template<typename Traits>
-quetzal::id_type quetzal::brep::boolean_operation(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name, connect_function_type<Traits> connect, disjoint_function_type<Traits> disjoint, inclusion_function_type<Traits> inclusion)
+quetzal::id_type quetzal::brep::boolean_operation(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, const std::string& name, connect_function_type<Traits> connect, disjoint_function_type<Traits> disjoint, inclusion_function_type<Traits> inclusion, BooleanMode mode)
 {
     id_type idSubmesh = mesh.submesh_id(name);
 
+    std::vector<std::vector<id_type>> idSets = ordered_intersections(mesh, idSubmeshA, idSubmeshB, mode);
+
+    // B is split along each set reversed
+    if (!splittable(mesh, idSubmeshA, idSets, false) || !splittable(mesh, idSubmeshB, idSets, true))
+    {
+        return nullid;
+    }
+
     std::string prefix;
     auto renamer = [&](const std::string& name) -> std::string { return prefix + name; };
 
@@ -248,7 +578,6 @@ quetzal::id_type quetzal::brep::boolean_operation(Mesh<Traits>& mesh, id_type id
     prefix = mesh.submesh(idSubmeshB).name() + "_";
     mesh.rename_submesh_surfaces(idSubmeshB, renamer);
 
-    std::vector<std::vector<id_type>> idSets = ordered_intersections(mesh, idSubmeshA, idSubmeshB);
     if (idSets.empty())
     {
         // No intersection, so only a single vertex position needs to be checked
@@ -267,44 +596,10 @@ quetzal::id_type quetzal::brep::boolean_operation(Mesh<Traits>& mesh, id_type id
     {
         for (auto& idsOrdered : idSets)
         {
-std::cout << "intersection set" << std::endl;
-for (id_type id : idsOrdered)
-{
-    std::cout << "\t" << id;
-}
-std::cout << std::endl;
-
-std::cout << "ordered_intersections" << std::endl;
-//validate(mesh);
-for (id_type id : idsOrdered)
-{
-write_halfedge<Mesh<Traits>>(mesh.halfedge(id), "h ");
-write_halfedge<Mesh<Traits>>(mesh.halfedge(id).partner(), "p ");
-write_face<Mesh<Traits>>(mesh.halfedge(id).face(), "f ");
-}
-
-std::cout << "split_submesh a" << std::endl;
             auto [idHalfedgeInteriorA, idHalfedgeExteriorA] = split_submesh(mesh, idSubmeshA, idsOrdered);
-//validate(mesh);
-std::cout << "split_submesh b" << std::endl;
 
             std::reverse(idsOrdered.begin(), idsOrdered.end());
             auto [idHalfedgeInteriorB, idHalfedgeExteriorB] = split_submesh(mesh, idSubmeshB, idsOrdered);
-//validate(mesh);
-
-std::cout << "interior a" << std::endl;
-dump_border(mesh, idHalfedgeInteriorA);
-dump_border_section(mesh, idHalfedgeInteriorA);
-std::cout << "exterior a" << std::endl;
-dump_border(mesh, idHalfedgeExteriorA);
-dump_border_section(mesh, idHalfedgeExteriorA);
-std::cout << "interior b" << std::endl;
-dump_border(mesh, idHalfedgeInteriorB);
-dump_border_section(mesh, idHalfedgeInteriorB);
-std::cout << "exterior b" << std::endl;
-dump_border(mesh, idHalfedgeExteriorB);
-dump_border_section(mesh, idHalfedgeExteriorB);
-
             connect(mesh, idHalfedgeInteriorA, idHalfedgeExteriorA, idHalfedgeInteriorB, idHalfedgeExteriorB);
         }
     }
@@ -324,45 +619,105 @@ dump_border_section(mesh, idHalfedgeExteriorB);
 
 //------------------------------------------------------------------------------
 template<typename Traits>
-std::vector<std::vector<quetzal::id_type>> quetzal::brep::ordered_intersections(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB)
+std::vector<std::vector<quetzal::id_type>> quetzal::brep::ordered_intersections(Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB, BooleanMode mode)
 {
+    face_candidates_type candidatesA; // submeshB faces paired with each submeshA face
+    face_candidates_type candidatesB; // submeshA faces paired with each submeshB face
+    if (mode == BooleanMode::Triangulated)
+    {
+        triangulate_submesh(mesh, idSubmeshA);
+        triangulate_submesh(mesh, idSubmeshB);
+
+        for (const auto& fi : face_intersections(mesh, idSubmeshA, idSubmeshB))
+        {
+            candidatesA[fi.idFaceA].push_back(fi.idFaceB);
+            candidatesB[fi.idFaceB].push_back(fi.idFaceA);
+        }
+    }
+
+    const face_candidates_type* pCandidatesA = mode == BooleanMode::Triangulated ? &candidatesA : nullptr;
+    const face_candidates_type* pCandidatesB = mode == BooleanMode::Triangulated ? &candidatesB : nullptr;
+
     Submesh<Traits> submeshA = mesh.submesh(idSubmeshA);
     Submesh<Traits> submeshB = mesh.submesh(idSubmeshB);
 
     intersections_type intersections;
-    split_submesh_intersections(mesh, submeshA, submeshB, intersections);
-    split_submesh_intersections(mesh, submeshB, submeshA, intersections);
-write_summary(mesh);
-for (const auto& i : intersections)
-{
-    std::cout << "face " << i.first << ": " << i.second << " | " << mesh.halfedge(i.second).partner_id() << " : " << mesh.halfedge(i.second).face_id() << std::endl;
-}
+    split_submesh_intersections(mesh, submeshA, submeshB, intersections, pCandidatesB);
+    split_submesh_intersections(mesh, submeshB, submeshA, intersections, pCandidatesA);
 
     return order_intersections(mesh, intersections);
 }
 
 //------------------------------------------------------------------------------
 template<typename Traits>
-void quetzal::brep::split_submesh_intersections(Mesh<Traits>& mesh, const Submesh<Traits>& submeshA, Submesh<Traits>& submeshB, intersections_type& intersections)
+void quetzal::brep::split_submesh_intersections(Mesh<Traits>& mesh, const Submesh<Traits>& submeshA, Submesh<Traits>& submeshB, intersections_type& intersections, const face_candidates_type* pCandidates)
 {
-//size_t i = 0;
-    for (auto& faceB : submeshB.faces())
+    // Each edge once, from its lower halfedge id
+    std::vector<id_type> idHalfedges;
+    for (const auto& halfedge : mesh.halfedge_store())
+    {
+        if (halfedge.deleted() || halfedge.checked() || halfedge.face().submesh_id() != submeshB.id() || (!halfedge.border() && halfedge.partner_id() < halfedge.id()))
+        {
+            continue;
+        }
+
+        idHalfedges.push_back(halfedge.id());
+    }
+
+    geometry::SpatialHash<typename Traits::vector_traits, id_type> grid(Traits::val(1));
+    if (pCandidates == nullptr)
+    {
+        grid = internal::face_grid(mesh, std::vector<id_type>(submeshA.face_ids().begin(), submeshA.face_ids().end()));
+    }
+
+    // All intersections are found before any topology edits
+    std::vector<std::vector<EdgeIntersection<Traits>>> hits(idHalfedges.size());
+    std::vector<size_t> indices(idHalfedges.size());
+    std::iota(indices.begin(), indices.end(), size_t(0));
+
+    std::for_each(std::execution::par, indices.begin(), indices.end(), [&](size_t i)
     {
-        for (auto& halfedgeB : faceB.halfedges())
-        {            
-            if (halfedgeB.checked())
+        const auto& halfedge = mesh.halfedge(idHalfedges[i]);
+
+        std::vector<id_type> idFaces;
+        if (pCandidates != nullptr)
+        {
+            for (id_type idFace : {halfedge.face_id(), halfedge.border() ? nullid : halfedge.partner().face_id()})
             {
-                continue;
+                auto j = pCandidates->find(idFace);
+                if (j != pCandidates->end())
+                {
+                    idFaces.insert(idFaces.end(), j->second.begin(), j->second.end());
+                }
+            }
+
+            std::sort(idFaces.begin(), idFaces.end());
+            idFaces.erase(std::unique(idFaces.begin(), idFaces.end()), idFaces.end());
+        }
+        else
+        {
+            internal::grid_faces(grid, to_segment(halfedge), idFaces);
+        }
+
+        hits[i] = edge_intersections(mesh, idHalfedges[i], idFaces);
+    });
+
+    // Edges are split in id order, so intersections are added in the same order on every run
+    for (size_t i = 0; i < idHalfedges.size(); ++i)
+    {
+        if (hits[i].empty())
+        {
+            auto& halfedge = mesh.halfedge(idHalfedges[i]);
+            halfedge.set_checked();
+            if (!halfedge.border())
+            {
+                halfedge.partner().set_checked();
             }
 
-//if (i == 2)
-//{
-//    int j = 0;
-//}
-            halfedge_intersection(mesh, submeshA, halfedgeB, intersections);
-//assert(intersections.empty());
-//++i;
+            continue;
         }
+
+        split_edge_intersections(mesh, idHalfedges[i], hits[i], intersections);
     }
 
     return;
@@ -370,97 +725,309 @@ void quetzal::brep::split_submesh_intersections(Mesh<Traits>& mesh, const Submes
 
 //------------------------------------------------------------------------------
 template<typename Traits>
-void quetzal::brep::halfedge_intersection(Mesh<Traits>& mesh, const Submesh<Traits>& submesh, Halfedge<Traits>& halfedge, intersections_type& intersections)
+std::vector<quetzal::brep::EdgeIntersection<Traits>> quetzal::brep::edge_intersections(const Mesh<Traits>& mesh, id_type idHalfedge, const std::vector<id_type>& idFaces)
 {
-    auto [idFace, point] = face_intersection(submesh, halfedge);
-    if (idFace == nullid)
+    geometry::Segment<typename Traits::vector_traits> segment = to_segment(mesh.halfedge(idHalfedge));
+
+    std::vector<EdgeIntersection<Traits>> hits;
+    for (id_type idFace : idFaces)
     {
-        halfedge.set_checked();
-        halfedge.partner().set_checked();
-        return;
+        geometry::Polygon<typename Traits::vector_traits> polygon = to_polygon(mesh.face(idFace));
+        geometry::Intersection<typename Traits::vector_traits> intersection = geometry::intersection(segment, polygon);
+
+        // An edge in the plane of the face touches rather than crosses it, coplanar contact is not split
+        if (intersection.locus() == geometry::Locus::Point)
+        {
+            hits.push_back({segment.projection_parameter(intersection.point()), idFace, intersection.point()});
+        }
     }
 
-    // check here for intersection at endpoints and handle differently ...
-    // this is a start, but also need to handle face - face intersections at only one point ...
-    if (vector_eq(point, halfedge.attributes().position()))
+    std::sort(hits.begin(), hits.end(), [](const EdgeIntersection<Traits>& a, const EdgeIntersection<Traits>& b) -> bool
+    {
+        return a.t < b.t || (a.t == b.t && a.idFace < b.idFace);
+    });
+
+    return hits;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+void quetzal::brep::split_edge_intersections(Mesh<Traits>& mesh, id_type idHalfedge, const std::vector<EdgeIntersection<Traits>>& hits, intersections_type& intersections)
+{
+    assert(!hits.empty());
+
+    using point_type = Traits::point_type;
+
+    // Copies, splitting creates halfedges
+    const point_type a = mesh.halfedge(idHalfedge).attributes().position();
+    const point_type b = mesh.halfedge(idHalfedge).next().attributes().position();
+
+    // Coincident points are grouped, iGroups holds the first hit of each group, followed by the hit count
+    std::vector<size_t> iGroups;
+    for (size_t i = 0; i < hits.size(); ++i)
     {
-        bool bExterior = to_halfspace(mesh.face(idFace)).exterior(halfedge.next().attributes().position());
-        if (bExterior)
+        if (iGroups.empty() || !vector_eq(hits[i].point, hits[iGroups.back()].point))
         {
-            intersections.emplace(idFace, halfedge.id());
+            iGroups.push_back(i);
         }
+    }
 
-        return;
+    size_t nGroups = iGroups.size();
+    iGroups.push_back(hits.size());
+
+    // Groups at the endpoints are not split, interior groups are jFirst through jLast - 1
+    size_t jFirst = vector_eq(hits[iGroups[0]].point, a) ? 1 : 0;
+    size_t jLast = nGroups > jFirst && vector_eq(hits[iGroups[nGroups - 1]].point, b) ? nGroups - 1 : nGroups;
+
+    // Split from the far end, so the original halfedge keeps its start and each split follows it
+    for (size_t j = jLast; j-- > jFirst; )
+    {
+        split_edge(mesh, idHalfedge, hits[iGroups[j]].point);
+    }
+
+    // Pieces of the edge in order, piece k ends at interior group jFirst + k
+    std::vector<id_type> idPieces = {idHalfedge};
+    for (size_t j = jFirst; j < jLast; ++j)
+    {
+        idPieces.push_back(mesh.halfedge(idPieces.back()).next_id());
     }
-    else if (vector_eq(point, halfedge.next().attributes().position()))
+
+    // Add intersections for exterior halfedges directed away from face
+    // All points before a face lie on the same side of it as the edge start, and all points after on the same side as the edge end
+    for (size_t j = 0; j < nGroups; ++j)
     {
-        bool bExterior = to_halfspace(mesh.face(idFace)).exterior(halfedge.attributes().position());
-        if (bExterior)
+        for (size_t i = iGroups[j]; i < iGroups[j + 1]; ++i)
         {
-            intersections.emplace(idFace, halfedge.partner_id());
-        }
+            id_type idFace = hits[i].idFace;
+            auto halfspace = to_halfspace(mesh.face(idFace));
 
-        return;
+            if (j < jFirst)
+            {
+                if (halfspace.exterior(b))
+                {
+                    intersections.emplace(idFace, idPieces.front());
+                }
+            }
+            else if (j >= jLast)
+            {
+                const auto& halfedge = mesh.halfedge(idPieces.back());
+                if (!halfedge.border() && halfspace.exterior(a))
+                {
+                    intersections.emplace(idFace, halfedge.partner_id());
+                }
+            }
+            else
+            {
+                size_t k = j - jFirst + 1;
+                intersections.emplace(idFace, halfspace.exterior(a) ? mesh.halfedge(idPieces[k - 1]).partner_id() : idPieces[k]);
+            }
+        }
     }
 
-    id_type idHalfedge = halfedge.id();
-    split_intersection(mesh, idFace, idHalfedge, point, intersections);
-
-    halfedge_intersection(mesh, submesh, mesh.halfedge(idHalfedge).next(), intersections);
-    halfedge_intersection(mesh, submesh, mesh.halfedge(idHalfedge), intersections);
     return;
 }
 
 //------------------------------------------------------------------------------
 template<typename Traits>
-std::tuple<quetzal::id_type, typename Traits::point_type> quetzal::brep::face_intersection(const Submesh<Traits>& submesh, const Halfedge<Traits>& halfedge)
+std::vector<std::array<size_t, 2>> quetzal::brep::crossing_operands(const Mesh<Traits>& mesh, const std::vector<id_type>& idSubmeshes)
 {
-    geometry::Segment<typename Traits::vector_traits> segment = to_segment(halfedge);
+    size_t nOperands = idSubmeshes.size();
 
-    for (const auto& face : submesh.faces())
+    std::vector<size_t> iOperands(mesh.submesh_store_count(), nOperands);
+    std::vector<id_type> idFaces;
+    for (size_t i = 0; i < nOperands; ++i)
     {
-//if (idFace == 74)
-//{
-//    int j = 0;
-//}
+        iOperands[idSubmeshes[i]] = i;
+        const auto& ids = mesh.submesh(idSubmeshes[i]).face_ids();
+        idFaces.insert(idFaces.end(), ids.begin(), ids.end());
+    }
 
-        geometry::Polygon<typename Traits::vector_traits> polygon = to_polygon(face);
-        geometry::Intersection<typename Traits::vector_traits> intersection = geometry::intersection(segment, polygon);
+    auto grid = internal::face_grid(mesh, idFaces);
 
-        if (intersection.locus() == geometry::Locus::Point)
+    // Each edge once, from its lower halfedge id
+    std::vector<id_type> idHalfedges;
+    for (const auto& halfedge : mesh.halfedge_store())
+    {
+        if (halfedge.deleted() || halfedge.face_id() == nullid || (!halfedge.border() && halfedge.partner_id() < halfedge.id()) || iOperands[halfedge.face().submesh_id()] == nOperands)
         {
-            return {face.id(), intersection.point()}; // return intersection? ...
+            continue;
         }
-        else if (intersection.locus() == geometry::Locus::Segment)
+
+        idHalfedges.push_back(halfedge.id());
+    }
+
+    // Operands crossed by each edge, each found once per edge
+    std::vector<std::vector<size_t>> crossed(idHalfedges.size());
+    std::vector<size_t> indices(idHalfedges.size());
+    std::iota(indices.begin(), indices.end(), size_t(0));
+
+    std::for_each(std::execution::par, indices.begin(), indices.end(), [&](size_t i)
+    {
+        const auto& halfedge = mesh.halfedge(idHalfedges[i]);
+        size_t iOperand = iOperands[halfedge.face().submesh_id()];
+        geometry::Segment<typename Traits::vector_traits> segment = to_segment(halfedge);
+
+        std::vector<id_type> idCandidates;
+        internal::grid_faces(grid, segment, idCandidates);
+        for (id_type idFace : idCandidates)
         {
-            // ...
-std::cout << "*** segment!" << std::endl;
-break;
+            size_t j = iOperands[mesh.face(idFace).submesh_id()];
+            if (j == iOperand || std::find(crossed[i].begin(), crossed[i].end(), j) != crossed[i].end())
+            {
+                continue;
+            }
+
+            if (geometry::intersection(segment, to_polygon(mesh.face(idFace))).locus() == geometry::Locus::Point)
+            {
+                crossed[i].push_back(j);
+            }
+        }
+    });
+
+    std::vector<std::array<size_t, 2>> pairs;
+    for (size_t i = 0; i < idHalfedges.size(); ++i)
+    {
+        size_t iOperand = iOperands[mesh.halfedge(idHalfedges[i]).face().submesh_id()];
+        for (size_t j : crossed[i])
+        {
+            pairs.push_back({std::min(iOperand, j), std::max(iOperand, j)});
         }
-        else if (intersection.locus() != geometry::Locus::Empty)
-std::cout << "*** other! " << intersection << std::endl;
     }
 
-    return {nullid, {}};
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+    return pairs;
 }
 
 //------------------------------------------------------------------------------
 template<typename Traits>
-void quetzal::brep::split_intersection(Mesh<Traits>& mesh, id_type idFaceA, id_type idHalfedgeB, typename Traits::point_type point, intersections_type& intersections)
+void quetzal::brep::triangulate_submesh(Mesh<Traits>& mesh, id_type idSubmesh)
 {
-    // if halfedgeB.attributes().position() == point, don't split, just use halfedgeB and prev ...
-    // if halfedgeB.next().attributes().position() == point, don't split, just use halfedgeB and next ...
-    // may need halfedge and next/prev both before and after point ...
+    // Copy, triangulation adds faces to the submesh
+    std::vector<id_type> idFaces(mesh.submesh(idSubmesh).face_ids().begin(), mesh.submesh(idSubmesh).face_ids().end());
 
-    split_edge(mesh, idHalfedgeB, point);
+    triangulation::Triangulator triangulator;
+
+    for (id_type idFace : idFaces)
+    {
+        const auto& face = mesh.face(idFace);
+        if (face.deleted() || (face.halfedge_count() == 3 && face.hole_count() == 0))
+        {
+            continue;
+        }
+
+        if (face.halfedge_count() == 4 && face.hole_count() == 0)
+        {
+            triangulate_face_quad(mesh, idFace);
+            continue;
+        }
+
+        triangulate_face_cdt(mesh, idFace, triangulator);
+    }
 
-    // Add intersections for exterior halfedges directed away from face
-    const auto& halfedgeB = mesh.halfedge(idHalfedgeB);
-    bool bExterior = to_halfspace(mesh.face(idFaceA)).exterior(halfedgeB.attributes().position());
-    intersections.emplace(idFaceA, bExterior ? halfedgeB.partner_id() : halfedgeB.next_id());
     return;
 }
 
+//------------------------------------------------------------------------------
+template<typename Traits>
+std::vector<quetzal::brep::FaceIntersection<Traits>> quetzal::brep::face_intersections(const Mesh<Traits>& mesh, id_type idSubmeshA, id_type idSubmeshB)
+{
+    using vector_traits = Traits::vector_traits;
+    using value_type = Traits::value_type;
+    using point_type = Traits::point_type;
+
+    auto vertices = [&mesh](id_type idFace) -> std::array<point_type, 3>
+    {
+        const auto& halfedge = mesh.face(idFace).halfedge();
+        assert(halfedge.face().halfedge_count() == 3);
+        return {halfedge.attributes().position(), halfedge.next().attributes().position(), halfedge.prev().attributes().position()};
+    };
+
+    auto bounds = [](const std::array<point_type, 3>& v) -> geometry::AxisAlignedBoundingBox<vector_traits>
+    {
+        return geometry::AxisAlignedBoundingBox<vector_traits>(min(min(v[0], v[1]), v[2]), max(max(v[0], v[1]), v[2]));
+    };
+
+    const auto& idsA = mesh.submesh(idSubmeshA).face_ids();
+    const auto& idsB = mesh.submesh(idSubmeshB).face_ids();
+    std::vector<id_type> idFacesA;
+    std::vector<id_type> idFacesB;
+    idFacesA.reserve(idsA.size());
+    idFacesB.reserve(idsB.size());
+    for (id_type id : idsA)
+    {
+        if (!mesh.face(id).deleted())
+        {
+            idFacesA.push_back(id);
+        }
+    }
+    for (id_type id : idsB)
+    {
+        if (!mesh.face(id).deleted())
+        {
+            idFacesB.push_back(id);
+        }
+    }
+
+    // Candidate pairs from the faces of B in the grid cells overlapping each face of A, then from bounds overlap
+    auto grid = internal::face_grid(mesh, idFacesB);
+    value_type sizeCell = grid.cell_size();
+
+    std::vector<std::vector<id_type>> candidates(idFacesA.size());
+    std::vector<size_t> indices(idFacesA.size());
+    std::iota(indices.begin(), indices.end(), size_t(0));
+
+    std::for_each(std::execution::par, indices.begin(), indices.end(), [&](size_t i)
+    {
+        auto boxA = bounds(vertices(idFacesA[i]));
+        auto cellLower = grid.cell(boxA.lower());
+        auto cellUpper = grid.cell(boxA.upper());
+
+        // Faces are entered at cell centers, so a query within a quarter cell of a center only visits that cell
+        std::vector<id_type> idFaces;
+        for (int64_t x = cellLower[0]; x <= cellUpper[0]; ++x)
+        {
+            for (int64_t y = cellLower[1]; y <= cellUpper[1]; ++y)
+            {
+                for (int64_t z = cellLower[2]; z <= cellUpper[2]; ++z)
+                {
+                    grid.query({(Traits::val(x) + Traits::val(0.5)) * sizeCell, (Traits::val(y) + Traits::val(0.5)) * sizeCell, (Traits::val(z) + Traits::val(0.5)) * sizeCell}, sizeCell / Traits::val(4), idFaces);
+                }
+            }
+        }
+
+        std::sort(idFaces.begin(), idFaces.end());
+        idFaces.erase(std::unique(idFaces.begin(), idFaces.end()), idFaces.end());
+        for (id_type idFaceB : idFaces)
+        {
+            if (boxA.overlaps(bounds(vertices(idFaceB))))
+            {
+                candidates[i].push_back(idFaceB);
+            }
+        }
+    });
+
+    std::vector<FaceIntersection<Traits>> pairs;
+    for (size_t i = 0; i < idFacesA.size(); ++i)
+    {
+        for (id_type idFaceB : candidates[i])
+        {
+            pairs.push_back({idFacesA[i], idFaceB, {}});
+        }
+    }
+
+    // Exact triangle pair tests
+    std::for_each(std::execution::par, pairs.begin(), pairs.end(), [&](FaceIntersection<Traits>& fi)
+    {
+        auto a = vertices(fi.idFaceA);
+        auto b = vertices(fi.idFaceB);
+        fi.intersection = geometry::triangle_intersection(a[0], a[1], a[2], b[0], b[1], b[2]);
+    });
+
+    pairs.erase(std::remove_if(pairs.begin(), pairs.end(), [](const FaceIntersection<Traits>& fi) { return fi.intersection.empty(); }), pairs.end());
+    return pairs;
+}
+
 //------------------------------------------------------------------------------
 template<typename Traits>
 std::vector<std::vector<quetzal::id_type>> quetzal::brep::order_intersections(const Mesh<Traits>& mesh, intersections_type& intersections)
@@ -494,7 +1061,6 @@ std::vector<std::vector<quetzal::id_type>> quetzal::brep::order_intersections(co
         }
 
         bool bReverse = false;
-std::cout << "bReverse: " << std::boolalpha << bReverse << std::endl;
 
         id_type idSubmesh = mesh.halfedge(idHalfedge).face().submesh_id();
 
@@ -505,6 +1071,14 @@ std::cout << "bReverse: " << std::boolalpha << bReverse << std::endl;
             assert(std::distance(ii.first, ii.second) > 0);
 
             std::vector<id_type> idsOrderedFace = order_face_halfedges(mesh, ii.first, ii.second);
+            if (idsOrderedFace.empty())
+            {
+                // Left as an empty set, which splittable rejects
+                idsOrdered.clear();
+                intersections.erase(ii.first, ii.second);
+                break;
+            }
+
             if (bReverse)
             {
                 idsOrdered.insert(idsOrdered.end(), idsOrderedFace.rbegin(), idsOrderedFace.rend());
@@ -570,7 +1144,6 @@ assert(iNext == i + 2);
 
         id_type idHalfedge0 = idHalfedges[i];
         id_type idHalfedge1 = idHalfedges[iNext % n];
-std::cout << "halfedges: " << i << ": " << idHalfedge0 << ", " << iNext << ": " <<  idHalfedge1 << std::endl;
         id_type idHalfedgeSplit = nullid;
 
 assert(mesh.halfedge(idHalfedge0).partner().next().face_id() == mesh.halfedge(idHalfedge1).face_id());
@@ -603,9 +1176,6 @@ check_split_face(mesh, idHalfedgeInner, idHalfedge1, nn);
                 idHalfedgeInterior = mesh.halfedge(idHalfedgeExterior).partner_id();
             }
 
-std::cout << mesh.halfedge(idHalfedgeSplit).id() << " | " << mesh.halfedge(idHalfedgeSplit).partner_id() << std::endl;
-std::cout << mesh.halfedge(idHalfedgeSplit).next_id() << " | " << mesh.halfedge(idHalfedgeSplit).next().partner_id() << std::endl;
-
             // also do this for edges that are already along the border ...
             // do this at each split above ...
             mesh.halfedge(idHalfedgeSplit).next().partner().set_border();
@@ -621,6 +1191,54 @@ std::cout << mesh.halfedge(idHalfedgeSplit).next_id() << " | " << mesh.halfedge(
     return {idHalfedgeInterior, idHalfedgeExterior};
 }
 
+//------------------------------------------------------------------------------
+template<typename Traits>
+bool quetzal::brep::splittable(const Mesh<Traits>& mesh, id_type idSubmesh, const std::vector<std::vector<id_type>>& idSets, bool bReverse)
+{
+    std::vector<id_type> idFaces;
+    for (const auto& idsOrdered : idSets)
+    {
+        std::vector<id_type> idHalfedges = idsOrdered;
+        if (bReverse)
+        {
+            std::reverse(idHalfedges.begin(), idHalfedges.end());
+        }
+
+        size_t n = idHalfedges.size();
+        if (n < 2 || n % 2 != 0)
+        {
+            return false;
+        }
+
+        // Crossings of idSubmesh edges at i0, i0 + 2, ...
+        size_t i0 = mesh.halfedge(idHalfedges[0]).face().submesh_id() == idSubmesh ? 0 : 1;
+        for (size_t i = 0; i < n; ++i)
+        {
+            bool bOwn = mesh.halfedge(idHalfedges[(i0 + i) % n]).face().submesh_id() == idSubmesh;
+            if (bOwn != (i % 2 == 0))
+            {
+                return false;
+            }
+        }
+
+        // split_submesh cuts the face across the edge of each crossing to the next crossing
+        for (size_t i = i0; i < i0 + n; i += 2)
+        {
+            const auto& halfedge0 = mesh.halfedge(idHalfedges[i % n]);
+            const auto& halfedge1 = mesh.halfedge(idHalfedges[(i + 2) % n]);
+            if (halfedge0.border() || halfedge0.partner().face_id() != halfedge1.face_id())
+            {
+                return false;
+            }
+
+            idFaces.push_back(halfedge1.face_id());
+        }
+    }
+
+    std::sort(idFaces.begin(), idFaces.end());
+    return std::adjacent_find(idFaces.begin(), idFaces.end()) == idFaces.end();
+}
+
 //------------------------------------------------------------------------------
 template<typename Traits>
 void quetzal::brep::connect_border_sections(Mesh<Traits>& mesh, id_type idHalfedgeA, id_type idHalfedgeB)
@@ -712,7 +1330,12 @@ id_type idHalfedge = nullid;
         }
     }
 
-    // infinite loop here in case where there are no submesh transitions ...
+    // No submesh transition, the curve closes within the face
+    if (idHalfedge == nullid)
+    {
+        return idsOrdered;
+    }
+
     idsOrdered.push_back(idHalfedge);
     while (far.contains(mesh.halfedge(idHalfedge).face_id()))
     {
@@ -829,4 +1452,220 @@ void quetzal::brep::dump_border(Mesh<Traits>& mesh, id_type idHalfedge)
     return;
 }
 
+//------------------------------------------------------------------------------
+template<typename Traits>
+quetzal::geometry::SpatialHash<typename Traits::vector_traits, quetzal::id_type> quetzal::brep::internal::face_grid(const Mesh<Traits>& mesh, const std::vector<id_type>& idFaces)
+{
+    using point_type = Traits::point_type;
+    using value_type = Traits::value_type;
+
+    // Outer boundary bounds of each face
+    std::vector<id_type> idFacesLive;
+    std::vector<point_type> lowers;
+    std::vector<point_type> uppers;
+    value_type sizeTotal = Traits::val(0);
+    for (id_type idFace : idFaces)
+    {
+        const auto& face = mesh.face(idFace);
+        if (face.deleted())
+        {
+            continue;
+        }
+
+        point_type lower = point_type::max();
+        point_type upper = point_type::min();
+        id_type idHalfedge = face.halfedge_id();
+        do
+        {
+            const auto& halfedge = mesh.halfedge(idHalfedge);
+            const point_type position = halfedge.attributes().position();
+            lower = min(lower, position);
+            upper = max(upper, position);
+            idHalfedge = halfedge.next_id();
+        } while (idHalfedge != face.halfedge_id());
+
+        idFacesLive.push_back(idFace);
+        lowers.push_back(lower);
+        uppers.push_back(upper);
+        sizeTotal += std::max({upper.x() - lower.x(), upper.y() - lower.y(), upper.z() - lower.z()});
+    }
+
+    value_type sizeCell = sizeTotal > Traits::val(0) ? sizeTotal / Traits::val(idFacesLive.size()) : Traits::val(1);
+
+    geometry::SpatialHash<typename Traits::vector_traits, id_type> grid(sizeCell);
+    for (size_t i = 0; i < idFacesLive.size(); ++i)
+    {
+        auto cellLower = grid.cell(lowers[i]);
+        auto cellUpper = grid.cell(uppers[i]);
+        for (int64_t x = cellLower[0]; x <= cellUpper[0]; ++x)
+        {
+            for (int64_t y = cellLower[1]; y <= cellUpper[1]; ++y)
+            {
+                for (int64_t z = cellLower[2]; z <= cellUpper[2]; ++z)
+                {
+                    grid.insert({(Traits::val(x) + Traits::val(0.5)) * sizeCell, (Traits::val(y) + Traits::val(0.5)) * sizeCell, (Traits::val(z) + Traits::val(0.5)) * sizeCell}, idFacesLive[i]);
+                }
+            }
+        }
+    }
+
+    return grid;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+void quetzal::brep::internal::grid_faces(const geometry::SpatialHash<Traits, id_type>& grid, const geometry::Segment<Traits>& segment, std::vector<id_type>& idFaces)
+{
+    using value_type = Traits::value_type;
+    using point_type = geometry::Point<Traits>;
+    using cell_type = typename geometry::SpatialHash<Traits, id_type>::cell_type;
+
+    // Samples at most a cell apart, every point of the segment is within half a cell of a sample on each axis,
+    // so the cells within half a cell of the samples include every cell the segment passes through
+    value_type sizeCell = grid.cell_size();
+    value_type sizeHalf = sizeCell / Traits::val(2);
+    size_t n = static_cast<size_t>(std::ceil(segment.length() / sizeCell));
+
+    std::vector<cell_type> cells;
+    for (size_t i = 0; i <= n; ++i)
+    {
+        const point_type point = segment.point(n > 0 ? Traits::val(i) / Traits::val(n) : Traits::val(0));
+        cell_type cellLower = grid.cell(point - point_type{sizeHalf, sizeHalf, sizeHalf});
+        cell_type cellUpper = grid.cell(point + point_type{sizeHalf, sizeHalf, sizeHalf});
+        for (int64_t x = cellLower[0]; x <= cellUpper[0]; ++x)
+        {
+            for (int64_t y = cellLower[1]; y <= cellUpper[1]; ++y)
+            {
+                for (int64_t z = cellLower[2]; z <= cellUpper[2]; ++z)
+                {
+                    cells.push_back({x, y, z});
+                }
+            }
+        }
+    }
+
+    std::sort(cells.begin(), cells.end());
+    cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+    // Faces are entered at cell centers, so a query within a quarter cell of a center only visits that cell
+    for (const cell_type& cell : cells)
+    {
+        grid.query({(Traits::val(cell[0]) + Traits::val(0.5)) * sizeCell, (Traits::val(cell[1]) + Traits::val(0.5)) * sizeCell, (Traits::val(cell[2]) + Traits::val(0.5)) * sizeCell}, sizeCell / Traits::val(4), idFaces);
+    }
+
+    std::sort(idFaces.begin(), idFaces.end());
+    idFaces.erase(std::unique(idFaces.begin(), idFaces.end()), idFaces.end());
+    return;
+}
+
+//------------------------------------------------------------------------------
+inline std::vector<std::vector<size_t>> quetzal::brep::internal::crossing_groups(size_t nOperands, const std::vector<std::array<size_t, 2>>& pairs)
+{
+    std::vector<std::vector<size_t>> neighbors(nOperands);
+    for (const auto& pair : pairs)
+    {
+        neighbors[pair[0]].push_back(pair[1]);
+        neighbors[pair[1]].push_back(pair[0]);
+    }
+
+    // Breadth first from the lowest operand not yet grouped, lower neighbors first
+    std::vector<std::vector<size_t>> groups;
+    std::vector<bool> bGrouped(nOperands, false);
+    for (size_t i = 0; i < nOperands; ++i)
+    {
+        if (bGrouped[i])
+        {
+            continue;
+        }
+
+        std::vector<size_t> group = {i};
+        bGrouped[i] = true;
+        for (size_t k = 0; k < group.size(); ++k)
+        {
+            std::sort(neighbors[group[k]].begin(), neighbors[group[k]].end());
+            for (size_t j : neighbors[group[k]])
+            {
+                if (!bGrouped[j])
+                {
+                    bGrouped[j] = true;
+                    group.push_back(j);
+                }
+            }
+        }
+
+        groups.push_back(std::move(group));
+    }
+
+    return groups;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+quetzal::geometry::AxisAlignedBoundingBox<typename Traits::vector_traits> quetzal::brep::internal::submesh_bounds(const Mesh<Traits>& mesh, id_type idSubmesh)
+{
+    using point_type = Traits::point_type;
+
+    point_type lower = point_type::max();
+    point_type upper = point_type::min();
+    for (id_type idFace : mesh.submesh(idSubmesh).face_ids())
+    {
+        const auto& face = mesh.face(idFace);
+        if (face.deleted())
+        {
+            continue;
+        }
+
+        id_type idHalfedge = face.halfedge_id();
+        do
+        {
+            const auto& halfedge = mesh.halfedge(idHalfedge);
+            const point_type position = halfedge.attributes().position();
+            lower = min(lower, position);
+            upper = max(upper, position);
+            idHalfedge = halfedge.next_id();
+        } while (idHalfedge != face.halfedge_id());
+    }
+
+    return {lower, upper};
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+typename Traits::point_type quetzal::brep::internal::submesh_point(const Mesh<Traits>& mesh, id_type idSubmesh)
+{
+    for (id_type idFace : mesh.submesh(idSubmesh).face_ids())
+    {
+        const auto& face = mesh.face(idFace);
+        if (!face.deleted())
+        {
+            return face.halfedge().attributes().position();
+        }
+    }
+
+    assert(false);
+    return {};
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+quetzal::id_type quetzal::brep::internal::union_group(Mesh<Traits>& mesh, const std::vector<id_type>& idSubmeshes, const std::vector<size_t>& group, BooleanMode mode)
+{
+    // Named after the first operand so that results of other groups are not combined with this one
+    id_type idResult = idSubmeshes[group.front()];
+    if (group.size() == 1)
+    {
+        // Surface names as boolean_operation would give them
+        std::string prefix = mesh.submesh(idResult).name() + "_";
+        mesh.rename_submesh_surfaces(idResult, [&prefix](const std::string& name) -> std::string { return prefix + name; });
+        return idResult;
+    }
+
+    for (size_t k = 1; k < group.size() && idResult != nullid; ++k)
+    {
+        idResult = boolean_union(mesh, idResult, idSubmeshes[group[k]], mesh.submesh(idResult).name(), mode);
+    }
+
+    return idResult;
+}
+
 #endif // QUETZAL_BREP_MESH_BOOLEAN_HPP
@@ -14,7 +14,12 @@
 #include "quetzal/geometry/Line.hpp"
 #include "quetzal/geometry/Polygon.hpp"
 #include "quetzal/geometry/intersect.hpp"
+#include <algorithm>
+#include <execution>
+#include <numeric>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace quetzal::brep
 {
@@ -22,6 +27,21 @@ namespace quetzal::brep
     template<typename M>
     void clip(M& mesh, const geometry::HalfSpace<typename M::vector_traits>& halfspace, const std::string& nameSurface = "clip");
 
+    // Clip to the intersection of halfspaces, a convex region
+    // Vertices are classified against all halfspaces at once, after which only faces with a vertex exterior to one of them are visited
+    // Each halfspace is applied in sequence to the faces remaining from the previous one and the caps it created
+    template<typename M>
+    void clip(M& mesh, std::span<const geometry::HalfSpace<typename M::vector_traits>> halfspaces, const std::string& nameSurface = "clip");
+
+namespace internal
+{
+
+    // Splits face where it crosses the halfspace plane and marks the exterior part, exterior vertices must already be marked
+    template<typename M>
+    void clip_face(M& mesh, id_type idFace, const geometry::HalfSpace<typename M::vector_traits>& halfspace);
+
+} // namespace internal
+
 } // namespace quetzal::brep
 
 //------------------------------------------------------------------------------
@@ -52,168 +72,299 @@ void quetzal::brep::clip(M& mesh, const geometry::HalfSpace<typename M::vector_t
     // Split intersecting faces
 
     id_type nFacesOrig = mesh.face_store_count();
-    for (size_t nFace = 0; nFace < nFacesOrig; ++nFace)
+    for (id_type idFace = 0; idFace < nFacesOrig; ++idFace)
     {
-        auto& face = mesh.face(nFace);
-        if (face.deleted())
+        if (!mesh.face(idFace).deleted())
         {
-            continue;
+            internal::clip_face(mesh, idFace, halfspace);
         }
+    }
 
-        bool bAllInterior = true;
-        bool bAllExterior = true;
-        for (const auto& halfedge : face.halfedges())
+    // Delete all vertices, edges, and faces that are exterior to the halfspace plane, store remaining border halfedges
+
+    // borderHalfedges[idHalfedge] = idSubmesh
+    BorderHalfedges borderHalfedges;
+
+    bool bInterior = true;
+    for (auto& face : mesh.faces())
+    {
+        if (face.marked() == bInterior)
         {
-            if (halfedge.vertex().marked())
+            for (auto& halfedge : face.halfedges())
             {
-                bAllInterior = false;
+                assert(halfedge.vertex().marked());
             }
-            else
+
+            mesh.delete_face(face.id());
+            continue;
+        }
+
+        for (auto& halfedge : face.halfedges())
+        {
+            assert(halfedge.vertex().marked() != bInterior);
+
+            if (halfedge.border() || halfedge.partner().vertex().marked() == bInterior)
             {
-                bAllExterior = false;
+                borderHalfedges.insert({halfedge.id(), face.submesh_id()});
+                halfedge.set_border();
             }
         }
+    }
+
+    if (borderHalfedges.empty()) // No intersection
+    {
+        return;
+    }
 
-        if (bAllInterior)
+    close_border(mesh, borderHalfedges, nameSurface, bInterior ? halfspace.plane().normal() : -halfspace.plane().normal());
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::clip(M& mesh, std::span<const geometry::HalfSpace<typename M::vector_traits>> halfspaces, const std::string& nameSurface)
+{
+    mesh.reset();
+
+    // Vertices interior to every halfspace, vertices in a halfspace plane are considered interior
+
+    std::vector<id_type> idVertices(mesh.vertex_store_count());
+    std::iota(idVertices.begin(), idVertices.end(), id_type(0));
+
+    std::vector<char> interior(mesh.vertex_store_count());
+    std::for_each(std::execution::par, idVertices.begin(), idVertices.end(), [&](id_type idVertex)
+    {
+        const auto& position = mesh.vertex_store()[idVertex].attributes().position();
+        interior[idVertex] = std::none_of(halfspaces.begin(), halfspaces.end(), [&](const auto& halfspace) { return halfspace.exterior(position); });
+    });
+
+    // Faces that may be clipped, all others are left untouched
+
+    const auto& halfedges = mesh.halfedge_store();
+    std::vector<id_type> idFaces;
+    for (id_type idFace = 0; idFace < mesh.face_store_count(); ++idFace)
+    {
+        const auto& face = mesh.face_store()[idFace];
+        if (face.deleted())
         {
             continue;
         }
-        if (bAllExterior)
+
+        id_type idHalfedge = face.halfedge_id();
+        do
         {
-            face.set_marked();
-            continue;
-        }
+            if (!interior[halfedges[idHalfedge].vertex_id()])
+            {
+                idFaces.push_back(idFace);
+                break;
+            }
 
-        id_type idHalfedgeTransitionOut = nullid;
-        id_type idHalfedgeTransitionIn = nullid;
+            idHalfedge = halfedges[idHalfedge].next_id();
+        } while (idHalfedge != face.halfedge_id());
+    }
 
-        for (const auto& halfedge : face.halfedges())
+    std::vector<id_type> idFacesInterior;
+    for (const auto& halfspace : halfspaces)
+    {
+        if (idFaces.empty())
         {
-            bool bMarked0 = halfedge.vertex().marked();
-            bool bMarked1 = halfedge.next().vertex().marked();
+            break;
+        }
 
-            if (bMarked0 && !bMarked1)
-            {
-                idHalfedgeTransitionIn = halfedge.id();
-            }
-            else if (!bMarked0 && bMarked1)
+        for (id_type idFace : idFaces)
+        {
+            mesh.face(idFace).set_marked(false);
+            for (const auto& halfedge : mesh.face(idFace).halfedges())
             {
-                idHalfedgeTransitionOut = halfedge.id();
+                halfedge.set_marked(false);
+                halfedge.vertex().set_marked(halfspace.exterior(halfedge.vertex().attributes().position()));
             }
         }
 
-        assert(idHalfedgeTransitionOut != nullid);
-        assert(idHalfedgeTransitionIn != nullid);
-
-        // Don't split if non-exterior point already intersects halfspace plane
-        if (!halfspace.boundary(mesh.halfedge(idHalfedgeTransitionIn).next().attributes().position()))
+        id_type nFacesOrig = mesh.face_store_count();
+        for (id_type idFace : idFaces)
         {
-            geometry::Line<typename M::vector_traits> line = to_line(mesh.halfedge(idHalfedgeTransitionIn));
-            geometry::Intersection<typename M::vector_traits> intersection = geometry::intersection(line, halfspace.plane());
-            assert(intersection.locus() == geometry::Locus::Point);
-            typename M::point_type position = intersection.point();
-            split_edge(mesh, idHalfedgeTransitionIn, position);
+            internal::clip_face(mesh, idFace, halfspace);
         }
-        else if (mesh.halfedge(idHalfedgeTransitionIn).next().id() == idHalfedgeTransitionOut)
+
+        for (id_type idFace = nFacesOrig; idFace < mesh.face_store_count(); ++idFace)
         {
-            // The only halfspace plane intersection is this vertex, so this is actually an exterior face, mark it as such
-            mesh.halfedge(idHalfedgeTransitionOut).vertex().set_marked();
-            face.set_marked();
-            continue;
+            idFaces.push_back(idFace);
         }
-        else if (halfspace.boundary(mesh.halfedge(idHalfedgeTransitionOut).attributes().position()))
-        {
-            // Both inward and outward transitioning halfedges intersect with the halfspace plane
-            // If all vertices between idHalfedgeTransitionIn and idHalfedgeTransitionOut are in halfspace plane or exterior, then this is an exterior face
 
-            bool bExterior = true;
-            for (id_type idHalfedge = mesh.halfedge(idHalfedgeTransitionIn).next().id(); idHalfedge != idHalfedgeTransitionOut; idHalfedge = mesh.halfedge(idHalfedge).next_id())
+        // Faces outside the working set are never marked, so a marked partner face is always one being deleted here
+
+        // borderHalfedges[idHalfedge] = idSubmesh
+        BorderHalfedges borderHalfedges;
+
+        idFacesInterior.clear();
+        for (id_type idFace : idFaces)
+        {
+            const auto& face = mesh.face(idFace);
+            if (!face.marked())
             {
-                bool bIncident = halfspace.boundary(mesh.halfedge(idHalfedge).attributes().position());
-                if (!mesh.halfedge(idHalfedge).marked() && !bIncident)
-                {
-                    bExterior = false;
-                    break;
-                }
+                idFacesInterior.push_back(idFace);
+                continue;
             }
 
-            if (bExterior)
+            for (const auto& halfedge : face.halfedges())
             {
-                for (id_type idHalfedge = mesh.halfedge(idHalfedgeTransitionIn).next().id(); idHalfedge != idHalfedgeTransitionOut; idHalfedge = mesh.halfedge(idHalfedge).next_id())
+                if (!halfedge.border() && !halfedge.partner().face().marked())
                 {
-                    mesh.halfedge(idHalfedge).vertex().set_marked();
+                    borderHalfedges.insert({halfedge.partner_id(), halfedge.partner().face().submesh_id()});
                 }
-
-                mesh.halfedge(idHalfedgeTransitionOut).vertex().set_marked();
-                face.set_marked();
-                continue;
             }
         }
 
-        idHalfedgeTransitionIn = mesh.halfedge(idHalfedgeTransitionIn).next_id(); // Adjust so vertex is on halfspace plane
-        assert(halfspace.boundary(mesh.halfedge(idHalfedgeTransitionIn).attributes().position()));
+        for (id_type idFace : idFaces)
+        {
+            if (mesh.face(idFace).marked())
+            {
+                mesh.delete_face(idFace);
+            }
+        }
 
-        assert(!mesh.halfedge(idHalfedgeTransitionIn).vertex().marked());
-        assert(!mesh.halfedge(idHalfedgeTransitionOut).vertex().marked());
+        // The caps of this halfspace are clipped by the halfspaces that follow
 
-        if (!halfspace.boundary(mesh.halfedge(idHalfedgeTransitionOut).attributes().position()))
+        if (!borderHalfedges.empty())
         {
-            geometry::Line<typename M::vector_traits> line = to_line(mesh.halfedge(idHalfedgeTransitionOut));
-            geometry::Intersection<typename M::vector_traits> intersection = geometry::intersection(line, halfspace.plane());
-            assert(intersection.locus() == geometry::Locus::Point);
-            typename M::point_type position = intersection.point();
-            split_edge(mesh, idHalfedgeTransitionOut, position);
+            nFacesOrig = mesh.face_store_count();
+            close_border(mesh, borderHalfedges, nameSurface, halfspace.plane().normal());
 
-            idHalfedgeTransitionOut = mesh.halfedge(idHalfedgeTransitionOut).next_id(); // Adjust so vertex is on halfspace plane
+            for (id_type idFace = nFacesOrig; idFace < mesh.face_store_count(); ++idFace)
+            {
+                idFacesInterior.push_back(idFace);
+            }
         }
 
-        mesh.halfedge(idHalfedgeTransitionOut).vertex().set_marked();
+        std::swap(idFaces, idFacesInterior);
+    }
 
-        assert(halfspace.boundary(mesh.halfedge(idHalfedgeTransitionOut).attributes().position()));
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::internal::clip_face(M& mesh, id_type idFace, const geometry::HalfSpace<typename M::vector_traits>& halfspace)
+{
+    auto& face = mesh.face(idFace);
 
-        // Split face into interior and exterior faces
-        split_face(mesh, idHalfedgeTransitionIn, idHalfedgeTransitionOut);
-        mesh.halfedge(idHalfedgeTransitionOut).prev().vertex().set_marked();
-        mesh.halfedge(idHalfedgeTransitionOut).face().set_marked();
+    bool bAllInterior = true;
+    bool bAllExterior = true;
+    for (const auto& halfedge : face.halfedges())
+    {
+        if (halfedge.vertex().marked())
+        {
+            bAllInterior = false;
+        }
+        else
+        {
+            bAllExterior = false;
+        }
     }
 
-    // Delete all vertices, edges, and faces that are exterior to the halfspace plane, store remaining border halfedges
+    if (bAllInterior)
+    {
+        return;
+    }
+    if (bAllExterior)
+    {
+        face.set_marked();
+        return;
+    }
 
-    // borderHalfedges[idHalfedge] = idSubmesh
-    BorderHalfedges borderHalfedges;
+    id_type idHalfedgeTransitionOut = nullid;
+    id_type idHalfedgeTransitionIn = nullid;
 
-    bool bInterior = true;
-    for (auto& face : mesh.faces())
+    for (const auto& halfedge : face.halfedges())
     {
-        if (face.marked() == bInterior)
+        bool bMarked0 = halfedge.vertex().marked();
+        bool bMarked1 = halfedge.next().vertex().marked();
+
+        if (bMarked0 && !bMarked1)
         {
-            for (auto& halfedge : face.halfedges())
+            idHalfedgeTransitionIn = halfedge.id();
+        }
+        else if (!bMarked0 && bMarked1)
+        {
+            idHalfedgeTransitionOut = halfedge.id();
+        }
+    }
+
+    assert(idHalfedgeTransitionOut != nullid);
+    assert(idHalfedgeTransitionIn != nullid);
+
+    // Don't split if non-exterior point already intersects halfspace plane
+    if (!halfspace.boundary(mesh.halfedge(idHalfedgeTransitionIn).next().attributes().position()))
+    {
+        geometry::Line<typename M::vector_traits> line = to_line(mesh.halfedge(idHalfedgeTransitionIn));
+        geometry::Intersection<typename M::vector_traits> intersection = geometry::intersection(line, halfspace.plane());
+        assert(intersection.locus() == geometry::Locus::Point);
+        typename M::point_type position = intersection.point();
+        split_edge(mesh, idHalfedgeTransitionIn, position);
+    }
+    else if (mesh.halfedge(idHalfedgeTransitionIn).next().id() == idHalfedgeTransitionOut)
+    {
+        // The only halfspace plane intersection is this vertex, so this is actually an exterior face, mark it as such
+        mesh.halfedge(idHalfedgeTransitionOut).vertex().set_marked();
+        face.set_marked();
+        return;
+    }
+    else if (halfspace.boundary(mesh.halfedge(idHalfedgeTransitionOut).attributes().position()))
+    {
+        // Both inward and outward transitioning halfedges intersect with the halfspace plane
+        // If all vertices between idHalfedgeTransitionIn and idHalfedgeTransitionOut are in halfspace plane or exterior, then this is an exterior face
+
+        bool bExterior = true;
+        for (id_type idHalfedge = mesh.halfedge(idHalfedgeTransitionIn).next().id(); idHalfedge != idHalfedgeTransitionOut; idHalfedge = mesh.halfedge(idHalfedge).next_id())
+        {
+            bool bIncident = halfspace.boundary(mesh.halfedge(idHalfedge).attributes().position());
+            if (!mesh.halfedge(idHalfedge).marked() && !bIncident)
             {
-                assert(halfedge.vertex().marked());
+                bExterior = false;
+                break;
             }
-
-            mesh.delete_face(face.id());
-            continue;
         }
 
-        for (auto& halfedge : face.halfedges())
+        if (bExterior)
         {
-            assert(halfedge.vertex().marked() != bInterior);
-
-            if (halfedge.border() || halfedge.partner().vertex().marked() == bInterior)
+            for (id_type idHalfedge = mesh.halfedge(idHalfedgeTransitionIn).next().id(); idHalfedge != idHalfedgeTransitionOut; idHalfedge = mesh.halfedge(idHalfedge).next_id())
             {
-                borderHalfedges.insert({halfedge.id(), face.submesh_id()});
-                halfedge.set_border();
+                mesh.halfedge(idHalfedge).vertex().set_marked();
             }
+
+            mesh.halfedge(idHalfedgeTransitionOut).vertex().set_marked();
+            face.set_marked();
+            return;
         }
     }
 
-    if (borderHalfedges.empty()) // No intersection
+    idHalfedgeTransitionIn = mesh.halfedge(idHalfedgeTransitionIn).next_id(); // Adjust so vertex is on halfspace plane
+    assert(halfspace.boundary(mesh.halfedge(idHalfedgeTransitionIn).attributes().position()));
+
+    assert(!mesh.halfedge(idHalfedgeTransitionIn).vertex().marked());
+    assert(!mesh.halfedge(idHalfedgeTransitionOut).vertex().marked());
+
+    if (!halfspace.boundary(mesh.halfedge(idHalfedgeTransitionOut).attributes().position()))
     {
-        return;
+        geometry::Line<typename M::vector_traits> line = to_line(mesh.halfedge(idHalfedgeTransitionOut));
+        geometry::Intersection<typename M::vector_traits> intersection = geometry::intersection(line, halfspace.plane());
+        assert(intersection.locus() == geometry::Locus::Point);
+        typename M::point_type position = intersection.point();
+        split_edge(mesh, idHalfedgeTransitionOut, position);
+
+        idHalfedgeTransitionOut = mesh.halfedge(idHalfedgeTransitionOut).next_id(); // Adjust so vertex is on halfspace plane
     }
 
-    close_border(mesh, borderHalfedges, nameSurface, bInterior ? halfspace.plane().normal() : -halfspace.plane().normal());
+    mesh.halfedge(idHalfedgeTransitionOut).vertex().set_marked();
+
+    assert(halfspace.boundary(mesh.halfedge(idHalfedgeTransitionOut).attributes().position()));
+
+    // Split face into interior and exterior faces
+    split_face(mesh, idHalfedgeTransitionIn, idHalfedgeTransitionOut);
+    mesh.halfedge(idHalfedgeTransitionOut).prev().vertex().set_marked();
+    mesh.halfedge(idHalfedgeTransitionOut).face().set_marked();
+
     return;
 }
 
@@ -0,0 +1,229 @@
+#if !defined(QUETZAL_BREP_MESH_COMPONENTS_HPP)
+#define QUETZAL_BREP_MESH_COMPONENTS_HPP
+//------------------------------------------------------------------------------
+// brep
+// mesh_components.hpp
+//------------------------------------------------------------------------------
+
+#include "id.hpp"
+#include "quetzal/common/Properties.hpp"
+#include <algorithm>
+#include <atomic>
+#include <execution>
+#include <map>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+namespace quetzal::brep
+{
+
+    // Faces are connected through partner halfedges, read only, the mesh is not reset or marked
+    // Component ids are dense and ordered by the lowest face id in each component, deleted faces have component nullid
+    // Returns the number of components
+    template<typename M>
+    size_t face_components(const M& mesh, std::vector<id_type>& idComponents);
+
+    // Move each connected component to its own submesh, returns the submesh id of each component as numbered by face_components
+    // The component containing the lowest face id of a submesh keeps that submesh, other components get new submeshes named <submesh name>_<n>
+    // Faces keep the name, attributes, and properties of their surface, and are moved in one batch per destination surface
+    template<typename M>
+    std::vector<id_type> partition_components(M& mesh);
+
+namespace internal
+{
+
+    // Lock free union find, roots are the lowest id in their set
+    id_type find_root(std::vector<std::atomic<id_type>>& parents, id_type id);
+    void unite_roots(std::vector<std::atomic<id_type>>& parents, id_type idA, id_type idB);
+
+} // namespace internal
+
+} // namespace quetzal::brep
+
+//------------------------------------------------------------------------------
+template<typename M>
+size_t quetzal::brep::face_components(const M& mesh, std::vector<id_type>& idComponents)
+{
+    size_t nFaces = mesh.face_store_count();
+    std::vector<std::atomic<id_type>> parents(nFaces);
+    for (id_type id = 0; id < nFaces; ++id)
+    {
+        parents[id].store(id, std::memory_order_relaxed);
+    }
+
+    std::vector<id_type> idHalfedges(mesh.halfedge_store_count());
+    std::iota(idHalfedges.begin(), idHalfedges.end(), id_type(0));
+
+    // Each partner link is visited once, from its lower id
+    std::for_each(std::execution::par, idHalfedges.begin(), idHalfedges.end(), [&](id_type idHalfedge)
+    {
+        const auto& halfedge = mesh.halfedge_store()[idHalfedge];
+        if (halfedge.deleted() || halfedge.border() || halfedge.partner_id() < idHalfedge)
+        {
+            return;
+        }
+
+        internal::unite_roots(parents, halfedge.face_id(), halfedge.partner().face_id());
+    });
+
+    // Roots are the lowest id in their component, so they are labeled before any other face of it
+    idComponents.assign(nFaces, nullid);
+    size_t nComponents = 0;
+    for (id_type idFace = 0; idFace < nFaces; ++idFace)
+    {
+        if (mesh.face_store()[idFace].deleted())
+        {
+            continue;
+        }
+
+        id_type idRoot = internal::find_root(parents, idFace);
+        idComponents[idFace] = idRoot == idFace ? nComponents++ : idComponents[idRoot];
+    }
+
+    return nComponents;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+std::vector<quetzal::id_type> quetzal::brep::partition_components(M& mesh)
+{
+    std::vector<id_type> idComponents;
+    size_t nComponents = face_components(mesh, idComponents);
+
+    // Assign submeshes in face order, so the first component seen in each submesh keeps it
+
+    std::vector<id_type> idSubmeshes(nComponents, nullid);
+    std::vector<bool> bClaimed(mesh.submesh_store_count(), false);
+    std::vector<size_t> nSuffixes(mesh.submesh_store_count(), 1);
+    for (id_type idFace = 0; idFace < idComponents.size(); ++idFace)
+    {
+        id_type idComponent = idComponents[idFace];
+        if (idComponent == nullid || idSubmeshes[idComponent] != nullid)
+        {
+            continue;
+        }
+
+        id_type idSubmesh = mesh.face(idFace).submesh_id();
+        assert(idSubmesh != nullid);
+
+        if (!bClaimed[idSubmesh])
+        {
+            bClaimed[idSubmesh] = true;
+            idSubmeshes[idComponent] = idSubmesh;
+            continue;
+        }
+
+        // Copied since creating a submesh can reallocate the store
+        std::string nameOrig = mesh.submesh(idSubmesh).name();
+        auto attributes = mesh.submesh(idSubmesh).attributes();
+        Properties properties = mesh.submesh(idSubmesh).properties();
+
+        std::string name;
+        do
+        {
+            name = nameOrig + "_" + std::to_string(nSuffixes[idSubmesh]++);
+        } while (mesh.submesh_id(name) != nullid);
+
+        idSubmeshes[idComponent] = mesh.create_submesh(name, attributes, properties);
+    }
+
+    // Group faces that change submesh by destination submesh and original surface
+    // Surface details are copied before any faces move, since moving can delete emptied surfaces
+
+    struct Batch
+    {
+        std::string name;
+        typename M::surface_attributes_type attributes;
+        Properties properties;
+        std::vector<id_type> idFaces;
+    };
+
+    std::map<std::pair<id_type, id_type>, Batch> batches;
+    for (id_type idFace = 0; idFace < idComponents.size(); ++idFace)
+    {
+        id_type idComponent = idComponents[idFace];
+        if (idComponent == nullid)
+        {
+            continue;
+        }
+
+        const auto& face = mesh.face(idFace);
+        id_type idSubmesh = idSubmeshes[idComponent];
+        if (face.submesh_id() == idSubmesh)
+        {
+            continue;
+        }
+
+        auto [i, bInserted] = batches.try_emplace({idSubmesh, face.surface_id()});
+        if (bInserted)
+        {
+            i->second.name = face.surface().name();
+            i->second.attributes = face.surface().attributes();
+            i->second.properties = face.surface().properties();
+        }
+
+        i->second.idFaces.push_back(idFace);
+    }
+
+    // Destination surfaces are looked up per batch, since an earlier batch may have emptied and deleted one
+    // Destination submeshes are never emptied, each keeps the lowest face of its component
+
+    for (const auto& [ids, batch] : batches)
+    {
+        id_type idSurface = mesh.get_surface_id(ids.first, batch.name, batch.attributes, batch.properties);
+        mesh.move_faces(batch.idFaces, idSurface);
+    }
+
+    return idSubmeshes;
+}
+
+//------------------------------------------------------------------------------
+inline quetzal::id_type quetzal::brep::internal::find_root(std::vector<std::atomic<id_type>>& parents, id_type id)
+{
+    // Path halving, a failed exchange only means another thread already shortened the path
+    id_type idParent = parents[id].load(std::memory_order_relaxed);
+    while (idParent != id)
+    {
+        id_type idGrandparent = parents[idParent].load(std::memory_order_relaxed);
+        if (idGrandparent != idParent)
+        {
+            parents[id].compare_exchange_weak(idParent, idGrandparent, std::memory_order_relaxed);
+        }
+
+        id = idGrandparent;
+        idParent = parents[id].load(std::memory_order_relaxed);
+    }
+
+    return id;
+}
+
+//------------------------------------------------------------------------------
+inline void quetzal::brep::internal::unite_roots(std::vector<std::atomic<id_type>>& parents, id_type idA, id_type idB)
+{
+    for (;;)
+    {
+        idA = find_root(parents, idA);
+        idB = find_root(parents, idB);
+        if (idA == idB)
+        {
+            return;
+        }
+
+        // Link the higher root under the lower, retrying if the higher root was linked elsewhere meanwhile
+        if (idA < idB)
+        {
+            std::swap(idA, idB);
+        }
+
+        id_type idExpected = idA;
+        if (parents[idA].compare_exchange_strong(idExpected, idB, std::memory_order_acq_rel))
+        {
+            return;
+        }
+    }
+}
+
+#endif // QUETZAL_BREP_MESH_COMPONENTS_HPP
@@ -8,15 +8,34 @@
 #include "mesh_geometry.hpp"
 #include "mesh_texcoord.hpp"
 #include "quetzal/common/string_util.hpp"
-#include <map>
+#include "quetzal/geometry/SpatialHash.hpp"
+#include <algorithm>
+#include <array>
+#include <span>
+#include <vector>
 
 namespace quetzal::brep
 {
 
+    // Faces left in place by weld
+    struct WeldResult
+    {
+        size_t nFaces = 0; // Face pairs welded
+        std::vector<id_type> idFacesA; // Faces of surface A with no face of surface B within epsilon
+        std::vector<id_type> idFacesB; // Faces of surface B with no face of surface A within epsilon
+        std::vector<std::array<id_type, 2>> idFacesMismatched; // Faces matched by centroid whose halfedges do not correspond
+    };
+
     // Connect bodies A and B at coincident matching surfaces
     // Remove the original surfaces and their faces
+    // Faces are matched by centroid through a spatial hash with cell size epsilon and halfedges by position within epsilon, expected O(n)
+    // Vertices of B are snapped to the positions of A, unmatched faces are left in place and reported
     template<typename M>
-    void weld(M& mesh, const std::string& nameSurfaceA, const std::string& nameSurfaceB);
+    WeldResult weld(M& mesh, const std::string& nameSurfaceA, const std::string& nameSurfaceB, typename M::value_type epsilon = typename M::value_type(1.0e-5));
+
+    // Weld each pair of surfaces, as above
+    template<typename M>
+    WeldResult weld(M& mesh, std::span<const std::array<std::string, 2>> nameSurfaces, typename M::value_type epsilon = typename M::value_type(1.0e-5));
 
     // Connect bodies A and B at coincident matching (partner) faces
     // Corresponding face halfedge partners will form new pairs
@@ -35,34 +54,141 @@ namespace quetzal::brep
     template<typename M>
     void attach(M& mesh, id_type idFaceA, id_type idFaceB, bool bSurfacesDistinct = false);
 
+    // Snap vertex positions within epsilon of an earlier vertex to that vertex position, returns the number of vertices moved
+    template<typename M>
+    size_t merge_coincident_vertices(M& mesh, typename M::value_type epsilon);
+
+    // Link border halfedges whose endpoints coincide within epsilon with those of a reversed border halfedge, returns the number of pairs linked
+    template<typename M>
+    size_t link_coincident_halfedges(M& mesh, typename M::value_type epsilon);
+
+    // Connect separately built bodies along coincident borders, merge_coincident_vertices followed by link_coincident_halfedges
+    // Both passes use a spatial hash with cell size epsilon, expected O(n)
+    template<typename M>
+    size_t weld_coincident(M& mesh, typename M::value_type epsilon);
+
+namespace internal
+{
+
+    // Faces of surface A are matched against indexB, which holds the faces of surface B, and the result accumulated
+    template<typename M>
+    void weld_surfaces(M& mesh, const std::string& nameSurfaceA, const std::string& nameSurfaceB, typename M::value_type epsilon, geometry::SpatialHash<typename M::vector_traits, id_type>& indexB, WeldResult& result);
+
+    // Weld the faces of partner halfedges A and B
+    template<typename M>
+    void weld_halfedges(M& mesh, id_type idHalfedgeA, id_type idHalfedgeB);
+
+} // namespace internal
+
 } // namespace quetzal::brep
 
 //------------------------------------------------------------------------------
 template<typename M>
-void quetzal::brep::weld(M& mesh, const std::string& nameSurfaceA, const std::string& nameSurfaceB)
+quetzal::brep::WeldResult quetzal::brep::weld(M& mesh, const std::string& nameSurfaceA, const std::string& nameSurfaceB, typename M::value_type epsilon)
 {
-    auto& surfaceA = mesh.surface(nameSurfaceA);
-    auto& surfaceB = mesh.surface(nameSurfaceB);
-    assert(surfaceA.face_count() == surfaceB.face_count());
+    WeldResult result;
+    geometry::SpatialHash<typename M::vector_traits, id_type> indexB(epsilon);
+    internal::weld_surfaces(mesh, nameSurfaceA, nameSurfaceB, epsilon, indexB, result);
+    return result;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+quetzal::brep::WeldResult quetzal::brep::weld(M& mesh, std::span<const std::array<std::string, 2>> nameSurfaces, typename M::value_type epsilon)
+{
+    WeldResult result;
+    geometry::SpatialHash<typename M::vector_traits, id_type> indexB(epsilon);
+    for (const auto& names : nameSurfaces)
+    {
+        internal::weld_surfaces(mesh, names[0], names[1], epsilon, indexB, result);
+    }
 
-    auto sort_faces = [&mesh](const typename M::surface_type& surface) -> std::map<typename M::point_type, id_type>
-    { 
-        std::map<typename M::point_type, id_type> index;
-        for (const auto& face : surface.faces())
+    return result;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::weld(M& mesh, id_type idFaceA, id_type idFaceB)
+{
+    auto [idHalfedgeA, idHalfedgeB] = find_partner_halfedges(mesh, idFaceA, idFaceB);
+    assert(idHalfedgeA != nullid);
+    assert(idHalfedgeB != nullid);
+
+    internal::weld_halfedges(mesh, idHalfedgeA, idHalfedgeB);
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::internal::weld_surfaces(M& mesh, const std::string& nameSurfaceA, const std::string& nameSurfaceB, typename M::value_type epsilon, geometry::SpatialHash<typename M::vector_traits, id_type>& indexB, WeldResult& result)
+{
+    // Copied since welding removes faces from the surfaces
+    const auto& idSurfaceFacesA = mesh.surface(nameSurfaceA).face_ids();
+    const auto& idSurfaceFacesB = mesh.surface(nameSurfaceB).face_ids();
+    std::vector<id_type> idFacesA(idSurfaceFacesA.begin(), idSurfaceFacesA.end());
+    std::vector<id_type> idFacesB(idSurfaceFacesB.begin(), idSurfaceFacesB.end());
+
+    indexB.clear();
+    indexB.reserve(idFacesB.size());
+    for (id_type idFaceB : idFacesB)
+    {
+        indexB.insert(centroid(mesh.face(idFaceB)), idFaceB);
+    }
+
+    size_t nMismatched = result.idFacesMismatched.size();
+    for (id_type idFaceA : idFacesA)
+    {
+        typename M::point_type centroidA = centroid(mesh.face(idFaceA));
+        id_type idFaceB = indexB.nearest(centroidA, epsilon, nullid);
+        if (idFaceB == nullid)
         {
-            index[centroid(face)] = face.id();
+            result.idFacesA.push_back(idFaceA);
+            continue;
         }
-        return index;
-    };
 
-    auto indexFacesA = sort_faces(surfaceA);
-    auto indexFacesB = sort_faces(surfaceB);
-    assert(indexFacesA.size() == indexFacesB.size());
+        indexB.remove(centroid(mesh.face(idFaceB)), idFaceB);
+
+        auto [idHalfedgeA, idHalfedgeB] = find_partner_halfedges(mesh, idFaceA, idFaceB, epsilon);
+        if (idHalfedgeA == nullid)
+        {
+            result.idFacesMismatched.push_back({idFaceA, idFaceB});
+            continue;
+        }
+
+        // Snap every corner of each B vertex so that partner positions agree exactly once welded
+        id_type idA = idHalfedgeA;
+        id_type idB = idHalfedgeB;
+        do
+        {
+            const typename M::point_type& position = mesh.halfedge(mesh.halfedge(idA).next_id()).attributes().position();
+            if (mesh.halfedge(idB).attributes().position() != position)
+            {
+                for (auto& halfedge : mesh.halfedge(idB).vertex().halfedges())
+                {
+                    halfedge.attributes().set_position(position);
+                }
+            }
 
-    for (auto iA = indexFacesA.begin(), iB = indexFacesB.begin(); iA != indexFacesA.end(); ++iA, ++iB)
+            idA = mesh.halfedge(idA).next_id();
+            idB = mesh.halfedge(idB).prev_id();
+        } while (idA != idHalfedgeA);
+
+        weld_halfedges(mesh, idHalfedgeA, idHalfedgeB);
+        ++result.nFaces;
+    }
+
+    for (id_type idFaceB : idFacesB)
     {
-        assert(vector_eq(iA->first, iB->first));
-        weld(mesh, iA->second, iB->second);
+        if (mesh.face(idFaceB).deleted())
+        {
+            continue;
+        }
+
+        auto i = std::find_if(result.idFacesMismatched.begin() + nMismatched, result.idFacesMismatched.end(), [idFaceB](const auto& ids) { return ids[1] == idFaceB; });
+        if (i == result.idFacesMismatched.end())
+        {
+            result.idFacesB.push_back(idFaceB);
+        }
     }
 
     return;
@@ -70,9 +196,8 @@ void quetzal::brep::weld(M& mesh, const std::string& nameSurfaceA, const std::st
 
 //------------------------------------------------------------------------------
 template<typename M>
-void quetzal::brep::weld(M& mesh, id_type idFaceA, id_type idFaceB)
+void quetzal::brep::internal::weld_halfedges(M& mesh, id_type idHalfedgeA, id_type idHalfedgeB)
 {
-    auto [idHalfedgeA, idHalfedgeB] = find_partner_halfedges(mesh, idFaceA, idFaceB);
     assert(idHalfedgeA != nullid);
     assert(idHalfedgeB != nullid);
     assert(!mesh.halfedge(idHalfedgeA).deleted());
@@ -82,8 +207,6 @@ void quetzal::brep::weld(M& mesh, id_type idFaceA, id_type idFaceB)
     auto& faceB = mesh.halfedge(idHalfedgeB).face();
     assert(!faceA.deleted());
     assert(!faceB.deleted());
-    assert(faceA.id() == idFaceA);
-    assert(faceB.id() == idFaceB);
     assert(faceA.halfedge_count() == faceB.halfedge_count());
 
     for (auto& halfedgeA : faceA.halfedges())
@@ -199,4 +322,95 @@ void quetzal::brep::attach(M& mesh, id_type idFaceA, id_type idFaceB, bool bSurf
     return;
 }
 
+//------------------------------------------------------------------------------
+template<typename M>
+size_t quetzal::brep::merge_coincident_vertices(M& mesh, typename M::value_type epsilon)
+{
+    geometry::SpatialHash<typename M::vector_traits, id_type> index(epsilon);
+    index.reserve(mesh.vertex_store_count());
+
+    size_t n = 0;
+    for (auto& vertex : mesh.vertices())
+    {
+        const typename M::point_type& position = vertex.attributes().position();
+        id_type idVertex = index.nearest(position, epsilon, nullid);
+        if (idVertex == nullid)
+        {
+            index.insert(position, vertex.id());
+        }
+        else if (mesh.vertex(idVertex).attributes().position() != position)
+        {
+            vertex.attributes().set_position(mesh.vertex(idVertex).attributes().position());
+            ++n;
+        }
+    }
+
+    return n;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+size_t quetzal::brep::link_coincident_halfedges(M& mesh, typename M::value_type epsilon)
+{
+    // Border halfedges indexed by their initial vertex position
+    geometry::SpatialHash<typename M::vector_traits, id_type> index(epsilon);
+
+    for (const auto& halfedge : mesh.halfedges())
+    {
+        if (halfedge.border())
+        {
+            index.insert(halfedge.attributes().position(), halfedge.id());
+        }
+    }
+
+    size_t n = 0;
+    for (auto& halfedge : mesh.halfedges())
+    {
+        if (!halfedge.border())
+        {
+            continue;
+        }
+
+        const typename M::point_type& position = halfedge.attributes().position();
+        const typename M::point_type& positionNext = halfedge.next().attributes().position();
+
+        // Partner candidate starts at this halfedge's end and ends at this halfedge's start
+        id_type idPartner = nullid;
+        index.visit(positionNext, epsilon, [&](const auto& entry) -> bool
+        {
+            const auto& candidate = mesh.halfedge(entry.value);
+            if (entry.value != halfedge.id() && candidate.border() && candidate.face_id() != halfedge.face_id()
+                && geometry::SpatialHash<typename M::vector_traits, id_type>::within(candidate.next().attributes().position(), position, epsilon))
+            {
+                idPartner = entry.value;
+                return false;
+            }
+
+            return true;
+        });
+
+        if (idPartner == nullid)
+        {
+            continue;
+        }
+
+        index.remove(position, halfedge.id());
+        index.remove(mesh.halfedge(idPartner).attributes().position(), idPartner);
+
+        halfedge.set_partner_id(idPartner);
+        mesh.halfedge(idPartner).set_partner_id(halfedge.id());
+        ++n;
+    }
+
+    return n;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+size_t quetzal::brep::weld_coincident(M& mesh, typename M::value_type epsilon)
+{
+    merge_coincident_vertices(mesh, epsilon);
+    return link_coincident_halfedges(mesh, epsilon);
+}
+
 #endif // QUETZAL_BREP_MESH_CONNECTION_HPP
@@ -0,0 +1,1082 @@
+#if !defined(QUETZAL_BREP_MESH_DECIMATION_HPP)
+#define QUETZAL_BREP_MESH_DECIMATION_HPP
+//------------------------------------------------------------------------------
+// brep
+// mesh_decimation.hpp
+//------------------------------------------------------------------------------
+
+#include "id.hpp"
+#include "quetzal/geometry/Attributes.hpp"
+#include "quetzal/math/floating_point.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <execution>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <vector>
+#include <cassert>
+
+namespace quetzal::brep
+{
+
+    //--------------------------------------------------------------------------
+    // Quadric error metric edge collapse, after Garland and Heckbert
+    // Points are the corners sharing a position, each point accumulates the area weighted planes of its faces
+    // Feature edges are surface borders, seams between surfaces, and edges across which corner normals or texcoords differ
+    // Feature points lie on exactly two feature edges and only collapse along them, onto the other end, points on more are kept
+    // Only edges between triangles collapse, points on faces that are not triangles or have holes are kept
+    // Seams are not told apart by whether only normals differ across them, so a faceted mesh with a surface per face, such as a faceted geodesic sphere, has every point fixed and is left unchanged
+    // Collapses are taken cheapest first from a heap, entries are invalidated lazily by a per point stamp rather than removed
+    template<typename M>
+    class Decimator
+    {
+    public:
+
+        using mesh_type = M;
+        using value_type = M::value_type;
+        using point_type = M::point_type;
+        using vector_type = M::vector_type;
+        using vertex_attributes_type = M::vertex_attributes_type;
+
+        // weightFeature scales the planes through feature edges perpendicular to their faces, relative to face planes of the same extent
+        // A collapse is rejected if it would turn a face normal by more than acos(dotNormalMin)
+        explicit Decimator(value_type weightFeature = value_type(1), value_type dotNormalMin = value_type(0.25));
+        Decimator(const Decimator&) = default;
+        Decimator(Decimator&&) noexcept = default;
+        ~Decimator() = default;
+
+        Decimator& operator=(const Decimator&) = default;
+        Decimator& operator=(Decimator&&) = default;
+
+        // Collapse edges until the mesh has no more than nFaces faces or the next collapse would exceed errorMax
+        // Error is the RMS distance of the collapsed point from the planes accumulated by its points, weighted by area
+        // Corner attributes are interpolated along the collapsed edge, face normals of moved faces are recalculated
+        // Returns the number of edges collapsed
+        size_t decimate(M& mesh, size_t nFaces, value_type errorMax = std::numeric_limits<value_type>::max());
+
+    private:
+
+        enum class PointType
+        {
+            Interior,
+            Feature,
+            Fixed
+        };
+
+        // Symmetric 4x4 matrix as the upper triangle of the 3x3 part, the linear part, and the constant, with the total weight of its planes
+        struct Quadric
+        {
+            std::array<value_type, 10> q = {};
+            value_type weight = value_type(0);
+
+            void add_plane(const vector_type& normal, const point_type& point, value_type w);
+            Quadric& operator+=(const Quadric& other);
+            value_type evaluate(const point_type& point) const;
+            bool minimum(point_type& point) const;
+        };
+
+        // Collapse of the edge of idHalfedge, removing the point at its start if bRemoveStart, otherwise the point at its end
+        // t is the attribute interpolation parameter from the removed point to the kept one
+        // Between interior points both move to position, which may lie off the edge even when t is clamped to 0 or 1
+        struct Candidate
+        {
+            value_type cost;
+            id_type idHalfedge;
+            bool bRemoveStart;
+            bool bInterior;
+            value_type t;
+            point_type position;
+            unsigned int stampStart;
+            unsigned int stampEnd;
+
+            bool operator>(const Candidate& other) const;
+        };
+
+        // Calls f(idHalfedge) for each halfedge leaving the point at the start of idHalfedge
+        template<typename F>
+        static void for_each_outgoing(const M& mesh, id_type idHalfedge, F f);
+
+        static bool continuous(const vertex_attributes_type& a, const vertex_attributes_type& b);
+        static bool feature_edge(const M& mesh, id_type idHalfedge);
+
+        bool triangle(id_type idFace) const;
+        PointType point_type_of(const M& mesh, id_type idHalfedge) const;
+        void label_faces(const M& mesh);
+        void label_edges(const M& mesh);
+        void update_edges(const M& mesh, id_type idHalfedge);
+        void label_points(const M& mesh);
+        void initialize_points(const M& mesh);
+        bool evaluate(const M& mesh, id_type idHalfedge, Candidate& candidate) const;
+        void push_point(const M& mesh, id_type idHalfedge);
+        void neighbors(const M& mesh, id_type idHalfedge, std::vector<id_type>& idPoints) const;
+        bool collapsible(const M& mesh, const Candidate& candidate);
+        void collapse(M& mesh, const Candidate& candidate);
+        void delete_face(M& mesh, id_type idFace);
+
+        value_type m_weightFeature;
+        value_type m_dotNormalMin;
+
+        std::vector<char> m_bTriangles; // Per face, triangle without holes, collapses only ever delete triangles
+        std::vector<char> m_bFeatures; // Per halfedge, updated for the edges of the kept point in a collapse
+        std::vector<id_type> m_idPoints; // Point at the start of each halfedge
+        std::vector<Quadric> m_quadrics; // Per point
+        std::vector<PointType> m_types; // Per point, updated for the points whose edges change in a collapse
+        std::vector<unsigned int> m_stamps; // Per point, set to the next value of m_stamp whenever the point changes, so values are never reused
+        unsigned int m_stamp;
+        std::vector<bool> m_bMoved; // Per face, normal to be recalculated
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> m_candidates;
+        size_t m_nFaces;
+
+        // Scratch space reused across collapses
+        std::vector<id_type> m_idsRemoved;
+        std::vector<id_type> m_idsKept;
+        std::vector<id_type> m_idNeighborsRemoved;
+        std::vector<id_type> m_idNeighborsKept;
+        std::vector<id_type> m_idsSideA;
+    };
+
+    // Decimate with a temporary Decimator, returns the number of edges collapsed
+    template<typename M>
+    size_t decimate(M& mesh, size_t nFaces, typename M::value_type errorMax = std::numeric_limits<typename M::value_type>::max());
+
+} // namespace quetzal::brep
+
+//------------------------------------------------------------------------------
+template<typename M>
+quetzal::brep::Decimator<M>::Decimator(value_type weightFeature, value_type dotNormalMin) :
+    m_weightFeature(weightFeature),
+    m_dotNormalMin(dotNormalMin),
+    m_bTriangles(),
+    m_bFeatures(),
+    m_idPoints(),
+    m_quadrics(),
+    m_types(),
+    m_stamps(),
+    m_stamp(0),
+    m_bMoved(),
+    m_candidates(),
+    m_nFaces(0),
+    m_idsRemoved(),
+    m_idsKept(),
+    m_idNeighborsRemoved(),
+    m_idNeighborsKept(),
+    m_idsSideA()
+{
+    assert(weightFeature >= value_type(0));
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+size_t quetzal::brep::Decimator<M>::decimate(M& mesh, size_t nFaces, value_type errorMax)
+{
+    m_nFaces = mesh.face_count();
+    if (m_nFaces <= nFaces)
+    {
+        return 0;
+    }
+
+    label_faces(mesh);
+    label_edges(mesh);
+    label_points(mesh);
+    initialize_points(mesh);
+    m_bMoved.assign(mesh.face_store_count(), false);
+
+    // Edges are evaluated once each, from the lower halfedge id or the only one at a border
+
+    std::vector<id_type> idHalfedges(mesh.halfedge_store_count());
+    std::iota(idHalfedges.begin(), idHalfedges.end(), id_type(0));
+
+    std::vector<Candidate> candidates(idHalfedges.size());
+    std::vector<char> bCandidates(idHalfedges.size(), 0);
+    std::for_each(std::execution::par, idHalfedges.begin(), idHalfedges.end(), [&](id_type idHalfedge)
+    {
+        const auto& halfedge = mesh.halfedge_store()[idHalfedge];
+        if (halfedge.deleted() || (!halfedge.border() && halfedge.partner_id() < idHalfedge))
+        {
+            return;
+        }
+
+        bCandidates[idHalfedge] = evaluate(mesh, idHalfedge, candidates[idHalfedge]);
+    });
+
+    size_t n = 0;
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        if (bCandidates[i])
+        {
+            candidates[n++] = candidates[i];
+        }
+    }
+
+    candidates.resize(n);
+    m_candidates = decltype(m_candidates)(std::greater<Candidate>(), std::move(candidates));
+
+    value_type costMax = errorMax < std::sqrt(std::numeric_limits<value_type>::max()) ? errorMax * errorMax : std::numeric_limits<value_type>::max();
+
+    size_t nCollapses = 0;
+    while (m_nFaces > nFaces && !m_candidates.empty())
+    {
+        Candidate candidate = m_candidates.top();
+        m_candidates.pop();
+
+        const auto& halfedge = mesh.halfedge(candidate.idHalfedge);
+        if (halfedge.deleted()
+            || m_stamps[m_idPoints[candidate.idHalfedge]] != candidate.stampStart
+            || m_stamps[m_idPoints[halfedge.next_id()]] != candidate.stampEnd)
+        {
+            continue;
+        }
+
+        if (candidate.cost > costMax)
+        {
+            break;
+        }
+
+        if (!collapsible(mesh, candidate))
+        {
+            continue;
+        }
+
+        collapse(mesh, candidate);
+        ++nCollapses;
+    }
+
+    m_candidates = {};
+
+    if (nCollapses == 0)
+    {
+        return 0;
+    }
+
+    // Face normals of moved faces
+
+    std::vector<id_type> idFaces;
+    for (id_type idFace = 0; idFace < m_bMoved.size(); ++idFace)
+    {
+        if (m_bMoved[idFace] && !mesh.face(idFace).deleted())
+        {
+            idFaces.push_back(idFace);
+        }
+    }
+
+    std::for_each(std::execution::par, idFaces.begin(), idFaces.end(), [&](id_type idFace)
+    {
+        auto& face = mesh.face(idFace);
+        const auto& halfedge = face.halfedge();
+        vector_type normal = cross(halfedge.next().attributes().position() - halfedge.attributes().position(), halfedge.prev().attributes().position() - halfedge.attributes().position());
+        if (!vector_eq0(normal))
+        {
+            face.attributes().set_normal(normalize(normal));
+        }
+    });
+
+    // Deleted faces are removed from their surfaces and submeshes in one pass rather than per collapse
+    // Perimeters are regenerated on next use, surfaces emptied by collapses across their borders are deleted
+
+    for (auto& submesh : mesh.submeshes())
+    {
+        std::erase_if(submesh.face_ids(), [&](id_type idFace) { return mesh.face(idFace).deleted(); });
+    }
+
+    std::vector<id_type> idSurfacesEmpty;
+    for (auto& surface : mesh.surfaces())
+    {
+        std::erase_if(surface.face_ids(), [&](id_type idFace) { return mesh.face(idFace).deleted(); });
+        surface.set_regenerate_perimeters();
+        if (surface.empty())
+        {
+            idSurfacesEmpty.push_back(surface.id());
+        }
+    }
+
+    for (id_type idSurface : idSurfacesEmpty)
+    {
+        mesh.delete_surface(idSurface);
+    }
+
+    return nCollapses;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::Decimator<M>::Quadric::add_plane(const vector_type& normal, const point_type& point, value_type w)
+{
+    value_type d = -dot(normal, point);
+    q[0] += w * normal.x() * normal.x();
+    q[1] += w * normal.x() * normal.y();
+    q[2] += w * normal.x() * normal.z();
+    q[3] += w * normal.y() * normal.y();
+    q[4] += w * normal.y() * normal.z();
+    q[5] += w * normal.z() * normal.z();
+    q[6] += w * d * normal.x();
+    q[7] += w * d * normal.y();
+    q[8] += w * d * normal.z();
+    q[9] += w * d * d;
+    weight += w;
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+typename quetzal::brep::Decimator<M>::Quadric& quetzal::brep::Decimator<M>::Quadric::operator+=(const Quadric& other)
+{
+    for (size_t i = 0; i < q.size(); ++i)
+    {
+        q[i] += other.q[i];
+    }
+
+    weight += other.weight;
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+typename quetzal::brep::Decimator<M>::value_type quetzal::brep::Decimator<M>::Quadric::evaluate(const point_type& point) const
+{
+    value_type x = point.x();
+    value_type y = point.y();
+    value_type z = point.z();
+
+    value_type e = q[0] * x * x + q[3] * y * y + q[5] * z * z
+        + value_type(2) * (q[1] * x * y + q[2] * x * z + q[4] * y * z)
+        + value_type(2) * (q[6] * x + q[7] * y + q[8] * z)
+        + q[9];
+
+    // Normalized to a mean squared distance, roundoff can make it slightly negative
+    return weight > value_type(0) ? std::max(e / weight, value_type(0)) : value_type(0);
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+bool quetzal::brep::Decimator<M>::Quadric::minimum(point_type& point) const
+{
+    // Cramer's rule, planar and cylindrical neighborhoods are singular and fall back to the edge
+    value_type c0 = q[3] * q[5] - q[4] * q[4];
+    value_type c1 = q[2] * q[4] - q[1] * q[5];
+    value_type c2 = q[1] * q[4] - q[2] * q[3];
+    value_type det = q[0] * c0 + q[1] * c1 + q[2] * c2;
+
+    value_type trace = q[0] + q[3] + q[5];
+    if (std::abs(det) <= value_type(1.0e-9) * trace * trace * trace)
+    {
+        return false;
+    }
+
+    value_type bx = -q[6];
+    value_type by = -q[7];
+    value_type bz = -q[8];
+
+    value_type x = bx * c0 + by * c1 + bz * c2;
+    value_type y = bx * c1 + by * (q[0] * q[5] - q[2] * q[2]) + bz * (q[1] * q[2] - q[0] * q[4]);
+    value_type z = bx * c2 + by * (q[1] * q[2] - q[0] * q[4]) + bz * (q[0] * q[3] - q[1] * q[1]);
+
+    point = point_type(x / det, y / det, z / det);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+bool quetzal::brep::Decimator<M>::Candidate::operator>(const Candidate& other) const
+{
+    // Ties broken by id so that the order does not depend on the heap
+    return cost > other.cost || (cost == other.cost && idHalfedge > other.idHalfedge);
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+template<typename F>
+void quetzal::brep::Decimator<M>::for_each_outgoing(const M& mesh, id_type idHalfedge, F f)
+{
+    // Rotate one way until back at the start, or at a border, in which case rotate the other way from the start
+    id_type id = idHalfedge;
+    do
+    {
+        f(id);
+        const auto& prev = mesh.halfedge(mesh.halfedge(id).prev_id());
+        id = prev.border() ? nullid : prev.partner_id();
+    } while (id != nullid && id != idHalfedge);
+
+    if (id == nullid)
+    {
+        for (id = idHalfedge; !mesh.halfedge(id).border(); )
+        {
+            id = mesh.halfedge(mesh.halfedge(id).partner_id()).next_id();
+            f(id);
+        }
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+bool quetzal::brep::Decimator<M>::triangle(id_type idFace) const
+{
+    return m_bTriangles[idFace];
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+bool quetzal::brep::Decimator<M>::continuous(const vertex_attributes_type& a, const vertex_attributes_type& b)
+{
+    if constexpr (vertex_attributes_type::contains(geometry::AttributesFlags::Normal))
+    {
+        if (!vector_eq(a.normal(), b.normal()))
+        {
+            return false;
+        }
+    }
+
+    if constexpr (vertex_attributes_type::contains(geometry::AttributesFlags::Texcoord0))
+    {
+        if (!vector_eq(a.texcoord(), b.texcoord()))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+bool quetzal::brep::Decimator<M>::feature_edge(const M& mesh, id_type idHalfedge)
+{
+    const auto& halfedge = mesh.halfedge(idHalfedge);
+    if (halfedge.border())
+    {
+        return true;
+    }
+
+    const auto& partner = halfedge.partner();
+    if (halfedge.face().surface_id() != partner.face().surface_id())
+    {
+        return true;
+    }
+
+    return !continuous(halfedge.attributes(), partner.next().attributes()) || !continuous(halfedge.next().attributes(), partner.attributes());
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+typename quetzal::brep::Decimator<M>::PointType quetzal::brep::Decimator<M>::point_type_of(const M& mesh, id_type idHalfedge) const
+{
+    size_t nFeatures = 0;
+    bool bFixed = false;
+
+    for_each_outgoing(mesh, idHalfedge, [&](id_type id)
+    {
+        const auto& halfedge = mesh.halfedge(id);
+        bFixed = bFixed || !triangle(halfedge.face_id());
+
+        // Each edge at the point leaves it in some face, except the one arriving along a border
+        nFeatures += m_bFeatures[id] ? 1 : 0;
+        nFeatures += halfedge.prev().border() ? 1 : 0;
+    });
+
+    if (bFixed || (nFeatures != 0 && nFeatures != 2))
+    {
+        return PointType::Fixed;
+    }
+
+    return nFeatures == 0 ? PointType::Interior : PointType::Feature;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::Decimator<M>::label_faces(const M& mesh)
+{
+    std::vector<id_type> idFaces(mesh.face_store_count());
+    std::iota(idFaces.begin(), idFaces.end(), id_type(0));
+
+    m_bTriangles.assign(idFaces.size(), 0);
+    std::for_each(std::execution::par, idFaces.begin(), idFaces.end(), [&](id_type idFace)
+    {
+        const auto& face = mesh.face_store()[idFace];
+        if (face.deleted())
+        {
+            return;
+        }
+
+        const auto& halfedge = face.halfedge();
+        m_bTriangles[idFace] = halfedge.next().next().next_id() == halfedge.id() && face.hole_count() == 0;
+    });
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::Decimator<M>::label_edges(const M& mesh)
+{
+    std::vector<id_type> idHalfedges(mesh.halfedge_store_count());
+    std::iota(idHalfedges.begin(), idHalfedges.end(), id_type(0));
+
+    m_bFeatures.assign(idHalfedges.size(), 0);
+    std::for_each(std::execution::par, idHalfedges.begin(), idHalfedges.end(), [&](id_type idHalfedge)
+    {
+        if (!mesh.halfedge_store()[idHalfedge].deleted())
+        {
+            m_bFeatures[idHalfedge] = feature_edge(mesh, idHalfedge);
+        }
+    });
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::Decimator<M>::update_edges(const M& mesh, id_type idHalfedge)
+{
+    for_each_outgoing(mesh, idHalfedge, [&](id_type id)
+    {
+        const auto& halfedge = mesh.halfedge(id);
+        m_bFeatures[id] = feature_edge(mesh, id);
+        if (!halfedge.border())
+        {
+            m_bFeatures[halfedge.partner_id()] = m_bFeatures[id];
+        }
+
+        if (halfedge.prev().border())
+        {
+            m_bFeatures[halfedge.prev_id()] = true;
+        }
+    });
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::Decimator<M>::label_points(const M& mesh)
+{
+    m_idPoints.assign(mesh.halfedge_store_count(), nullid);
+
+    id_type idPoint = 0;
+    for (id_type idHalfedge = 0; idHalfedge < m_idPoints.size(); ++idHalfedge)
+    {
+        if (m_idPoints[idHalfedge] != nullid || mesh.halfedge(idHalfedge).deleted())
+        {
+            continue;
+        }
+
+        for_each_outgoing(mesh, idHalfedge, [&](id_type id)
+        {
+            m_idPoints[id] = idPoint;
+        });
+
+        ++idPoint;
+    }
+
+    m_quadrics.assign(idPoint, Quadric());
+    m_types.assign(idPoint, PointType::Fixed);
+    m_stamps.assign(idPoint, 0);
+    m_stamp = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::Decimator<M>::initialize_points(const M& mesh)
+{
+    // One halfedge per point, each point sums its own faces so points are independent
+    std::vector<id_type> idHalfedges(m_quadrics.size(), nullid);
+    for (id_type idHalfedge = 0; idHalfedge < m_idPoints.size(); ++idHalfedge)
+    {
+        if (m_idPoints[idHalfedge] != nullid && idHalfedges[m_idPoints[idHalfedge]] == nullid)
+        {
+            idHalfedges[m_idPoints[idHalfedge]] = idHalfedge;
+        }
+    }
+
+    std::for_each(std::execution::par, idHalfedges.begin(), idHalfedges.end(), [&](id_type idHalfedge)
+    {
+        m_types[m_idPoints[idHalfedge]] = point_type_of(mesh, idHalfedge);
+        Quadric& quadric = m_quadrics[m_idPoints[idHalfedge]];
+
+        // Plane of the face through its corner at this point, and of each feature edge perpendicular to its face
+        auto add_feature = [&](const auto& halfedge, const vector_type& normal)
+        {
+            vector_type edge = halfedge.next().attributes().position() - halfedge.attributes().position();
+            vector_type normalFeature = cross(edge, normal);
+            value_type length = normalFeature.norm();
+            if (length > value_type(0))
+            {
+                quadric.add_plane(normalFeature / length, halfedge.attributes().position(), m_weightFeature * dot(edge, edge));
+            }
+        };
+
+        for_each_outgoing(mesh, idHalfedge, [&](id_type id)
+        {
+            const auto& halfedge = mesh.halfedge(id);
+            const auto& face = halfedge.face();
+            const point_type position = halfedge.attributes().position();
+
+            vector_type normal = cross(halfedge.next().attributes().position() - position, halfedge.prev().attributes().position() - position);
+            value_type area = value_type(0.5) * normal.norm();
+            if (!triangle(face.id()))
+            {
+                normal = face.attributes().normal();
+            }
+            else if (area > value_type(0))
+            {
+                normal /= value_type(2) * area;
+            }
+            else
+            {
+                return;
+            }
+
+            quadric.add_plane(normal, position, area);
+
+            if (m_bFeatures[id])
+            {
+                add_feature(halfedge, normal);
+            }
+
+            if (halfedge.prev().border())
+            {
+                add_feature(halfedge.prev(), normal);
+            }
+        });
+    });
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+bool quetzal::brep::Decimator<M>::evaluate(const M& mesh, id_type idHalfedge, Candidate& candidate) const
+{
+    const auto& halfedge = mesh.halfedge(idHalfedge);
+    if (!triangle(halfedge.face_id()) || (!halfedge.border() && !triangle(halfedge.partner().face_id())))
+    {
+        return false;
+    }
+
+    id_type idPointStart = m_idPoints[idHalfedge];
+    id_type idPointEnd = m_idPoints[halfedge.next_id()];
+
+    PointType typeStart = m_types[idPointStart];
+    PointType typeEnd = m_types[idPointEnd];
+    if (typeStart == PointType::Fixed && typeEnd == PointType::Fixed)
+    {
+        return false;
+    }
+
+    Quadric quadric = m_quadrics[idPointStart];
+    quadric += m_quadrics[idPointEnd];
+
+    const point_type positionStart = halfedge.attributes().position();
+    const point_type positionEnd = halfedge.next().attributes().position();
+
+    candidate.idHalfedge = idHalfedge;
+    candidate.stampStart = m_stamps[idPointStart];
+    candidate.stampEnd = m_stamps[idPointEnd];
+
+    if (typeStart == PointType::Interior && typeEnd == PointType::Interior)
+    {
+        // Anywhere near the edge, attributes interpolated at the projection onto it
+        vector_type edge = positionEnd - positionStart;
+        value_type lengthSquared = dot(edge, edge);
+
+        point_type position;
+        if (!quadric.minimum(position) || dot(position - positionStart - value_type(0.5) * edge, position - positionStart - value_type(0.5) * edge) > lengthSquared)
+        {
+            position = positionStart;
+            for (const point_type& p : {positionEnd, point_type(positionStart + value_type(0.5) * edge)})
+            {
+                if (quadric.evaluate(p) < quadric.evaluate(position))
+                {
+                    position = p;
+                }
+            }
+        }
+
+        candidate.cost = quadric.evaluate(position);
+        candidate.bRemoveStart = true;
+        candidate.bInterior = true;
+        candidate.t = lengthSquared > value_type(0) ? std::clamp(dot(position - positionStart, edge) / lengthSquared, value_type(0), value_type(1)) : value_type(0);
+        candidate.position = position;
+        return true;
+    }
+
+    // Onto the other end, feature points only along a feature edge
+    bool bFeature = m_bFeatures[idHalfedge];
+    bool bRemoveStart = typeStart == PointType::Interior || (typeStart == PointType::Feature && bFeature);
+    bool bRemoveEnd = typeEnd == PointType::Interior || (typeEnd == PointType::Feature && bFeature);
+    if (!bRemoveStart && !bRemoveEnd)
+    {
+        return false;
+    }
+
+    value_type costStart = bRemoveStart ? quadric.evaluate(positionEnd) : std::numeric_limits<value_type>::max();
+    value_type costEnd = bRemoveEnd ? quadric.evaluate(positionStart) : std::numeric_limits<value_type>::max();
+
+    candidate.bRemoveStart = costStart <= costEnd;
+    candidate.bInterior = false;
+    candidate.cost = candidate.bRemoveStart ? costStart : costEnd;
+    candidate.t = value_type(1);
+    candidate.position = candidate.bRemoveStart ? positionEnd : positionStart;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::Decimator<M>::push_point(const M& mesh, id_type idHalfedge)
+{
+    // Every edge at the point once, through its halfedge leaving the point or the border halfedge arriving at it
+    for_each_outgoing(mesh, idHalfedge, [&](id_type id)
+    {
+        Candidate candidate;
+        if (evaluate(mesh, id, candidate))
+        {
+            m_candidates.push(candidate);
+        }
+
+        const auto& prev = mesh.halfedge(id).prev();
+        if (prev.border() && evaluate(mesh, prev.id(), candidate))
+        {
+            m_candidates.push(candidate);
+        }
+    });
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::Decimator<M>::neighbors(const M& mesh, id_type idHalfedge, std::vector<id_type>& idPoints) const
+{
+    idPoints.clear();
+    for_each_outgoing(mesh, idHalfedge, [&](id_type id)
+    {
+        const auto& halfedge = mesh.halfedge(id);
+        idPoints.push_back(m_idPoints[halfedge.next_id()]);
+        idPoints.push_back(m_idPoints[halfedge.prev_id()]);
+    });
+
+    std::sort(idPoints.begin(), idPoints.end());
+    idPoints.erase(std::unique(idPoints.begin(), idPoints.end()), idPoints.end());
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+bool quetzal::brep::Decimator<M>::collapsible(const M& mesh, const Candidate& candidate)
+{
+    const auto& halfedge = mesh.halfedge(candidate.idHalfedge);
+    id_type idRemoved = candidate.bRemoveStart ? halfedge.id() : halfedge.next_id();
+    id_type idKept = candidate.bRemoveStart ? halfedge.next_id() : halfedge.id();
+
+    // Each face of the edge loses one edge, so neither may have another border edge or it would be left hanging
+    std::array<id_type, 2> idOpposites = {nullid, nullid};
+    for (const auto* ph : {&halfedge, halfedge.border() ? nullptr : &halfedge.partner()})
+    {
+        if (ph == nullptr)
+        {
+            continue;
+        }
+
+        if (ph->next().border() && ph->prev().border())
+        {
+            return false;
+        }
+
+        idOpposites[ph == &halfedge ? 0 : 1] = ph->prev_id();
+    }
+
+    // Link condition, the points of the edge share no neighbors other than the opposite corners of its faces
+    neighbors(mesh, idRemoved, m_idNeighborsRemoved);
+    neighbors(mesh, idKept, m_idNeighborsKept);
+
+    size_t nShared = 0;
+    for (auto i = m_idNeighborsRemoved.begin(), j = m_idNeighborsKept.begin(); i != m_idNeighborsRemoved.end() && j != m_idNeighborsKept.end(); )
+    {
+        if (*i < *j)
+        {
+            ++i;
+        }
+        else if (*j < *i)
+        {
+            ++j;
+        }
+        else
+        {
+            if (*i != m_idPoints[idOpposites[0]] && (idOpposites[1] == nullid || *i != m_idPoints[idOpposites[1]]))
+            {
+                return false;
+            }
+
+            ++nShared;
+            ++i;
+            ++j;
+        }
+    }
+
+    if (nShared != (halfedge.border() ? 1 : 2))
+    {
+        return false;
+    }
+
+    // An opposite corner with three neighbors all round would be left with two, folding its remaining faces onto each other
+    for (id_type idOpposite : idOpposites)
+    {
+        if (idOpposite == nullid)
+        {
+            continue;
+        }
+
+        size_t nFaces = 0;
+        bool bBorder = false;
+        for_each_outgoing(mesh, idOpposite, [&](id_type id)
+        {
+            ++nFaces;
+            bBorder = bBorder || mesh.halfedge(id).border() || mesh.halfedge(id).prev().border();
+        });
+
+        if (!bBorder && nFaces <= 3)
+        {
+            return false;
+        }
+    }
+
+    // No other face of a moved point may flip or turn too far
+    id_type idFaceA = halfedge.face_id();
+    id_type idFaceB = halfedge.border() ? nullid : halfedge.partner().face_id();
+
+    bool bFolds = false;
+    auto check = [&](id_type id)
+    {
+        const auto& h = mesh.halfedge(id);
+        if (bFolds || h.face_id() == idFaceA || h.face_id() == idFaceB)
+        {
+            return;
+        }
+
+        const point_type position = h.attributes().position();
+        const point_type positionNext = h.next().attributes().position();
+        const point_type positionPrev = h.prev().attributes().position();
+
+        vector_type normal0 = cross(positionNext - position, positionPrev - position);
+        vector_type normal1 = cross(positionNext - candidate.position, positionPrev - candidate.position);
+        value_type length0 = normal0.norm();
+        value_type length1 = normal1.norm();
+
+        bFolds = length1 == value_type(0) || dot(normal0, normal1) < m_dotNormalMin * length0 * length1;
+    };
+
+    for_each_outgoing(mesh, idRemoved, check);
+    if (candidate.bInterior)
+    {
+        for_each_outgoing(mesh, idKept, check);
+    }
+
+    return !bFolds;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::Decimator<M>::collapse(M& mesh, const Candidate& candidate)
+{
+    const auto& halfedge = mesh.halfedge(candidate.idHalfedge);
+    id_type idFaceA = halfedge.face_id();
+    id_type idFaceB = halfedge.border() ? nullid : halfedge.partner().face_id();
+
+    // Halfedges leaving the removed point in each face of the edge, and its kept point
+    id_type idRemovedA = candidate.bRemoveStart ? halfedge.id() : halfedge.next_id();
+    id_type idKeptA = candidate.bRemoveStart ? halfedge.next_id() : halfedge.id();
+    id_type idRemovedB = nullid;
+    id_type idKeptB = nullid;
+    if (idFaceB != nullid)
+    {
+        idRemovedB = candidate.bRemoveStart ? halfedge.partner().next_id() : halfedge.partner_id();
+        idKeptB = candidate.bRemoveStart ? halfedge.partner_id() : halfedge.partner().next_id();
+    }
+
+    id_type idPointRemoved = m_idPoints[idRemovedA];
+    id_type idPointKept = m_idPoints[idKeptA];
+
+    // Attributes for each side of the edge, sides differ only when the edge is a feature
+
+    vertex_attributes_type avA = lerp(mesh.halfedge(idRemovedA).attributes(), mesh.halfedge(idKeptA).attributes(), candidate.t);
+    avA.set_position(candidate.position);
+
+    vertex_attributes_type avB = avA;
+    if (idFaceB != nullid)
+    {
+        avB = lerp(mesh.halfedge(idRemovedB).attributes(), mesh.halfedge(idKeptB).attributes(), candidate.t);
+        avB.set_position(candidate.position);
+    }
+
+    m_idsRemoved.clear();
+    for_each_outgoing(mesh, idRemovedA, [&](id_type id)
+    {
+        m_idsRemoved.push_back(id);
+    });
+
+    m_idsKept.clear();
+    for_each_outgoing(mesh, idKeptA, [&](id_type id)
+    {
+        m_idsKept.push_back(id);
+    });
+
+    // Side A runs from the edge through face A until the next feature edge
+    // Leaving the removed point in face A, the edge crossed is the previous halfedge when removing the start, otherwise this one
+    std::vector<id_type>& idsSideA = m_idsSideA;
+    idsSideA.clear();
+    if (idFaceB != nullid && m_bFeatures[candidate.idHalfedge])
+    {
+        id_type id = idRemovedA;
+        do
+        {
+            idsSideA.push_back(id);
+            const auto& h = mesh.halfedge(id);
+            id_type idCrossed = candidate.bRemoveStart ? h.prev_id() : id;
+            if (m_bFeatures[idCrossed])
+            {
+                break;
+            }
+
+            id = candidate.bRemoveStart ? mesh.halfedge(idCrossed).partner_id() : h.partner().next_id();
+        } while (id != idRemovedA);
+
+        std::sort(idsSideA.begin(), idsSideA.end());
+    }
+
+    for (id_type id : m_idsRemoved)
+    {
+        bool bSideA = idsSideA.empty() || std::binary_search(idsSideA.begin(), idsSideA.end(), id);
+        mesh.halfedge(id).set_attributes(bSideA ? avA : avB);
+        m_idPoints[id] = idPointKept;
+        m_bMoved[mesh.halfedge(id).face_id()] = true;
+    }
+
+    // Only interior points move the kept point, and they have the same attributes all round
+    // Otherwise the kept point is already at the position, its corners keep their attributes on either side of its features
+    if (candidate.bInterior)
+    {
+        for (id_type id : m_idsKept)
+        {
+            mesh.halfedge(id).set_attributes(avA);
+            m_bMoved[mesh.halfedge(id).face_id()] = true;
+        }
+    }
+
+    // The two remaining edges of each face of the edge become partners
+    // Halfedges leaving the opposite corners are kept to update them afterwards
+
+    std::array<id_type, 2> idOpposites = {nullid, nullid};
+    for (id_type idFace : {idFaceA, idFaceB})
+    {
+        if (idFace == nullid)
+        {
+            continue;
+        }
+
+        const auto& h = idFace == idFaceA ? halfedge : halfedge.partner();
+        id_type idA = h.next().partner_id();
+        id_type idB = h.prev().partner_id();
+        idOpposites[idFace == idFaceA ? 0 : 1] = idA != nullid ? idA : mesh.halfedge(idB).next_id();
+
+        if (idA != nullid)
+        {
+            mesh.halfedge(idA).set_partner_id(idB);
+        }
+
+        if (idB != nullid)
+        {
+            mesh.halfedge(idB).set_partner_id(idA);
+        }
+    }
+
+    for (id_type idFace : {idFaceA, idFaceB})
+    {
+        if (idFace != nullid)
+        {
+            delete_face(mesh, idFace);
+        }
+    }
+
+    m_quadrics[idPointKept] += m_quadrics[idPointRemoved];
+    m_stamps[idPointRemoved] = ++m_stamp;
+    m_stamps[idPointKept] = ++m_stamp;
+
+    // Any surviving halfedge that left either point now leaves the kept one
+    id_type idStart = nullid;
+    for (const auto* pids : {&m_idsKept, &m_idsRemoved})
+    {
+        for (id_type id : *pids)
+        {
+            if (idStart == nullid && !mesh.halfedge(id).deleted())
+            {
+                idStart = id;
+            }
+        }
+    }
+
+    // Edges merged at the opposite corners are edges of the kept point, so its edges are updated first
+
+    if (idStart != nullid)
+    {
+        update_edges(mesh, idStart);
+        m_types[idPointKept] = point_type_of(mesh, idStart);
+    }
+
+    // An opposite corner that changes type has its candidates evaluated for the old type, so they are replaced
+    for (id_type idOpposite : idOpposites)
+    {
+        if (idOpposite == nullid)
+        {
+            continue;
+        }
+
+        PointType type = point_type_of(mesh, idOpposite);
+        if (type != m_types[m_idPoints[idOpposite]])
+        {
+            m_types[m_idPoints[idOpposite]] = type;
+            m_stamps[m_idPoints[idOpposite]] = ++m_stamp;
+            push_point(mesh, idOpposite);
+        }
+    }
+
+    if (idStart != nullid)
+    {
+        push_point(mesh, idStart);
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::Decimator<M>::delete_face(M& mesh, id_type idFace)
+{
+    // Like Mesh::delete_face, but partners are relinked by the caller, and face ids and perimeters are updated once at the end
+    auto& face = mesh.face(idFace);
+    id_type id = face.halfedge_id();
+    for (int i = 0; i < 3; ++i)
+    {
+        auto& halfedge = mesh.halfedge(id);
+        id = halfedge.next_id();
+        halfedge.vertex().set_deleted();
+        halfedge.set_deleted();
+    }
+
+    face.set_deleted();
+    --m_nFaces;
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+size_t quetzal::brep::decimate(M& mesh, size_t nFaces, typename M::value_type errorMax)
+{
+    Decimator<M> decimator;
+    return decimator.decimate(mesh, nFaces, errorMax);
+}
+
+#endif // QUETZAL_BREP_MESH_DECIMATION_HPP
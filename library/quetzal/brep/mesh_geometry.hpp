@@ -17,8 +17,11 @@
 #include "quetzal/geometry/Polygon.hpp"
 #include "quetzal/geometry/Segment.hpp"
 #include "quetzal/geometry/intersect.hpp"
+#include "quetzal/geometry/predicates.hpp"
 #include "quetzal/geometry/triangle_util.hpp"
 #include "quetzal/math/DimensionReducer.hpp"
+#include "quetzal/math/math_util.hpp"
+#include <cmath>
 
 namespace quetzal::brep
 {
@@ -104,6 +107,11 @@ namespace quetzal::brep
     template<typename Traits>
     bool solid_contains(const Mesh<Traits>& mesh, const typename Traits::point_type& point);
 
+    // Generalized winding number of a submesh around point, about 1 inside a closed outward facing submesh and 0 outside
+    // Sum of the signed solid angles of face boundaries and holes fanned into triangles, read only, unlike solid_contains
+    template<typename Traits>
+    typename Traits::value_type winding_number(const Mesh<Traits>& mesh, id_type idSubmesh, const typename Traits::point_type& point);
+
 } // namespace quetzal::brep
 
 //------------------------------------------------------------------------------
@@ -119,14 +127,15 @@ int quetzal::brep::orientation(const Halfedge<Traits>& halfedge)
     const auto& b = halfedge.attributes().position();
     const auto& c = halfedge.next().attributes().position();
 
+    // Sign of dot(c - b, cross(normal, b - a)) in 3d, dot(c - b, perp(b - a)) in 2d, exact so that convex and reflex are consistent
     if constexpr (Traits::dimension == 3)
     {
         const auto& normal = halfedge.attributes().normal();
-        return dot(c - b, cross(normal, b - a)) < Traits::val(0) ? -1 : 1;
+        return geometry::orient3d(a, b, c, b - normal) < 0 ? -1 : 1;
     }
     else if constexpr (Traits::dimension == 2)
     {
-        return dot(c - b, perp(b - a)) < Traits::val(0) ? -1 : 1;
+        return geometry::orient2d(a, b, c) < 0 ? -1 : 1;
     }
 }
 
@@ -503,6 +512,56 @@ bool quetzal::brep::solid_contains(const Mesh<Traits>& mesh, const typename Trai
     return math::odd(n);
 }
 
+//------------------------------------------------------------------------------
+template<typename Traits>
+typename Traits::value_type quetzal::brep::winding_number(const Mesh<Traits>& mesh, id_type idSubmesh, const typename Traits::point_type& point)
+{
+    using value_type = Traits::value_type;
+
+    // Solid angle of the triangle fan of one boundary, by Van Oosterom and Strackee
+    auto solid_angle = [&mesh, &point](id_type idHalfedge0) -> value_type
+    {
+        value_type omega = Traits::val(0);
+
+        const auto& halfedge0 = mesh.halfedge(idHalfedge0);
+        const auto a = halfedge0.attributes().position() - point;
+        value_type la = a.norm();
+
+        for (id_type idHalfedge = halfedge0.next_id(); mesh.halfedge(idHalfedge).next_id() != idHalfedge0; idHalfedge = mesh.halfedge(idHalfedge).next_id())
+        {
+            const auto& halfedge = mesh.halfedge(idHalfedge);
+            const auto b = halfedge.attributes().position() - point;
+            const auto c = halfedge.next().attributes().position() - point;
+            value_type lb = b.norm();
+            value_type lc = c.norm();
+
+            value_type numerator = dot(a, cross(b, c));
+            value_type denominator = la * lb * lc + dot(a, b) * lc + dot(a, c) * lb + dot(b, c) * la;
+            omega += Traits::val(2) * std::atan2(numerator, denominator);
+        }
+
+        return omega;
+    };
+
+    value_type omega = Traits::val(0);
+    for (id_type idFace : mesh.submesh(idSubmesh).face_ids())
+    {
+        const auto& face = mesh.face(idFace);
+        if (face.deleted())
+        {
+            continue;
+        }
+
+        omega += solid_angle(face.halfedge_id());
+        for (const auto& hole : face.holes())
+        {
+            omega += solid_angle(hole.halfedge_id());
+        }
+    }
+
+    return omega / (Traits::val(4) * math::Pi<value_type>);
+}
+
 /* reactivate if needed ...
 //------------------------------------------------------------------------------
 template<typename S>
@@ -0,0 +1,470 @@
+#if !defined(QUETZAL_BREP_MESH_SLICE_HPP)
+#define QUETZAL_BREP_MESH_SLICE_HPP
+//------------------------------------------------------------------------------
+// brep
+// mesh_slice.hpp
+//------------------------------------------------------------------------------
+
+#include "id.hpp"
+#include "quetzal/geometry/Plane.hpp"
+#include "quetzal/geometry/Polygon.hpp"
+#include "quetzal/geometry/PolygonWithHoles.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <execution>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+#include <cassert>
+
+namespace quetzal::brep
+{
+
+    // Slicing is read only, the mesh is not reset, marked, or split
+    // Contours lie in their planes, outer contours are CCW about the plane normal and holes CW, given outward facing faces
+    // Vertices lying in a plane are treated as above it, so every contour edge crosses a mesh edge
+    // Contours of an open mesh that end at its border are closed by their implied last edge
+
+    // Contours of a single plane
+    template<typename M>
+    using slice_type = std::vector<geometry::PolygonWithHoles<typename M::vector_traits>>;
+
+    // Called once per layer, in layer order
+    template<typename M>
+    using slice_function_type = std::function<void(size_t nLayer, const slice_type<M>& slice)>;
+
+    // Planes with normal at the given ascending offsets along it
+    // Faces are swept once in order of the first plane they cross, layers are sliced in parallel nWindow at a time
+    // Memory beyond the per face plane ranges is bounded by the faces crossing the current window of layers
+    template<typename M>
+    void slice(const M& mesh, const typename M::vector_type& normal, const std::vector<typename M::value_type>& offsets, slice_function_type<M> f, size_t nWindow = 64);
+
+    // Faces of the submesh only
+    template<typename M>
+    void slice(const M& mesh, id_type idSubmesh, const typename M::vector_type& normal, const std::vector<typename M::value_type>& offsets, slice_function_type<M> f, size_t nWindow = 64);
+
+    // nLayers planes, the first being plane and each subsequent one step further along its normal
+    template<typename M>
+    void slice(const M& mesh, const geometry::Plane<typename M::vector_traits>& plane, typename M::value_type step, size_t nLayers, slice_function_type<M> f, size_t nWindow = 64);
+
+    // As above, collecting all layers
+    template<typename M>
+    std::vector<slice_type<M>> slice(const M& mesh, const geometry::Plane<typename M::vector_traits>& plane, typename M::value_type step, size_t nLayers);
+
+namespace internal
+{
+
+    template<typename M>
+    void slice_faces(const M& mesh, const std::vector<id_type>& idFaces, const typename M::vector_type& normal, const std::vector<typename M::value_type>& offsets, slice_function_type<M> f, size_t nWindow);
+
+    template<typename M>
+    slice_type<M> slice_layer(const M& mesh, const std::vector<id_type>& idFaces, const typename M::vector_type& normal, typename M::value_type offset);
+
+    // Sorts loops into outer contours and the holes they contain, by signed area about normal
+    template<typename M>
+    slice_type<M> slice_contours(std::vector<geometry::Polygon<typename M::vector_traits>>& loops, const typename M::vector_type& normal);
+
+} // namespace internal
+
+} // namespace quetzal::brep
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::slice(const M& mesh, const typename M::vector_type& normal, const std::vector<typename M::value_type>& offsets, slice_function_type<M> f, size_t nWindow)
+{
+    std::vector<id_type> idFaces;
+    idFaces.reserve(mesh.face_count());
+    for (id_type idFace = 0; idFace < mesh.face_store_count(); ++idFace)
+    {
+        if (!mesh.face_store()[idFace].deleted())
+        {
+            idFaces.push_back(idFace);
+        }
+    }
+
+    internal::slice_faces(mesh, idFaces, normal, offsets, f, nWindow);
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::slice(const M& mesh, id_type idSubmesh, const typename M::vector_type& normal, const std::vector<typename M::value_type>& offsets, slice_function_type<M> f, size_t nWindow)
+{
+    const auto& idSubmeshFaces = mesh.submesh(idSubmesh).face_ids();
+    std::vector<id_type> idFaces(idSubmeshFaces.begin(), idSubmeshFaces.end());
+
+    internal::slice_faces(mesh, idFaces, normal, offsets, f, nWindow);
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::slice(const M& mesh, const geometry::Plane<typename M::vector_traits>& plane, typename M::value_type step, size_t nLayers, slice_function_type<M> f, size_t nWindow)
+{
+    assert(step > typename M::value_type(0));
+
+    typename M::value_type offset0 = dot(plane.normal(), plane.point());
+
+    std::vector<typename M::value_type> offsets(nLayers);
+    for (size_t i = 0; i < nLayers; ++i)
+    {
+        offsets[i] = offset0 + typename M::value_type(i) * step;
+    }
+
+    slice(mesh, plane.normal(), offsets, f, nWindow);
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+std::vector<quetzal::brep::slice_type<M>> quetzal::brep::slice(const M& mesh, const geometry::Plane<typename M::vector_traits>& plane, typename M::value_type step, size_t nLayers)
+{
+    std::vector<slice_type<M>> slices(nLayers);
+
+    slice(mesh, plane, step, nLayers, [&slices](size_t nLayer, const slice_type<M>& slice)
+    {
+        slices[nLayer] = slice;
+    });
+
+    return slices;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::internal::slice_faces(const M& mesh, const std::vector<id_type>& idFaces, const typename M::vector_type& normal, const std::vector<typename M::value_type>& offsets, slice_function_type<M> f, size_t nWindow)
+{
+    assert(std::is_sorted(offsets.begin(), offsets.end()));
+    assert(nWindow > 0);
+
+    const auto& halfedges = mesh.halfedge_store();
+    const auto& vertices = mesh.vertex_store();
+    size_t nLayers = offsets.size();
+    size_t nFaces = idFaces.size();
+
+    // Range of planes crossed by each face, [nLayerFirst, nLayerLast), empty if the face crosses none
+    // A face crosses a plane if it has vertices both below and not below it
+    std::vector<size_t> nLayerFirst(nFaces);
+    std::vector<size_t> nLayerLast(nFaces);
+    std::vector<size_t> nFaceIndices(nFaces);
+    std::iota(nFaceIndices.begin(), nFaceIndices.end(), size_t(0));
+
+    std::for_each(std::execution::par, nFaceIndices.begin(), nFaceIndices.end(), [&](size_t i)
+    {
+        typename M::value_type dMin = std::numeric_limits<typename M::value_type>::max();
+        typename M::value_type dMax = std::numeric_limits<typename M::value_type>::lowest();
+
+        id_type idHalfedge0 = mesh.face_store()[idFaces[i]].halfedge_id();
+        id_type idHalfedge = idHalfedge0;
+        do
+        {
+            typename M::value_type d = dot(normal, vertices[halfedges[idHalfedge].vertex_id()].attributes().position());
+            dMin = std::min(dMin, d);
+            dMax = std::max(dMax, d);
+            idHalfedge = halfedges[idHalfedge].next_id();
+        } while (idHalfedge != idHalfedge0);
+
+        nLayerFirst[i] = std::upper_bound(offsets.begin(), offsets.end(), dMin) - offsets.begin();
+        nLayerLast[i] = std::max(nLayerFirst[i], size_t(std::upper_bound(offsets.begin(), offsets.end(), dMax) - offsets.begin()));
+    });
+
+    // Event list, faces bucketed by the first plane they cross
+    std::vector<size_t> nEventStarts(nLayers + 1, 0);
+    for (size_t i = 0; i < nFaces; ++i)
+    {
+        if (nLayerFirst[i] < nLayerLast[i])
+        {
+            ++nEventStarts[nLayerFirst[i] + 1];
+        }
+    }
+
+    std::partial_sum(nEventStarts.begin(), nEventStarts.end(), nEventStarts.begin());
+
+    std::vector<size_t> events(nEventStarts[nLayers]);
+    std::vector<size_t> nEventNext(nEventStarts.begin(), nEventStarts.end() - 1);
+    for (size_t i = 0; i < nFaces; ++i)
+    {
+        if (nLayerFirst[i] < nLayerLast[i])
+        {
+            events[nEventNext[nLayerFirst[i]]++] = i;
+        }
+    }
+
+    std::vector<size_t> active;
+    std::vector<std::vector<id_type>> idLayerFaces;
+    std::vector<slice_type<M>> slices;
+    std::vector<size_t> nWindowLayers;
+
+    for (size_t nWindowFirst = 0; nWindowFirst < nLayers; nWindowFirst += nWindow)
+    {
+        size_t nWindowLast = std::min(nWindowFirst + nWindow, nLayers);
+        size_t nWindowSize = nWindowLast - nWindowFirst;
+
+        active.erase(std::remove_if(active.begin(), active.end(), [&](size_t i) { return nLayerLast[i] <= nWindowFirst; }), active.end());
+        active.insert(active.end(), events.begin() + nEventStarts[nWindowFirst], events.begin() + nEventStarts[nWindowLast]);
+
+        idLayerFaces.assign(nWindowSize, {});
+        for (size_t i : active)
+        {
+            size_t nLast = std::min(nLayerLast[i], nWindowLast);
+            for (size_t nLayer = std::max(nLayerFirst[i], nWindowFirst); nLayer < nLast; ++nLayer)
+            {
+                idLayerFaces[nLayer - nWindowFirst].push_back(idFaces[i]);
+            }
+        }
+
+        slices.assign(nWindowSize, {});
+        nWindowLayers.resize(nWindowSize);
+        std::iota(nWindowLayers.begin(), nWindowLayers.end(), size_t(0));
+
+        std::for_each(std::execution::par, nWindowLayers.begin(), nWindowLayers.end(), [&](size_t n)
+        {
+            slices[n] = slice_layer(mesh, idLayerFaces[n], normal, offsets[nWindowFirst + n]);
+        });
+
+        for (size_t n = 0; n < nWindowSize; ++n)
+        {
+            f(nWindowFirst + n, slices[n]);
+        }
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+quetzal::brep::slice_type<M> quetzal::brep::internal::slice_layer(const M& mesh, const std::vector<id_type>& idFaces, const typename M::vector_type& normal, typename M::value_type offset)
+{
+    using value_type = M::value_type;
+
+    const auto& halfedges = mesh.halfedge_store();
+    const auto& vertices = mesh.vertex_store();
+
+    auto distance = [&](id_type idHalfedge) -> value_type
+    {
+        return dot(normal, vertices[halfedges[idHalfedge].vertex_id()].attributes().position()) - offset;
+    };
+
+    // Crossing points are identified by the lower id of the halfedge pair, and calculated from that halfedge, so both faces agree exactly
+    auto edge_id = [&](id_type idHalfedge) -> id_type
+    {
+        id_type idPartner = halfedges[idHalfedge].partner_id();
+        return idPartner == nullid ? idHalfedge : std::min(idHalfedge, idPartner);
+    };
+
+    auto crossing = [&](id_type idEdge) -> typename M::point_type
+    {
+        const auto& position0 = vertices[halfedges[idEdge].vertex_id()].attributes().position();
+        const auto& position1 = vertices[halfedges[halfedges[idEdge].next_id()].vertex_id()].attributes().position();
+        value_type d0 = distance(idEdge);
+        value_type d1 = distance(halfedges[idEdge].next_id());
+        return position0 + (d0 / (d0 - d1)) * (position1 - position0);
+    };
+
+    // Segments run from the edge where the face boundary goes below the plane to the edge where it comes back
+    struct Crossing
+    {
+        id_type idEdge;
+        bool bUp;
+        value_type t;
+    };
+
+    std::vector<std::array<id_type, 2>> segments;
+    std::vector<Crossing> crossings;
+
+    for (id_type idFace : idFaces)
+    {
+        crossings.clear();
+
+        id_type idHalfedge0 = mesh.face_store()[idFace].halfedge_id();
+        id_type idHalfedge = idHalfedge0;
+        bool bBelow = distance(idHalfedge) < value_type(0);
+        do
+        {
+            id_type idNext = halfedges[idHalfedge].next_id();
+            bool bBelowNext = distance(idNext) < value_type(0);
+            if (bBelow != bBelowNext)
+            {
+                crossings.push_back({edge_id(idHalfedge), bBelow, value_type(0)});
+            }
+
+            bBelow = bBelowNext;
+            idHalfedge = idNext;
+        } while (idHalfedge != idHalfedge0);
+
+        assert(crossings.size() % 2 == 0);
+
+        if (crossings.size() == 2)
+        {
+            segments.push_back(crossings[0].bUp ? std::array<id_type, 2>{crossings[1].idEdge, crossings[0].idEdge} : std::array<id_type, 2>{crossings[0].idEdge, crossings[1].idEdge});
+            continue;
+        }
+
+        // Non-convex face, crossings alternate down and up along the direction of the contour
+        typename M::vector_type direction = cross(normal, mesh.face_store()[idFace].attributes().normal());
+        for (auto& c : crossings)
+        {
+            c.t = dot(direction, crossing(c.idEdge));
+        }
+
+        std::sort(crossings.begin(), crossings.end(), [](const Crossing& a, const Crossing& b) { return a.t < b.t; });
+
+        for (size_t i = 0; i + 1 < crossings.size(); i += 2)
+        {
+            if (!crossings[i].bUp && crossings[i + 1].bUp)
+            {
+                segments.push_back({crossings[i].idEdge, crossings[i + 1].idEdge});
+            }
+        }
+    }
+
+    // Chain segments into loops, starting with any that begin at the mesh border
+    std::unordered_map<id_type, size_t> segmentStarts;
+    segmentStarts.reserve(segments.size());
+    for (size_t i = 0; i < segments.size(); ++i)
+    {
+        segmentStarts.emplace(segments[i][0], i);
+    }
+
+    std::vector<bool> used(segments.size(), false);
+    std::vector<geometry::Polygon<typename M::vector_traits>> loops;
+
+    auto chain = [&](size_t i)
+    {
+        geometry::Polygon<typename M::vector_traits> loop;
+        while (!used[i])
+        {
+            used[i] = true;
+            loop.vertices().push_back(crossing(segments[i][0]));
+
+            auto j = segmentStarts.find(segments[i][1]);
+            if (j == segmentStarts.end())
+            {
+                loop.vertices().push_back(crossing(segments[i][1]));
+                break;
+            }
+
+            i = j->second;
+        }
+
+        if (loop.vertex_count() >= 3)
+        {
+            loops.push_back(std::move(loop));
+        }
+    };
+
+    for (size_t i = 0; i < segments.size(); ++i)
+    {
+        if (halfedges[segments[i][0]].partner_id() == nullid)
+        {
+            chain(i);
+        }
+    }
+
+    for (size_t i = 0; i < segments.size(); ++i)
+    {
+        if (!used[i])
+        {
+            chain(i);
+        }
+    }
+
+    return slice_contours<M>(loops, normal);
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+quetzal::brep::slice_type<M> quetzal::brep::internal::slice_contours(std::vector<geometry::Polygon<typename M::vector_traits>>& loops, const typename M::vector_type& normal)
+{
+    using value_type = M::value_type;
+    using vector_type = M::vector_type;
+
+    // In plane coordinates for area and containment
+    vector_type u = std::abs(normal.x()) < value_type(0.9) ? cross(normal, vector_type(value_type(1), value_type(0), value_type(0))) : cross(normal, vector_type(value_type(0), value_type(1), value_type(0)));
+    u.normalize();
+    vector_type v = cross(normal, u);
+
+    auto signed_area = [&](const geometry::Polygon<typename M::vector_traits>& loop) -> value_type
+    {
+        value_type area = value_type(0);
+        const auto& points = loop.vertices();
+        for (size_t i = 0, j = points.size() - 1; i < points.size(); j = i++)
+        {
+            area += dot(points[j], u) * dot(points[i], v) - dot(points[i], u) * dot(points[j], v);
+        }
+
+        return value_type(0.5) * area;
+    };
+
+    auto contains = [&](const geometry::Polygon<typename M::vector_traits>& loop, const typename M::point_type& point) -> bool
+    {
+        value_type x = dot(point, u);
+        value_type y = dot(point, v);
+        bool bInside = false;
+        const auto& points = loop.vertices();
+        for (size_t i = 0, j = points.size() - 1; i < points.size(); j = i++)
+        {
+            value_type xi = dot(points[i], u);
+            value_type yi = dot(points[i], v);
+            value_type xj = dot(points[j], u);
+            value_type yj = dot(points[j], v);
+            if ((yi > y) != (yj > y) && x < xi + (y - yi) * (xj - xi) / (yj - yi))
+            {
+                bInside = !bInside;
+            }
+        }
+
+        return bInside;
+    };
+
+    std::vector<value_type> areas(loops.size());
+    std::vector<size_t> outers;
+    for (size_t i = 0; i < loops.size(); ++i)
+    {
+        areas[i] = signed_area(loops[i]);
+        if (areas[i] > value_type(0))
+        {
+            outers.push_back(i);
+        }
+    }
+
+    slice_type<M> contours(outers.size());
+    for (size_t n = 0; n < outers.size(); ++n)
+    {
+        contours[n].polygon() = std::move(loops[outers[n]]);
+    }
+
+    // Each hole goes to the smallest outer contour containing it, a hole contained by none is kept as a contour of its own
+    for (size_t i = 0; i < loops.size(); ++i)
+    {
+        if (areas[i] > value_type(0))
+        {
+            continue;
+        }
+
+        size_t nOuter = outers.size();
+        for (size_t n = 0; n < outers.size(); ++n)
+        {
+            if (contains(contours[n].polygon(), loops[i].vertex(0)) && (nOuter == outers.size() || areas[outers[n]] < areas[outers[nOuter]]))
+            {
+                nOuter = n;
+            }
+        }
+
+        if (nOuter < outers.size())
+        {
+            contours[nOuter].holes().push_back(std::move(loops[i]));
+        }
+        else
+        {
+            contours.emplace_back();
+            contours.back().polygon() = std::move(loops[i]);
+        }
+    }
+
+    return contours;
+}
+
+#endif // QUETZAL_BREP_MESH_SLICE_HPP
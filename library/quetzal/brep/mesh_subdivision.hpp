@@ -0,0 +1,682 @@
+#if !defined(QUETZAL_BREP_MESH_SUBDIVISION_HPP)
+#define QUETZAL_BREP_MESH_SUBDIVISION_HPP
+//------------------------------------------------------------------------------
+// brep
+// mesh_subdivision.hpp
+//------------------------------------------------------------------------------
+
+#include "id.hpp"
+#include "quetzal/geometry/Attributes.hpp"
+#include "quetzal/math/floating_point.hpp"
+#include "quetzal/math/math_util.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <execution>
+#include <numeric>
+#include <vector>
+#include <cassert>
+
+namespace quetzal::brep
+{
+
+    // Each level is built directly into new element stores that replace the current ones, so no more than two levels exist at once
+    // Surfaces, submeshes, and their names, attributes, and properties are unchanged, each new face belongs to the surface of the face it came from
+    // Crease edges are borders, edges between different surfaces, and edges across which corner normals differ
+    // Points on two crease edges follow the crease rule, points on more are corners and stay in place
+    // Corner attributes are interpolated within each face, so texcoord seams are kept, face normals are recalculated
+    // Faces must not have holes
+
+    // Loop subdivision, each triangle becomes four triangles, all faces must be triangles
+    template<typename M>
+    void subdivide_loop(M& mesh, size_t nLevels = 1);
+
+    // Catmull-Clark subdivision, each face of n sides becomes n quads
+    template<typename M>
+    void subdivide_catmull_clark(M& mesh, size_t nLevels = 1);
+
+    // Loop subdivision if all faces are triangles, Catmull-Clark otherwise
+    template<typename M>
+    void subdivide(M& mesh, size_t nLevels = 1);
+
+namespace internal
+{
+
+    // Connectivity of one level in dense numbering, deleted elements are skipped
+    // Corners are numbered consecutively around each face, in halfedge order, so the corners of a face of triangles f are 3 * f + k
+    struct SubdivisionTopology
+    {
+        std::vector<id_type> idFaces; // Face id of each face
+        std::vector<size_t> iCornersFirst; // First corner of each face, followed by the total corner count
+        std::vector<id_type> idHalfedges; // Halfedge id of each corner
+        std::vector<size_t> iCornerFaces; // Face of each corner
+        std::vector<size_t> iCorners; // Corner of each halfedge id, nullid if deleted
+        std::vector<size_t> iPartners; // Corner of the partner of each corner, nullid at a border
+        std::vector<size_t> iPoints; // Point at each corner, corners sharing a position around a fan
+        std::vector<id_type> idPointHalfedges; // Halfedge leaving each point
+        std::vector<size_t> iEdges; // Edge of each corner, from the corner to the next corner of its face
+        std::vector<size_t> iEdgeCorners; // A corner of each edge
+        std::vector<char> bCreases; // Per edge
+
+        size_t face_count() const;
+        size_t corner_count() const;
+        size_t next(size_t iCorner, size_t iFace) const;
+        size_t prev(size_t iCorner, size_t iFace) const;
+    };
+
+    template<typename M>
+    void label_subdivision_topology(const M& mesh, SubdivisionTopology& topology);
+
+    // Calls f(idHalfedge, bIncoming) once for each edge at the point at the start of idHalfedge
+    // Edges leaving the point are passed as the halfedge leaving it, the edge arriving along a border as its halfedge
+    template<typename M, typename F>
+    void for_each_point_edge(const M& mesh, id_type idHalfedge, F f);
+
+    template<typename M>
+    bool subdivision_crease(const M& mesh, id_type idHalfedge);
+
+    // New point positions by the smooth rule from the point position, its neighbors, and for Catmull-Clark its face points
+    template<typename M>
+    void subdivide_points(const M& mesh, const SubdivisionTopology& topology, bool bLoop, const std::vector<typename M::point_type>& facePositions, std::vector<typename M::point_type>& pointPositions);
+
+    template<typename M>
+    void subdivide_loop_level(M& mesh);
+
+    template<typename M>
+    void subdivide_catmull_clark_level(M& mesh);
+
+    // Replace the element stores with those of the new level, and add its faces to their surfaces and submeshes
+    template<typename M>
+    void replace_subdivided(M& mesh, typename M::halfedge_store_type& halfedges, typename M::vertex_store_type& vertices, typename M::face_store_type& faces);
+
+    template<typename M>
+    typename M::vector_type subdivided_face_normal(const typename M::vertex_store_type& vertices, id_type idVertexFirst, size_t nCorners);
+
+} // namespace internal
+
+} // namespace quetzal::brep
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::subdivide_loop(M& mesh, size_t nLevels)
+{
+    for (size_t i = 0; i < nLevels; ++i)
+    {
+        internal::subdivide_loop_level(mesh);
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::subdivide_catmull_clark(M& mesh, size_t nLevels)
+{
+    for (size_t i = 0; i < nLevels; ++i)
+    {
+        internal::subdivide_catmull_clark_level(mesh);
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::subdivide(M& mesh, size_t nLevels)
+{
+    bool bTriangles = std::all_of(mesh.face_store().begin(), mesh.face_store().end(), [&](const auto& face)
+    {
+        return face.deleted() || mesh.halfedge(mesh.halfedge(mesh.halfedge(face.halfedge_id()).next_id()).next_id()).next_id() == face.halfedge_id();
+    });
+
+    if (bTriangles)
+    {
+        subdivide_loop(mesh, nLevels);
+    }
+    else
+    {
+        subdivide_catmull_clark(mesh, nLevels);
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+inline size_t quetzal::brep::internal::SubdivisionTopology::face_count() const
+{
+    return idFaces.size();
+}
+
+//------------------------------------------------------------------------------
+inline size_t quetzal::brep::internal::SubdivisionTopology::corner_count() const
+{
+    return idHalfedges.size();
+}
+
+//------------------------------------------------------------------------------
+inline size_t quetzal::brep::internal::SubdivisionTopology::next(size_t iCorner, size_t iFace) const
+{
+    return iCorner + 1 < iCornersFirst[iFace + 1] ? iCorner + 1 : iCornersFirst[iFace];
+}
+
+//------------------------------------------------------------------------------
+inline size_t quetzal::brep::internal::SubdivisionTopology::prev(size_t iCorner, size_t iFace) const
+{
+    return iCorner > iCornersFirst[iFace] ? iCorner - 1 : iCornersFirst[iFace + 1] - 1;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::internal::label_subdivision_topology(const M& mesh, SubdivisionTopology& topology)
+{
+    topology = {};
+
+    // Face halfedges are counted directly rather than through the face element containers, which are slow to iterate
+    topology.iCornersFirst.push_back(0);
+    for (const auto& face : mesh.face_store())
+    {
+        if (face.deleted())
+        {
+            continue;
+        }
+
+        assert(face.hole_count() == 0);
+        size_t n = 0;
+        id_type idHalfedge = face.halfedge_id();
+        do
+        {
+            ++n;
+            idHalfedge = mesh.halfedge(idHalfedge).next_id();
+        } while (idHalfedge != face.halfedge_id());
+
+        topology.idFaces.push_back(face.id());
+        topology.iCornersFirst.push_back(topology.iCornersFirst.back() + n);
+    }
+
+    size_t nCorners = topology.iCornersFirst.back();
+    topology.idHalfedges.resize(nCorners);
+    topology.iCornerFaces.resize(nCorners);
+    topology.iCorners.assign(mesh.halfedge_store_count(), nullid);
+
+    std::vector<size_t> iFaces(topology.face_count());
+    std::iota(iFaces.begin(), iFaces.end(), size_t(0));
+
+    std::for_each(std::execution::par, iFaces.begin(), iFaces.end(), [&](size_t iFace)
+    {
+        size_t iCorner = topology.iCornersFirst[iFace];
+        id_type idHalfedge0 = mesh.face(topology.idFaces[iFace]).halfedge_id();
+        id_type idHalfedge = idHalfedge0;
+        do
+        {
+            topology.idHalfedges[iCorner] = idHalfedge;
+            topology.iCornerFaces[iCorner] = iFace;
+            topology.iCorners[idHalfedge] = iCorner;
+            ++iCorner;
+            idHalfedge = mesh.halfedge(idHalfedge).next_id();
+        } while (idHalfedge != idHalfedge0);
+    });
+
+    topology.iPartners.resize(nCorners);
+    std::vector<size_t> iCorners(nCorners);
+    std::iota(iCorners.begin(), iCorners.end(), size_t(0));
+
+    std::for_each(std::execution::par, iCorners.begin(), iCorners.end(), [&](size_t iCorner)
+    {
+        const auto& halfedge = mesh.halfedge(topology.idHalfedges[iCorner]);
+        topology.iPartners[iCorner] = halfedge.border() ? nullid : topology.iCorners[halfedge.partner_id()];
+    });
+
+    // Points, each labeled from the first corner reached, by rotating around its fan
+
+    topology.iPoints.assign(nCorners, nullid);
+    for (size_t iCorner = 0; iCorner < nCorners; ++iCorner)
+    {
+        if (topology.iPoints[iCorner] != nullid)
+        {
+            continue;
+        }
+
+        size_t iPoint = topology.idPointHalfedges.size();
+        topology.idPointHalfedges.push_back(topology.idHalfedges[iCorner]);
+        for_each_point_edge(mesh, topology.idHalfedges[iCorner], [&](id_type idHalfedge, bool bIncoming)
+        {
+            if (!bIncoming)
+            {
+                topology.iPoints[topology.iCorners[idHalfedge]] = iPoint;
+            }
+        });
+    }
+
+    // Edges, numbered from the lower halfedge id or the only one at a border
+
+    topology.iEdges.assign(nCorners, nullid);
+    for (size_t iCorner = 0; iCorner < nCorners; ++iCorner)
+    {
+        const auto& halfedge = mesh.halfedge(topology.idHalfedges[iCorner]);
+        if (halfedge.border() || halfedge.partner_id() > halfedge.id())
+        {
+            topology.iEdges[iCorner] = topology.iEdgeCorners.size();
+            topology.iEdgeCorners.push_back(iCorner);
+        }
+    }
+
+    std::for_each(std::execution::par, iCorners.begin(), iCorners.end(), [&](size_t iCorner)
+    {
+        if (topology.iEdges[iCorner] == nullid)
+        {
+            topology.iEdges[iCorner] = topology.iEdges[topology.iPartners[iCorner]];
+        }
+    });
+
+    topology.bCreases.resize(topology.iEdgeCorners.size());
+    std::vector<size_t> iEdges(topology.iEdgeCorners.size());
+    std::iota(iEdges.begin(), iEdges.end(), size_t(0));
+
+    std::for_each(std::execution::par, iEdges.begin(), iEdges.end(), [&](size_t iEdge)
+    {
+        topology.bCreases[iEdge] = subdivision_crease(mesh, topology.idHalfedges[topology.iEdgeCorners[iEdge]]);
+    });
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M, typename F>
+void quetzal::brep::internal::for_each_point_edge(const M& mesh, id_type idHalfedge, F f)
+{
+    // Rotate one way until back at the start, or at a border, in which case rotate the other way from the start
+    id_type id = idHalfedge;
+    do
+    {
+        f(id, false);
+        const auto& prev = mesh.halfedge(mesh.halfedge(id).prev_id());
+        if (prev.border())
+        {
+            f(prev.id(), true);
+            id = nullid;
+        }
+        else
+        {
+            id = prev.partner_id();
+        }
+    } while (id != nullid && id != idHalfedge);
+
+    if (id == nullid)
+    {
+        for (id = idHalfedge; !mesh.halfedge(id).border(); )
+        {
+            id = mesh.halfedge(mesh.halfedge(id).partner_id()).next_id();
+            f(id, false);
+        }
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+bool quetzal::brep::internal::subdivision_crease(const M& mesh, id_type idHalfedge)
+{
+    const auto& halfedge = mesh.halfedge(idHalfedge);
+    if (halfedge.border())
+    {
+        return true;
+    }
+
+    const auto& partner = halfedge.partner();
+    if (halfedge.face().surface_id() != partner.face().surface_id())
+    {
+        return true;
+    }
+
+    if constexpr (M::vertex_attributes_type::contains(geometry::AttributesFlags::Normal))
+    {
+        return !vector_eq(halfedge.attributes().normal(), partner.next().attributes().normal()) || !vector_eq(halfedge.next().attributes().normal(), partner.attributes().normal());
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::internal::subdivide_points(const M& mesh, const SubdivisionTopology& topology, bool bLoop, const std::vector<typename M::point_type>& facePositions, std::vector<typename M::point_type>& pointPositions)
+{
+    using value_type = M::value_type;
+    using point_type = M::point_type;
+
+    pointPositions.resize(topology.idPointHalfedges.size());
+    std::vector<size_t> iPoints(pointPositions.size());
+    std::iota(iPoints.begin(), iPoints.end(), size_t(0));
+
+    std::for_each(std::execution::par, iPoints.begin(), iPoints.end(), [&](size_t iPoint)
+    {
+        id_type idHalfedge = topology.idPointHalfedges[iPoint];
+        const point_type position = mesh.halfedge(idHalfedge).attributes().position();
+
+        // Sums over neighbors and over the neighbors across crease edges, the neighbor of an edge is its other end
+        point_type sumNeighbors = {};
+        point_type sumCreases = {};
+        point_type sumFaces = {};
+        size_t nEdges = 0;
+        size_t nCreases = 0;
+        size_t nFaces = 0;
+
+        for_each_point_edge(mesh, idHalfedge, [&](id_type id, bool bIncoming)
+        {
+            const auto& halfedge = mesh.halfedge(id);
+            const point_type neighbor = bIncoming ? halfedge.attributes().position() : halfedge.next().attributes().position();
+            size_t iCorner = topology.iCorners[id];
+
+            sumNeighbors += neighbor;
+            ++nEdges;
+
+            if (topology.bCreases[topology.iEdges[iCorner]])
+            {
+                sumCreases += neighbor;
+                ++nCreases;
+            }
+
+            if (!bIncoming && !bLoop)
+            {
+                sumFaces += facePositions[topology.iCornerFaces[iCorner]];
+                ++nFaces;
+            }
+        });
+
+        if (nCreases >= 3)
+        {
+            pointPositions[iPoint] = position;
+        }
+        else if (nCreases == 2)
+        {
+            pointPositions[iPoint] = value_type(0.75) * position + value_type(0.125) * sumCreases;
+        }
+        else if (bLoop)
+        {
+            value_type n = value_type(nEdges);
+            value_type c = value_type(0.375) + value_type(0.25) * std::cos(math::PiTwo<value_type> / n);
+            value_type beta = (value_type(0.625) - c * c) / n;
+            pointPositions[iPoint] = (value_type(1) - n * beta) * position + beta * sumNeighbors;
+        }
+        else
+        {
+            // (Q + 2R + (n - 3)S) / n, Q the average of the face points, R the average of the edge midpoints, S the point, with n faces and n edges
+            value_type n = value_type(nFaces);
+            point_type q = sumFaces / n;
+            point_type r = value_type(0.5) * (position + sumNeighbors / n);
+            pointPositions[iPoint] = (q + value_type(2) * r + (n - value_type(3)) * position) / n;
+        }
+    });
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::internal::subdivide_loop_level(M& mesh)
+{
+    using value_type = M::value_type;
+    using point_type = M::point_type;
+    using vertex_attributes_type = M::vertex_attributes_type;
+
+    SubdivisionTopology topology;
+    label_subdivision_topology(mesh, topology);
+    assert(topology.corner_count() == 3 * topology.face_count());
+
+    std::vector<point_type> pointPositions;
+    subdivide_points(mesh, topology, true, {}, pointPositions);
+
+    // Edge points, 3/8 of each end and 1/8 of each opposite corner, or the midpoint on a crease
+
+    std::vector<point_type> edgePositions(topology.iEdgeCorners.size());
+    std::vector<size_t> iEdges(edgePositions.size());
+    std::iota(iEdges.begin(), iEdges.end(), size_t(0));
+
+    std::for_each(std::execution::par, iEdges.begin(), iEdges.end(), [&](size_t iEdge)
+    {
+        const auto& halfedge = mesh.halfedge(topology.idHalfedges[topology.iEdgeCorners[iEdge]]);
+        const point_type a = halfedge.attributes().position();
+        const point_type b = halfedge.next().attributes().position();
+        if (topology.bCreases[iEdge])
+        {
+            edgePositions[iEdge] = value_type(0.5) * (a + b);
+            return;
+        }
+
+        const point_type c = halfedge.prev().attributes().position();
+        const point_type d = halfedge.partner().prev().attributes().position();
+        edgePositions[iEdge] = value_type(0.375) * (a + b) + value_type(0.125) * (c + d);
+    });
+
+    // Face f becomes corner triangles 4f + k at its corners k and the central triangle 4f + 3, halfedges and vertices of new face g are 3g + j
+    // Corner triangle k runs from corner k to the midpoint of edge k, then to the midpoint of edge k - 1, the central triangle from midpoint 0 to 1 to 2
+
+    size_t nFaces = topology.face_count();
+    typename M::halfedge_store_type halfedges(12 * nFaces);
+    typename M::vertex_store_type vertices(12 * nFaces);
+    typename M::face_store_type faces(4 * nFaces);
+
+    std::vector<size_t> iFaces(nFaces);
+    std::iota(iFaces.begin(), iFaces.end(), size_t(0));
+
+    std::for_each(std::execution::par, iFaces.begin(), iFaces.end(), [&](size_t iFace)
+    {
+        const auto& faceOrig = mesh.face(topology.idFaces[iFace]);
+
+        std::array<vertex_attributes_type, 3> avCorners;
+        std::array<vertex_attributes_type, 3> avMidpoints;
+        for (size_t k = 0; k < 3; ++k)
+        {
+            size_t iCorner = 3 * iFace + k;
+            avCorners[k] = mesh.halfedge(topology.idHalfedges[iCorner]).attributes();
+            avCorners[k].set_position(pointPositions[topology.iPoints[iCorner]]);
+        }
+
+        for (size_t k = 0; k < 3; ++k)
+        {
+            avMidpoints[k] = geometry::lerp(mesh.halfedge(topology.idHalfedges[3 * iFace + k]).attributes(), mesh.halfedge(topology.idHalfedges[3 * iFace + (k + 1) % 3]).attributes(), value_type(0.5));
+            avMidpoints[k].set_position(edgePositions[topology.iEdges[3 * iFace + k]]);
+        }
+
+        auto create_face = [&](id_type idFace, const std::array<const vertex_attributes_type*, 3>& avs, const std::array<id_type, 3>& idPartners)
+        {
+            id_type idHalfedge = 3 * idFace;
+            for (size_t j = 0; j < 3; ++j)
+            {
+                id_type id = idHalfedge + j;
+                halfedges[id] = {mesh, id, idPartners[j], idHalfedge + (j + 1) % 3, idHalfedge + (j + 2) % 3, id, idFace};
+                vertices[id] = {mesh, id, id, *avs[j]};
+            }
+
+            faces[idFace] = {mesh, idFace, faceOrig.surface_id(), faceOrig.submesh_id(), idHalfedge, faceOrig.attributes()};
+            faces[idFace].properties() = faceOrig.properties();
+
+            typename M::vector_type normal = subdivided_face_normal<M>(vertices, idHalfedge, 3);
+            if (!vector_eq0(normal))
+            {
+                faces[idFace].attributes().set_normal(normalize(normal));
+            }
+
+            return;
+        };
+
+        // The halves of edge k are the first edge of corner triangle k and the last edge of corner triangle k + 1, partnered across with the halves of the partner edge
+        for (size_t k = 0; k < 3; ++k)
+        {
+            size_t k1 = (k + 2) % 3;
+            size_t iPartner = topology.iPartners[3 * iFace + k];
+            size_t iPartner1 = topology.iPartners[3 * iFace + k1];
+            create_face(4 * iFace + k, {&avCorners[k], &avMidpoints[k], &avMidpoints[k1]},
+                {iPartner == nullid ? nullid : 12 * (iPartner / 3) + 3 * ((iPartner + 1) % 3) + 2,
+                 12 * iFace + 9 + k1,
+                 iPartner1 == nullid ? nullid : 12 * (iPartner1 / 3) + 3 * (iPartner1 % 3)});
+        }
+
+        create_face(4 * iFace + 3, {&avMidpoints[0], &avMidpoints[1], &avMidpoints[2]},
+            {12 * iFace + 3 * 1 + 1, 12 * iFace + 3 * 2 + 1, 12 * iFace + 3 * 0 + 1});
+    });
+
+    replace_subdivided(mesh, halfedges, vertices, faces);
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::internal::subdivide_catmull_clark_level(M& mesh)
+{
+    using value_type = M::value_type;
+    using point_type = M::point_type;
+    using vertex_attributes_type = M::vertex_attributes_type;
+
+    SubdivisionTopology topology;
+    label_subdivision_topology(mesh, topology);
+
+    size_t nFaces = topology.face_count();
+    std::vector<size_t> iFaces(nFaces);
+    std::iota(iFaces.begin(), iFaces.end(), size_t(0));
+
+    // Face points, with the average corner attributes of each face
+
+    std::vector<point_type> facePositions(nFaces);
+    std::vector<vertex_attributes_type> faceAttributes(nFaces);
+
+    std::for_each(std::execution::par, iFaces.begin(), iFaces.end(), [&](size_t iFace)
+    {
+        size_t iCornerFirst = topology.iCornersFirst[iFace];
+        vertex_attributes_type av = mesh.halfedge(topology.idHalfedges[iCornerFirst]).attributes();
+        for (size_t iCorner = iCornerFirst + 1; iCorner < topology.iCornersFirst[iFace + 1]; ++iCorner)
+        {
+            av = geometry::lerp(av, mesh.halfedge(topology.idHalfedges[iCorner]).attributes(), value_type(1) / value_type(iCorner - iCornerFirst + 1));
+        }
+
+        facePositions[iFace] = av.position();
+        faceAttributes[iFace] = av;
+    });
+
+    std::vector<point_type> pointPositions;
+    subdivide_points(mesh, topology, false, facePositions, pointPositions);
+
+    // Edge points, the average of the ends and the face points on each side, or the midpoint on a crease
+
+    std::vector<point_type> edgePositions(topology.iEdgeCorners.size());
+    std::vector<size_t> iEdges(edgePositions.size());
+    std::iota(iEdges.begin(), iEdges.end(), size_t(0));
+
+    std::for_each(std::execution::par, iEdges.begin(), iEdges.end(), [&](size_t iEdge)
+    {
+        size_t iCorner = topology.iEdgeCorners[iEdge];
+        const auto& halfedge = mesh.halfedge(topology.idHalfedges[iCorner]);
+        const point_type a = halfedge.attributes().position();
+        const point_type b = halfedge.next().attributes().position();
+        if (topology.bCreases[iEdge])
+        {
+            edgePositions[iEdge] = value_type(0.5) * (a + b);
+            return;
+        }
+
+        edgePositions[iEdge] = value_type(0.25) * (a + b + facePositions[topology.iCornerFaces[iCorner]] + facePositions[topology.iCornerFaces[topology.iPartners[iCorner]]]);
+    });
+
+    // Corner c of the old mesh becomes quad c, from the corner to the midpoint of its edge, the face point, and the midpoint of the previous edge
+    // Halfedges and vertices of quad c are 4c + j
+
+    size_t nCorners = topology.corner_count();
+    typename M::halfedge_store_type halfedges(4 * nCorners);
+    typename M::vertex_store_type vertices(4 * nCorners);
+    typename M::face_store_type faces(nCorners);
+
+    std::for_each(std::execution::par, iFaces.begin(), iFaces.end(), [&](size_t iFace)
+    {
+        const auto& faceOrig = mesh.face(topology.idFaces[iFace]);
+
+        for (size_t iCorner = topology.iCornersFirst[iFace]; iCorner < topology.iCornersFirst[iFace + 1]; ++iCorner)
+        {
+            size_t iNext = topology.next(iCorner, iFace);
+            size_t iPrev = topology.prev(iCorner, iFace);
+            const auto& av = mesh.halfedge(topology.idHalfedges[iCorner]).attributes();
+
+            std::array<vertex_attributes_type, 4> avs;
+            avs[0] = av;
+            avs[0].set_position(pointPositions[topology.iPoints[iCorner]]);
+            avs[1] = geometry::lerp(av, mesh.halfedge(topology.idHalfedges[iNext]).attributes(), value_type(0.5));
+            avs[1].set_position(edgePositions[topology.iEdges[iCorner]]);
+            avs[2] = faceAttributes[iFace];
+            avs[3] = geometry::lerp(mesh.halfedge(topology.idHalfedges[iPrev]).attributes(), av, value_type(0.5));
+            avs[3].set_position(edgePositions[topology.iEdges[iPrev]]);
+
+            // The halves of an edge are the first edge of the quad at its start and the last edge of the quad at its end, partnered across with the halves of the partner edge
+            size_t iPartner = topology.iPartners[iCorner];
+            size_t iPartnerPrev = topology.iPartners[iPrev];
+            std::array<id_type, 4> idPartners =
+            {
+                iPartner == nullid ? nullid : 4 * topology.next(iPartner, topology.iCornerFaces[iPartner]) + 3,
+                4 * iNext + 2,
+                4 * iPrev + 1,
+                iPartnerPrev == nullid ? nullid : 4 * iPartnerPrev
+            };
+
+            id_type idFace = iCorner;
+            id_type idHalfedge = 4 * idFace;
+            for (size_t j = 0; j < 4; ++j)
+            {
+                id_type id = idHalfedge + j;
+                halfedges[id] = {mesh, id, idPartners[j], idHalfedge + (j + 1) % 4, idHalfedge + (j + 3) % 4, id, idFace};
+                vertices[id] = {mesh, id, id, avs[j]};
+            }
+
+            faces[idFace] = {mesh, idFace, faceOrig.surface_id(), faceOrig.submesh_id(), idHalfedge, faceOrig.attributes()};
+            faces[idFace].properties() = faceOrig.properties();
+
+            typename M::vector_type normal = subdivided_face_normal<M>(vertices, idHalfedge, 4);
+            if (!vector_eq0(normal))
+            {
+                faces[idFace].attributes().set_normal(normalize(normal));
+            }
+        }
+    });
+
+    replace_subdivided(mesh, halfedges, vertices, faces);
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::internal::replace_subdivided(M& mesh, typename M::halfedge_store_type& halfedges, typename M::vertex_store_type& vertices, typename M::face_store_type& faces)
+{
+    for (auto& surface : mesh.surfaces())
+    {
+        surface.face_ids().clear();
+        surface.set_regenerate_perimeters();
+    }
+
+    for (auto& submesh : mesh.submeshes())
+    {
+        submesh.face_ids().clear();
+    }
+
+    // The previous level is released here
+    mesh.halfedge_store() = std::move(halfedges);
+    mesh.vertex_store() = std::move(vertices);
+    mesh.face_store() = std::move(faces);
+
+    mesh.link_faces(0);
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+typename M::vector_type quetzal::brep::internal::subdivided_face_normal(const typename M::vertex_store_type& vertices, id_type idVertexFirst, size_t nCorners)
+{
+    // Newell's method, for the quads of Catmull-Clark, which are not planar in general
+    typename M::vector_type normal = {};
+    for (size_t j = 0; j < nCorners; ++j)
+    {
+        const auto& a = vertices[idVertexFirst + j].attributes().position();
+        const auto& b = vertices[idVertexFirst + (j + 1) % nCorners].attributes().position();
+        normal += cross(a, b);
+    }
+
+    return normal;
+}
+
+#endif // QUETZAL_BREP_MESH_SUBDIVISION_HPP
@@ -10,7 +10,11 @@
 #include "quetzal/math/DimensionReducer.hpp"
 #include "quetzal/math/transformation_matrix.hpp"
 #include "quetzal/geometry/AxisAlignedBoundingBox.hpp"
+#include "quetzal/geometry/Plane.hpp"
 #include "quetzal/geometry/Polygon.hpp"
+#include <algorithm>
+#include <execution>
+#include <vector>
 
 namespace quetzal::brep
 {
@@ -21,9 +25,46 @@ namespace quetzal::brep
     template<typename M>
     void calculate_planar_surface_texcoords(M& mesh, id_type idSurface);
 
+    // Batch calculate_planar_surface_texcoords, surfaces are processed in parallel, each with its projection set up once
+    template<typename M>
+    void calculate_planar_surface_texcoords(M& mesh, const std::vector<id_type>& idSurfaces);
+
+    // All planar surfaces of mesh, others such as the curved side of a cylinder are left unchanged
+    template<typename M>
+    void calculate_planar_surface_texcoords(M& mesh);
+
     template<typename M>
     void calculate_face_texcoords(M& mesh, id_type idFace);
 
+    //--------------------------------------------------------------------------
+    // Affine mapping from positions to texcoords in the plane of a reference face, from the texcoords of its first three corners
+    // Set up once and applied to any number of positions, in place of interpolate_face_texcoord per position
+    template<typename Traits>
+    class FaceTexcoordMapping
+    {
+    public:
+
+        using point_type = Traits::point_type;
+        using texcoord_type = Face<Traits>::mesh_type::vertex_attributes_type::texcoord_type;
+
+        explicit FaceTexcoordMapping(const Face<Traits>& faceReference);
+        FaceTexcoordMapping(const FaceTexcoordMapping&) = default;
+        FaceTexcoordMapping(FaceTexcoordMapping&&) noexcept = default;
+        ~FaceTexcoordMapping() = default;
+
+        FaceTexcoordMapping& operator=(const FaceTexcoordMapping&) = default;
+        FaceTexcoordMapping& operator=(FaceTexcoordMapping&&) = default;
+
+        texcoord_type operator()(const point_type& position) const;
+
+    private:
+
+        math::DimensionReducer<typename Traits::vector_traits> m_dr;
+        texcoord_type m_point0;
+        texcoord_type m_texcoord0;
+        math::Matrix<typename Traits::value_type, 2, 2> m_matrix;
+    };
+
     // Add texcoords to face by interpolating from texcoords of faceReference
     template<typename Traits>
     void interpolate_face_texcoords(const Face<Traits>& faceReference, Face<Traits>& face);
@@ -36,6 +77,23 @@ namespace quetzal::brep
     template<typename Traits>
     typename Face<Traits>::mesh_type::vertex_attributes_type::texcoord_type interpolate_face_texcoord(const Face<Traits>& face, const typename Traits::point_type& position);
 
+namespace internal
+{
+
+    // Unit surface normal shared by every face, and every corner in one plane
+    template<typename M>
+    bool planar_surface(const M& mesh, id_type idSurface);
+
+    // Append the corners of the face and its holes
+    template<typename M>
+    void append_face_corners(const M& mesh, id_type idFace, std::vector<id_type>& idHalfedges);
+
+    // Project the corners along normal and scale them to their bounds, u increasing along the reduced x axis and v decreasing along the reduced y axis
+    template<typename M>
+    void set_planar_texcoords(M& mesh, const typename M::vector_type& normal, const std::vector<id_type>& idHalfedges);
+
+} // namespace internal
+
 } // namespace quetzal::brep
 
 //------------------------------------------------------------------------------
@@ -52,53 +110,43 @@ void quetzal::brep::calculate_surface_texcoords(M& mesh, id_type idSurface)
 template<typename M>
 void quetzal::brep::calculate_planar_surface_texcoords(M& mesh, id_type idSurface)
 {
-    using value_type = M::value_type;
-    using texcoord_type = M::vertex_attributes_type::texcoord_type;
-
-    typename M::surface_type& surface = mesh.surface(idSurface);
-	math::DimensionReducer<typename M::vector_traits> dr(surface.attributes().normal());
-
-    std::vector<texcoord_type> points;
-    for (const auto& face : surface.faces())
+    std::vector<id_type> idHalfedges;
+    for (id_type idFace : mesh.surface(idSurface).face_ids())
     {
-        for (const auto& halfedge : face.halfedges())
-        {
-            points.emplace_back(dr.reduce(halfedge.attributes().position()));
-        }
-
-        for (auto& hole : face.holes())
-        {
-            for (auto& halfedge : hole.halfedges())
-            {
-                points.emplace_back(dr.reduce(halfedge.attributes().position()));
-            }
-        }
+        internal::append_face_corners(mesh, idFace, idHalfedges);
     }
 
-    geometry::AxisAlignedBoundingBox<texcoord_type::traits_type> aabb(points);
-    auto extent = aabb.extent();
+    internal::set_planar_texcoords(mesh, mesh.surface(idSurface).attributes().normal(), idHalfedges);
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::calculate_planar_surface_texcoords(M& mesh, const std::vector<id_type>& idSurfaces)
+{
+    // Surfaces have disjoint faces, and each corner has its own vertex, so surfaces write disjoint attributes
+    std::for_each(std::execution::par, idSurfaces.begin(), idSurfaces.end(), [&](id_type idSurface)
+    {
+        calculate_planar_surface_texcoords(mesh, idSurface);
+    });
 
-    auto to_texcoord = [&](const texcoord_type& position) -> texcoord_type { return {(position.x() - aabb.lower().x()) / extent.x(), value_type(1) - (position.y() - aabb.lower().y()) / extent.y()}; };
+    return;
+}
 
-    size_t i = 0;
-    for (auto& face : surface.faces())
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::calculate_planar_surface_texcoords(M& mesh)
+{
+    std::vector<id_type> idSurfaces;
+    for (const auto& surface : mesh.surfaces())
     {
-        for (auto& halfedge : face.halfedges())
+        if (internal::planar_surface(mesh, surface.id()))
         {
-            halfedge.attributes().set_texcoord(to_texcoord(points[i]));
-            ++i;
-        }
-
-        for (auto& hole : face.holes())
-        {
-            for (auto& halfedge : hole.halfedges())
-            {
-                halfedge.attributes().set_texcoord(to_texcoord(points[i]));
-                ++i;
-            }
+            idSurfaces.push_back(surface.id());
         }
     }
 
+    calculate_planar_surface_texcoords(mesh, idSurfaces);
     return;
 }
 
@@ -106,30 +154,41 @@ void quetzal::brep::calculate_planar_surface_texcoords(M& mesh, id_type idSurfac
 template<typename M>
 void quetzal::brep::calculate_face_texcoords(M& mesh, id_type idFace)
 {
-    using value_type = M::value_type;
-    using texcoord_type = M::vertex_attributes_type::texcoord_type;
-
-    typename M::face_type& face = mesh.face(idFace);
+    std::vector<id_type> idHalfedges;
+    id_type idHalfedge = mesh.face(idFace).halfedge_id();
+    do
+    {
+        idHalfedges.push_back(idHalfedge);
+        idHalfedge = mesh.halfedge(idHalfedge).next_id();
+    } while (idHalfedge != mesh.face(idFace).halfedge_id());
 
-	math::DimensionReducer<typename M::vector_traits> dr(face.attributes().normal());
+    internal::set_planar_texcoords(mesh, mesh.face(idFace).attributes().normal(), idHalfedges);
+    return;
+}
 
-    std::vector<texcoord_type> points;
-    for (const auto& halfedge : face.halfedges())
+//------------------------------------------------------------------------------
+template<typename Traits>
+void quetzal::brep::interpolate_face_texcoords(const Face<Traits>& faceReference, Face<Traits>& face)
+{
+    FaceTexcoordMapping<Traits> mapping(faceReference);
+    for (auto& halfedge : face.halfedges())
     {
-        texcoord_type position = dr.reduce(halfedge.attributes().position());
-        points.emplace_back(position);
+        halfedge.attributes().set_texcoord(mapping(halfedge.attributes().position()));
     }
 
-    geometry::AxisAlignedBoundingBox<texcoord_type::traits_type> aabb(points);
-    auto extent = aabb.extent();
+    return;
+}
 
-    auto to_texcoord = [&](const texcoord_type& position) -> texcoord_type { return {(position.x() - aabb.lower().x()) / extent.x(), value_type(1) - (position.y() - aabb.lower().y()) / extent.y()}; };
+//------------------------------------------------------------------------------
+template<typename Traits>
+void quetzal::brep::interpolate_hole_texcoords(const Face<Traits>& faceReference, Hole<Traits>& hole)
+{
+    // this produces texcoords out of range 0..1 ...
 
-    size_t i = 0;
-    for (auto& halfedge : face.halfedges())
+    FaceTexcoordMapping<Traits> mapping(faceReference);
+    for (auto& halfedge : hole.halfedges())
     {
-        halfedge.attributes().set_texcoord(to_texcoord(points[i]));
-        ++i;
+        halfedge.attributes().set_texcoord(mapping(halfedge.attributes().position()));
     }
 
     return;
@@ -137,83 +196,145 @@ void quetzal::brep::calculate_face_texcoords(M& mesh, id_type idFace)
 
 //------------------------------------------------------------------------------
 template<typename Traits>
-void quetzal::brep::interpolate_face_texcoords(const Face<Traits>& faceReference, Face<Traits>& face)
+typename quetzal::brep::Face<Traits>::mesh_type::vertex_attributes_type::texcoord_type quetzal::brep::interpolate_face_texcoord(const Face<Traits>& face, const typename Traits::point_type& position)
 {
-    math::DimensionReducer<typename Traits::vector_traits> dr(faceReference.attributes().normal());
-    auto polygon = to_polygon(faceReference, dr);
+    return FaceTexcoordMapping<Traits>(face)(position);
+}
 
+//------------------------------------------------------------------------------
+template<typename Traits>
+quetzal::brep::FaceTexcoordMapping<Traits>::FaceTexcoordMapping(const Face<Traits>& faceReference) :
+    m_dr(faceReference.attributes().normal()),
+    m_point0(),
+    m_texcoord0(),
+    m_matrix()
+{
     // consider changing the vertex used for 2 ...
     // if texcoords have u or v of 0 or 1, then those vertices should be chosen ...
     // need to make sure these form an orthogonal basis ...
-    auto point0 = polygon.vertex(0);
-    auto point1 = polygon.vertex(1);
-    auto point2 = polygon.vertex(2);
-    auto texcoord0 = faceReference.halfedge().attributes().texcoord();
-    auto texcoord1 = faceReference.halfedge().next().attributes().texcoord();
-    auto texcoord2 = faceReference.halfedge().next().next().attributes().texcoord();
+    const auto& halfedge0 = faceReference.halfedge();
+    const auto& halfedge1 = halfedge0.next();
+    const auto& halfedge2 = halfedge1.next();
+
+    m_point0 = m_dr.reduce(halfedge0.attributes().position());
+    texcoord_type point1 = m_dr.reduce(halfedge1.attributes().position());
+    texcoord_type point2 = m_dr.reduce(halfedge2.attributes().position());
+    m_texcoord0 = halfedge0.attributes().texcoord();
+    texcoord_type texcoord1 = halfedge1.attributes().texcoord();
+    texcoord_type texcoord2 = halfedge2.attributes().texcoord();
+
+    m_matrix = math::linear_mapping(point1 - m_point0, point2 - m_point0, texcoord1 - m_texcoord0, texcoord2 - m_texcoord0);
+}
 
-    auto matrix = math::linear_mapping(point1 - point0, point2 - point0, texcoord1 - texcoord0, texcoord2 - texcoord0);
+//------------------------------------------------------------------------------
+template<typename Traits>
+typename quetzal::brep::FaceTexcoordMapping<Traits>::texcoord_type quetzal::brep::FaceTexcoordMapping<Traits>::operator()(const point_type& position) const
+{
+    return (m_dr.reduce(position) - m_point0) * m_matrix + m_texcoord0;
+}
 
-    for (auto& halfedge : face.halfedges())
+//------------------------------------------------------------------------------
+template<typename M>
+bool quetzal::brep::internal::planar_surface(const M& mesh, id_type idSurface)
+{
+    const auto& surface = mesh.surface(idSurface);
+    const auto normal = surface.attributes().normal();
+    if (!normal.unit() || surface.face_ids().empty())
     {
-        auto point = dr.reduce(halfedge.attributes().position());
-        halfedge.attributes().set_texcoord((point - point0) * matrix + texcoord0);
+        return false;
     }
 
-    return;
-}
+    const auto& faceFirst = mesh.face(*surface.face_ids().begin());
+    geometry::Plane<typename M::vector_traits> plane(faceFirst.halfedge().attributes().position(), normal);
 
-//------------------------------------------------------------------------------
-template<typename Traits>
-void quetzal::brep::interpolate_hole_texcoords(const Face<Traits>& faceReference, Hole<Traits>& hole)
-{
-    // this produces texcoords out of range 0..1 ...
+    std::vector<id_type> idHalfedges;
+    for (id_type idFace : surface.face_ids())
+    {
+        if (!vector_eq(mesh.face(idFace).attributes().normal(), normal))
+        {
+            return false;
+        }
 
-    math::DimensionReducer<typename Traits::vector_traits> dr(faceReference.attributes().normal());
-    auto polygon = to_polygon(faceReference, dr);
+        idHalfedges.clear();
+        append_face_corners(mesh, idFace, idHalfedges);
+        for (id_type idHalfedge : idHalfedges)
+        {
+            if (!plane.contains(mesh.halfedge(idHalfedge).attributes().position()))
+            {
+                return false;
+            }
+        }
+    }
 
-    // consider changing the vertex used for 2 ...
-    // if texcoords have u or v of 0 or 1, then those vertices should be chosen ...
-    // need to make sure these form an orthogonal basis ...
-    auto point0 = polygon.vertex(0);
-    auto point1 = polygon.vertex(1);
-    auto point2 = polygon.vertex(2);
-    auto texcoord0 = faceReference.halfedge().attributes().texcoord();
-    auto texcoord1 = faceReference.halfedge().next().attributes().texcoord();
-    auto texcoord2 = faceReference.halfedge().next().next().attributes().texcoord();
+    return true;
+}
 
-    auto matrix = math::linear_mapping(point1 - point0, point2 - point0, texcoord1 - texcoord0, texcoord2 - texcoord0);
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::internal::append_face_corners(const M& mesh, id_type idFace, std::vector<id_type>& idHalfedges)
+{
+    const auto& face = mesh.face(idFace);
+    id_type idHalfedge = face.halfedge_id();
+    do
+    {
+        idHalfedges.push_back(idHalfedge);
+        idHalfedge = mesh.halfedge(idHalfedge).next_id();
+    } while (idHalfedge != face.halfedge_id());
 
-    for (auto& halfedge : hole.halfedges())
+    for (const auto& hole : face.holes())
     {
-        auto point = dr.reduce(halfedge.attributes().position());
-        auto zzz = (point - point0) * matrix + texcoord0;
-        halfedge.attributes().set_texcoord((point - point0) * matrix + texcoord0);
+        idHalfedge = hole.halfedge_id();
+        do
+        {
+            idHalfedges.push_back(idHalfedge);
+            idHalfedge = mesh.halfedge(idHalfedge).next_id();
+        } while (idHalfedge != hole.halfedge_id());
     }
 
     return;
 }
 
 //------------------------------------------------------------------------------
-template<typename Traits>
-typename quetzal::brep::Face<Traits>::mesh_type::vertex_attributes_type::texcoord_type quetzal::brep::interpolate_face_texcoord(const Face<Traits>& face, const typename Traits::point_type& position)
+template<typename M>
+void quetzal::brep::internal::set_planar_texcoords(M& mesh, const typename M::vector_type& normal, const std::vector<id_type>& idHalfedges)
 {
-    math::DimensionReducer<typename Traits::vector_traits> dr(face.attributes().normal());
-    auto polygon = to_polygon(face, dr);
+    using value_type = M::value_type;
 
-    // consider changing the vertex used for 2 ...
-    // if texcoords have u or v of 0 or 1, then those vertices should be chosen ...
-    auto point0 = polygon.vertex(0);
-    auto point1 = polygon.vertex(1);
-    auto point2 = polygon.vertex(2);
-    auto texcoord0 = face.halfedge().attributes().texcoord();
-    auto texcoord1 = face.halfedge().next().attributes().texcoord();
-    auto texcoord2 = face.halfedge().next().next().attributes().texcoord();
+    if (idHalfedges.empty())
+    {
+        return;
+    }
+
+    // Reduced coordinates are gathered into separate arrays so the bounds and the mapping are simple loops over contiguous values
+    math::DimensionReducer<typename M::vector_traits> dr(normal);
+    std::vector<value_type> xs(idHalfedges.size());
+    std::vector<value_type> ys(idHalfedges.size());
+    for (size_t i = 0; i < idHalfedges.size(); ++i)
+    {
+        auto point = dr.reduce(mesh.halfedge(idHalfedges[i]).attributes().position());
+        xs[i] = point.x();
+        ys[i] = point.y();
+    }
 
-    auto matrix = math::linear_mapping(point1 - point0, point2 - point0, texcoord1 - texcoord0, texcoord2 - texcoord0);
+    auto [xMin, xMax] = std::minmax_element(xs.begin(), xs.end());
+    auto [yMin, yMax] = std::minmax_element(ys.begin(), ys.end());
+    value_type x0 = *xMin;
+    value_type y0 = *yMin;
+    value_type dx = *xMax - x0;
+    value_type dy = *yMax - y0;
 
-    auto point = dr.reduce(position);
-    return (point - point0) * matrix + texcoord0;
+    for (size_t i = 0; i < idHalfedges.size(); ++i)
+    {
+        xs[i] = (xs[i] - x0) / dx;
+        ys[i] = value_type(1) - (ys[i] - y0) / dy;
+    }
+
+    for (size_t i = 0; i < idHalfedges.size(); ++i)
+    {
+        mesh.halfedge(idHalfedges[i]).attributes().set_texcoord({xs[i], ys[i]});
+    }
+
+    return;
 }
 
 #endif // QUETZAL_BREP_MESH_TEXCOORD_HPP
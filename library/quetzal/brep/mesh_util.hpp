@@ -13,8 +13,12 @@
 #include "quetzal/geometry/Attributes.hpp"
 #include "quetzal/geometry/Points.hpp"
 #include "quetzal/geometry/Polygon.hpp"
+#include "quetzal/geometry/SpatialHash.hpp"
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <functional>
+#include <limits>
 #include <map>
 
 //#include "validation.hpp" // ...
@@ -165,6 +169,19 @@ namespace quetzal::brep
     template<typename M>
     std::array<id_type, 2> find_partner_halfedges(M& mesh, id_type idFaceA, id_type idFaceB);
 
+    // As above with positions matched within epsilon, and only if every halfedge of face A has a reversed counterpart in face B
+    template<typename M>
+    std::array<id_type, 2> find_partner_halfedges(const M& mesh, id_type idFaceA, id_type idFaceB, typename M::value_type epsilon);
+
+namespace internal
+{
+
+    // Positions within a few ulp of the larger of the edge length and the coordinates, the distance test SpatialHash queries apply
+    template<typename M>
+    bool coincident_on_edge(const M& mesh, id_type idHalfedge, const typename M::point_type& a, const typename M::point_type& b);
+
+} // namespace internal
+
 } // namespace quetzal::brep
 
 //------------------------------------------------------------------------------
@@ -392,7 +409,7 @@ template<typename M>
 void quetzal::brep::split_edge(M& mesh, id_type idHalfedge, const typename M::vertex_attributes_type& av, const typename M::vertex_attributes_type& avPartner)
 {
     assert(!mesh.halfedge(idHalfedge).deleted());
-    assert(vector_eq(av.position(), avPartner.position()));
+    assert(internal::coincident_on_edge(mesh, idHalfedge, av.position(), avPartner.position()));
 
     const auto& halfedgeOrig = mesh.halfedge(idHalfedge);
     id_type idHalfedgeNext = halfedgeOrig.next_id();
@@ -413,6 +430,16 @@ void quetzal::brep::split_edge(M& mesh, id_type idHalfedge, const typename M::ve
     halfedge.next().set_prev_id(idHalfedge0);
     halfedge.set_next_id(idHalfedge0);
     halfedge.set_partner_id(idHalfedge1);
+
+    // The new halfedges extend any perimeter on either side of the edge
+    for (id_type idFace : {idHalfedgeFace, idPartnerFace})
+    {
+        if (idFace != nullid && mesh.face(idFace).surface_id() != nullid)
+        {
+            mesh.face(idFace).surface().update_perimeters(idFace);
+        }
+    }
+
     return;
 }
 
@@ -428,8 +455,8 @@ void quetzal::brep::split_edge(M& mesh, id_type idHalfedge, const typename M::po
     const typename M::vertex_attributes_type avp0 = halfedge.partner().next().attributes();
     const typename M::vertex_attributes_type avp1 = halfedge.partner().attributes();
 
-    assert(vector_eq(av0.position(), avp0.position()));
-    assert(vector_eq(av1.position(), avp1.position()));
+    assert(internal::coincident_on_edge(mesh, idHalfedge, av0.position(), avp0.position()));
+    assert(internal::coincident_on_edge(mesh, idHalfedge, av1.position(), avp1.position()));
 
     auto t = to_segment(halfedge).projection_parameter(position);
     typename M::vertex_attributes_type av = lerp(av0, av1, t);
@@ -456,8 +483,8 @@ void quetzal::brep::split_edge(M& mesh, id_type idHalfedge, const typename M::va
     const typename M::vertex_attributes_type avp0 = halfedge.partner().next().attributes();
     const typename M::vertex_attributes_type avp1 = halfedge.partner().attributes();
 
-    assert(vector_eq(av0.position(), avp0.position()));
-    assert(vector_eq(av1.position(), avp1.position()));
+    assert(internal::coincident_on_edge(mesh, idHalfedge, av0.position(), avp0.position()));
+    assert(internal::coincident_on_edge(mesh, idHalfedge, av1.position(), avp1.position()));
 
     const typename M::vertex_attributes_type av = lerp(av0, av1, t);
     const typename M::vertex_attributes_type avPartner = lerp(avp0, avp1, t);
@@ -486,8 +513,8 @@ void quetzal::brep::split_edge(M& mesh, id_type idHalfedge, size_t n)
     const typename M::vertex_attributes_type avp0 = halfedge.partner().next().attributes();
     const typename M::vertex_attributes_type avp1 = halfedge.partner().attributes();
 
-    assert(vector_eq(av0.position(), avp0.position()));
-    assert(vector_eq(av1.position(), avp1.position()));
+    assert(internal::coincident_on_edge(mesh, idHalfedge, av0.position(), avp0.position()));
+    assert(internal::coincident_on_edge(mesh, idHalfedge, av1.position(), avp1.position()));
 
     for (size_t i = 1; i < n; ++i)
     {
@@ -514,8 +541,9 @@ void quetzal::brep::split_face(M& mesh, id_type idHalfedgeA, id_type idHalfedgeB
     id_type idSurface = mesh.face(idFaceA).surface_id();
 assert(idSurface != nullid); // ...
 
+    // The new face is linked to the surface once its halfedges are connected so that only the perimeters it touches are updated
     mesh.face(idFaceA).set_halfedge_id(idHalfedgeA);
-    id_type idFaceB = mesh.create_face(idSurface, idHalfedgeB, mesh.face(idFaceA).attributes());
+    id_type idFaceB = mesh.create_face(nullid, idHalfedgeB, mesh.face(idFaceA).attributes());
 
     for (id_type id = idHalfedgeB; id != idHalfedgeA; id = mesh.halfedge(id).next_id())
     {
@@ -526,6 +554,7 @@ assert(idSurface != nullid); // ...
     assert(mesh.halfedge(idHalfedgeB).face_id() == idFaceB);
 
     connect(mesh, idHalfedgeA, idHalfedgeB, idFaceA, idFaceB);
+    mesh.move_face(idFaceB, idSurface);
     return;
 }
 
@@ -555,8 +584,9 @@ void quetzal::brep::split_face(M& mesh, id_type idHalfedgeA, id_type idHalfedgeB
         idHalfedgeB = split_edge(mesh, idHalfedgeB, points.back());
     }
 
+    // The new face is linked to the surface once its halfedges are connected so that only the perimeters it touches are updated
     mesh.face(idFaceA).set_halfedge_id(idHalfedgeA);
-    id_type idFaceB = mesh.create_face(idSurface, idHalfedgeB, mesh.face(idFaceA).attributes());
+    id_type idFaceB = mesh.create_face(nullid, idHalfedgeB, mesh.face(idFaceA).attributes());
 
     for (id_type id = idHalfedgeB; id != idHalfedgeA; id = mesh.halfedge(id).next_id())
     {
@@ -567,6 +597,12 @@ void quetzal::brep::split_face(M& mesh, id_type idHalfedgeA, id_type idHalfedgeB
     assert(mesh.halfedge(idHalfedgeB).face_id() == idFaceB);
 
     connect(mesh, idHalfedgeA, idHalfedgeB, idFaceA, idFaceB, points);
+
+    if (idSurface != nullid)
+    {
+        mesh.move_face(idFaceB, idSurface);
+    }
+
     return;
 }
 
@@ -1118,4 +1154,80 @@ std::array<quetzal::id_type, 2> quetzal::brep::find_partner_halfedges(M& mesh, i
     return {nullid, nullid};
 }
 
+//------------------------------------------------------------------------------
+template<typename M>
+std::array<quetzal::id_type, 2> quetzal::brep::find_partner_halfedges(const M& mesh, id_type idFaceA, id_type idFaceB, typename M::value_type epsilon)
+{
+    using hash_type = geometry::SpatialHash<typename M::vector_traits, id_type>;
+
+    const auto& halfedges = mesh.halfedge_store();
+    const auto& vertices = mesh.vertex_store();
+
+    auto position = [&](id_type idHalfedge) -> typename M::point_type
+    {
+        return vertices[halfedges[idHalfedge].vertex_id()].attributes().position();
+    };
+
+    auto reversed = [&](id_type idHalfedgeA, id_type idHalfedgeB) -> bool
+    {
+        return hash_type::within(position(idHalfedgeA), position(halfedges[idHalfedgeB].next_id()), epsilon)
+            && hash_type::within(position(halfedges[idHalfedgeA].next_id()), position(idHalfedgeB), epsilon);
+    };
+
+    // Halfedges of face B indexed by initial position, a candidate starts where the first halfedge of face A ends
+    hash_type index(epsilon);
+    id_type idHalfedgeB0 = mesh.face(idFaceB).halfedge_id();
+    id_type idHalfedgeB = idHalfedgeB0;
+    do
+    {
+        index.insert(position(idHalfedgeB), idHalfedgeB);
+        idHalfedgeB = halfedges[idHalfedgeB].next_id();
+    } while (idHalfedgeB != idHalfedgeB0);
+
+    id_type idHalfedgeA = mesh.face(idFaceA).halfedge_id();
+    std::array<id_type, 2> idHalfedges = {nullid, nullid};
+    index.visit(position(halfedges[idHalfedgeA].next_id()), epsilon, [&](const auto& entry) -> bool
+    {
+        idHalfedgeB = entry.value;
+        if (!reversed(idHalfedgeA, idHalfedgeB))
+        {
+            return true;
+        }
+
+        // Face A runs forward while face B runs backward
+        id_type idA = halfedges[idHalfedgeA].next_id();
+        id_type idB = halfedges[idHalfedgeB].prev_id();
+        while (idA != idHalfedgeA && idB != idHalfedgeB && reversed(idA, idB))
+        {
+            idA = halfedges[idA].next_id();
+            idB = halfedges[idB].prev_id();
+        }
+
+        if (idA == idHalfedgeA && idB == idHalfedgeB)
+        {
+            idHalfedges = {idHalfedgeA, idHalfedgeB};
+            return false;
+        }
+
+        return true;
+    });
+
+    return idHalfedges;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+bool quetzal::brep::internal::coincident_on_edge(const M& mesh, id_type idHalfedge, const typename M::point_type& a, const typename M::point_type& b)
+{
+    const auto& halfedge = mesh.halfedge(idHalfedge);
+    typename M::value_type scale = (halfedge.next().attributes().position() - halfedge.attributes().position()).norm();
+    for (size_t i = 0; i < M::vector_traits::dimension; ++i)
+    {
+        scale = std::max(scale, std::abs(a[i]));
+    }
+
+    typename M::value_type radius = M::val(math::ulpDefault) * std::numeric_limits<typename M::value_type>::epsilon() * scale;
+    return geometry::SpatialHash<typename M::vector_traits, id_type>::within(a, b, radius);
+}
+
 #endif // QUETZAL_BREP_MESH_UTIL_HPP
@@ -8,21 +8,59 @@
 #include "id.hpp"
 #include "mesh_geometry.hpp"
 #include "mesh_util.hpp"
+#include "quetzal/common/Timestamp.hpp"
+#include "quetzal/geometry/predicates.hpp"
 #include "quetzal/math/DimensionReducer.hpp"
 #include "quetzal/triangulation/triangulation.hpp"
+#include <algorithm>
+#include <array>
+#include <execution>
+#include <numeric>
+#include <vector>
 #include <cassert>
 
 namespace quetzal::brep
 {
 
+    // Method used by triangulate for a face
+    enum class TriangulationStrategy
+    {
+        None, // Already a triangle
+        Quad, // Convex quad, shorter diagonal
+        Convex, // Fan
+        Ear, // Ear clipping, nonconvex without holes and few vertices
+        Cdt // Constrained Delaunay, holes or many vertices
+    };
+
+    // Face counts and elapsed seconds, indexed by TriangulationStrategy
+    struct TriangulationStatistics
+    {
+        std::array<size_t, 5> faces = {};
+        std::array<double, 5> seconds = {};
+    };
+
+    // Ear clipping is quadratic in the number of vertices, larger faces use the CDT
+    template<typename M>
+    TriangulationStrategy triangulation_strategy(const M& mesh, id_type idFace, size_t nEarMax = 32);
+
     // Uses only existing vertex positions
     template<typename M>
-    void triangulate(M& mesh);
+    void triangulate(M& mesh, TriangulationStatistics* pStatistics = nullptr);
+
+    // Same result as triangulate, ids included
+    // Faces are triangulated in parallel with a triangulator per thread, then the mesh is edited in a single serial pass in face order
+    template<typename M>
+    void triangulate_parallel(M& mesh);
+
+    // Triangulates face using strategy, triangulator is used for Cdt
+    template<typename M>
+    void triangulate_face(M& mesh, id_type idFace, TriangulationStrategy strategy, triangulation::Triangulator& triangulator);
 
     template<typename M>
     void triangulate_face_quad(M& mesh, id_type idFace);
 
     // Uses only existing vertex positions
+    // Reflex vertices are cached and only they are tested against candidate ears, falls back to the CDT if no ear is found
     template<typename M>
     void triangulate_face_ear(M& mesh, id_type idFace);
 
@@ -30,6 +68,10 @@ namespace quetzal::brep
     template<typename M>
     void triangulate_face_cdt(M& mesh, id_type idFace);
 
+    // Reuses the storage of triangulator, which is cleared first
+    template<typename M>
+    void triangulate_face_cdt(M& mesh, id_type idFace, triangulation::Triangulator& triangulator);
+
     // Delaunay triangulation of all faces in a surface
     template<typename M>
     void triangulate_surface(M& mesh, id_type idSurface);
@@ -59,31 +101,230 @@ namespace quetzal::brep
     template<typename M>
     void triangulate_face_central_vertex(M& mesh, id_type idFace, const typename M::point_type& position, bool bSurfacesDistinct = false);
 
+namespace internal
+{
+
+    // Triangulates the reduced boundary and holes of face in triangulator, vertex ids are halfedge ids
+    template<typename M>
+    void triangulate_face_cdt_triangles(const M& mesh, id_type idFace, triangulation::Triangulator& triangulator);
+
+    // Replaces face by nTriangles triangles, vertexId(n, i) is the halfedge id of vertex i of triangle n and neighbor(n, i) the triangle across the edge opposite it
+    template<typename M, typename V, typename N>
+    void replace_face_triangles(M& mesh, id_type idFace, size_t nTriangles, V vertexId, N neighbor);
+
+} // namespace internal
+
 } // namespace quetzal::brep
 
 //------------------------------------------------------------------------------
 template<typename M>
-void quetzal::brep::triangulate(M& mesh)
+quetzal::brep::TriangulationStrategy quetzal::brep::triangulation_strategy(const M& mesh, id_type idFace, size_t nEarMax)
+{
+    const typename M::face_type& face = mesh.face(idFace);
+    assert(!face.deleted());
+
+    if (face.hole_count() > 0)
+    {
+        return TriangulationStrategy::Cdt;
+    }
+
+    size_t n = face.halfedge_count();
+    if (n == 3)
+    {
+        return TriangulationStrategy::None;
+    }
+
+    if (convex(face))
+    {
+        return n == 4 ? TriangulationStrategy::Quad : TriangulationStrategy::Convex;
+    }
+
+    return n <= nEarMax ? TriangulationStrategy::Ear : TriangulationStrategy::Cdt;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::triangulate(M& mesh, TriangulationStatistics* pStatistics)
 {
+    triangulation::Triangulator triangulator;
+
     size_t nFacesOrig = mesh.face_store_count();
     for (size_t i = 0; i < nFacesOrig; ++i)
     {
-        const typename M::face_type& face = mesh.face(i);
+        if (mesh.face(i).deleted())
+        {
+            continue;
+        }
 
-        if (face.deleted() || (face.halfedge_count() == 3 && face.hole_count() == 0))
+        if (pStatistics == nullptr)
         {
+            triangulate_face(mesh, i, triangulation_strategy(mesh, i), triangulator);
             continue;
         }
 
-        if (face.halfedge_count() == 4 && face.hole_count() == 0)
+        Timestamp ts = Timestamp::now();
+        TriangulationStrategy strategy = triangulation_strategy(mesh, i);
+        triangulate_face(mesh, i, strategy, triangulator);
+
+        size_t k = static_cast<size_t>(strategy);
+        ++pStatistics->faces[k];
+        pStatistics->seconds[k] += Timestamp::since(ts);
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::triangulate_parallel(M& mesh)
+{
+    constexpr size_t nFacesBlock = 64;
+
+    // Same selection as triangulate, faces for the CDT in face order
+    size_t nFacesOrig = mesh.face_store_count();
+    size_t nHalfedges = 0;
+    size_t nFaces = 0;
+    std::vector<TriangulationStrategy> strategies(nFacesOrig, TriangulationStrategy::None);
+    std::vector<id_type> idFacesCdt;
+    for (id_type i = 0; i < nFacesOrig; ++i)
+    {
+        const typename M::face_type& face = mesh.face(i);
+        if (face.deleted())
         {
-            triangulate_face_quad(mesh, i);
             continue;
         }
 
-        // check for other simplifications for speed ...
+        strategies[i] = triangulation_strategy(mesh, i);
 
-        triangulate_face_cdt(mesh, i);
+        if (strategies[i] == TriangulationStrategy::Cdt)
+        {
+            idFacesCdt.push_back(i);
+        }
+        else if (strategies[i] != TriangulationStrategy::None)
+        {
+            // Each split adds a face and a pair of halfedges
+            nHalfedges += 2 * (face.halfedge_count() - 3);
+            nFaces += face.halfedge_count() - 3;
+        }
+    }
+
+    // Phase one, triangles of each block of faces are stored contiguously, vertex ids followed by neighbors
+    struct Block
+    {
+        std::vector<std::array<size_t, 6>> triangles;
+        std::vector<size_t> offsets; // start of each face's triangles, with a final end offset
+    };
+
+    std::vector<Block> blocks((idFacesCdt.size() + nFacesBlock - 1) / nFacesBlock);
+    std::vector<size_t> iBlocks(blocks.size());
+    std::iota(iBlocks.begin(), iBlocks.end(), size_t(0));
+
+    std::for_each(std::execution::par, iBlocks.begin(), iBlocks.end(), [&](size_t iBlock)
+    {
+        thread_local triangulation::Triangulator triangulator;
+
+        Block& block = blocks[iBlock];
+        size_t iEnd = std::min(idFacesCdt.size(), (iBlock + 1) * nFacesBlock);
+
+        block.offsets.push_back(0);
+        for (size_t i = iBlock * nFacesBlock; i < iEnd; ++i)
+        {
+            internal::triangulate_face_cdt_triangles(mesh, idFacesCdt[i], triangulator);
+
+            for (size_t n = 0; n < triangulator.triangle_count(); ++n)
+            {
+                block.triangles.push_back({triangulator.vertex_id(n, 0), triangulator.vertex_id(n, 1), triangulator.vertex_id(n, 2),
+                    triangulator.neighbor(n, 0), triangulator.neighbor(n, 1), triangulator.neighbor(n, 2)});
+            }
+
+            block.offsets.push_back(block.triangles.size());
+        }
+    });
+
+    // Each triangle edge not on the original face boundary is a new halfedge with its own vertex
+    for (size_t i = 0; i < idFacesCdt.size(); ++i)
+    {
+        const auto& face = mesh.face(idFacesCdt[i]);
+        const Block& block = blocks[i / nFacesBlock];
+        size_t nTriangles = block.offsets[i % nFacesBlock + 1] - block.offsets[i % nFacesBlock];
+
+        size_t nHalfedgesFace = face.halfedge_count();
+        for (const auto& hole : face.holes())
+        {
+            for ([[maybe_unused]] const auto& halfedge : hole.halfedges())
+            {
+                ++nHalfedgesFace;
+            }
+        }
+
+        nHalfedges += 3 * nTriangles - nHalfedgesFace;
+        nFaces += nTriangles;
+    }
+
+    // Phase two, the same sequence of edits as triangulate
+    mesh.halfedge_store().reserve(mesh.halfedge_store_count() + nHalfedges);
+    mesh.vertex_store().reserve(mesh.vertex_store_count() + nHalfedges);
+    mesh.face_store().reserve(mesh.face_store_count() + nFaces);
+
+    triangulation::Triangulator triangulator; // Ear clipping fallback
+
+    size_t iCdt = 0;
+    for (id_type i = 0; i < nFacesOrig; ++i)
+    {
+        if (strategies[i] != TriangulationStrategy::Cdt)
+        {
+            if (strategies[i] != TriangulationStrategy::None)
+            {
+                triangulate_face(mesh, i, strategies[i], triangulator);
+            }
+
+            continue;
+        }
+
+        assert(idFacesCdt[iCdt] == i);
+
+        const Block& block = blocks[iCdt / nFacesBlock];
+        size_t offset = block.offsets[iCdt % nFacesBlock];
+        size_t nTriangles = block.offsets[iCdt % nFacesBlock + 1] - offset;
+        const std::array<size_t, 6>* pTriangles = block.triangles.data() + offset;
+
+        auto vertexId = [pTriangles](size_t n, size_t j) -> id_type
+        {
+            return pTriangles[n][j];
+        };
+
+        auto neighbor = [pTriangles](size_t n, size_t j) -> size_t
+        {
+            return pTriangles[n][3 + j];
+        };
+
+        internal::replace_face_triangles(mesh, i, nTriangles, vertexId, neighbor);
+        ++iCdt;
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::triangulate_face(M& mesh, id_type idFace, TriangulationStrategy strategy, triangulation::Triangulator& triangulator)
+{
+    switch (strategy)
+    {
+        case TriangulationStrategy::None:
+            break;
+        case TriangulationStrategy::Quad:
+            triangulate_face_quad(mesh, idFace);
+            break;
+        case TriangulationStrategy::Convex:
+            triangulate_face_convex(mesh, idFace);
+            break;
+        case TriangulationStrategy::Ear:
+            triangulate_face_ear(mesh, idFace);
+            break;
+        case TriangulationStrategy::Cdt:
+            triangulate_face_cdt(mesh, idFace, triangulator);
+            break;
     }
 
     return;
@@ -134,30 +375,95 @@ void quetzal::brep::triangulate_face_ear(M& mesh, id_type idFace)
     assert(face.halfedge_count() > 3);
     assert(face.hole_count() == 0);
 
-// mark reflex vertices ...
     typename M::vector_type normal = face.attributes().normal();
-    size_t nEdges = face.halfedge_count();
-    size_t n = 0; // Counts number of failed attempts to find ear vertex
 
-    id_type idHalfedge = face.halfedge_id();
-    while (mesh.halfedge(idHalfedge).face().halfedge_count() > 3)
+    // Polygon as a ring of indices, the halfedge of each vertex is updated as ears are split off
+    std::vector<id_type> idHalfedges;
+    std::vector<typename M::point_type> positions;
+    for (const auto& halfedge : face.halfedges())
     {
-        id_type idHalfedgeNext = mesh.halfedge(idHalfedge).next_id();
-        // a bit better by advancing to next vertex; this should be done away with and instead use better triangulation algorithm ...
-        if (convex(mesh.halfedge(idHalfedgeNext).face()))
+        idHalfedges.push_back(halfedge.id());
+        positions.push_back(halfedge.attributes().position());
+    }
+
+    size_t n = idHalfedges.size();
+    std::vector<size_t> next(n);
+    std::vector<size_t> prev(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        next[i] = (i + 1) % n;
+        prev[i] = (i + n - 1) % n;
+    }
+
+    // Straight vertices count as reflex, they cannot be ear tips but can block ears
+    std::vector<bool> reflex(n);
+    auto update = [&](size_t i)
+    {
+        const auto& b = positions[i];
+        reflex[i] = geometry::orient3d(positions[prev[i]], b, positions[next[i]], b - normal) <= 0;
+    };
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        update(i);
+    }
+
+    auto ear = [&](size_t i) -> bool
+    {
+        if (reflex[i])
         {
-            idHalfedgeNext = mesh.halfedge(idHalfedgeNext).next_id();
+            return false;
         }
 
-        if (ear(mesh.halfedge(idHalfedge), mesh))
+        const auto& a = positions[prev[i]];
+        const auto& b = positions[i];
+        const auto& c = positions[next[i]];
+        for (size_t j = next[next[i]]; j != prev[i]; j = next[j])
         {
-            split_face(mesh, mesh.halfedge(idHalfedge).prev_id(), mesh.halfedge(idHalfedge).next_id());
-            // update status of prev and next vertices ...
-            n = 0;
+            if (reflex[j] && geometry::triangle_contains(a, b, c, positions[j]))
+            {
+                return false;
+            }
         }
 
-        idHalfedge = idHalfedgeNext;
-        assert(++n < nEdges);
+        return true;
+    };
+
+    size_t nRemaining = n;
+    size_t nFailed = 0; // Vertices tested since the last ear
+    size_t i = 0;
+    while (nRemaining > 3)
+    {
+        if (!ear(i))
+        {
+            i = next[i];
+            if (++nFailed > nRemaining)
+            {
+                // Not a simple polygon as far as the exact tests are concerned
+                triangulate_face_cdt(mesh, mesh.halfedge(idHalfedges[i]).face_id());
+                return;
+            }
+
+            continue;
+        }
+
+        size_t iPrev = prev[i];
+        size_t iNext = next[i];
+
+        // The ear keeps the face, the remainder moves to a new face starting with a new halfedge at the previous vertex
+        split_face(mesh, idHalfedges[iPrev], idHalfedges[iNext]);
+        idHalfedges[iPrev] = mesh.halfedge(idHalfedges[iNext]).prev_id();
+
+        next[iPrev] = iNext;
+        prev[iNext] = iPrev;
+        --nRemaining;
+
+        update(iPrev);
+        update(iNext);
+
+        // Advancing past the next vertex avoids fans from a single vertex
+        i = next[iNext];
+        nFailed = 0;
     }
 
     return;
@@ -166,42 +472,80 @@ void quetzal::brep::triangulate_face_ear(M& mesh, id_type idFace)
 //------------------------------------------------------------------------------
 template<typename M>
 void quetzal::brep::triangulate_face_cdt(M& mesh, id_type idFace)
+{
+    triangulation::Triangulator triangulator;
+    triangulate_face_cdt(mesh, idFace, triangulator);
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::triangulate_face_cdt(M& mesh, id_type idFace, triangulation::Triangulator& triangulator)
+{
+    internal::triangulate_face_cdt_triangles(mesh, idFace, triangulator);
+
+    auto vertexId = [&triangulator](size_t n, size_t i) -> id_type
+    {
+        return triangulator.vertex_id(n, i);
+    };
+
+    auto neighbor = [&triangulator](size_t n, size_t i) -> size_t
+    {
+        return triangulator.neighbor(n, i);
+    };
+
+    internal::replace_face_triangles(mesh, idFace, triangulator.triangle_count(), vertexId, neighbor);
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::brep::internal::triangulate_face_cdt_triangles(const M& mesh, id_type idFace, triangulation::Triangulator& triangulator)
 {
     const auto& face = mesh.face(idFace);
     assert(!face.deleted());
 
-    typename M::face_attributes_type af = face.attributes();
-    typename M::vector_type normal = af.normal();
-    id_type idSubmesh = face.submesh_id();
-    id_type idSurface = face.surface_id();
+	math::DimensionReducer<typename M::vector_traits> dr(face.attributes().normal());
 
-	math::DimensionReducer<typename M::vector_traits> dr(normal);
+    triangulator.clear();
 
-    std::vector<p2t::Point> polygon;
     for (const auto& halfedge : face.halfedges())
     {
         const auto position = dr.reduce(halfedge.attributes().position());
-        polygon.emplace_back(halfedge.id(), position.x(), position.y());
+        triangulator.add_vertex(halfedge.id(), position.x(), position.y());
     }
 
-    p2t::CDT cdt(polygon);
+    triangulator.close_contour();
 
     for (const auto& hole : face.holes())
     {
-        std::vector<p2t::Point> p2tHole;
         for (const auto& halfedge : hole.halfedges())
         {
             const auto position = dr.reduce(halfedge.attributes().position());
-            p2tHole.emplace_back(halfedge.id(), position.x(), position.y());
+            triangulator.add_vertex(halfedge.id(), position.x(), position.y());
         }
 
-        cdt.AddHole(p2tHole);
+        triangulator.close_contour();
     }
 
-    cdt.Triangulate();
+    triangulator.triangulate();
+    assert(triangulator.triangle_count() > 0);
+    return;
+}
 
-    std::vector<p2t::Triangle> triangles = cdt.GetTriangles();
-    assert(!triangles.empty());
+//------------------------------------------------------------------------------
+template<typename M, typename V, typename N>
+void quetzal::brep::internal::replace_face_triangles(M& mesh, id_type idFace, size_t nTriangles, V vertexId, N neighbor)
+{
+    assert(nTriangles > 0);
+
+    const auto& face = mesh.face(idFace);
+    assert(!face.deleted());
+
+    typename M::face_attributes_type af = face.attributes();
+    id_type idSubmesh = face.submesh_id();
+    id_type idSurface = face.surface_id();
 
     // Delete original face leaving its halfedges, vertices, and surface
     if (idSubmesh != nullid)
@@ -217,13 +561,11 @@ void quetzal::brep::triangulate_face_cdt(M& mesh, id_type idFace)
     id_type nhOrig = mesh.halfedge_store_count();
     id_type nh = nhOrig;
 
-    // Store first halfedge of each new pair for partner lookup
-    std::map<std::array<id_type, 2>, id_type> edges; // ...
+    // Triangle i becomes face idFaceFirst + i, with its halfedges in triangle vertex order from the face halfedge
+    id_type idFaceFirst = mesh.face_store_count();
 
-    for (size_t i = 0; i < triangles.size(); ++i)
+    for (size_t i = 0; i < nTriangles; ++i)
     {
-        p2t::Triangle& triangle = triangles[i];
-
         id_type idHalfedgeOrig[3];
         id_type idHalfedgeFace[3];
 
@@ -231,8 +573,8 @@ void quetzal::brep::triangulate_face_cdt(M& mesh, id_type idFace)
         {
             size_t jNext = (j + 1) % 3;
 
-            id_type idHalfedge = triangle.GetPoint(j)->m_id;
-            id_type idHalfedgeNext = triangle.GetPoint(jNext)->m_id;
+            id_type idHalfedge = vertexId(i, j);
+            id_type idHalfedgeNext = vertexId(i, jNext);
 
             idHalfedgeOrig[j] = idHalfedge;
 
@@ -247,6 +589,7 @@ void quetzal::brep::triangulate_face_cdt(M& mesh, id_type idFace)
         }
 
         id_type idFaceTriangle = mesh.create_face(idSurface, idHalfedgeFace[0], af);
+        assert(idFaceTriangle == idFaceFirst + i);
 
         for (size_t j = 0; j < 3; ++j)
         {
@@ -266,16 +609,23 @@ void quetzal::brep::triangulate_face_cdt(M& mesh, id_type idFace)
             }
             else
             {
-                auto iEdge = edges.find({idHalfedgeOrig[jNext], idHalfedgeOrig[j]});
-                id_type idPartner = iEdge != edges.end() ? iEdge->second : nullid;
-                if (idPartner != nullid)
+                // The partner lies in the triangle across the edge, which has already been created if it precedes this one
+                size_t iNeighbor = neighbor(i, jPrev);
+                assert(iNeighbor != triangulation::Triangulator::nullindex);
+
+                id_type idPartner = nullid;
+                if (iNeighbor < i)
                 {
+                    idPartner = mesh.face(idFaceFirst + iNeighbor).halfedge_id();
+                    size_t k = 0;
+                    while (vertexId(iNeighbor, k) != idHalfedgeOrig[jNext])
+                    {
+                        idPartner = mesh.halfedge(idPartner).next_id();
+                        ++k;
+                        assert(k < 3);
+                    }
+
                     mesh.halfedge(idPartner).set_partner_id(idHalfedge);
-                    edges.erase({idHalfedgeOrig[jNext], idHalfedgeOrig[j]});
-                }
-                else
-                {
-                    edges[{idHalfedgeOrig[j], idHalfedgeOrig[jNext]}] = idHalfedge;
                 }
 
                 assert(idHalfedge == mesh.halfedge_store_count());
@@ -285,7 +635,6 @@ void quetzal::brep::triangulate_face_cdt(M& mesh, id_type idFace)
         }
     }
 
-    assert(edges.empty());
     return;
 }
 
@@ -16,6 +16,7 @@
 #include <map>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace quetzal::brep
 {
@@ -953,33 +954,43 @@ bool quetzal::brep::check_manifold_edges(const M& mesh)
 {
     bool bOK = true;
 
-    std::map<id_type, size_t> face_counts;
-    std::map<id_type, size_t> partner_face_counts;
+    // Dense counters indexed by halfedge id, border halfedges are not counted as partners
+    std::vector<size_t> face_counts(mesh.halfedge_store_count(), 0);
+    std::vector<size_t> partner_face_counts(mesh.halfedge_store_count(), 0);
 
     std::cout << "Checking manifold edges: " << mesh.halfedge_count() << " halfedges" << std::endl;
     for (const auto& face : mesh.faces())
     {
-        for (const auto& halfedge : face.halfedges())
+        id_type idHalfedge0 = face.halfedge_id();
+        id_type idHalfedge = idHalfedge0;
+        do
         {
-            face_counts[halfedge.id()]++;
-            partner_face_counts[halfedge.partner_id()]++;
-        }
+            const auto& halfedge = mesh.halfedge(idHalfedge);
+            ++face_counts[idHalfedge];
+
+            if (halfedge.partner_id() != nullid)
+            {
+                ++partner_face_counts[halfedge.partner_id()];
+            }
+
+            idHalfedge = halfedge.next_id();
+        } while (idHalfedge != idHalfedge0);
     }
 
-    for (const auto& i : face_counts)
+    for (id_type id = 0; id < face_counts.size(); ++id)
     {
-        if (i.second > 1)
+        if (face_counts[id] > 1)
         {
-            std::cout << "Bad: halfedge " << i.first << " connected to " << i.second << " faces" << std::endl;
+            std::cout << "Bad: halfedge " << id << " connected to " << face_counts[id] << " faces" << std::endl;
             bOK = false;
         }
     }
 
-    for (const auto& i : partner_face_counts)
+    for (id_type id = 0; id < partner_face_counts.size(); ++id)
     {
-        if (i.second > 1)
+        if (partner_face_counts[id] > 1)
         {
-            std::cout << "Bad: halfedge partner " << i.first << " connected to " << i.second << " faces" << std::endl;
+            std::cout << "Bad: halfedge partner " << id << " connected to " << partner_face_counts[id] << " faces" << std::endl;
             bOK = false;
         }
     }
@@ -8,7 +8,9 @@
 #include "BoundingVolume.hpp"
 #include "quetzal/math/Vector.hpp"
 #include "quetzal/math/floating_point.hpp"
+#include <array>
 #include <iostream>
+#include <span>
 #include <cassert>
 
 namespace quetzal::geometry
@@ -51,6 +53,10 @@ namespace quetzal::geometry
 
         void print(std::ostream& os) const override;
 
+        // Non-virtual tests for batched use, boundary counts as overlap
+        bool overlaps(const AxisAlignedBoundingBox& box) const;
+        bool contains(const point_type& point) const;
+
     private:
 
         bool disjoint() const;
@@ -62,6 +68,11 @@ namespace quetzal::geometry
         point_type m_pointUpper;
     };
 
+    // Component-wise min/max reduction of points into lower and upper, which are extended rather than reset
+    // Each component is reduced independently with branch-free selects so that the loop vectorizes
+    template<typename Traits>
+    void bounds(std::span<const Point<Traits>> points, Point<Traits>& lower, Point<Traits>& upper);
+
 } // namespace quetzal::geometry
 
 //------------------------------------------------------------------------------
@@ -163,11 +174,7 @@ void quetzal::geometry::AxisAlignedBoundingBox<Traits>::insert(std::span<point_t
 {
     assert(ordered());
 
-    for (const auto& point : points)
-    {
-        insert(point);
-    }
-
+    bounds<Traits>(points, m_pointLower, m_pointUpper);
     return;
 }
 
@@ -218,6 +225,32 @@ void quetzal::geometry::AxisAlignedBoundingBox<Traits>::print(std::ostream& os)
     return;
 }
 
+//------------------------------------------------------------------------------
+template<typename Traits>
+bool quetzal::geometry::AxisAlignedBoundingBox<Traits>::overlaps(const AxisAlignedBoundingBox& box) const
+{
+    bool b = true;
+    for (size_t i = 0; i < Traits::dimension; ++i)
+    {
+        b &= (m_pointLower[i] <= box.m_pointUpper[i]) & (m_pointUpper[i] >= box.m_pointLower[i]);
+    }
+
+    return b;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+bool quetzal::geometry::AxisAlignedBoundingBox<Traits>::contains(const point_type& point) const
+{
+    bool b = true;
+    for (size_t i = 0; i < Traits::dimension; ++i)
+    {
+        b &= (m_pointLower[i] <= point[i]) & (point[i] <= m_pointUpper[i]);
+    }
+
+    return b;
+}
+
 //------------------------------------------------------------------------------
 template<typename Traits>
 bool quetzal::geometry::AxisAlignedBoundingBox<Traits>::disjoint() const
@@ -265,4 +298,37 @@ void quetzal::geometry::AxisAlignedBoundingBox<Traits>::order()
     return;
 }
 
+//------------------------------------------------------------------------------
+template<typename Traits>
+void quetzal::geometry::bounds(std::span<const Point<Traits>> points, Point<Traits>& lower, Point<Traits>& upper)
+{
+    using value_type = Traits::value_type;
+
+    std::array<value_type, Traits::dimension> lo;
+    std::array<value_type, Traits::dimension> hi;
+    for (size_t k = 0; k < Traits::dimension; ++k)
+    {
+        lo[k] = lower[k];
+        hi[k] = upper[k];
+    }
+
+    for (const auto& point : points)
+    {
+        for (size_t k = 0; k < Traits::dimension; ++k)
+        {
+            value_type x = point[k];
+            lo[k] = x < lo[k] ? x : lo[k];
+            hi[k] = x > hi[k] ? x : hi[k];
+        }
+    }
+
+    for (size_t k = 0; k < Traits::dimension; ++k)
+    {
+        lower[k] = lo[k];
+        upper[k] = hi[k];
+    }
+
+    return;
+}
+
 #endif // QUETZAL_GEOMETRY_AXISALIGNEDBOUNDINGBOX_HPP
@@ -0,0 +1,429 @@
+#if !defined(QUETZAL_GEOMETRY_AXISALIGNEDBOUNDINGBOXARRAY_HPP)
+#define QUETZAL_GEOMETRY_AXISALIGNEDBOUNDINGBOXARRAY_HPP
+//------------------------------------------------------------------------------
+// geometry
+// AxisAlignedBoundingBoxArray.hpp
+//------------------------------------------------------------------------------
+
+// Structure of arrays storage of axis aligned boxes for batched queries, building block for bounding volume hierarchies
+// Overlap and containment test each box on every axis in one branch-free expression into a block of 64 bytes, then pack the bytes eight at a time into a 64 bit word
+// Ray queries process boxes in blocks of 64, one axis at a time over contiguous bounds
+// Results are bitmasks, bit i of word i / 64 is set for box i
+
+#include "AxisAlignedBoundingBox.hpp"
+#include "Point.hpp"
+#include "Ray.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+
+namespace quetzal::geometry
+{
+
+    //--------------------------------------------------------------------------
+    template<typename Traits>
+    class AxisAlignedBoundingBoxArray
+    {
+    public:
+
+        using value_type = Traits::value_type;
+        using point_type = Point<Traits>;
+        using box_type = AxisAlignedBoundingBox<Traits>;
+        using ray_type = Ray<Traits>;
+        using size_type = size_t;
+        using mask_type = std::vector<uint64_t>;
+
+        static constexpr size_t block_size = 64;
+
+        AxisAlignedBoundingBoxArray() = default;
+        AxisAlignedBoundingBoxArray(const AxisAlignedBoundingBoxArray&) = default;
+        AxisAlignedBoundingBoxArray(AxisAlignedBoundingBoxArray&&) = default;
+        ~AxisAlignedBoundingBoxArray() = default;
+
+        AxisAlignedBoundingBoxArray& operator=(const AxisAlignedBoundingBoxArray&) = default;
+        AxisAlignedBoundingBoxArray& operator=(AxisAlignedBoundingBoxArray&&) = default;
+
+        size_type size() const;
+        bool empty() const;
+        void clear();
+        void reserve(size_type n);
+
+        void push_back(const box_type& box);
+        void push_back(const point_type& pointLower, const point_type& pointUpper);
+
+        point_type lower(size_type i) const;
+        point_type upper(size_type i) const;
+        box_type box(size_type i) const;
+
+        // Boxes overlapping box, boundary contact counts as overlap
+        void overlaps(const box_type& box, mask_type& mask) const;
+
+        // Boxes containing point, boundary included
+        void contains(const point_type& point, mask_type& mask) const;
+
+        // Boxes hit by the ray for parameter values in [0, tMax], slab test
+        void intersects(const ray_type& ray, mask_type& mask, value_type tMax = std::numeric_limits<value_type>::max()) const;
+
+        // Number of words in a mask for the current size
+        size_type mask_size() const;
+
+        // Number of set bits in mask
+        static size_type mask_count(const mask_type& mask);
+
+        static bool mask_test(const mask_type& mask, size_type i);
+
+    private:
+
+        // Set bit i of the mask where f(i) is true, f should be a branch-free test that inlines
+        template<typename F>
+        void evaluate(mask_type& mask, F f) const;
+
+        // Bit i of the result is byte i of bytes, each byte 0 or 1
+        static uint64_t pack(const std::array<uint8_t, block_size>& bytes);
+
+        // f(k) for every axis k, unrolled and combined without branches
+        template<typename F>
+        static bool all_axes(F f);
+
+        // Bounds of each axis for box i onward, for the tests passed to evaluate
+        std::array<const value_type*, Traits::dimension> lowers() const;
+        std::array<const value_type*, Traits::dimension> uppers() const;
+
+        static std::array<value_type, Traits::dimension> coordinates(const point_type& point);
+
+        std::array<std::vector<value_type>, Traits::dimension> m_lower;
+        std::array<std::vector<value_type>, Traits::dimension> m_upper;
+    };
+
+} // namespace quetzal::geometry
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+typename quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::size_type quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::size() const
+{
+    return m_lower[0].size();
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+bool quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::empty() const
+{
+    return m_lower[0].empty();
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+void quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::clear()
+{
+    for (size_t k = 0; k < Traits::dimension; ++k)
+    {
+        m_lower[k].clear();
+        m_upper[k].clear();
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+void quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::reserve(size_type n)
+{
+    for (size_t k = 0; k < Traits::dimension; ++k)
+    {
+        m_lower[k].reserve(n);
+        m_upper[k].reserve(n);
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+void quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::push_back(const box_type& box)
+{
+    push_back(box.lower(), box.upper());
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+void quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::push_back(const point_type& pointLower, const point_type& pointUpper)
+{
+    for (size_t k = 0; k < Traits::dimension; ++k)
+    {
+        m_lower[k].push_back(pointLower[k]);
+        m_upper[k].push_back(pointUpper[k]);
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+typename quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::point_type quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::lower(size_type i) const
+{
+    assert(i < size());
+
+    point_type point;
+    for (size_t k = 0; k < Traits::dimension; ++k)
+    {
+        point[k] = m_lower[k][i];
+    }
+
+    return point;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+typename quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::point_type quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::upper(size_type i) const
+{
+    assert(i < size());
+
+    point_type point;
+    for (size_t k = 0; k < Traits::dimension; ++k)
+    {
+        point[k] = m_upper[k][i];
+    }
+
+    return point;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+typename quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::box_type quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::box(size_type i) const
+{
+    return box_type(lower(i), upper(i));
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+void quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::overlaps(const box_type& box, mask_type& mask) const
+{
+    const auto lower = coordinates(box.lower());
+    const auto upper = coordinates(box.upper());
+    const auto lo = lowers();
+    const auto hi = uppers();
+
+    evaluate(mask, [&](size_t i) -> bool
+    {
+        return all_axes([&](size_t k) -> bool { return (lo[k][i] <= upper[k]) & (hi[k][i] >= lower[k]); });
+    });
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+void quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::contains(const point_type& point, mask_type& mask) const
+{
+    const auto x = coordinates(point);
+    const auto lo = lowers();
+    const auto hi = uppers();
+
+    evaluate(mask, [&](size_t i) -> bool
+    {
+        return all_axes([&](size_t k) -> bool { return (lo[k][i] <= x[k]) & (x[k] <= hi[k][i]); });
+    });
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+void quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::intersects(const ray_type& ray, mask_type& mask, value_type tMax) const
+{
+    point_type origin = ray.endpoint();
+    auto direction = ray.direction();
+
+    mask.assign(mask_size(), 0);
+
+    std::array<value_type, block_size> tNear;
+    std::array<value_type, block_size> tFar;
+    std::array<uint8_t, block_size> hits;
+
+    for (size_t i0 = 0; i0 < size(); i0 += block_size)
+    {
+        size_t n = std::min(block_size, size() - i0);
+        tNear.fill(value_type(0));
+        tFar.fill(tMax);
+        hits.fill(1);
+
+        for (size_t k = 0; k < Traits::dimension; ++k)
+        {
+            const value_type* lo = m_lower[k].data() + i0;
+            const value_type* hi = m_upper[k].data() + i0;
+            value_type o = origin[k];
+
+            if (direction[k] == value_type(0))
+            {
+                // Parallel to the slab, the origin must lie within it
+                for (size_t i = 0; i < n; ++i)
+                {
+                    hits[i] &= static_cast<uint8_t>((lo[i] <= o) & (o <= hi[i]));
+                }
+
+                continue;
+            }
+
+            value_type inverse = value_type(1) / direction[k];
+            for (size_t i = 0; i < n; ++i)
+            {
+                value_type t0 = (lo[i] - o) * inverse;
+                value_type t1 = (hi[i] - o) * inverse;
+                value_type tMin = t0 < t1 ? t0 : t1;
+                value_type tMaxSlab = t0 < t1 ? t1 : t0;
+                tNear[i] = tMin > tNear[i] ? tMin : tNear[i];
+                tFar[i] = tMaxSlab < tFar[i] ? tMaxSlab : tFar[i];
+            }
+        }
+
+        uint64_t word = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            word |= static_cast<uint64_t>(hits[i] & static_cast<uint8_t>(tNear[i] <= tFar[i])) << i;
+        }
+
+        mask[i0 / block_size] = word;
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+typename quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::size_type quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::mask_size() const
+{
+    return (size() + block_size - 1) / block_size;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+template<typename F>
+void quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::evaluate(mask_type& mask, F f) const
+{
+    mask.assign(mask_size(), 0);
+
+    alignas(block_size) std::array<uint8_t, block_size> bytes;
+    for (size_t i0 = 0; i0 < size(); i0 += block_size)
+    {
+        size_t n = std::min(block_size, size() - i0);
+        if (n < block_size)
+        {
+            bytes.fill(0);
+        }
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            bytes[i] = static_cast<uint8_t>(f(i0 + i));
+        }
+
+        mask[i0 / block_size] = pack(bytes);
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+uint64_t quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::pack(const std::array<uint8_t, block_size>& bytes)
+{
+    uint64_t word = 0;
+    for (size_t q = 0; q < block_size / 8; ++q)
+    {
+        uint64_t x;
+        std::memcpy(&x, bytes.data() + 8 * q, 8);
+
+        if constexpr (std::endian::native == std::endian::little)
+        {
+            // Multiplication gathers the low bit of each byte into the top byte, byte j to bit 56 + j
+            word |= ((x * 0x0102040810204080ull) >> 56) << (8 * q);
+        }
+        else
+        {
+            for (size_t j = 0; j < 8; ++j)
+            {
+                word |= static_cast<uint64_t>(bytes[8 * q + j]) << (8 * q + j);
+            }
+        }
+    }
+
+    return word;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+template<typename F>
+bool quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::all_axes(F f)
+{
+    return [&]<size_t... K>(std::index_sequence<K...>) -> bool
+    {
+        return (f(K) & ...);
+    }(std::make_index_sequence<Traits::dimension>());
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+std::array<typename Traits::value_type, Traits::dimension> quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::coordinates(const point_type& point)
+{
+    std::array<value_type, Traits::dimension> x;
+    for (size_t k = 0; k < Traits::dimension; ++k)
+    {
+        x[k] = point[k];
+    }
+
+    return x;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+std::array<const typename Traits::value_type*, Traits::dimension> quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::lowers() const
+{
+    std::array<const value_type*, Traits::dimension> pointers;
+    for (size_t k = 0; k < Traits::dimension; ++k)
+    {
+        pointers[k] = m_lower[k].data();
+    }
+
+    return pointers;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+std::array<const typename Traits::value_type*, Traits::dimension> quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::uppers() const
+{
+    std::array<const value_type*, Traits::dimension> pointers;
+    for (size_t k = 0; k < Traits::dimension; ++k)
+    {
+        pointers[k] = m_upper[k].data();
+    }
+
+    return pointers;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+typename quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::size_type quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::mask_count(const mask_type& mask)
+{
+    size_type n = 0;
+    for (uint64_t word : mask)
+    {
+        n += static_cast<size_type>(std::popcount(word));
+    }
+
+    return n;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+bool quetzal::geometry::AxisAlignedBoundingBoxArray<Traits>::mask_test(const mask_type& mask, size_type i)
+{
+    return (mask[i / block_size] >> (i % block_size)) & 1;
+}
+
+#endif // QUETZAL_GEOMETRY_AXISALIGNEDBOUNDINGBOXARRAY_HPP
@@ -0,0 +1,349 @@
+#if !defined(QUETZAL_GEOMETRY_SPATIALHASH_HPP)
+#define QUETZAL_GEOMETRY_SPATIALHASH_HPP
+//------------------------------------------------------------------------------
+// geometry
+// SpatialHash.hpp
+//------------------------------------------------------------------------------
+
+// Uniform grid of cubic cells over an unbounded domain, only occupied cells are stored
+// Each entry is a point with an associated value, typically an element id
+// Radius queries visit only the cells overlapping the query box, or only the occupied cells when there are fewer of those
+// Expected O(1) for a radius on the order of the cell size
+
+#include "Point.hpp"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <cassert>
+
+namespace quetzal::geometry
+{
+
+    //--------------------------------------------------------------------------
+    template<typename Traits, typename T = size_t>
+    class SpatialHash
+    {
+    public:
+
+        using value_type = Traits::value_type;
+        using point_type = Point<Traits>;
+        using mapped_type = T;
+        using size_type = size_t;
+        using cell_type = std::array<int64_t, Traits::dimension>;
+
+        struct Entry
+        {
+            point_type point;
+            mapped_type value;
+        };
+
+        explicit SpatialHash(value_type sizeCell);
+        SpatialHash(const SpatialHash&) = default;
+        SpatialHash(SpatialHash&&) = default;
+        ~SpatialHash() = default;
+
+        SpatialHash& operator=(const SpatialHash&) = default;
+        SpatialHash& operator=(SpatialHash&&) = default;
+
+        value_type cell_size() const;
+
+        size_type size() const;
+        bool empty() const;
+        void clear();
+        void reserve(size_type n); // Expected number of occupied cells
+
+        void insert(const point_type& point, const mapped_type& value);
+
+        // Removes a single entry matching both value and exact point, returns false if not found
+        bool remove(const point_type& point, const mapped_type& value);
+
+        // Appends the values of all entries within radius of point
+        void query(const point_type& point, value_type radius, std::vector<mapped_type>& values) const;
+
+        // Calls f(entry) for each entry within radius of point until f returns false, returns false if stopped early
+        template<typename F>
+        bool visit(const point_type& point, value_type radius, F f) const;
+
+        // Value of the entry nearest to point within radius, or valueNone if there is none
+        mapped_type nearest(const point_type& point, value_type radius, const mapped_type& valueNone) const;
+
+        cell_type cell(const point_type& point) const;
+
+        // The test applied to each entry by a radius query
+        static bool within(const point_type& a, const point_type& b, value_type radius);
+
+    private:
+
+        template<typename F>
+        bool visit_cell(const std::vector<Entry>& entries, const point_type& point, value_type radius, F& f) const;
+
+        struct CellHash
+        {
+            size_t operator()(const cell_type& cell) const;
+        };
+
+        using cells_type = std::unordered_map<cell_type, std::vector<Entry>, CellHash>;
+
+        value_type m_sizeCell;
+        value_type m_sizeCellInverse;
+        cells_type m_cells;
+        size_type m_size;
+    };
+
+} // namespace quetzal::geometry
+
+//------------------------------------------------------------------------------
+template<typename Traits, typename T>
+quetzal::geometry::SpatialHash<Traits, T>::SpatialHash(value_type sizeCell) :
+    m_sizeCell(sizeCell),
+    m_sizeCellInverse(Traits::val(1) / sizeCell),
+    m_cells(),
+    m_size(0)
+{
+    assert(sizeCell > Traits::val(0));
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits, typename T>
+typename quetzal::geometry::SpatialHash<Traits, T>::value_type quetzal::geometry::SpatialHash<Traits, T>::cell_size() const
+{
+    return m_sizeCell;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits, typename T>
+typename quetzal::geometry::SpatialHash<Traits, T>::size_type quetzal::geometry::SpatialHash<Traits, T>::size() const
+{
+    return m_size;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits, typename T>
+bool quetzal::geometry::SpatialHash<Traits, T>::empty() const
+{
+    return m_size == 0;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits, typename T>
+void quetzal::geometry::SpatialHash<Traits, T>::clear()
+{
+    m_cells.clear();
+    m_size = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits, typename T>
+void quetzal::geometry::SpatialHash<Traits, T>::reserve(size_type n)
+{
+    m_cells.reserve(n);
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits, typename T>
+void quetzal::geometry::SpatialHash<Traits, T>::insert(const point_type& point, const mapped_type& value)
+{
+    m_cells[cell(point)].push_back({point, value});
+    ++m_size;
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits, typename T>
+bool quetzal::geometry::SpatialHash<Traits, T>::remove(const point_type& point, const mapped_type& value)
+{
+    auto i = m_cells.find(cell(point));
+    if (i == m_cells.end())
+    {
+        return false;
+    }
+
+    auto& entries = i->second;
+    for (auto j = entries.begin(); j != entries.end(); ++j)
+    {
+        if (j->value == value && j->point == point)
+        {
+            *j = entries.back();
+            entries.pop_back();
+            if (entries.empty())
+            {
+                m_cells.erase(i);
+            }
+
+            --m_size;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits, typename T>
+void quetzal::geometry::SpatialHash<Traits, T>::query(const point_type& point, value_type radius, std::vector<mapped_type>& values) const
+{
+    visit(point, radius, [&values](const Entry& entry) -> bool
+    {
+        values.push_back(entry.value);
+        return true;
+    });
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits, typename T>
+template<typename F>
+bool quetzal::geometry::SpatialHash<Traits, T>::visit(const point_type& point, value_type radius, F f) const
+{
+    assert(radius >= Traits::val(0));
+
+    if (m_cells.empty())
+    {
+        return true;
+    }
+
+    point_type offset;
+    for (size_t i = 0; i < Traits::dimension; ++i)
+    {
+        offset[i] = radius;
+    }
+
+    cell_type cellLower = cell(point - offset);
+    cell_type cellUpper = cell(point + offset);
+    // Cells in the query box, saturating once there are more than are occupied
+    size_type nCells = 1;
+    for (size_t i = 0; i < Traits::dimension && nCells <= m_cells.size(); ++i)
+    {
+        uint64_t nAxis = static_cast<uint64_t>(cellUpper[i] - cellLower[i]) + 1;
+        nCells = nAxis > m_cells.size() ? m_cells.size() + 1 : nCells * static_cast<size_type>(nAxis);
+    }
+
+    if (nCells > m_cells.size())
+    {
+        for (const auto& [c, entries] : m_cells)
+        {
+            bool bInside = true;
+            for (size_t i = 0; i < Traits::dimension && bInside; ++i)
+            {
+                bInside = c[i] >= cellLower[i] && c[i] <= cellUpper[i];
+            }
+
+            if (bInside && !visit_cell(entries, point, radius, f))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Odometer over the cells of the query box
+    cell_type c = cellLower;
+    for (;;)
+    {
+        auto i = m_cells.find(c);
+        if (i != m_cells.end() && !visit_cell(i->second, point, radius, f))
+        {
+            return false;
+        }
+
+        size_t k = 0;
+        while (k < Traits::dimension && c[k] == cellUpper[k])
+        {
+            c[k] = cellLower[k];
+            ++k;
+        }
+
+        if (k == Traits::dimension)
+        {
+            break;
+        }
+
+        ++c[k];
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits, typename T>
+typename quetzal::geometry::SpatialHash<Traits, T>::mapped_type quetzal::geometry::SpatialHash<Traits, T>::nearest(const point_type& point, value_type radius, const mapped_type& valueNone) const
+{
+    mapped_type value = valueNone;
+    value_type distanceSquared = radius * radius;
+    bool bFound = false;
+
+    visit(point, radius, [&](const Entry& entry) -> bool
+    {
+        value_type d = (entry.point - point).norm_squared();
+        if (!bFound || d < distanceSquared)
+        {
+            value = entry.value;
+            distanceSquared = d;
+            bFound = true;
+        }
+
+        return true;
+    });
+
+    return value;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits, typename T>
+typename quetzal::geometry::SpatialHash<Traits, T>::cell_type quetzal::geometry::SpatialHash<Traits, T>::cell(const point_type& point) const
+{
+    cell_type c;
+    for (size_t i = 0; i < Traits::dimension; ++i)
+    {
+        c[i] = static_cast<int64_t>(std::floor(point[i] * m_sizeCellInverse));
+    }
+
+    return c;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits, typename T>
+bool quetzal::geometry::SpatialHash<Traits, T>::within(const point_type& a, const point_type& b, value_type radius)
+{
+    return (a - b).norm_squared() <= radius * radius;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits, typename T>
+template<typename F>
+bool quetzal::geometry::SpatialHash<Traits, T>::visit_cell(const std::vector<Entry>& entries, const point_type& point, value_type radius, F& f) const
+{
+    for (const auto& entry : entries)
+    {
+        if (within(entry.point, point, radius) && !f(entry))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits, typename T>
+size_t quetzal::geometry::SpatialHash<Traits, T>::CellHash::operator()(const cell_type& cell) const
+{
+    // Large primes per axis (Teschner et al.)
+    constexpr std::array<uint64_t, 4> primes = {73856093ull, 19349663ull, 83492791ull, 50331653ull};
+
+    uint64_t h = 0;
+    for (size_t i = 0; i < cell.size(); ++i)
+    {
+        h ^= static_cast<uint64_t>(cell[i]) * primes[i % primes.size()];
+    }
+
+    return static_cast<size_t>(h);
+}
+
+#endif // QUETZAL_GEOMETRY_SPATIALHASH_HPP
@@ -518,9 +518,10 @@ bool quetzal::geometry::intersects(const Segment<Traits>& segmentA, const Segmen
 template<typename Traits>
 bool quetzal::geometry::intersects(const Segment<Traits>& segment, const Plane<Traits>& plane)
 {
-    auto p = plane.compare(segment.endpoint(0));
-    auto q = plane.compare(segment.endpoint(1));
-    return p != q || p == 0;
+    // Plane::compare only distinguishes points on the plane from those off it, so compare sides directly
+    auto p = dot(plane.normal(), segment.endpoint(0) - plane.point());
+    auto q = dot(plane.normal(), segment.endpoint(1) - plane.point());
+    return math::float_eq0(p) || math::float_eq0(q) || (p < 0) != (q < 0);
 }
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,574 @@
+#if !defined(QUETZAL_GEOMETRY_PREDICATES_HPP)
+#define QUETZAL_GEOMETRY_PREDICATES_HPP
+//------------------------------------------------------------------------------
+// geometry
+// predicates.hpp
+//------------------------------------------------------------------------------
+
+// Adaptive precision orientation and incircle predicates (Shewchuk)
+// The determinant is first evaluated in ordinary floating point, and the sign is accepted when its magnitude exceeds a forward error bound
+// Otherwise the determinant is evaluated exactly with floating point expansion arithmetic, so the sign is always correct
+// Coordinates are evaluated in double, float coordinates are converted exactly
+// Round to nearest even without extended precision intermediates is assumed, which holds for SSE2 and later
+
+#include "Point.hpp"
+#include <cmath>
+#include <limits>
+#include <cstddef>
+
+namespace quetzal::geometry
+{
+
+    // Returns -1, 0, 1: clockwise, colinear, counterclockwise
+    template<typename V> requires (V::dimension == 2)
+    int orient2d(const V& a, const V& b, const V& c);
+
+    // Returns -1, 0, 1: d above, on, below the plane through a, b, c
+    // Above is the side from which a, b, c appear in counterclockwise order
+    template<typename V> requires (V::dimension == 3)
+    int orient3d(const V& a, const V& b, const V& c, const V& d);
+
+    // Returns -1, 0, 1: d outside, on, inside the circle through a, b, c
+    // a, b, c must be in counterclockwise order, otherwise the sign is reversed
+    template<typename V> requires (V::dimension == 2)
+    int incircle(const V& a, const V& b, const V& c, const V& d);
+
+    // Error bound coefficients for the floating point evaluation, epsilon is half a unit in the last place
+    // A determinant evaluated in floating point has the sign of the exact one when its magnitude exceeds the coefficient times the permanent
+    // Public for callers that share differences between several determinants and fall back to the predicates above only when the bound fails
+    template<typename T>
+    struct PredicateBounds
+    {
+        static constexpr T epsilon = std::numeric_limits<T>::epsilon() / T(2);
+        static constexpr T orient2d = (T(3) + T(16) * epsilon) * epsilon;
+        static constexpr T orient3d = (T(7) + T(56) * epsilon) * epsilon;
+        static constexpr T incircle = (T(10) + T(96) * epsilon) * epsilon;
+    };
+
+namespace internal
+{
+
+    // x + y == a + b exactly
+    template<typename T>
+    void two_sum(T a, T b, T& x, T& y);
+
+    // x + y == a - b exactly
+    template<typename T>
+    void two_diff(T a, T b, T& x, T& y);
+
+    // x + y == a * b exactly
+    template<typename T>
+    void two_product(T a, T b, T& x, T& y);
+
+    // e = a * b - c * d exactly as a four component expansion
+    template<typename T>
+    void two_two_diff(T a, T b, T c, T d, T* e);
+
+    // h = e + f, zero components eliminated, returns the length of h
+    template<typename T>
+    size_t expansion_sum(size_t ne, const T* e, size_t nf, const T* f, T* h);
+
+    // h = e * b, zero components eliminated, returns the length of h
+    template<typename T>
+    size_t expansion_scale(size_t ne, const T* e, T b, T* h);
+
+    template<typename T>
+    int sign(T x);
+
+    template<typename T>
+    int orient2d_exact(T ax, T ay, T bx, T by, T cx, T cy);
+
+    template<typename T>
+    int orient3d_exact(const T* pa, const T* pb, const T* pc, const T* pd);
+
+    // Exact sign from the differences of a, b, c from d, when those differences are themselves exact
+    template<typename T>
+    int incircle_exact(T adx, T ady, T bdx, T bdy, T cdx, T cdy);
+
+    template<typename T>
+    int incircle_exact(const T* pa, const T* pb, const T* pc, const T* pd);
+
+} // namespace internal
+
+} // namespace quetzal::geometry
+
+//------------------------------------------------------------------------------
+template<typename V> requires (V::dimension == 2)
+int quetzal::geometry::orient2d(const V& a, const V& b, const V& c)
+{
+    static_assert(sizeof(typename V::value_type) <= sizeof(double));
+
+    double ax = a.x();
+    double ay = a.y();
+    double bx = b.x();
+    double by = b.y();
+    double cx = c.x();
+    double cy = c.y();
+
+    double detLeft = (ax - cx) * (by - cy);
+    double detRight = (ay - cy) * (bx - cx);
+    double det = detLeft - detRight;
+
+    // Terms of opposite sign or a zero term pass the filter exactly, so one comparison covers every case without data dependent branches
+    double detSum = std::abs(detLeft) + std::abs(detRight);
+    if (std::abs(det) >= PredicateBounds<double>::orient2d * detSum)
+    {
+        return internal::sign(det);
+    }
+
+    return internal::orient2d_exact(ax, ay, bx, by, cx, cy);
+}
+
+//------------------------------------------------------------------------------
+template<typename V> requires (V::dimension == 3)
+int quetzal::geometry::orient3d(const V& a, const V& b, const V& c, const V& d)
+{
+    static_assert(sizeof(typename V::value_type) <= sizeof(double));
+
+    double pa[3] = {a.x(), a.y(), a.z()};
+    double pb[3] = {b.x(), b.y(), b.z()};
+    double pc[3] = {c.x(), c.y(), c.z()};
+    double pd[3] = {d.x(), d.y(), d.z()};
+
+    double adx = pa[0] - pd[0];
+    double bdx = pb[0] - pd[0];
+    double cdx = pc[0] - pd[0];
+    double ady = pa[1] - pd[1];
+    double bdy = pb[1] - pd[1];
+    double cdy = pc[1] - pd[1];
+    double adz = pa[2] - pd[2];
+    double bdz = pb[2] - pd[2];
+    double cdz = pc[2] - pd[2];
+
+    double bdxcdy = bdx * cdy;
+    double cdxbdy = cdx * bdy;
+    double cdxady = cdx * ady;
+    double adxcdy = adx * cdy;
+    double adxbdy = adx * bdy;
+    double bdxady = bdx * ady;
+
+    double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+    double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * std::abs(adz)
+        + (std::abs(cdxady) + std::abs(adxcdy)) * std::abs(bdz)
+        + (std::abs(adxbdy) + std::abs(bdxady)) * std::abs(cdz);
+
+    if (std::abs(det) > PredicateBounds<double>::orient3d * permanent)
+    {
+        return internal::sign(det);
+    }
+
+    return internal::orient3d_exact(pa, pb, pc, pd);
+}
+
+//------------------------------------------------------------------------------
+template<typename V> requires (V::dimension == 2)
+int quetzal::geometry::incircle(const V& a, const V& b, const V& c, const V& d)
+{
+    static_assert(sizeof(typename V::value_type) <= sizeof(double));
+
+    double pa[2] = {a.x(), a.y()};
+    double pb[2] = {b.x(), b.y()};
+    double pc[2] = {c.x(), c.y()};
+    double pd[2] = {d.x(), d.y()};
+
+    double adx = pa[0] - pd[0];
+    double bdx = pb[0] - pd[0];
+    double cdx = pc[0] - pd[0];
+    double ady = pa[1] - pd[1];
+    double bdy = pb[1] - pd[1];
+    double cdy = pc[1] - pd[1];
+
+    double bdxcdy = bdx * cdy;
+    double cdxbdy = cdx * bdy;
+    double alift = adx * adx + ady * ady;
+
+    double cdxady = cdx * ady;
+    double adxcdy = adx * cdy;
+    double blift = bdx * bdx + bdy * bdy;
+
+    double adxbdy = adx * bdy;
+    double bdxady = bdx * ady;
+    double clift = cdx * cdx + cdy * cdy;
+
+    double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+    double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift
+        + (std::abs(cdxady) + std::abs(adxcdy)) * blift
+        + (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+
+    if (std::abs(det) > PredicateBounds<double>::incircle * permanent)
+    {
+        return internal::sign(det);
+    }
+
+    // The differences are usually exact, the determinant of the differences is then far cheaper than that of the points
+    double tails[6];
+    internal::two_diff(pa[0], pd[0], adx, tails[0]);
+    internal::two_diff(pb[0], pd[0], bdx, tails[1]);
+    internal::two_diff(pc[0], pd[0], cdx, tails[2]);
+    internal::two_diff(pa[1], pd[1], ady, tails[3]);
+    internal::two_diff(pb[1], pd[1], bdy, tails[4]);
+    internal::two_diff(pc[1], pd[1], cdy, tails[5]);
+    if (tails[0] == 0.0 && tails[1] == 0.0 && tails[2] == 0.0 && tails[3] == 0.0 && tails[4] == 0.0 && tails[5] == 0.0)
+    {
+        return internal::incircle_exact(adx, ady, bdx, bdy, cdx, cdy);
+    }
+
+    return internal::incircle_exact(pa, pb, pc, pd);
+}
+
+//------------------------------------------------------------------------------
+template<typename T>
+void quetzal::geometry::internal::two_sum(T a, T b, T& x, T& y)
+{
+    x = a + b;
+    T bv = x - a;
+    T av = x - bv;
+    y = (a - av) + (b - bv);
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename T>
+void quetzal::geometry::internal::two_diff(T a, T b, T& x, T& y)
+{
+    x = a - b;
+    T bv = a - x;
+    T av = x + bv;
+    y = (a - av) + (bv - b);
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename T>
+void quetzal::geometry::internal::two_product(T a, T b, T& x, T& y)
+{
+    x = a * b;
+#if defined(__FMA__) || defined(__AVX2__)
+    y = std::fma(a, b, -x);
+#else
+    // Dekker's product, std::fma is a slow library call without hardware support
+    constexpr T splitter = T(size_t(1) << ((std::numeric_limits<T>::digits + 1) / 2)) + T(1);
+    T ca = splitter * a;
+    T aHigh = ca - (ca - a);
+    T aLow = a - aHigh;
+    T cb = splitter * b;
+    T bHigh = cb - (cb - b);
+    T bLow = b - bHigh;
+    y = aLow * bLow - (((x - aHigh * bHigh) - aLow * bHigh) - aHigh * bLow);
+#endif
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename T>
+void quetzal::geometry::internal::two_two_diff(T a, T b, T c, T d, T* e)
+{
+    T a1;
+    T a0;
+    T b1;
+    T b0;
+    two_product(a, b, a1, a0);
+    two_product(c, d, b1, b0);
+
+    // (a1 + a0) - b0, then the result minus b1, components in increasing order of magnitude
+    T i;
+    T j;
+    T k;
+    two_diff(a0, b0, i, e[0]);
+    two_sum(a1, i, j, k);
+    two_diff(k, b1, i, e[1]);
+    two_sum(j, i, e[3], e[2]);
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename T>
+size_t quetzal::geometry::internal::expansion_sum(size_t ne, const T* e, size_t nf, const T* f, T* h)
+{
+    // Merge by increasing magnitude, then accumulate with two_sum (fast_expansion_sum_zeroelim)
+    size_t ie = 0;
+    size_t jf = 0;
+    size_t nh = 0;
+
+    auto next = [&]() -> T
+    {
+        if (jf >= nf || (ie < ne && (std::abs(e[ie]) < std::abs(f[jf]))))
+        {
+            return e[ie++];
+        }
+
+        return f[jf++];
+    };
+
+    if (ne + nf == 0)
+    {
+        return 0;
+    }
+
+    T q = next();
+    T qNew;
+    T hh;
+    while (ie < ne || jf < nf)
+    {
+        two_sum(q, next(), qNew, hh);
+        q = qNew;
+        if (hh != T(0))
+        {
+            h[nh++] = hh;
+        }
+    }
+
+    if (q != T(0) || nh == 0)
+    {
+        h[nh++] = q;
+    }
+
+    return nh;
+}
+
+//------------------------------------------------------------------------------
+template<typename T>
+size_t quetzal::geometry::internal::expansion_scale(size_t ne, const T* e, T b, T* h)
+{
+    // scale_expansion_zeroelim
+    size_t nh = 0;
+    T q;
+    T hh;
+    two_product(e[0], b, q, hh);
+    if (hh != T(0))
+    {
+        h[nh++] = hh;
+    }
+
+    for (size_t i = 1; i < ne; ++i)
+    {
+        T product1;
+        T product0;
+        two_product(e[i], b, product1, product0);
+
+        T sum;
+        two_sum(q, product0, sum, hh);
+        if (hh != T(0))
+        {
+            h[nh++] = hh;
+        }
+
+        two_sum(product1, sum, q, hh);
+        if (hh != T(0))
+        {
+            h[nh++] = hh;
+        }
+    }
+
+    if (q != T(0) || nh == 0)
+    {
+        h[nh++] = q;
+    }
+
+    return nh;
+}
+
+//------------------------------------------------------------------------------
+template<typename T>
+int quetzal::geometry::internal::sign(T x)
+{
+    return (x > T(0)) - (x < T(0));
+}
+
+//------------------------------------------------------------------------------
+template<typename T>
+int quetzal::geometry::internal::orient2d_exact(T ax, T ay, T bx, T by, T cx, T cy)
+{
+    // ax * by - ay * bx + bx * cy - by * cx + cx * ay - cy * ax, each term an exact product
+    T ab[4];
+    T bc[4];
+    T ca[4];
+    two_two_diff(ax, by, ay, bx, ab);
+    two_two_diff(bx, cy, by, cx, bc);
+    two_two_diff(cx, ay, cy, ax, ca);
+
+    T temp[8];
+    size_t nTemp = expansion_sum(size_t(4), ab, size_t(4), bc, temp);
+    T det[12];
+    size_t nDet = expansion_sum(nTemp, temp, size_t(4), ca, det);
+
+    return sign(det[nDet - 1]);
+}
+
+//------------------------------------------------------------------------------
+template<typename T>
+int quetzal::geometry::internal::orient3d_exact(const T* pa, const T* pb, const T* pc, const T* pd)
+{
+    T ab[4];
+    T bc[4];
+    T cd[4];
+    T da[4];
+    T ac[4];
+    T bd[4];
+    two_two_diff(pa[0], pb[1], pb[0], pa[1], ab);
+    two_two_diff(pb[0], pc[1], pc[0], pb[1], bc);
+    two_two_diff(pc[0], pd[1], pd[0], pc[1], cd);
+    two_two_diff(pd[0], pa[1], pa[0], pd[1], da);
+    two_two_diff(pa[0], pc[1], pc[0], pa[1], ac);
+    two_two_diff(pb[0], pd[1], pd[0], pb[1], bd);
+
+    T temp[8];
+    size_t nTemp;
+
+    T cda[12];
+    nTemp = expansion_sum(size_t(4), cd, size_t(4), da, temp);
+    size_t nCda = expansion_sum(nTemp, temp, size_t(4), ac, cda);
+
+    T dab[12];
+    nTemp = expansion_sum(size_t(4), da, size_t(4), ab, temp);
+    size_t nDab = expansion_sum(nTemp, temp, size_t(4), bd, dab);
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        bd[i] = -bd[i];
+        ac[i] = -ac[i];
+    }
+
+    T abc[12];
+    nTemp = expansion_sum(size_t(4), ab, size_t(4), bc, temp);
+    size_t nAbc = expansion_sum(nTemp, temp, size_t(4), ac, abc);
+
+    T bcd[12];
+    nTemp = expansion_sum(size_t(4), bc, size_t(4), cd, temp);
+    size_t nBcd = expansion_sum(nTemp, temp, size_t(4), bd, bcd);
+
+    T adet[24];
+    T bdet[24];
+    T cdet[24];
+    T ddet[24];
+    size_t na = expansion_scale(nBcd, bcd, pa[2], adet);
+    size_t nb = expansion_scale(nCda, cda, -pb[2], bdet);
+    size_t nc = expansion_scale(nDab, dab, pc[2], cdet);
+    size_t nd = expansion_scale(nAbc, abc, -pd[2], ddet);
+
+    T abdet[48];
+    T cddet[48];
+    T det[96];
+    size_t nab = expansion_sum(na, adet, nb, bdet, abdet);
+    size_t ncd = expansion_sum(nc, cdet, nd, ddet, cddet);
+    size_t nDet = expansion_sum(nab, abdet, ncd, cddet, det);
+
+    return sign(det[nDet - 1]);
+}
+
+//------------------------------------------------------------------------------
+template<typename T>
+int quetzal::geometry::internal::incircle_exact(T adx, T ady, T bdx, T bdy, T cdx, T cdy)
+{
+    T bc[4];
+    T ca[4];
+    T ab[4];
+    two_two_diff(bdx, cdy, cdx, bdy, bc);
+    two_two_diff(cdx, ady, adx, cdy, ca);
+    two_two_diff(adx, bdy, bdx, ady, ab);
+
+    // Each term is (x * x + y * y) * minor, scaled twice per coordinate
+    auto lift = [](const T* e, T x, T y, T* h) -> size_t
+    {
+        T x8[8];
+        T x16[16];
+        T y8[8];
+        T y16[16];
+        size_t nx8 = expansion_scale(size_t(4), e, x, x8);
+        size_t nx16 = expansion_scale(nx8, x8, x, x16);
+        size_t ny8 = expansion_scale(size_t(4), e, y, y8);
+        size_t ny16 = expansion_scale(ny8, y8, y, y16);
+        return expansion_sum(nx16, x16, ny16, y16, h);
+    };
+
+    T adet[32];
+    T bdet[32];
+    T cdet[32];
+    size_t na = lift(bc, adx, ady, adet);
+    size_t nb = lift(ca, bdx, bdy, bdet);
+    size_t nc = lift(ab, cdx, cdy, cdet);
+
+    T abdet[64];
+    T det[96];
+    size_t nab = expansion_sum(na, adet, nb, bdet, abdet);
+    size_t nDet = expansion_sum(nab, abdet, nc, cdet, det);
+
+    return sign(det[nDet - 1]);
+}
+
+//------------------------------------------------------------------------------
+template<typename T>
+int quetzal::geometry::internal::incircle_exact(const T* pa, const T* pb, const T* pc, const T* pd)
+{
+    T ab[4];
+    T bc[4];
+    T cd[4];
+    T da[4];
+    T ac[4];
+    T bd[4];
+    two_two_diff(pa[0], pb[1], pb[0], pa[1], ab);
+    two_two_diff(pb[0], pc[1], pc[0], pb[1], bc);
+    two_two_diff(pc[0], pd[1], pd[0], pc[1], cd);
+    two_two_diff(pd[0], pa[1], pa[0], pd[1], da);
+    two_two_diff(pa[0], pc[1], pc[0], pa[1], ac);
+    two_two_diff(pb[0], pd[1], pd[0], pb[1], bd);
+
+    T temp[8];
+    size_t nTemp;
+
+    T cda[12];
+    nTemp = expansion_sum(size_t(4), cd, size_t(4), da, temp);
+    size_t nCda = expansion_sum(nTemp, temp, size_t(4), ac, cda);
+
+    T dab[12];
+    nTemp = expansion_sum(size_t(4), da, size_t(4), ab, temp);
+    size_t nDab = expansion_sum(nTemp, temp, size_t(4), bd, dab);
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        bd[i] = -bd[i];
+        ac[i] = -ac[i];
+    }
+
+    T abc[12];
+    nTemp = expansion_sum(size_t(4), ab, size_t(4), bc, temp);
+    size_t nAbc = expansion_sum(nTemp, temp, size_t(4), ac, abc);
+
+    T bcd[12];
+    nTemp = expansion_sum(size_t(4), bc, size_t(4), cd, temp);
+    size_t nBcd = expansion_sum(nTemp, temp, size_t(4), bd, bcd);
+
+    // Each lifted term is (x * x + y * y) * minor, scaled twice per coordinate
+    auto lift = [](size_t n, const T* e, const T* p, T s, T* h) -> size_t
+    {
+        T x24[24];
+        T x48[48];
+        T y24[24];
+        T y48[48];
+        size_t nx24 = expansion_scale(n, e, p[0], x24);
+        size_t nx48 = expansion_scale(nx24, x24, s * p[0], x48);
+        size_t ny24 = expansion_scale(n, e, p[1], y24);
+        size_t ny48 = expansion_scale(ny24, y24, s * p[1], y48);
+        return expansion_sum(nx48, x48, ny48, y48, h);
+    };
+
+    T adet[96];
+    T bdet[96];
+    T cdet[96];
+    T ddet[96];
+    size_t na = lift(nBcd, bcd, pa, T(1), adet);
+    size_t nb = lift(nCda, cda, pb, T(-1), bdet);
+    size_t nc = lift(nDab, dab, pc, T(1), cdet);
+    size_t nd = lift(nAbc, abc, pd, T(-1), ddet);
+
+    T abdet[192];
+    T cddet[192];
+    T det[384];
+    size_t nab = expansion_sum(na, adet, nb, bdet, abdet);
+    size_t ncd = expansion_sum(nc, cdet, nd, ddet, cddet);
+    size_t nDet = expansion_sum(nab, abdet, ncd, cddet, det);
+
+    return sign(det[nDet - 1]);
+}
+
+#endif // QUETZAL_GEOMETRY_PREDICATES_HPP
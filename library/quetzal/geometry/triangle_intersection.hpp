@@ -0,0 +1,304 @@
+#if !defined(QUETZAL_GEOMETRY_TRIANGLE_INTERSECTION_HPP)
+#define QUETZAL_GEOMETRY_TRIANGLE_INTERSECTION_HPP
+//------------------------------------------------------------------------------
+// geometry
+// triangle_intersection.hpp
+//------------------------------------------------------------------------------
+
+// Triangle-triangle intersection in 3d, plane side classification in the style of Guigue-Devillers
+// Vertex sides of each plane are decided with exact orient3d, so disjoint, crossing, and coplanar cases are classified exactly
+// Constructed points, and the overlap of the two plane sections along the line of intersection of the planes, are in floating point
+// Triangles are assumed to be nondegenerate
+
+#include "Intersection.hpp"
+#include "Point.hpp"
+#include "Polygon.hpp"
+#include "Segment.hpp"
+#include "predicates.hpp"
+#include "quetzal/math/Vector.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+#include <cstddef>
+#include <cassert>
+
+namespace quetzal::geometry
+{
+
+    // All six vertices lie in a common plane
+    template<typename V> requires (V::dimension == 3)
+    bool triangle_coplanar(const V& a0, const V& a1, const V& a2, const V& b0, const V& b1, const V& b2);
+
+    // Returns locus Empty, Point, or Segment for triangles in distinct planes
+    // For coplanar triangles, also Polygon for an overlap with nonzero area, the convex intersection region
+    template<typename V> requires (V::dimension == 3)
+    Intersection<typename V::traits_type> triangle_intersection(const V& a0, const V& a1, const V& a2, const V& b0, const V& b1, const V& b2);
+
+namespace internal
+{
+
+    // Points where triangle t meets the plane through another triangle with normal n and point p, given exact vertex sides
+    template<typename V>
+    size_t triangle_plane_section(const std::array<V, 3>& t, const std::array<int, 3>& sides, const V& n, const V& p, std::array<V, 2>& points);
+
+    template<typename V>
+    Intersection<typename V::traits_type> triangle_intersection_coplanar(const std::array<V, 3>& a, const std::array<V, 3>& b);
+
+} // namespace internal
+
+} // namespace quetzal::geometry
+
+//------------------------------------------------------------------------------
+template<typename V> requires (V::dimension == 3)
+bool quetzal::geometry::triangle_coplanar(const V& a0, const V& a1, const V& a2, const V& b0, const V& b1, const V& b2)
+{
+    return orient3d(a0, a1, a2, b0) == 0 && orient3d(a0, a1, a2, b1) == 0 && orient3d(a0, a1, a2, b2) == 0;
+}
+
+//------------------------------------------------------------------------------
+template<typename V> requires (V::dimension == 3)
+quetzal::geometry::Intersection<typename V::traits_type> quetzal::geometry::triangle_intersection(const V& a0, const V& a1, const V& a2, const V& b0, const V& b1, const V& b2)
+{
+    std::array<V, 3> a = {a0, a1, a2};
+    std::array<V, 3> b = {b0, b1, b2};
+
+    std::array<int, 3> sidesB;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        sidesB[i] = orient3d(a0, a1, a2, b[i]);
+    }
+
+    if ((sidesB[0] > 0 && sidesB[1] > 0 && sidesB[2] > 0) || (sidesB[0] < 0 && sidesB[1] < 0 && sidesB[2] < 0))
+    {
+        return {};
+    }
+
+    if (sidesB[0] == 0 && sidesB[1] == 0 && sidesB[2] == 0)
+    {
+        return internal::triangle_intersection_coplanar(a, b);
+    }
+
+    std::array<int, 3> sidesA;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        sidesA[i] = orient3d(b0, b1, b2, a[i]);
+    }
+
+    if ((sidesA[0] > 0 && sidesA[1] > 0 && sidesA[2] > 0) || (sidesA[0] < 0 && sidesA[1] < 0 && sidesA[2] < 0))
+    {
+        return {};
+    }
+
+    V normalA = cross(a1 - a0, a2 - a0);
+    V normalB = cross(b1 - b0, b2 - b0);
+
+    // Each triangle meets the plane of the other in a point or a segment, both on the line of intersection of the planes
+    std::array<V, 2> pointsA;
+    std::array<V, 2> pointsB;
+    size_t nA = internal::triangle_plane_section(a, sidesA, normalB, b0, pointsA);
+    size_t nB = internal::triangle_plane_section(b, sidesB, normalA, a0, pointsB);
+    assert(nA > 0 && nB > 0);
+
+    V direction = cross(normalA, normalB);
+
+    auto order = [&direction](std::array<V, 2>& points, size_t n) -> std::array<typename V::value_type, 2>
+    {
+        if (n == 1)
+        {
+            points[1] = points[0];
+        }
+
+        std::array<typename V::value_type, 2> t = {dot(direction, points[0]), dot(direction, points[1])};
+        if (t[1] < t[0])
+        {
+            std::swap(points[0], points[1]);
+            std::swap(t[0], t[1]);
+        }
+
+        return t;
+    };
+
+    std::array<typename V::value_type, 2> tA = order(pointsA, nA);
+    std::array<typename V::value_type, 2> tB = order(pointsB, nB);
+
+    if (tA[1] < tB[0] || tB[1] < tA[0])
+    {
+        return {};
+    }
+
+    const V& pointLower = tA[0] >= tB[0] ? pointsA[0] : pointsB[0];
+    const V& pointUpper = tA[1] <= tB[1] ? pointsA[1] : pointsB[1];
+
+    if (vector_eq(pointLower, pointUpper))
+    {
+        return Intersection<typename V::traits_type>(pointLower);
+    }
+
+    return Intersection<typename V::traits_type>(Segment<typename V::traits_type>(pointLower, pointUpper));
+}
+
+//------------------------------------------------------------------------------
+template<typename V>
+size_t quetzal::geometry::internal::triangle_plane_section(const std::array<V, 3>& t, const std::array<int, 3>& sides, const V& n, const V& p, std::array<V, 2>& points)
+{
+    using T = V::value_type;
+
+    size_t count = 0;
+    for (size_t i = 0; i < 3 && count < 2; ++i)
+    {
+        if (sides[i] == 0)
+        {
+            points[count++] = t[i];
+        }
+    }
+
+    for (size_t i = 0; i < 3 && count < 2; ++i)
+    {
+        size_t j = (i + 1) % 3;
+        if (sides[i] * sides[j] < 0)
+        {
+            // Sides are exact, the crossing parameter is clamped in case the floating point distances disagree
+            T di = dot(n, t[i] - p);
+            T dj = dot(n, t[j] - p);
+            T denom = di - dj;
+            T s = denom != T(0) ? di / denom : T(0.5);
+            s = std::min(std::max(s, T(0)), T(1));
+            points[count++] = t[i] + (t[j] - t[i]) * s;
+        }
+    }
+
+    return count;
+}
+
+//------------------------------------------------------------------------------
+template<typename V>
+quetzal::geometry::Intersection<typename V::traits_type> quetzal::geometry::internal::triangle_intersection_coplanar(const std::array<V, 3>& a, const std::array<V, 3>& b)
+{
+    using T = V::value_type;
+    using reduced_type = math::Vector<typename V::traits_type::reduced_traits>;
+
+    // Project onto the coordinate plane most nearly parallel to the triangles
+    V normal = cross(a[1] - a[0], a[2] - a[0]);
+    size_t k = 0;
+    for (size_t i = 1; i < 3; ++i)
+    {
+        if (std::abs(normal[i]) > std::abs(normal[k]))
+        {
+            k = i;
+        }
+    }
+
+    size_t i0 = (k + 1) % 3;
+    size_t i1 = (k + 2) % 3;
+    auto project = [i0, i1](const V& v) -> reduced_type
+    {
+        return reduced_type(v[i0], v[i1]);
+    };
+
+    std::array<reduced_type, 3> b2 = {project(b[0]), project(b[1]), project(b[2])};
+    int orientationB = orient2d(b2[0], b2[1], b2[2]);
+    assert(orientationB != 0);
+
+    // Sutherland-Hodgman clipping of a against each edge of b, inside tests are exact
+    std::vector<V> polygon(a.begin(), a.end());
+    std::vector<V> clipped;
+    for (size_t i = 0; i < 3 && !polygon.empty(); ++i)
+    {
+        const reduced_type& e0 = b2[i];
+        const reduced_type& e1 = b2[(i + 1) % 3];
+
+        auto side = [&](const V& v) -> int
+        {
+            return orient2d(e0, e1, project(v)) * orientationB;
+        };
+
+        auto distance = [&](const V& v) -> T
+        {
+            reduced_type v2 = project(v);
+            return ((e1.x() - e0.x()) * (v2.y() - e0.y()) - (e1.y() - e0.y()) * (v2.x() - e0.x())) * T(orientationB);
+        };
+
+        clipped.clear();
+        for (size_t j = 0; j < polygon.size(); ++j)
+        {
+            const V& p = polygon[j];
+            const V& q = polygon[(j + 1) % polygon.size()];
+            int sp = side(p);
+            int sq = side(q);
+
+            if (sp >= 0)
+            {
+                clipped.push_back(p);
+            }
+
+            if (sp * sq < 0)
+            {
+                T dp = distance(p);
+                T dq = distance(q);
+                T s = dp != dq ? dp / (dp - dq) : T(0.5);
+                s = std::min(std::max(s, T(0)), T(1));
+                clipped.push_back(p + (q - p) * s);
+            }
+        }
+
+        polygon.swap(clipped);
+    }
+
+    // Remove coincident vertices
+    std::vector<V> vertices;
+    for (const auto& v : polygon)
+    {
+        if (vertices.empty() || !vector_eq(v, vertices.back()))
+        {
+            vertices.push_back(v);
+        }
+    }
+
+    if (vertices.size() > 1 && vector_eq(vertices.front(), vertices.back()))
+    {
+        vertices.pop_back();
+    }
+
+    if (vertices.empty())
+    {
+        return {};
+    }
+
+    if (vertices.size() == 1)
+    {
+        return Intersection<typename V::traits_type>(vertices.front());
+    }
+
+    bool bColinear = true;
+    for (size_t j = 2; j < vertices.size() && bColinear; ++j)
+    {
+        bColinear = orient2d(project(vertices[0]), project(vertices[1]), project(vertices[j])) == 0;
+    }
+
+    if (!bColinear)
+    {
+        return Intersection<typename V::traits_type>(Polygon<typename V::traits_type>(vertices.begin(), vertices.end()));
+    }
+
+    // Touching along an edge, the segment spans the extreme vertices
+    V direction = vertices[1] - vertices[0];
+    size_t jMin = 0;
+    size_t jMax = 0;
+    for (size_t j = 1; j < vertices.size(); ++j)
+    {
+        if (dot(direction, vertices[j]) < dot(direction, vertices[jMin]))
+        {
+            jMin = j;
+        }
+
+        if (dot(direction, vertices[j]) > dot(direction, vertices[jMax]))
+        {
+            jMax = j;
+        }
+    }
+
+    return Intersection<typename V::traits_type>(Segment<typename V::traits_type>(vertices[jMin], vertices[jMax]));
+}
+
+#endif // QUETZAL_GEOMETRY_TRIANGLE_INTERSECTION_HPP
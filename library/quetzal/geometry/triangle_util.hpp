@@ -8,6 +8,7 @@
 #include "quetzal/math/DimensionReducer.hpp"
 #include "quetzal/math/Vector.hpp"
 #include "Point.hpp"
+#include "predicates.hpp"
 #include "Segment.hpp"
 #include <cmath>
 
@@ -105,14 +106,14 @@ bool quetzal::geometry::triangle_contains(const V& a, const V& b, const V& c, co
 template<typename V> requires (V::dimension == 2)
 bool quetzal::geometry::triangle_ccw(const V& a, const V& b, const V& c)
 {
-    return dot(c - a, perp(b - a)) >= 0;
+    return orient2d(a, b, c) >= 0;
 }
 
 //------------------------------------------------------------------------------
 template<typename V> requires (V::dimension == 3)
 bool quetzal::geometry::triangle_ccw(const V& a, const V& b, const V& c, const V& normal)
 {
-    return dot(c - a, cross(normal, b - a)) >= 0;
+    return orient3d(a, b, c, a - normal) >= 0; // Sign of dot(c - a, cross(normal, b - a))
 }
 
 //------------------------------------------------------------------------------
@@ -166,13 +167,11 @@ typename V::value_type quetzal::geometry::triangle_signed_area(const V& a, const
 template<typename V> requires (V::dimension == 2)
 bool quetzal::geometry::internal::triangle_region_contains(const V& a, const V& b, const V& c, const V& point)
 {
-    using T = V::value_type;
-
-    T signa = dot(perp(b - a), point - a);
-    T signb = dot(perp(c - b), point - b);
-    T signc = dot(perp(a - c), point - c);
+    int signa = orient2d(a, b, point);
+    int signb = orient2d(b, c, point);
+    int signc = orient2d(c, a, point);
 
-    return (signa > T(0) && signb > T(0) && signc > T(0)) || (signa < T(0) && signb < T(0) && signc < T(0));
+    return (signa > 0 && signb > 0 && signc > 0) || (signa < 0 && signb < 0 && signc < 0);
 }
 
 /*
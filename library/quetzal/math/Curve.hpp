@@ -7,6 +7,7 @@
 //------------------------------------------------------------------------------
 
 #include <vector>
+#include <cstddef>
 
 namespace quetzal::math
 {
@@ -17,26 +18,43 @@ namespace quetzal::math
     // bezier, interpolated points, multi/connected, ...
 
     //--------------------------------------------------------------------------
-    template<typename T, typename U = T::component_type>
+    template<typename T, typename U = typename T::value_type>
     class Curve
     {
     public:
 
-        typedef T point_type; // curve point type
-        typedef U parameter_type; // curve parameter type
-        typedef point_type::component_type component_type; // curve point component type
+        using point_type = T; // curve point type
+        using parameter_type = U; // curve parameter type
+        using component_type = typename point_type::value_type; // curve point component type
+        using points_type = std::vector<point_type>;
 
         Curve() = default;
         Curve(const Curve&) = default;
-        Curve(const Curve&&) = default;
+        Curve(Curve&&) = default;
         virtual ~Curve() = default;
 
-        Curve operator=(const Curve&) = default;
-        Curve operator=(const Curve&&) = default;
+        Curve& operator=(const Curve&) = default;
+        Curve& operator=(Curve&&) = default;
 
         virtual point_type operator()(parameter_type t) const = 0;
+
+        // Batched evaluation at n + 1 uniformly spaced parameter values over [0, 1], appended to points
+        virtual void evaluate(size_t n, points_type& points) const;
     };
 
 } // namespace quetzal::math
 
+//------------------------------------------------------------------------------
+template<typename T, typename U>
+void quetzal::math::Curve<T, U>::evaluate(size_t n, points_type& points) const
+{
+    points.reserve(points.size() + n + 1);
+    for (size_t i = 0; i < n; ++i)
+    {
+        points.push_back((*this)(static_cast<parameter_type>(i) / static_cast<parameter_type>(n)));
+    }
+    points.push_back((*this)(static_cast<parameter_type>(1)));
+    return;
+}
+
 #endif // QUETZAL_MATH_CURVE_HPP
@@ -1,32 +1,52 @@
-#if !defined(QUETZAL_MATH_CURVEBezier_HPP)
-#define QUETZAL_MATH_CURVEBezier_HPP
+#if !defined(QUETZAL_MATH_CURVEBEZIER_HPP)
+#define QUETZAL_MATH_CURVEBEZIER_HPP
 //------------------------------------------------------------------------------
 // math
 // CurveBezier.hpp
 //------------------------------------------------------------------------------
 
 #include "Curve.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cassert>
 
 namespace quetzal::math
 {
 
     //--------------------------------------------------------------------------
-    template<typename T, typename U = T::component_type>
-    class CurveBezier : public Curve
+    template<typename T, typename U = typename T::value_type>
+    class CurveBezier final : public Curve<T, U>
     {
     public:
 
-        typedef std::vector<point_type> control_points_type;
+        using point_type = Curve<T, U>::point_type;
+        using parameter_type = Curve<T, U>::parameter_type;
+        using component_type = Curve<T, U>::component_type;
+        using points_type = Curve<T, U>::points_type;
+        using control_points_type = std::vector<point_type>;
 
         CurveBezier() = default;
-        CurveBezier(const Curve&) = default;
-        CurveBezier(const Curve&&) = default;
-        virtual ~CurveBezier() = default;
+        CurveBezier(const control_points_type& control_points);
+        CurveBezier(const CurveBezier&) = default;
+        CurveBezier(CurveBezier&&) = default;
+        ~CurveBezier() = default;
 
-        CurveBezier operator=(const CurveBezier&) = default;
-        CurveBezier operator=(const CurveBezier&&) = default;
+        CurveBezier& operator=(const CurveBezier&) = default;
+        CurveBezier& operator=(CurveBezier&&) = default;
 
-        virtual point_type operator()(parameter_type t) const;
+        point_type operator()(parameter_type t) const override;
+
+        // Forward differencing, degree + 1 direct evaluations to seed the difference table and additions only thereafter
+        void evaluate(size_t n, points_type& points) const override;
+
+        size_t degree() const;
+
+        // Number of uniform parameter segments for which the polygon is within tolerance of the curve,
+        // closed form from the control polygon second differences (Wang's formula), no curve evaluation
+        size_t segment_count(component_type tolerance) const;
+
+        // Appends segment_count(tolerance) + 1 points
+        void flatten(component_type tolerance, points_type& points) const;
 
         // Expose directly so that the container's interface can be used to its full extent
         control_points_type& control_points();
@@ -40,26 +60,138 @@ namespace quetzal::math
 } // namespace quetzal::math
 
 //------------------------------------------------------------------------------
-quetzal::math::CurveBezier::point_type quetzal::math::CurveBezier::operator()(parameter_type t) const
+template<typename T, typename U>
+quetzal::math::CurveBezier<T, U>::CurveBezier(const control_points_type& control_points) :
+    Curve<T, U>(),
+    m_control_points(control_points)
 {
+}
+
+//------------------------------------------------------------------------------
+template<typename T, typename U>
+typename quetzal::math::CurveBezier<T, U>::point_type quetzal::math::CurveBezier<T, U>::operator()(parameter_type t) const
+{
+    assert(!m_control_points.empty());
     assert(t >= static_cast<parameter_type>(0));
     assert(t <= static_cast<parameter_type>(1));
 
-    ...
+    // Horner-like evaluation of the Bernstein form, no temporary storage
+    size_t n = degree();
+    if (n == 0)
+    {
+        return m_control_points[0];
+    }
 
-    return ...
+    component_type s = component_type(1) - static_cast<component_type>(t);
+    component_type tn = component_type(1);
+    component_type binomial = component_type(1);
+    point_type point = m_control_points[0] * s;
+
+    for (size_t i = 1; i < n; ++i)
+    {
+        tn *= static_cast<component_type>(t);
+        binomial *= static_cast<component_type>(n - i + 1) / static_cast<component_type>(i);
+        point = (point + m_control_points[i] * (tn * binomial)) * s;
+    }
+
+    return point + m_control_points[n] * (tn * static_cast<component_type>(t));
+}
+
+//------------------------------------------------------------------------------
+template<typename T, typename U>
+void quetzal::math::CurveBezier<T, U>::evaluate(size_t n, points_type& points) const
+{
+    assert(!m_control_points.empty());
+
+    size_t d = degree();
+    if (n <= d)
+    {
+        Curve<T, U>::evaluate(n, points);
+        return;
+    }
+
+    // Difference table, differences[k] is the kth forward difference at the current sample
+    control_points_type differences;
+    differences.reserve(d + 1);
+    for (size_t i = 0; i <= d; ++i)
+    {
+        differences.push_back((*this)(static_cast<parameter_type>(i) / static_cast<parameter_type>(n)));
+    }
+
+    for (size_t k = 1; k <= d; ++k)
+    {
+        for (size_t i = d; i >= k; --i)
+        {
+            differences[i] -= differences[i - 1];
+        }
+    }
+
+    points.reserve(points.size() + n + 1);
+    points.push_back(differences[0]);
+    for (size_t i = 1; i < n; ++i)
+    {
+        for (size_t k = 0; k < d; ++k)
+        {
+            differences[k] += differences[k + 1];
+        }
+
+        points.push_back(differences[0]);
+    }
+
+    points.push_back(m_control_points.back()); // Exact end point, no accumulated error
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename T, typename U>
+size_t quetzal::math::CurveBezier<T, U>::degree() const
+{
+    assert(!m_control_points.empty());
+    return m_control_points.size() - 1;
+}
+
+//------------------------------------------------------------------------------
+template<typename T, typename U>
+size_t quetzal::math::CurveBezier<T, U>::segment_count(component_type tolerance) const
+{
+    assert(tolerance > component_type(0));
+
+    size_t n = degree();
+    if (n < 2)
+    {
+        return 1;
+    }
+
+    component_type m = component_type(0);
+    for (size_t i = 0; i + 2 <= n; ++i)
+    {
+        m = std::max(m, (m_control_points[i + 2] - m_control_points[i + 1] * component_type(2) + m_control_points[i]).norm());
+    }
+
+    component_type c = std::sqrt(static_cast<component_type>(n * (n - 1)) * m / (component_type(8) * tolerance));
+    return std::max(size_t(1), static_cast<size_t>(std::ceil(c)));
+}
+
+//------------------------------------------------------------------------------
+template<typename T, typename U>
+void quetzal::math::CurveBezier<T, U>::flatten(component_type tolerance, points_type& points) const
+{
+    evaluate(segment_count(tolerance), points);
+    return;
 }
 
 //------------------------------------------------------------------------------
-quetzal::math::CurveBezier::control_points_type& quetzal::math::CurveBezier::control_points()
+template<typename T, typename U>
+typename quetzal::math::CurveBezier<T, U>::control_points_type& quetzal::math::CurveBezier<T, U>::control_points()
 {
     return m_control_points;
 }
 
 //------------------------------------------------------------------------------
-const quetzal::math::CurveBezier::control_points_type& quetzal::math::CurveBezier::control_points() const
+template<typename T, typename U>
+const typename quetzal::math::CurveBezier<T, U>::control_points_type& quetzal::math::CurveBezier<T, U>::control_points() const
 {
     return m_control_points;
 }
 
-#endif // QUETZAL_MATH_CURVEBezier_HPP
+#endif // QUETZAL_MATH_CURVEBEZIER_HPP
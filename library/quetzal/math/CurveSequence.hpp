@@ -6,27 +6,48 @@
 //------------------------------------------------------------------------------
 
 #include "Curve.hpp"
+#include "CurveBezier.hpp"
+#include <cmath>
+#include <cassert>
 
 namespace quetzal::math
 {
 
+    // Each curve in the sequence covers an equal share of the parameter interval [0, 1]
+    // Curves are held by value as type C so that evaluation of the sections is not dispatched through the base class
+
     //--------------------------------------------------------------------------
-    template<typename T, typename U = T::component_type>
-    class CurveSequence : public Curve
+    template<typename T, typename U = typename T::value_type, typename C = CurveBezier<T, U>>
+    class CurveSequence final : public Curve<T, U>
     {
     public:
 
-        typedef std::vector<Curve> container_type;
+        using point_type = Curve<T, U>::point_type;
+        using parameter_type = Curve<T, U>::parameter_type;
+        using component_type = Curve<T, U>::component_type;
+        using points_type = Curve<T, U>::points_type;
+        using curve_type = C;
+        using container_type = std::vector<curve_type>;
 
         CurveSequence() = default;
-        CurveSequence(const Curve&) = default;
-        CurveSequence(const Curve&&) = default;
-        virtual ~CurveSequence() = default;
+        CurveSequence(const container_type& container);
+        CurveSequence(const CurveSequence&) = default;
+        CurveSequence(CurveSequence&&) = default;
+        ~CurveSequence() = default;
+
+        CurveSequence& operator=(const CurveSequence&) = default;
+        CurveSequence& operator=(CurveSequence&&) = default;
+
+        point_type operator()(parameter_type t) const override;
 
-        CurveSequence operator=(const CurveSequence&) = default;
-        CurveSequence operator=(const CurveSequence&&) = default;
+        // Batched per section when n is a multiple of the section count, shared end points are emitted once
+        void evaluate(size_t n, points_type& points) const override;
 
-        virtual point_type operator()(parameter_type t) const;
+        // Sum of the section segment counts
+        size_t segment_count(component_type tolerance) const;
+
+        // Each section flattened to its own segment count, shared end points are emitted once
+        void flatten(component_type tolerance, points_type& points) const;
 
         // Expose directly so that the container's interface can be used to its full extent
         container_type& container();
@@ -40,31 +61,102 @@ namespace quetzal::math
 } // namespace quetzal::math
 
 //------------------------------------------------------------------------------
-quetzal::math::CurveSequence::point_type quetzal::math::CurveSequence::operator()(parameter_type t) const
+template<typename T, typename U, typename C>
+quetzal::math::CurveSequence<T, U, C>::CurveSequence(const container_type& container) :
+    Curve<T, U>(),
+    m_container(container)
 {
+}
+
+//------------------------------------------------------------------------------
+template<typename T, typename U, typename C>
+typename quetzal::math::CurveSequence<T, U, C>::point_type quetzal::math::CurveSequence<T, U, C>::operator()(parameter_type t) const
+{
+    assert(!m_container.empty());
     assert(t >= static_cast<parameter_type>(0));
     assert(t <= static_cast<parameter_type>(1));
 
-    t *= m_container.size();
-    unsigned int n = static_cast<unsigned int>(floor(t));
+    t *= static_cast<parameter_type>(m_container.size());
+    size_t n = static_cast<size_t>(std::floor(t));
     if (n == m_container.size()) // t == 1
     {
         --n;
     }
 
-    t -= n;
+    t -= static_cast<parameter_type>(n);
 
     return m_container[n](t);
 }
 
 //------------------------------------------------------------------------------
-quetzal::math::CurveSequence::container_type& quetzal::math::CurveSequence::curve_sequence()
+template<typename T, typename U, typename C>
+void quetzal::math::CurveSequence<T, U, C>::evaluate(size_t n, points_type& points) const
+{
+    assert(!m_container.empty());
+
+    if (n == 0 || n % m_container.size() != 0)
+    {
+        Curve<T, U>::evaluate(n, points);
+        return;
+    }
+
+    size_t nSection = n / m_container.size();
+    points.reserve(points.size() + n + 1);
+    for (size_t i = 0; i < m_container.size(); ++i)
+    {
+        if (i > 0)
+        {
+            points.pop_back();
+        }
+
+        m_container[i].evaluate(nSection, points);
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename T, typename U, typename C>
+size_t quetzal::math::CurveSequence<T, U, C>::segment_count(component_type tolerance) const
+{
+    size_t n = 0;
+    for (const auto& curve : m_container)
+    {
+        n += curve.segment_count(tolerance);
+    }
+
+    return n;
+}
+
+//------------------------------------------------------------------------------
+template<typename T, typename U, typename C>
+void quetzal::math::CurveSequence<T, U, C>::flatten(component_type tolerance, points_type& points) const
+{
+    assert(!m_container.empty());
+
+    for (size_t i = 0; i < m_container.size(); ++i)
+    {
+        if (i > 0)
+        {
+            points.pop_back();
+        }
+
+        m_container[i].flatten(tolerance, points);
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename T, typename U, typename C>
+typename quetzal::math::CurveSequence<T, U, C>::container_type& quetzal::math::CurveSequence<T, U, C>::container()
 {
     return m_container;
 }
 
 //------------------------------------------------------------------------------
-const quetzal::math::CurveSequence::container_type& quetzal::math::CurveSequence::curve_sequence() const
+template<typename T, typename U, typename C>
+const typename quetzal::math::CurveSequence<T, U, C>::container_type& quetzal::math::CurveSequence<T, U, C>::container() const
 {
     return m_container;
 }
@@ -6,8 +6,8 @@
 //------------------------------------------------------------------------------
 
 #include "Vector.hpp"
-#include <functional>
 #include <cmath>
+#include <cstddef>
 
 namespace quetzal::math
 {
@@ -34,22 +34,17 @@ namespace quetzal::math
 
 	private:
 
-		std::function<vector_reduced_type(const vector_type& v)> m_reducer;
-
-		static vector_reduced_type reduce_x_yz(const vector_type& v);
-		static vector_reduced_type reduce_x_zy(const vector_type& v);
-		static vector_reduced_type reduce_y_zx(const vector_type& v);
-		static vector_reduced_type reduce_y_xz(const vector_type& v);
-		static vector_reduced_type reduce_z_xy(const vector_type& v);
-		static vector_reduced_type reduce_z_yx(const vector_type& v);
+		// Reduced vector is (m_sign * v[m_iu], v[m_iv]), selected once so that reduce does not dispatch per call
+		size_t m_iu = 0;
+		size_t m_iv = 1;
+		value_type m_sign = value_type(1);
 	};
 
 } // namespace quetzal::math
 
 //------------------------------------------------------------------------------
 template<typename Traits>
-quetzal::math::DimensionReducer<Traits>::DimensionReducer(const vector_type& normal) :
-	m_reducer()
+quetzal::math::DimensionReducer<Traits>::DimensionReducer(const vector_type& normal)
 {
 	init(normal);
 }
@@ -62,15 +57,24 @@ void quetzal::math::DimensionReducer<Traits>::init(const vector_type& normal)
 
 	if (std::abs(normal.z()) >= std::abs(normal.x()) && std::abs(normal.z()) >= std::abs(normal.y()))
 	{
-		m_reducer = normal.z() > 0 ? reduce_z_xy : reduce_z_yx;
+		// xy or -xy
+		m_iu = 0;
+		m_iv = 1;
+		m_sign = normal.z() > 0 ? value_type(1) : value_type(-1);
 	}
 	else if (std::abs(normal.y()) >= std::abs(normal.x()))
 	{
-		m_reducer = normal.y() > 0 ? reduce_y_zx : reduce_y_xz;
+		// -xz or xz
+		m_iu = 0;
+		m_iv = 2;
+		m_sign = normal.y() > 0 ? value_type(-1) : value_type(1);
 	}
 	else
 	{
-		m_reducer = normal.x() > 0 ? reduce_x_yz : reduce_x_zy;
+		// yz or -yz
+		m_iu = 1;
+		m_iv = 2;
+		m_sign = normal.x() > 0 ? value_type(1) : value_type(-1);
 	}
 
 	return;
@@ -80,49 +84,7 @@ void quetzal::math::DimensionReducer<Traits>::init(const vector_type& normal)
 template<typename Traits>
 typename quetzal::math::DimensionReducer<Traits>::vector_reduced_type quetzal::math::DimensionReducer<Traits>::reduce(const vector_type& v) const
 {
-	return m_reducer(v);
-}
-
-//------------------------------------------------------------------------------
-template<typename Traits>
-typename quetzal::math::DimensionReducer<Traits>::vector_reduced_type quetzal::math::DimensionReducer<Traits>::reduce_x_yz(const vector_type& v)
-{
-	return {v.y(), v.z()};
-}
-
-//------------------------------------------------------------------------------
-template<typename Traits>
-typename quetzal::math::DimensionReducer<Traits>::vector_reduced_type quetzal::math::DimensionReducer<Traits>::reduce_x_zy(const vector_type& v)
-{
-	return {-v.y(), v.z()};
-}
-
-//------------------------------------------------------------------------------
-template<typename Traits>
-typename quetzal::math::DimensionReducer<Traits>::vector_reduced_type quetzal::math::DimensionReducer<Traits>::reduce_y_zx(const vector_type& v)
-{
-	return {-v.x(), v.z()};
-}
-
-//------------------------------------------------------------------------------
-template<typename Traits>
-typename quetzal::math::DimensionReducer<Traits>::vector_reduced_type quetzal::math::DimensionReducer<Traits>::reduce_y_xz(const vector_type& v)
-{
-	return {v.x(), v.z()};
-}
-
-//------------------------------------------------------------------------------
-template<typename Traits>
-typename quetzal::math::DimensionReducer<Traits>::vector_reduced_type quetzal::math::DimensionReducer<Traits>::reduce_z_xy(const vector_type& v)
-{
-	return {v.x(), v.y()};
-}
-
-//------------------------------------------------------------------------------
-template<typename Traits>
-typename quetzal::math::DimensionReducer<Traits>::vector_reduced_type quetzal::math::DimensionReducer<Traits>::reduce_z_yx(const vector_type& v)
-{
-	return {-v.x(), v.y()};
+	return {m_sign * v[m_iu], v[m_iv]};
 }
 
 #endif // QUETZAL_MATH_DIMENSIONREDUCER_HPP
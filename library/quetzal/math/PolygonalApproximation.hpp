@@ -5,97 +5,132 @@
 // PolygonalApproximation.hpp
 //------------------------------------------------------------------------------
 
+// Adaptive subdivision of a curve over [0, 1] into a polyline
+// Intervals are processed from an explicit stack, left half first, so vertices are appended in parameter order
+// A minimum depth guards against the midpoint of an S-shaped or closed interval happening to lie on its chord
+// C is the concrete curve type so that evaluation is not dispatched through the Curve base class when avoidable
+
+#include "floating_point.hpp"
 #include <vector>
-#include <map>
-#include "Curve.hpp"
+#include <cstddef>
 
 namespace quetzal::math
 {
 
     //--------------------------------------------------------------------------
-    template<typename T, typename U = T::component_type>
+    template<typename C>
     class PolygonalApproximation
     {
     public:
 
-        typedef T point_type; // curve point type
-        typedef U parameter_type; // curve parameter type
-        typedef point_type::component_type component_type; // curve point component type
-        typedef std::vector<point_type> vertices_type;
+        using curve_type = C;
+        using point_type = C::point_type; // curve point type
+        using parameter_type = C::parameter_type; // curve parameter type
+        using component_type = C::component_type; // curve point component type
+        using vertices_type = std::vector<point_type>;
 
-        PolygonalApproximation(const Curve<point_type, parameter_type>& curve, component_type threshold = 0.01);
-        PolygonalApproximation(const PolygonalApproximation&) = delete;
+        PolygonalApproximation(const curve_type& curve, component_type threshold = component_type(0.01), size_t depthMin = 2, size_t depthMax = 16);
+        PolygonalApproximation(const PolygonalApproximation&) = default;
         ~PolygonalApproximation() = default;
 
-        PolygonalApproximation operator=(const PolygonalApproximation&) = delete;
+        PolygonalApproximation& operator=(const PolygonalApproximation&) = default;
+
+        const vertices_type& vertices() const;
 
-        vertices_type vertices() const;
+    private:
 
-    private;
+        struct Section
+        {
+            parameter_type tStart;
+            parameter_type tEnd;
+            point_type pointStart;
+            point_type pointEnd;
+            size_t depth;
+        };
 
-        void approximate_interval(parameter_type tStart, parameter_type tEnd, point_type pointStart, point_type pointEnd);
-        bool collinear(point_type pointStart, point_type pointEnd, point_type pointMid);
+        void approximate(const curve_type& curve);
+        bool collinear(const point_type& pointStart, const point_type& pointEnd, const point_type& pointMid) const;
 
-        Curve<point_type, parameter_type>& m_curve;
         component_type m_threshold; // maximum distance of point from line relative to length of segment for the given interval
-        map<parameter_type, point_type> m_vertices;
+        size_t m_depthMin; // subdivision is unconditional up to this depth
+        size_t m_depthMax; // limit on subdivision, bounds the stack size to m_depthMax + 1
+        vertices_type m_vertices;
     };
 
 } // namespace quetzal::math
 
 //------------------------------------------------------------------------------
-template<typename T, typename U>
-quetzal::math::PolygonalApproximation<T, U>::PolygonalApproximation(const Curve& curve, component_type threshold)
-    m_curve(curve),
+template<typename C>
+quetzal::math::PolygonalApproximation<C>::PolygonalApproximation(const curve_type& curve, component_type threshold, size_t depthMin, size_t depthMax) :
     m_threshold(threshold),
+    m_depthMin(depthMin),
+    m_depthMax(depthMax),
     m_vertices()
 {
-    parameter_type t0 = static_cast<parameter_type>(0);
-    parameter_type t1 = static_cast<parameter_type>(1);
-    approximate_interval(t0, t1, m_curve(t0), m_curve(t1));
+    approximate(curve);
 }
 
 //------------------------------------------------------------------------------
-template<typename T, typename U>
-quetzal::math::PolygonalApproximation<T, U>::vertices_type quetzal::math::PolygonalApproximation<T, U>::vertices() const
+template<typename C>
+const typename quetzal::math::PolygonalApproximation<C>::vertices_type& quetzal::math::PolygonalApproximation<C>::vertices() const
 {
-    vertices_type vs;
-    for (const auto i : m_vertices)
-    {
-        vs.push_back(i->second);
-    }
-
-    return vs;
+    return m_vertices;
 }
 
 //------------------------------------------------------------------------------
-template<typename T, typename U>
-void quetzal::math::PolygonalApproximation<T, U>::approximate_interval(parameter_type tStart, parameter_type tEnd, point_type pointStart, point_type pointEnd)
+template<typename C>
+void quetzal::math::PolygonalApproximation<C>::approximate(const curve_type& curve)
 {
-    parameter_type tMid = (tStart + tEnd) / static_cast<parameter_type>(2);
-    point_type pointMid = m_curve(tMid);
+    parameter_type t0 = static_cast<parameter_type>(0);
+    parameter_type t1 = static_cast<parameter_type>(1);
+    point_type point0 = curve(t0);
+    point_type point1 = curve(t1);
 
-    if (!collinear(pointStart, pointEnd, pointMid)
-    {
-        m_vertices[tMid] = pointMid;
+    std::vector<Section> sections;
+    sections.reserve(m_depthMax + 1);
+    sections.push_back({t0, t1, point0, point1, 0});
 
-        approximate_interval(tStart, tMid, pointStart, pointMid);
-        approximate_interval(tMid, tEnd, pointMid, pointEnd);
+    m_vertices.push_back(point0);
+
+    while (!sections.empty())
+    {
+        Section section = sections.back();
+        sections.pop_back();
+
+        parameter_type tMid = (section.tStart + section.tEnd) / static_cast<parameter_type>(2);
+        point_type pointMid = curve(tMid);
+
+        if (section.depth < m_depthMin || (section.depth < m_depthMax && !collinear(section.pointStart, section.pointEnd, pointMid)))
+        {
+            sections.push_back({tMid, section.tEnd, pointMid, section.pointEnd, section.depth + 1});
+            sections.push_back({section.tStart, tMid, section.pointStart, pointMid, section.depth + 1});
+        }
+        else
+        {
+            m_vertices.push_back(section.pointEnd);
+        }
     }
 
     return;
 }
 
 //------------------------------------------------------------------------------
-bool quetzal::math::PolygonalApproximation<T, U>::collinear(point_type pointStart, point_type pointEnd, point_type pointMid)
+template<typename C>
+bool quetzal::math::PolygonalApproximation<C>::collinear(const point_type& pointStart, const point_type& pointEnd, const point_type& pointMid) const
 {
     point_type segment = pointEnd - pointStart;
-    point_type n = normalize(segment);
+    component_type length = segment.norm();
+    if (float_eq0(length))
+    {
+        return vector_eq(pointMid, pointStart);
+    }
+
+    point_type n = segment / length;
     point_type v = pointStart - pointMid;
 
-    component_type d = norm(v - dot(v, n) * n);
+    component_type d = (v - dot(v, n) * n).norm();
 
-    return (d / norm(segment)) < m_threshold;
+    return (d / length) < m_threshold;
 }
 
 #endif // QUETZAL_MATH_POLYGONALAPPROXIMATION_HPP
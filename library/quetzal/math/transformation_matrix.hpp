@@ -488,7 +488,7 @@ quetzal::math::Matrix<typename Traits::value_type, 2, 2> quetzal::math::linear_m
     m(1, 0) = (b1.x() * a0.x() - b0.x() * a1.x()) * d;
     m(1, 1) = (b1.y() * a0.x() - b0.y() * a1.x()) * d;
 */
-    typename Traits::value_type d = Traits::value_type(1) / (a0.y() * a1.x() - a0.x() * a1.y());
+    typename Traits::value_type d = typename Traits::value_type(1) / (a0.y() * a1.x() - a0.x() * a1.y());
 
     matrix2_type m;
     m(0, 0) = (a0.y() * b1.x() - a1.y() * b0.x()) * d;
@@ -0,0 +1,359 @@
+#if !defined(QUETZAL_MODEL_DEFORMATION_HPP)
+#define QUETZAL_MODEL_DEFORMATION_HPP
+//------------------------------------------------------------------------------
+// model
+// Deformation.hpp
+//------------------------------------------------------------------------------
+
+#include "mesh_attributes.hpp"
+#include "quetzal/common/id.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <execution>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace quetzal::model
+{
+
+    //--------------------------------------------------------------------------
+    // Sequence of per vertex deformations applied to a mesh in as few passes as possible
+    // Each stage sees the z extent of the mesh as it was after the previous stages, the same as applying them one at a time
+    // Stages that preserve z share a pass, a stage that moves z ends the pass and the extent is measured again before the next one
+    // Built in stages are stored as concrete types, each stage runs as a tight loop over a block of vertices so that the stage inlines into the loop
+    template<typename M>
+    class Deformation
+    {
+    public:
+
+        using mesh_type = M;
+        using value_type = M::value_type;
+        using vector_type = M::vector_type;
+        using vertex_attributes_type = M::vertex_attributes_type;
+        using stage_type = std::function<void(vertex_attributes_type& av, value_type z0, value_type z1)>;
+
+        Deformation() = default;
+        Deformation(const Deformation&) = default;
+        ~Deformation() = default;
+
+        Deformation& operator=(const Deformation&) = default;
+
+        // The following append a stage and return *this for chaining
+
+        // bMovesZ false only if stage never changes position z, otherwise later stages would see a stale extent
+        Deformation& add(stage_type stage, bool bMovesZ = true);
+
+        // Rotate positions and normals about axis by an angle proportional to z
+        Deformation& tuskify(const vector_type& axis, value_type angle);
+
+        // Scale x and y by a factor that varies with z
+        Deformation& undulate(value_type amplitude, value_type period);
+
+        // Rotate positions about the z-axis by an angle proportional to z
+        Deformation& swirl(value_type angle);
+
+        // Rotate positions about the z-axis by an angle proportional to z and to the distance from the z-axis
+        Deformation& swirler(value_type angle_z, value_type angle_r, value_type r_max);
+
+        size_t size() const;
+        bool empty() const;
+        void clear();
+
+        // Apply the stages in order to each vertex with the z extent of mesh, measured again after each stage that moves z
+        // Vertices are processed in parallel, face normals are recalculated once at the end with bNormals
+        void apply(M& mesh, bool bNormals = true) const;
+
+        // Apply the stages in order to each vertex in a single pass, every stage sees the given z extent
+        void apply(M& mesh, value_type z0, value_type z1, bool bNormals = true) const;
+
+    private:
+
+        struct Tuskify
+        {
+            void operator()(vertex_attributes_type& av, value_type z0, value_type z1) const;
+
+            vector_type axis;
+            value_type angle;
+        };
+
+        struct Undulate
+        {
+            void operator()(vertex_attributes_type& av, value_type z0, value_type z1) const;
+
+            value_type amplitude;
+        };
+
+        struct Swirl
+        {
+            void operator()(vertex_attributes_type& av, value_type z0, value_type z1) const;
+
+            value_type angle;
+        };
+
+        struct Swirler
+        {
+            void operator()(vertex_attributes_type& av, value_type z0, value_type z1) const;
+
+            value_type angle_z;
+            value_type angle_r;
+            value_type r_max;
+        };
+
+        struct Stage
+        {
+            std::variant<Tuskify, Undulate, Swirl, Swirler, stage_type> function;
+            bool bMovesZ;
+        };
+
+        // Apply stages [iBegin, iEnd) to each vertex with the given z extent
+        void apply_stages(M& mesh, size_t iBegin, size_t iEnd, value_type z0, value_type z1) const;
+
+        static std::pair<value_type, value_type> z_extent(const M& mesh);
+
+        static constexpr size_t block_size = 256;
+
+        std::vector<Stage> m_stages;
+    };
+
+} // namespace quetzal::model
+
+//------------------------------------------------------------------------------
+template<typename M>
+quetzal::model::Deformation<M>& quetzal::model::Deformation<M>::add(stage_type stage, bool bMovesZ)
+{
+    m_stages.push_back({stage, bMovesZ});
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+quetzal::model::Deformation<M>& quetzal::model::Deformation<M>::tuskify(const vector_type& axis, value_type angle)
+{
+    assert(axis.unit());
+    m_stages.push_back({Tuskify{axis, angle}, true});
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+quetzal::model::Deformation<M>& quetzal::model::Deformation<M>::undulate(value_type amplitude, [[maybe_unused]] value_type period)
+{
+    // nLevel 2, needs to be passed in (or as a function of dz) ...
+    m_stages.push_back({Undulate{amplitude * value_type(0.3333333)}, false});
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+quetzal::model::Deformation<M>& quetzal::model::Deformation<M>::swirl(value_type angle)
+{
+    m_stages.push_back({Swirl{angle}, false});
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+quetzal::model::Deformation<M>& quetzal::model::Deformation<M>::swirler(value_type angle_z, value_type angle_r, value_type r_max)
+{
+    m_stages.push_back({Swirler{angle_z, angle_r, r_max}, false});
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+size_t quetzal::model::Deformation<M>::size() const
+{
+    return m_stages.size();
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+bool quetzal::model::Deformation<M>::empty() const
+{
+    return m_stages.empty();
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::model::Deformation<M>::clear()
+{
+    m_stages.clear();
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::model::Deformation<M>::apply(M& mesh, bool bNormals) const
+{
+    auto [z0, z1] = z_extent(mesh);
+
+    size_t iBegin = 0;
+    while (iBegin < m_stages.size())
+    {
+        // A pass runs up to and including the next stage that moves z
+        size_t iEnd = iBegin;
+        while (iEnd < m_stages.size() && !m_stages[iEnd].bMovesZ)
+        {
+            ++iEnd;
+        }
+
+        iEnd = std::min(iEnd + 1, m_stages.size());
+
+        apply_stages(mesh, iBegin, iEnd, z0, z1);
+
+        if (iEnd < m_stages.size())
+        {
+            std::tie(z0, z1) = z_extent(mesh);
+        }
+
+        iBegin = iEnd;
+    }
+
+    if (bNormals)
+    {
+        calculate_face_normals(mesh);
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::model::Deformation<M>::apply(M& mesh, value_type z0, value_type z1, bool bNormals) const
+{
+    apply_stages(mesh, 0, m_stages.size(), z0, z1);
+
+    if (bNormals)
+    {
+        calculate_face_normals(mesh);
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::model::Deformation<M>::apply_stages(M& mesh, size_t iBegin, size_t iEnd, value_type z0, value_type z1) const
+{
+    if (iBegin == iEnd)
+    {
+        return;
+    }
+
+    // Vertices are split into blocks that stay in cache, each stage is dispatched once per block and runs as a tight loop over it
+    const size_t nVertices = mesh.vertex_store_count();
+    std::vector<size_t> blocks((nVertices + block_size - 1) / block_size);
+    std::iota(blocks.begin(), blocks.end(), size_t(0));
+
+    std::for_each(std::execution::par, blocks.begin(), blocks.end(), [&](size_t iBlock)
+    {
+        const id_type idBegin = id_type(iBlock * block_size);
+        const id_type idEnd = id_type(std::min(nVertices, (iBlock + 1) * block_size));
+
+        for (size_t i = iBegin; i < iEnd; ++i)
+        {
+            std::visit([&](const auto& function)
+            {
+                for (id_type idVertex = idBegin; idVertex < idEnd; ++idVertex)
+                {
+                    auto& vertex = mesh.vertex_store()[idVertex];
+                    if (!vertex.deleted())
+                    {
+                        function(vertex.attributes(), z0, z1);
+                    }
+                }
+            }, m_stages[i].function);
+        }
+    });
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::model::Deformation<M>::Tuskify::operator()(vertex_attributes_type& av, value_type z0, value_type z1) const
+{
+    // Rodrigues' rotation formula applied directly rather than through a rotation matrix per vertex
+    value_type theta = -angle * (value_type(0.5) * av.position().z() - z0) / (z1 - z0);
+    value_type c = cos(theta);
+    value_type s = sin(theta);
+
+    auto rotate = [&](const vector_type& v) -> vector_type
+    {
+        return c * v + s * cross(axis, v) + (value_type(1) - c) * dot(axis, v) * axis;
+    };
+
+    av.set_position(rotate(av.position()));
+    av.set_normal(rotate(av.normal()));
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::model::Deformation<M>::Undulate::operator()(vertex_attributes_type& av, value_type z0, value_type z1) const
+{
+    value_type zRelative = (av.position().z() - z0) / (z1 - z0);
+    value_type rScale = sin(zRelative * amplitude);
+    rScale *= value_type(1) - zRelative;
+    rScale = value_type(1) - value_type(0.5) * rScale;
+
+    av.position().set_x(av.position().x() * rScale);
+    av.position().set_y(av.position().y() * rScale);
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::model::Deformation<M>::Swirl::operator()(vertex_attributes_type& av, value_type z0, value_type z1) const
+{
+    value_type phi = angle * (av.position().z() - z0) / (z1 - z0);
+    value_type c = cos(phi);
+    value_type s = sin(phi);
+
+    value_type x = av.position().x();
+    value_type y = av.position().y();
+    av.position().set_x(c * x - s * y);
+    av.position().set_y(s * x + c * y);
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::model::Deformation<M>::Swirler::operator()(vertex_attributes_type& av, value_type z0, value_type z1) const
+{
+    value_type x = av.position().x();
+    value_type y = av.position().y();
+    value_type r = sqrt(x * x + y * y);
+    value_type phi = angle_z * (av.position().z() - z0) / (z1 - z0) + angle_r * r / r_max;
+    value_type c = cos(phi);
+    value_type s = sin(phi);
+
+    av.position().set_x(c * x - s * y);
+    av.position().set_y(s * x + c * y);
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+std::pair<typename quetzal::model::Deformation<M>::value_type, typename quetzal::model::Deformation<M>::value_type> quetzal::model::Deformation<M>::z_extent(const M& mesh)
+{
+    value_type z0 = std::numeric_limits<value_type>::max();
+    value_type z1 = std::numeric_limits<value_type>::lowest();
+
+    for (const auto& vertex : mesh.vertices())
+    {
+        value_type z = vertex.attributes().position().z();
+        z0 = std::min(z0, z);
+        z1 = std::max(z1, z);
+    }
+
+    return {z0, z1};
+}
+
+#endif // QUETZAL_MODEL_DEFORMATION_HPP
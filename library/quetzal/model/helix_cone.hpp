@@ -120,11 +120,7 @@ void quetzal::model::create_helix_cone(M& mesh, const std::string& name, size_ty
 
     seal_cylinder(m, nAzimuth, nz, false, true, false, {}, ExtentEndsFlat<T>(), idSubmesh);
 
-    // This has to be done after sealing bottom so that vertex halfedge iterators will work, fix that ...
-    for (auto& surface : m.submesh(idSubmesh).surfaces())
-    {
-        model::calculate_surface_normals(surface);
-    }
+    model::calculate_surface_normals(m.submesh(idSubmesh));
 
     m.check();
     mesh.append(m);
@@ -208,12 +204,8 @@ void quetzal::model::create_helix_cone(M& mesh, const std::string& name, const g
 
     seal_cylinder(m, nAzimuth, nz, false, true, false, {}, ExtentEndsFlat<T>(), idSubmesh);
 
-    // This has to be done after sealing bottom so that vertex halfedge iterators will work, fix that ...
     // face normals should be calculated above and applied to vertices here ...
-    for (auto& surface : m.submesh(idSubmesh).surfaces())
-    {
-        model::calculate_surface_normals(surface);
-    }
+    model::calculate_surface_normals(m.submesh(idSubmesh));
 
     m.check();
     mesh.append(m);
@@ -13,6 +13,8 @@
 #include "quetzal/math/Vector.hpp"
 #include "quetzal/math/floating_point.hpp"
 #include "quetzal/math/transformation_matrix.hpp"
+#include <algorithm>
+#include <execution>
 #include <functional>
 #include <limits>
 #include <vector>
@@ -34,6 +36,11 @@ namespace quetzal::model
     template<typename Traits>
     typename Traits::vector_type face_vertex_normal(const brep::Halfedge<Traits>& halfdedge);
 
+    // Face normal by Newell's method, its length is twice the face area
+    // Valid for non-planar and non-convex faces, returns 0 vector for degenerate faces
+    template<typename Traits>
+    typename Traits::vector_type face_area_normal(const brep::Face<Traits>& face);
+
     // Calculate smooth surface normal at this vertex
     // There must be no reflex vertices
     template<typename Traits>
@@ -60,21 +67,24 @@ namespace quetzal::model
 
     // Calculate a common face normal and apply it to all vertices in the face
     // There must be no shared vertices
+    // Faces are calculated in parallel
     template<typename M>
     void calculate_face_normals(M& mesh);
 
     // Calculate a common face normal and apply it to all vertices in the face
-    // There must be no reflex vertices
+    // Degenerate faces keep their normals
     template<typename Traits>
     void calculate_face_normal(brep::Face<Traits>& face);
 
     // Calculate normals for the surface, each face, and each vertex in the mesh/submesh
+    // Vertex normals are the angle weighted sum of the normals of the faces of the same surface at that vertex, area weighted with bAreaWeighted
+    // Faces and vertices are calculated in parallel with the same result as serially
     template<typename M>
-    void calculate_surface_normals(M& m);
+    void calculate_surface_normals(M& m, bool bAreaWeighted = false);
 
     // Calculate normals for the surface, each face, and each vertex in the surface
     template<typename Traits>
-    void calculate_surface_normals(brep::Surface<Traits>& surface);
+    void calculate_surface_normals(brep::Surface<Traits>& surface, bool bAreaWeighted = false);
 
     template<typename M>
     void calculate_spherical_normals(M& mesh);
@@ -107,6 +117,19 @@ namespace quetzal::model
     template<typename M>
     id_type adjust_matching_face(M& mesh, id_type idFaceA, id_type idFaceB);
 
+namespace internal
+{
+
+    // Calls f with the id of each halfedge based at the vertex position of idHalfedge, around both sides of a border vertex, until f returns false
+    template<typename M, typename F>
+    void for_each_vertex_halfedge(const M& mesh, id_type idHalfedge, F f);
+
+    // Calculate surface normals for the given faces of mesh in parallel
+    template<typename M>
+    void calculate_surface_normals(M& mesh, const std::vector<id_type>& idFaces, bool bAreaWeighted);
+
+} // namespace internal
+
 } // namespace quetzal::model
 
 //------------------------------------------------------------------------------
@@ -151,6 +174,28 @@ typename Traits::vector_type quetzal::model::face_vertex_normal(const brep::Half
 
 }
 
+//------------------------------------------------------------------------------
+template<typename Traits>
+typename Traits::vector_type quetzal::model::face_area_normal(const brep::Face<Traits>& face)
+{
+    // Sum of the cross products of the fan of triangles from the first vertex, relative to it to limit cancellation
+    const auto& mesh = face.mesh();
+    const id_type id0 = face.halfedge_id();
+    const auto& position0 = mesh.halfedge(id0).attributes().position();
+    typename Traits::vector_type normal;
+
+    id_type id = mesh.halfedge(id0).next_id();
+    id_type idNext = mesh.halfedge(id).next_id();
+    while (idNext != id0)
+    {
+        normal += cross(mesh.halfedge(id).attributes().position() - position0, mesh.halfedge(idNext).attributes().position() - position0);
+        id = idNext;
+        idNext = mesh.halfedge(id).next_id();
+    }
+
+    return normal;
+}
+
 //------------------------------------------------------------------------------
 template<typename Traits>
 typename Traits::vector_type quetzal::model::surface_vertex_normal(const brep::Vertex<Traits>& vertex)
@@ -338,11 +383,17 @@ void quetzal::model::transform_border_section_positions(M& mesh, id_type idHalfe
 template<typename M>
 void quetzal::model::calculate_face_normals(M& mesh)
 {
-    for (auto& face : mesh.faces())
+    std::vector<id_type> idFaces;
+    for (const auto& face : mesh.faces())
     {
-        calculate_face_normal(face);
+        idFaces.push_back(face.id());
     }
 
+    std::for_each(std::execution::par, idFaces.begin(), idFaces.end(), [&](id_type idFace)
+    {
+        calculate_face_normal(mesh.face(idFace));
+    });
+
     return;
 }
 
@@ -350,59 +401,52 @@ void quetzal::model::calculate_face_normals(M& mesh)
 template<typename Traits>
 void quetzal::model::calculate_face_normal(brep::Face<Traits>& face)
 {
-    if (face.halfedge_count() == 3)
+    // For a triangle this is the cross product of the edges at its first vertex
+    auto normal = face_area_normal(face);
+    if (vector_eq0(normal))
     {
-        // for best accuracy, choose the vertex that forms an angle closest to Pi/2 (dot product 0) and similar/minimum lengths ...
-
-        const auto& positionPrev = face.halfedge().prev().attributes().position();
-        const auto& position = face.halfedge().attributes().position();
-        const auto& positionNext = face.halfedge().next().attributes().position();
-
-        auto normal = normalize(cross(positionNext - position, positionPrev - position));
-        face.attributes().set_normal(normal);
-        for (auto& halfedge : face.halfedges())
-        {
-            halfedge.vertex().attributes().set_normal(normal);
-        }
-
         return;
     }
 
-    typename Traits::vector_type normalSum;
-
-    // can anything be done about reflex vertices here? not without at least approximate normal ...
-    // while all primitives now have usable normals, can't necessarily count on new work ...
-
-    for (auto& halfedge : face.halfedges())
-    {
-        if (!colinear(halfedge))
-        {
-            const auto& positionPrev = halfedge.prev().attributes().position();
-            const auto& position = halfedge.attributes().position();
-            const auto& positionNext = halfedge.next().attributes().position();
-            auto normal = normalize(cross(positionNext - position, positionPrev - position));
-            normalSum += normal;
-        }
-    }
-
     // Set all normals to the same value for consistency
-    auto normal = normalize(normalSum);
+    normal = normalize(normal);
     face.attributes().set_normal(normal);
-    for (auto& halfedge : face.halfedges())
+
+    auto& mesh = face.mesh();
+    id_type id = face.halfedge_id();
+    do
     {
-        halfedge.vertex().attributes().set_normal(normal);
-    }
+        mesh.halfedge(id).vertex().attributes().set_normal(normal);
+        id = mesh.halfedge(id).next_id();
+    } while (id != face.halfedge_id());
 
     return;
 }
 
 //------------------------------------------------------------------------------
 template<typename M>
-void quetzal::model::calculate_surface_normals(M& m)
+void quetzal::model::calculate_surface_normals(M& m, bool bAreaWeighted)
 {
+    std::vector<id_type> idFaces;
+    for (const auto& face : m.faces())
+    {
+        idFaces.push_back(face.id());
+    }
+
+    if (idFaces.empty())
+    {
+        return;
+    }
+
+    internal::calculate_surface_normals(m.face(idFaces.front()).mesh(), idFaces, bAreaWeighted);
+
+    // improve normal consistency in this special case ...
     for (auto& surface : m.surfaces())
     {
-        calculate_surface_normals(surface);
+        if (surface.face_count() == 1)
+        {
+            surface.attributes().set_normal(surface.faces().front().attributes().normal());
+        }
     }
 
     return;
@@ -410,54 +454,18 @@ void quetzal::model::calculate_surface_normals(M& m)
 
 //------------------------------------------------------------------------------
 template<typename Traits>
-void quetzal::model::calculate_surface_normals(brep::Surface<Traits>& surface)
+void quetzal::model::calculate_surface_normals(brep::Surface<Traits>& surface, bool bAreaWeighted)
 {
     assert(!surface.empty());
 
+    std::vector<id_type> idFaces(surface.face_ids().begin(), surface.face_ids().end());
+    internal::calculate_surface_normals(surface.faces().front().mesh(), idFaces, bAreaWeighted);
+
     // improve normal consistency in this special case ...
     // handle other special cases, for example, planar surfaces should have a single normal that is the same for all vertices, faces, and the surface ...
-    if (surface.face_count() == 1) // && surface.faces().front().vertex_count() == 3 ...
+    if (surface.face_count() == 1)
     {
-        auto& face = surface.faces().front();
-        calculate_face_normal(face);
-        face.surface().attributes().set_normal(face.attributes().normal());
-        return;
-    }
-
-    surface.reset();
-
-    for (auto& face : surface.faces())
-    {
-        typename Traits::vector_type normalFaceTotal;
-
-        for (auto& fh : face.halfedges())
-        {
-            if (fh.vertex().marked())
-            {
-                normalFaceTotal += fh.attributes().normal();
-                continue;
-            }
-
-            typename Traits::vector_type normalVertex = surface_vertex_normal(fh.vertex()); // calculate the common surface normal at that vertex position
-            normalFaceTotal += normalVertex;
-
-            for (auto& vh : fh.vertex().halfedges())
-            {
-                if (vh.face().surface_id() != surface.id())
-                {
-                    continue;
-                }
-
-                auto& vertex = vh.vertex();
-                assert(!vertex.marked());
-
-                vertex.attributes().set_normal(normalVertex);
-                vertex.set_marked();
-            }
-        }
-
-        typename Traits::vector_type normalFace = normalize(normalFaceTotal); // face normal is simple average of surface vertex normals ...
-        face.attributes().set_normal(normalFace);
+        surface.attributes().set_normal(surface.faces().front().attributes().normal());
     }
 
     return;
@@ -725,4 +733,141 @@ quetzal::id_type quetzal::model::adjust_matching_face(M& mesh, id_type idFaceA,
     return idHalfedgeB;
 }
 
+//------------------------------------------------------------------------------
+template<typename M, typename F>
+void quetzal::model::internal::for_each_vertex_halfedge(const M& mesh, id_type idHalfedge, F f)
+{
+    id_type id = idHalfedge;
+    do
+    {
+        if (!f(id))
+        {
+            return;
+        }
+
+        id = mesh.halfedge(mesh.halfedge(id).prev_id()).partner_id();
+    } while (id != nullid && id != idHalfedge);
+
+    if (id == nullid)
+    {
+        // Border vertex, continue from the start in the other direction
+        id = mesh.halfedge(idHalfedge).partner_id();
+        while (id != nullid)
+        {
+            id = mesh.halfedge(id).next_id();
+            if (!f(id))
+            {
+                return;
+            }
+
+            id = mesh.halfedge(id).partner_id();
+        }
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::model::internal::calculate_surface_normals(M& mesh, const std::vector<id_type>& idFaces, bool bAreaWeighted)
+{
+    using vector_type = M::vector_type;
+
+    // Surface id and weighted face normal at each halfedge of the faces, surface id is nullid for halfedges of other faces
+    std::vector<id_type> idSurfaces(mesh.halfedge_store_count(), nullid);
+    std::vector<vector_type> normalsWeighted(mesh.halfedge_store_count());
+
+    std::for_each(std::execution::par, idFaces.begin(), idFaces.end(), [&](id_type idFace)
+    {
+        const auto& face = mesh.face(idFace);
+        vector_type normalArea = face_area_normal(face);
+        vector_type normal = vector_eq0(normalArea) ? vector_type() : normalize(normalArea);
+
+        id_type id = face.halfedge_id();
+        do
+        {
+            const auto& halfedge = mesh.halfedge(id);
+            idSurfaces[id] = face.surface_id();
+
+            if (bAreaWeighted)
+            {
+                normalsWeighted[id] = normalArea;
+            }
+            else if (!vector_eq0(normal))
+            {
+                const auto& position = halfedge.attributes().position();
+                normalsWeighted[id] = angle(mesh.halfedge(halfedge.next_id()).attributes().position() - position, mesh.halfedge(halfedge.prev_id()).attributes().position() - position) * normal;
+            }
+
+            id = halfedge.next_id();
+        } while (id != face.halfedge_id());
+    });
+
+    // The lowest halfedge id of the surface at each vertex position sums the weighted normals in a fixed order and sets the vertex normals of all of them,
+    // so each vertex is written once and the result does not depend on scheduling
+    std::for_each(std::execution::par, idFaces.begin(), idFaces.end(), [&](id_type idFace)
+    {
+        const auto& face = mesh.face(idFace);
+        id_type idSurface = face.surface_id();
+
+        id_type idHalfedge = face.halfedge_id();
+        do
+        {
+            bool bLowest = true;
+            for_each_vertex_halfedge(mesh, idHalfedge, [&](id_type id)
+            {
+                bLowest = id >= idHalfedge || idSurfaces[id] != idSurface;
+                return bLowest;
+            });
+
+            if (bLowest)
+            {
+                vector_type normalTotalWeighted;
+                for_each_vertex_halfedge(mesh, idHalfedge, [&](id_type id)
+                {
+                    if (idSurfaces[id] == idSurface)
+                    {
+                        normalTotalWeighted += normalsWeighted[id];
+                    }
+
+                    return true;
+                });
+
+                if (!vector_eq0(normalTotalWeighted))
+                {
+                    vector_type normal = normalize(normalTotalWeighted);
+                    for_each_vertex_halfedge(mesh, idHalfedge, [&](id_type id)
+                    {
+                        if (idSurfaces[id] == idSurface)
+                        {
+                            mesh.halfedge(id).vertex().attributes().set_normal(normal);
+                        }
+
+                        return true;
+                    });
+                }
+            }
+
+            idHalfedge = mesh.halfedge(idHalfedge).next_id();
+        } while (idHalfedge != face.halfedge_id());
+    });
+
+    std::for_each(std::execution::par, idFaces.begin(), idFaces.end(), [&](id_type idFace)
+    {
+        auto& face = mesh.face(idFace);
+
+        vector_type normalFaceTotal;
+        id_type id = face.halfedge_id();
+        do
+        {
+            normalFaceTotal += mesh.halfedge(id).attributes().normal();
+            id = mesh.halfedge(id).next_id();
+        } while (id != face.halfedge_id());
+
+        face.attributes().set_normal(normalize(normalFaceTotal)); // face normal is simple average of surface vertex normals ...
+    });
+
+    return;
+}
+
 #endif // QUETZAL_MODEL_MESH_ATTRIBUTES_HPP
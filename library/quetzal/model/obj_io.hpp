@@ -12,8 +12,9 @@
 #include "quetzal/wavefront_obj/Writer.hpp"
 #include "quetzal/wavefront_obj/symbols.hpp"
 #include <array>
-#include <map>
+#include <cstddef>
 #include <filesystem>
+#include <functional>
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -51,8 +52,23 @@ void quetzal::model::read_obj(M& mesh, const std::filesystem::path& pathname)
     size_t nVertices = 0;
     std::string material;
 
+    // Unpartnered halfedges indexed by their exact start and end positions, positions read from the same obj vertex are identical
     using segment_type = std::array<typename M::point_type, 2>;
-    std::map<segment_type, id_type> segments;
+    auto segment_hash = [](const segment_type& segment) -> size_t
+    {
+        size_t h = 0;
+        for (const auto& point : segment)
+        {
+            for (size_t i = 0; i < M::vector_traits::dimension; ++i)
+            {
+                h = h * 1000003 ^ std::hash<typename M::value_type>()(point[i]);
+            }
+        }
+
+        return h;
+    };
+
+    std::unordered_map<segment_type, id_type, decltype(segment_hash)> segments(0, segment_hash);
 
     auto on_open = [&](M& mesh, const std::filesystem::path& pathname) -> void
     {
@@ -138,13 +154,13 @@ void quetzal::model::read_obj(M& mesh, const std::filesystem::path& pathname)
         for (typename M::halfedge_type& halfedge : face.halfedges())
         {
             id_type idHalfedge = halfedge.id();
-            const typename M::point_type& position = halfedge.attributes().position();
-            const typename M::point_type& positionNext = halfedge.next().attributes().position();
-            segment_type segment = {positionNext, position};
-            auto i = segments.find(segment);
+            const typename M::point_type position = halfedge.attributes().position();
+            const typename M::point_type positionNext = halfedge.next().attributes().position();
+
+            auto i = segments.find({positionNext, position});
             if (i == segments.end())
             {
-                segments[{position, positionNext}] = idHalfedge;
+                segments.emplace(segment_type{position, positionNext}, idHalfedge);
             }
             else
             {
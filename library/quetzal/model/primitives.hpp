@@ -21,7 +21,9 @@
 #include "quetzal/geometry/PolygonWithHoles.hpp"
 #include "quetzal/geometry/Path.hpp"
 #include "quetzal/math/math_util.hpp"
+#include "quetzal/triangulation/delaunay.hpp"
 #include <functional>
+#include <span>
 
 namespace quetzal::model
 {
@@ -46,6 +48,12 @@ namespace quetzal::model
     template<typename M>
     void create_hexagonal_grid(M& mesh, const std::string& name, size_type nRadial, value_type<M> rHexagon);
 
+    // Create a surface triangulating points in the xy-plane (Delaunay), lifted to heights z if given, one per point
+    // Duplicate points are used once, colinear points produce no faces
+    // Surfaces: "delaunay"
+    template<typename M>
+    void create_delaunay_surface(M& mesh, const std::string& name, std::span<const geometry::Point<typename M::vector_traits::reduced_traits>> points, std::span<const value_type<M>> z = {});
+
     // Create a disk in the xy-plane centered at the origin with nAzimuth divisions
     // Surfaces: "disk"
     template<typename M>
@@ -212,7 +220,7 @@ namespace quetzal::model
 
     // Create a geodesic sphere centered at the origin with the given radius
     // bVertex refers to vertical orientation, vertex or face
-    // nSubdivisions (nSegments? ...)
+    // nSubdivisions is the number of segments per icosahedron edge, producing 20 * nSubdivisions^2 triangles
     // Surfaces: per face "body_<i>"
     template<typename M>
     void create_geodesic_sphere(M& mesh, const std::string& name, value_type<M> radius, size_type nSubdivisions, bool bVertex = true, bool bSmooth = false);
@@ -313,7 +321,7 @@ void quetzal::model::create_grid(M& mesh, const std::string& name, size_type nx,
     }
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -355,7 +363,89 @@ void quetzal::model::create_hexagonal_grid(M& mesh, const std::string& name, siz
 
 */
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::model::create_delaunay_surface(M& mesh, const std::string& name, std::span<const geometry::Point<typename M::vector_traits::reduced_traits>> points, std::span<const value_type<M>> z)
+{
+    using T = M::value_type;
+    using point_type = M::point_type;
+    using vector_type = M::vector_type;
+
+    assert(z.empty() || z.size() == points.size());
+
+    std::vector<size_t> neighbors;
+    std::vector<size_t> indices = triangulation::delaunay(points, &neighbors);
+    size_type nTriangles = indices.size() / 3;
+    if (nTriangles == 0)
+    {
+        return;
+    }
+
+    std::vector<point_type> positions(points.size());
+    for (size_type i = 0; i < points.size(); ++i)
+    {
+        positions[i] = {points[i].x(), points[i].y(), z.empty() ? T(0) : z[i]};
+    }
+
+    // Area weighted vertex normals, continuous over the surface
+    std::vector<vector_type> faceNormals(nTriangles);
+    std::vector<vector_type> vertexNormals(points.size(), vector_type(T(0), T(0), T(0)));
+    for (size_type t = 0; t < nTriangles; ++t)
+    {
+        const point_type& p0 = positions[indices[3 * t + 0]];
+        vector_type normal = cross(positions[indices[3 * t + 1]] - p0, positions[indices[3 * t + 2]] - p0);
+        for (size_type i = 0; i < 3; ++i)
+        {
+            vertexNormals[indices[3 * t + i]] += normal;
+        }
+
+        faceNormals[t] = normalize(normal);
+    }
+
+    auto lower = points[0];
+    auto upper = points[0];
+    geometry::bounds(points, lower, upper);
+    T du = upper.x() > lower.x() ? T(1) / (upper.x() - lower.x()) : T(0);
+    T dv = upper.y() > lower.y() ? T(1) / (upper.y() - lower.y()) : T(0);
+
+    vector_type normalSurface = {T(0), T(0), T(1)};
+    typename M::surface_attributes_type as = {normalSurface};
+
+    M m;
+    id_type idSubmesh = m.create_submesh(name);
+    id_type idSurface = m.create_surface(idSubmesh, "delaunay", as);
+
+    // Halfedge i of triangle t runs from its vertex i to vertex i + 1, its partner starts at vertex i + 1 in the neighbor opposite vertex i + 2
+    for (size_type t = 0; t < nTriangles; ++t)
+    {
+        size_type nh = m.halfedge_store_count();
+        size_type nv = m.vertex_store_count();
+        id_type idFace = m.create_face(idSurface, nh, {faceNormals[t]});
+
+        for (size_type i = 0; i < 3; ++i)
+        {
+            size_t index = indices[3 * t + i];
+            size_t indexNext = indices[3 * t + (i + 1) % 3];
+            size_t u = neighbors[3 * t + (i + 2) % 3];
+
+            id_type idPartner = nullid;
+            if (u != triangulation::Triangulator::nullindex)
+            {
+                size_type j = indices[3 * u + 0] == indexNext ? 0 : indices[3 * u + 1] == indexNext ? 1 : 2;
+                idPartner = 3 * u + j;
+            }
+
+            m.create_halfedge(idPartner, nh + (i + 1) % 3, nh + (i + 2) % 3, nv + i, idFace);
+            m.create_vertex(nh + i, {positions[index], normalize(vertexNormals[index]), {(points[index].x() - lower.x()) * du, (points[index].y() - lower.y()) * dv}});
+        }
+    }
+
+    m.check();
+    mesh.append(std::move(m));
     return;
 }
 
@@ -384,7 +474,7 @@ void quetzal::model::create_disk(M& mesh, const std::string& name, size_type nAz
     m.rename_surface(m.surface_id(m.submesh_id(name), SurfaceName::Body), "disk");
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -491,7 +581,7 @@ void quetzal::model::create_box(M& mesh, const std::string& name, value_type<M>
     m.create_halfedge(18, 20, 22, 23,  5);
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -587,7 +677,7 @@ void quetzal::model::create_antiprism(M& mesh, const std::string& name, size_typ
     seal_cylinder(m, nAzimuth, 1, false, false, false, {}, extentZ, idSubmesh);
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -667,28 +757,35 @@ void quetzal::model::create_cylinder(M& mesh, const std::string& name, size_type
         create_band(m, nAzimuth, r0, r1, z0, z1, shift(extentAzimuth.interval(), azimuth0), shift(extentAzimuth.interval(), azimuth1), normalProto, normalProto, tsProto0, tsProto1, idSurface0, bSurfacesDistinct);
     }
 
-    for (size_type i = 2; i <= nz; ++i)
+    // Intermediate layers in bulk
+    size_type nzBands = (nz > 1 && bCuspUpper) ? nz - 1 : nz;
+    std::vector<vertices_attributes_type<M>> avss(nzBands > 1 ? nzBands - 1 : 0);
+    std::vector<texture_span_type<M>> tsProtos(avss.size());
+    for (size_type i = 2; i <= nzBands; ++i)
     {
         t = T(i) / T(nz);
         r1 = math::lerp(rLower, rUpper, t);
         z1 = math::lerp(zLower, zUpper, t);
         azimuth1 = math::lerp(azimuthLower, azimuthUpper, t);
 
-        if (i == nz && bCuspUpper)
-        {
-            connect_apex_cusp(m, nAzimuth, z1, shift(extentAzimuth.interval(), azimuth1), normalProto, idSurface0, bSurfacesDistinct, true);
-        }
-        else
-        {
-            auto tsProto1 = texture_span<T>(i, nz, bCuspLower, bCuspUpper);
-            connect_band(m, nAzimuth, r1, z1, shift(extentAzimuth.interval(), azimuth1), normalProto, tsProto1, idSurface0, bSurfacesDistinct, true);
-        }
+        tsProtos[i - 2] = texture_span<T>(i, nz, bCuspLower, bCuspUpper);
+        avss[i - 2] = vertices_attributes<M>(nAzimuth, r1, z1, shift(extentAzimuth.interval(), azimuth1), normalProto, tsProtos[i - 2]);
+    }
+
+    connect_bands(m, avss, tsProtos, extentAzimuth.interval().unit_length(), idSurface0, bSurfacesDistinct, true);
+
+    if (nz > 1 && bCuspUpper)
+    {
+        t = T(nz) / T(nz);
+        z1 = math::lerp(zLower, zUpper, t);
+        azimuth1 = math::lerp(azimuthLower, azimuthUpper, t);
+        connect_apex_cusp(m, nAzimuth, z1, shift(extentAzimuth.interval(), azimuth1), normalProto, idSurface0, bSurfacesDistinct, true);
     }
 
     seal_cylinder(m, nAzimuth, nz, bCuspLower, bCuspUpper, bOpenSide, extentAzimuth, extentZ, idSubmesh);
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -769,7 +866,7 @@ calculate_axial_vertex_normals(m, nAzimuth);
     seal_cylinder(m, nAzimuth, nz, bCuspLower, bCuspUpper, bOpenSide, extentAzimuth, extentZ, idSubmesh);
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -835,7 +932,7 @@ void quetzal::model::create_cylinder(M& mesh, const std::string& name, size_type
     seal_cylinder(m, nAzimuth, nz, false, false, false, {}, extentZ, idSubmesh);
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -910,7 +1007,7 @@ void quetzal::model::create_cylinder(M& mesh, const std::string& name, size_type
     seal_cylinder(m, nAzimuth, nz, false, false, false, {}, extentZ, idSubmesh);
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -1014,7 +1111,7 @@ void quetzal::model::create_cylinder(M& mesh, const std::string& name, size_type
     seal_cylinder(m, nAzimuth, nz, bCuspLower, bCuspUpper, false, {}, extentZ, idSubmesh);
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -1068,7 +1165,7 @@ void quetzal::model::create_cylinder(M& mesh, const std::string& name, size_type
     seal_cylinder(m, nAzimuth, nz, false, false, false, {}, extentZ, idSubmesh);
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -1135,7 +1232,7 @@ void quetzal::model::create_cylinder(M& mesh, const std::string& name, size_type
     }
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -1218,7 +1315,7 @@ calculate_axial_vertex_normals(m, nAzimuth);
     seal_cylinder(m, nAzimuth, nz, bCuspLower, bCuspUpper, bOpenSide, extentAzimuth, extentZ, idSubmesh);
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -1302,7 +1399,7 @@ void quetzal::model::create_anticylinder(M& mesh, const std::string& name, size_
     seal_cylinder(m, nAzimuth, nz, false, false, false, {}, extentZ, idSubmesh);
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -1380,7 +1477,7 @@ void quetzal::model::create_sphere(M& mesh, const std::string& name, size_type n
     seal_sphere(m, nAzimuth, nElevation, bCuspLower, bCuspUpper, bOpenSide, extentAzimuth, extentElevation, idSubmesh);
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -1478,7 +1575,7 @@ assert(float_eq0(radius0)); // ...
     seal_sphere(m, nAzimuth, nElevation, bCuspLower, bCuspUpper, bOpenSide, extentAzimuth, extentElevation, idSubmesh);
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -1564,7 +1661,7 @@ void quetzal::model::create_sphere(M& mesh, const std::string& name, size_type n
     seal_sphere(m, nAzimuth, nElevation, bCuspLower, bCuspUpper, bOpenSide, extentAzimuth, extentElevation, idSubmesh);
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -1605,6 +1702,10 @@ void quetzal::model::create_torus(M& mesh, const std::string& name, size_type nM
     std::vector<typename M::vertex_attributes_type> avs0(nMinor + 1);
     std::vector<typename M::vertex_attributes_type> avs1(nMinor + 1);
 
+    // Layers after the first band, connected in bulk
+    std::vector<vertices_attributes_type<M>> avss;
+    avss.reserve(nMajor > 1 ? nMajor - 1 : 0);
+
     for (size_type i = 0; i <= nMajor; ++i)
     {
         T t = T(i) / T(nMajor);
@@ -1659,14 +1760,16 @@ void quetzal::model::create_torus(M& mesh, const std::string& name, size_type nM
         }
         else
         {
-            connect_band(m, avs1, texture_span_top<M>, !bOpenMinor, idSurface); // testure_span? ...
+            avss.push_back(avs1);
         }
     }
 
+    connect_bands(m, avss, std::vector<texture_span_type<M>>(avss.size(), texture_span_top<M>), !bOpenMinor, idSurface); // testure_span? ...
+
     seal_torus(m, nMinor, nMajor, rMajor, bCuspLower, bCuspUpper, bOpenMinor, bOpenMajor, extentMinor, extentMajor, idSubmesh);
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -1768,7 +1871,7 @@ void quetzal::model::create_torus(M& mesh, const std::string& name, size_type nM
     seal_torus(m, nMinor, nMajor, (rMajorLower + rMajorUpper) / T(2), bCuspLower, bCuspUpper, bOpenMinor, bOpenMajor, extentMinor, extentMajor, idSubmesh); // ...
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -1868,7 +1971,7 @@ void quetzal::model::create_torus(M& mesh, const std::string& name, size_type nM
     seal_torus(m, nMinor, nMajor, fr(T(0.5), T(0.5)), bCuspLower, bCuspUpper, bOpenMinor, bOpenMajor, extentMinor, extentMajor, idSubmesh); // ...
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -1948,7 +2051,7 @@ void quetzal::model::create_tetrahedron(M& mesh, const std::string& name, value_
     }
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -2100,7 +2203,7 @@ void quetzal::model::create_octahedron(M& mesh, const std::string& name, value_t
     }
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -2284,7 +2387,7 @@ void quetzal::model::create_dodecahedron(M& mesh, const std::string& name, value
     }
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -2573,7 +2676,7 @@ void quetzal::model::create_icosahedron(M& mesh, const std::string& name, value_
 
     m.check();
     assert(check_spherical(m, radius));
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -2582,64 +2685,255 @@ template<typename M>
 void quetzal::model::create_geodesic_sphere(M& mesh, const std::string& name, value_type<M> radius, size_type nSubdivisions, bool bVertex, bool bSmooth)
 {
     using T = M::value_type;
+    using vertex_attributes_type = M::vertex_attributes_type;
+    using texcoord_type = M::vertex_attributes_type::texcoord_type;
 
     assert(radius > T(0));
     assert(nSubdivisions > 0);
 
     // Approximate a sphere by tessellating an icosahedron
 
-    M m;
-    create_icosahedron(m, name, radius, bVertex, bSmooth);
+    M base;
+    create_icosahedron(base, name, radius, bVertex, bSmooth);
     if (nSubdivisions == 1)
     {
-        mesh.append(m);
+        mesh.append(std::move(base));
         return;
     }
 
-    auto nFacesOrig = m.face_count();
-    for (size_t i = 0; i < nFacesOrig; ++i)
+    // Each icosahedron face is a patch of n * n triangles with lattice points (i, j), i + j <= n, at barycentric weights (n - i - j, i, j) of its halfedge vertices
+    // Points are shared through an index: the 12 corners, then n - 1 points per edge in the direction of its lower halfedge id, then each patch's interior points by row
+    const size_type n = nSubdivisions;
+    const size_type nh0 = base.halfedge_store_count();
+    assert(nh0 == 60);
+
+    std::vector<size_type> corners(nh0, nullid);
+    size_type nCorners = 0;
+    for (id_type id = 0; id < nh0; ++id)
     {
-        // Split all unmarked edges
-        id_type idHalfedge0 = m.face(i).halfedge_id();
-        id_type idHalfedge = idHalfedge0;
-        do
+        if (corners[id] == nullid)
         {
-            id_type idHalfedgeNext = m.halfedge(idHalfedge).next_id();
-
-            // Split unmarked edge
-            if (!m.halfedge(idHalfedge).marked())
+            // Walk the halfedges leaving this vertex
+            id_type idHalfedge = id;
+            do
             {
-                split_edge(m, idHalfedge, nSubdivisions);
+                corners[idHalfedge] = nCorners;
+                idHalfedge = base.halfedge(idHalfedge).prev().partner_id();
+            } while (idHalfedge != id);
 
-                // Mark partners of this edge's segments so that adjacent face edges will not be split
-                id_type idHalfedgeEdge = idHalfedge;
-                for (int j = 0; j < nSubdivisions; ++j)
-                {
-                    m.halfedge(idHalfedgeEdge).partner().set_marked();
-                    idHalfedgeEdge = m.halfedge(idHalfedgeEdge).next_id();
-                }
-            }
+            ++nCorners;
+        }
+    }
+
+    std::vector<size_type> edges(nh0, nullid);
+    size_type nEdges = 0;
+    for (id_type id = 0; id < nh0; ++id)
+    {
+        id_type idPartner = base.halfedge(id).partner_id();
+        if (id < idPartner)
+        {
+            edges[id] = nEdges;
+            edges[idPartner] = nEdges;
+            ++nEdges;
+        }
+    }
+
+    assert(nCorners == 12);
+    assert(nEdges == 30);
+
+    const size_type nPatches = nh0 / 3;
+    const size_type nPointsEdge = n - 1;
+    const size_type nPointsInterior = (n - 1) * (n - 2) / 2;
+    const size_type nPointsEdges = nCorners + nEdges * nPointsEdge;
+
+    auto edge_point = [&](id_type idHalfedge, size_type k) -> size_type
+    {
+        bool bForward = idHalfedge < base.halfedge(idHalfedge).partner_id();
+        return nCorners + edges[idHalfedge] * nPointsEdge + (bForward ? k : n - k) - 1;
+    };
+
+    auto point_index = [&](size_type f, size_type i, size_type j) -> size_type
+    {
+        id_type idHalfedge = 3 * f;
+        if (j == 0)
+        {
+            return i == 0 ? corners[idHalfedge] : (i == n ? corners[idHalfedge + 1] : edge_point(idHalfedge, i));
+        }
+        else if (i + j == n)
+        {
+            return j == n ? corners[idHalfedge + 2] : edge_point(idHalfedge + 1, j);
+        }
+        else if (i == 0)
+        {
+            return edge_point(idHalfedge + 2, n - j);
+        }
 
-            idHalfedge = idHalfedgeNext;
-        } while (idHalfedge != idHalfedge0);
+        return nPointsEdges + f * nPointsInterior + (j - 1) * (n - 1) - (j - 1) * j / 2 + i - 1;
+    };
+
+    auto lattice_point = [&](id_type idHalfedge, size_type i, size_type j) -> vertex_attributes_type
+    {
+        const auto& a = base.halfedge(idHalfedge).attributes().position();
+        const auto& b = base.halfedge(idHalfedge).next().attributes().position();
+        const auto& c = base.halfedge(idHalfedge).prev().attributes().position();
 
-        // Recursively triangulate by row
-        triangulate_rows(m, m.face(i).halfedge_id(), nSubdivisions);
+        vertex_attributes_type av;
+        av.set_position(T(n - i - j) * a + T(i) * b + T(j) * c);
+        project_vertex(av, radius);
+        return av;
+    };
+
+    std::vector<vertex_attributes_type> points(nPointsEdges + nPatches * nPointsInterior);
+
+    for (id_type id = 0; id < nh0; ++id)
+    {
+        points[corners[id]] = lattice_point(id, 0, 0);
+        if (id < base.halfedge(id).partner_id())
+        {
+            for (size_type k = 1; k < n; ++k)
+            {
+                points[edge_point(id, k)] = lattice_point(id, k, 0);
+            }
+        }
     }
 
-    project_vertices(m.vertices().begin(), m.vertices().end(), radius);
+    // Rows of all patches, row r of patch f is f * n + r
+    std::vector<size_type> iRows(nPatches * n);
+    std::iota(iRows.begin(), iRows.end(), size_type(0));
+
+    std::for_each(std::execution::par, iRows.begin(), iRows.end(), [&](size_type iRow)
+    {
+        size_type f = iRow / n;
+        size_type j = iRow % n;
+        if (j == 0)
+        {
+            return;
+        }
+
+        for (size_type i = 1; i + j < n; ++i)
+        {
+            points[point_index(f, i, j)] = lattice_point(3 * f, i, j);
+        }
+    });
+
+    // Row r of a patch holds triangles up(0), down(0), up(1), ... up(n - 1 - r), up triangles have their base on the row's lower edge
+    auto up_face = [&](size_type f, size_type i, size_type r) -> id_type
+    {
+        return f * n * n + r * (2 * n - r) + 2 * i;
+    };
+
+    auto down_face = [&](size_type f, size_type i, size_type r) -> id_type
+    {
+        return up_face(f, i, r) + 1;
+    };
+
+    // Halfedge of segment q along side s of patch f
+    auto side_halfedge = [&](size_type f, size_type s, size_type q) -> id_type
+    {
+        if (s == 0)
+        {
+            return 3 * up_face(f, q, 0);
+        }
+        else if (s == 1)
+        {
+            return 3 * up_face(f, n - 1 - q, q) + 1;
+        }
+
+        return 3 * up_face(f, 0, n - 1 - q) + 2;
+    };
+
+    // Sides run in opposite directions in adjacent patches
+    auto side_partner = [&](size_type f, size_type s, size_type q) -> id_type
+    {
+        id_type idPartner = base.halfedge(3 * f + s).partner_id();
+        return side_halfedge(idPartner / 3, idPartner % 3, n - 1 - q);
+    };
+
+    M m;
+    id_type idSubmesh = m.create_submesh(name);
 
+    const size_type nFaces = nPatches * n * n;
+    id_type idSurface0 = nullid;
     if (bSmooth)
     {
-        calculate_spherical_normals(m);
-        // spherical texture coordinates, with smooth icosahedron to start, splits should produce mostly correct texture coordinates ...
+        idSurface0 = m.create_surface(idSubmesh, SurfaceName::Body);
     }
     else
     {
-        calculate_face_normals(m);
-        apply_triangular_face_texcoords(m);
-        add_face_surfaces(m, SurfaceName::BodySection + "_");
+        for (id_type idFace = 0; idFace < nFaces; ++idFace)
+        {
+            id_type idSurface = m.create_surface(idSubmesh, SurfaceName::BodySection + "_" + to_string(idFace));
+            if (idFace == 0)
+            {
+                idSurface0 = idSurface;
+            }
+        }
+    }
+
+    m.halfedge_store().resize(3 * nFaces);
+    m.vertex_store().resize(3 * nFaces);
+    m.face_store().resize(nFaces);
+
+    const std::array<texcoord_type, 3> texcoords = {{{T(0), T(1)}, {T(1), T(1)}, {T(0.5), T(0)}}};
+
+    // Faceted texcoords are applied in face order from corner k0, the corner that splitting edges and triangulating rows left as the face halfedge
+    auto create_triangle = [&](id_type idFace, const std::array<size_type, 3>& ips, const std::array<id_type, 3>& idPartners, size_type k0)
+    {
+        id_type idHalfedge = 3 * idFace;
 
+        const auto& p0 = points[ips[0]].position();
+        const auto& p1 = points[ips[1]].position();
+        const auto& p2 = points[ips[2]].position();
+        typename M::vector_type normal = bSmooth ? normalize(p0 + p1 + p2) : normalize(cross(p1 - p0, p2 - p0));
+
+        id_type idSurface = bSmooth ? idSurface0 : idSurface0 + idFace;
+        m.face_store()[idFace] = {m, idFace, idSurface, idSubmesh, idHalfedge, {normal}};
+
+        for (size_type k = 0; k < 3; ++k)
+        {
+            id_type id = idHalfedge + k;
+            m.halfedge(id) = {m, id, idPartners[k], idHalfedge + (k + 1) % 3, idHalfedge + (k + 2) % 3, id, idFace};
+            m.vertex(id) = {m, id, id, points[ips[k]]};
+
+            if (!bSmooth)
+            {
+                m.vertex(id).attributes().set_normal(normal);
+                m.vertex(id).attributes().set_texcoord(texcoords[(k + 3 - k0) % 3]);
+            }
+        }
+
+        return;
+    };
+
+    std::for_each(std::execution::par, iRows.begin(), iRows.end(), [&](size_type iRow)
+    {
+        size_type f = iRow / n;
+        size_type r = iRow % n;
+        for (size_type i = 0; i + r < n; ++i)
+        {
+            // Up triangle (i, r), (i + 1, r), (i, r + 1)
+            create_triangle(up_face(f, i, r),
+                {point_index(f, i, r), point_index(f, i + 1, r), point_index(f, i, r + 1)},
+                {r > 0 ? 3 * down_face(f, i, r - 1) + 1 : side_partner(f, 0, i),
+                 i + r < n - 1 ? 3 * down_face(f, i, r) + 2 : side_partner(f, 1, r),
+                 i > 0 ? 3 * down_face(f, i - 1, r) : side_partner(f, 2, n - 1 - r)},
+                i + r < n - 1 ? 2 : (r == 0 ? 0 : 1));
+
+            // Down triangle (i + 1, r), (i + 1, r + 1), (i, r + 1)
+            if (i + r < n - 1)
+            {
+                create_triangle(down_face(f, i, r),
+                    {point_index(f, i + 1, r), point_index(f, i + 1, r + 1), point_index(f, i, r + 1)},
+                    {3 * up_face(f, i + 1, r) + 2, 3 * up_face(f, i, r + 1), 3 * up_face(f, i, r) + 1},
+                    2);
+            }
+        }
+    });
+
+    m.link_faces(0);
+
+    if (!bSmooth)
+    {
         for (auto& face : m.faces())
         {
             m.surface(face.surface_id()).attributes().set_normal(face.attributes().normal());
@@ -2648,7 +2942,7 @@ void quetzal::model::create_geodesic_sphere(M& mesh, const std::string& name, va
 
     m.check();
     assert(check_spherical(m, radius));
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -2737,7 +3031,7 @@ assert(texcoord.y() == T(0) || texcoord.y() == T(1));
     }
 */
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -2830,7 +3124,7 @@ idHalfedgeUpper = m.halfedge_store_count() - 2 * nAzimuth; // after last layer .
     }
 
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -2897,7 +3191,7 @@ void quetzal::model::create_swept_volume(M& mesh, const std::string& name, const
     }
 */
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -2968,7 +3262,7 @@ void quetzal::model::create_swept_volume(M& mesh, const std::string& name, const
     }
 */
     m.check();
-    mesh.append(m);
+    mesh.append(std::move(m));
     return;
 }
 
@@ -20,7 +20,10 @@
 #include "quetzal/model/Extent.hpp"
 #include <algorithm>
 #include <array>
+#include <execution>
 #include <functional>
+#include <numeric>
+#include <vector>
 
 namespace quetzal::model
 {
@@ -122,6 +125,11 @@ namespace quetzal::model
     template<typename M>
     void connect_band(M& mesh, const vertices_attributes_type<M>& avs1, texture_span_type<M> tsProto1, bool bClosed, id_type idSurface0, bool bSurfacesDistinct = false, bool bLinear = false);
 
+    // Bulk equivalent of connect_band applied to each of avss in turn with the corresponding tsProtos
+    // Band layout is the same, so the result can be sealed or extended by the other functions, but stores are sized once, bands are filled in parallel, and faces are linked to their surfaces in one pass at the end
+    template<typename M>
+    void connect_bands(M& mesh, const std::vector<vertices_attributes_type<M>>& avss, const std::vector<texture_span_type<M>>& tsProtos, bool bClosed, id_type idSurface0, bool bSurfacesDistinct = false, bool bLinear = false);
+
     // Create an open antiprism section connected to the previous section
     template<typename M>
     void connect_antiband(M& mesh, size_type nAzimuth, value_type<M> r1, value_type<M> z1, value_type<M> ty1, id_type idSurface0, bool bSurfacesDistinct = false);
@@ -178,6 +186,10 @@ namespace quetzal::model
     template<typename ForwardIterator>
     void project_vertices(ForwardIterator first, ForwardIterator last, typename ForwardIterator::value_type::attributes_type::value_type radius);
 
+    // Project vertex attributes onto sphere and calculate normal and texture coordinates
+    template<typename A>
+    void project_vertex(A& av, typename A::value_type radius);
+
     // Precalculate vertex values for a circle parallel to the xy-plane
     // Calculates normals and texture coordinates appropriate for a section of a single encompassing surface
     // Produces nAzimuth + 1 points
@@ -648,7 +660,7 @@ void quetzal::model::connect_apex_cusp(M& mesh, size_type nAzimuth, value_type<M
     using T = M::value_type;
 
     assert(nAzimuth > 2);
-    assert(mesh.halfedge_count() >= 2 * nAzimuth);
+    assert(mesh.halfedge_store_count() >= 2 * nAzimuth);
 
     T dAzimuth = T(0.5) * azimuth0.length() / T(nAzimuth);
     azimuth_interval_type<M> azimuth1 = {azimuth0.lower() + dAzimuth, azimuth0.upper() - dAzimuth};
@@ -678,7 +690,7 @@ void quetzal::model::connect_apex_cusp(M& mesh, size_type nAzimuth, value_type<M
         typename M::vertex_attributes_type av1 = mesh.vertex(j2 - 4 * nAzimuth).attributes();
         typename M::vertex_attributes_type av2 = avs1[j];
 
-        typename M::vector_type normal = mesh.face(mesh.face_count() - nAzimuth).attributes().normal();
+        typename M::vector_type normal = mesh.face(mesh.face_store_count() - nAzimuth).attributes().normal();
         if (!bLinear)
         {
             normal = normalize(cross(av0.position() - av2.position(), av1.position() - av2.position()));
@@ -720,7 +732,7 @@ void quetzal::model::connect_apex_cusp(M& mesh, const vertices_attributes_type<M
 
     size_type nAzimuth = avs1.size();
     assert(nAzimuth > 2);
-    assert(mesh.halfedge_count() >= 2 * nAzimuth);
+    assert(mesh.halfedge_store_count() >= 2 * nAzimuth);
 
     size_type nh = mesh.halfedge_store_count();
     size_type nv = mesh.vertex_store_count();
@@ -745,7 +757,7 @@ void quetzal::model::connect_apex_cusp(M& mesh, const vertices_attributes_type<M
         typename M::vertex_attributes_type av1 = mesh.vertex(j2 - 4 * nAzimuth).attributes();
         typename M::vertex_attributes_type av2 = avs1[j];
 
-        typename M::vector_type normal = mesh.face(mesh.face_count() - nAzimuth).attributes().normal();
+        typename M::vector_type normal = mesh.face(mesh.face_store_count() - nAzimuth).attributes().normal();
         if (!bLinear)
         {
             normal = normalize(cross(av0.position() - av2.position(), av1.position() - av2.position()));
@@ -785,7 +797,7 @@ void quetzal::model::connect_band(M& mesh, size_type nAzimuth, value_type<M> r1,
 {
     using T = M::value_type;
 
-    assert(mesh.halfedge_count() >= 2 * nAzimuth);
+    assert(mesh.halfedge_store_count() >= 2 * nAzimuth);
 
     auto position0 = mesh.halfedge(mesh.halfedge_store_count() - 2 * nAzimuth).attributes().position();
     T z0 = position0.z();
@@ -832,7 +844,7 @@ void quetzal::model::connect_band(M& mesh, const vertices_attributes_type<M>& av
 
     size_type nAzimuth = avs1.size() - 1;
     assert(nAzimuth > 2);
-    assert(mesh.halfedge_count() >= 2 * nAzimuth);
+    assert(mesh.halfedge_store_count() >= 2 * nAzimuth);
 
     size_type nh = mesh.halfedge_store_count();
     size_type nv = mesh.vertex_store_count();
@@ -858,7 +870,7 @@ void quetzal::model::connect_band(M& mesh, const vertices_attributes_type<M>& av
         typename M::vertex_attributes_type av2 = avs1[j + 1];
         typename M::vertex_attributes_type av3 = avs1[j];
 
-        typename M::vector_type normal = mesh.face(mesh.face_count() - nAzimuth).attributes().normal();
+        typename M::vector_type normal = mesh.face(mesh.face_store_count() - nAzimuth).attributes().normal();
         if (!bLinear)
         {
             normal = normalize(cross(av1.position() - av0.position(), av3.position() - av0.position()));
@@ -906,6 +918,124 @@ void quetzal::model::connect_band(M& mesh, const vertices_attributes_type<M>& av
     return;
 }
 
+//------------------------------------------------------------------------------
+template<typename M>
+void quetzal::model::connect_bands(M& mesh, const std::vector<vertices_attributes_type<M>>& avss, const std::vector<texture_span_type<M>>& tsProtos, bool bClosed, id_type idSurface0, bool bSurfacesDistinct, bool bLinear)
+{
+    using T = M::value_type;
+
+    assert(avss.size() == tsProtos.size());
+    if (avss.empty())
+    {
+        return;
+    }
+
+    size_type nBands = avss.size();
+    size_type nAzimuth = avss[0].size() - 1;
+    assert(nAzimuth > 2);
+
+    size_type nh = mesh.halfedge_store_count();
+    size_type nv = mesh.vertex_store_count();
+    size_type nf = mesh.face_store_count();
+    assert(nh >= 2 * nAzimuth);
+    assert(nv == nh);
+    assert(nf >= nAzimuth);
+
+    // Previous layer, its upper edges are partnered with the first band and with bLinear its face normals are carried up every band
+    std::vector<typename M::vector_type> normalsLinear(nAzimuth);
+    for (size_type j = 0; j < nAzimuth; ++j)
+    {
+        mesh.halfedge(nh - 2 * nAzimuth + j).set_partner_id(nh + j);
+        normalsLinear[j] = mesh.face(nf - nAzimuth + j).attributes().normal();
+    }
+
+    mesh.halfedge_store().resize(nh + 4 * nAzimuth * nBands);
+    mesh.vertex_store().resize(nv + 4 * nAzimuth * nBands);
+    mesh.face_store().resize(nf + nAzimuth * nBands);
+
+    std::vector<size_type> iBands(nBands);
+    std::iota(iBands.begin(), iBands.end(), size_type(0));
+
+    std::for_each(std::execution::par, iBands.begin(), iBands.end(), [&](size_type k)
+    {
+        const vertices_attributes_type<M>& avs1 = avss[k];
+        assert(avs1.size() == nAzimuth + 1);
+
+        size_type nhBand = nh + 4 * nAzimuth * k;
+        size_type nfBand = nf + nAzimuth * k;
+
+        for (size_type j = 0; j < nAzimuth; ++j)
+        {
+            size_type j0 = nhBand + j;
+            size_type j1 = j0 + nAzimuth;
+            size_type j2 = j1 + nAzimuth;
+            size_type j3 = j2 + nAzimuth;
+
+            id_type idSurface = idSurface0;
+            if (bSurfacesDistinct && idSurface != nullid)
+            {
+                idSurface += j;
+            }
+
+            // Lower vertices as the previous band left them, read from the mesh only for the first band since the others are being written concurrently
+            typename M::vertex_attributes_type av0;
+            typename M::vertex_attributes_type av1;
+            if (k == 0)
+            {
+                av0 = mesh.vertex(j3 - 4 * nAzimuth).attributes();
+                av1 = mesh.vertex(j2 - 4 * nAzimuth).attributes();
+            }
+            else
+            {
+                av0 = avss[k - 1][j];
+                av1 = avss[k - 1][j + 1];
+                if (bSurfacesDistinct)
+                {
+                    av0.texcoord().set_x(tsProtos[k - 1][0]);
+                    av1.texcoord().set_x(tsProtos[k - 1][1]);
+                }
+            }
+
+            typename M::vertex_attributes_type av2 = avs1[j + 1];
+            typename M::vertex_attributes_type av3 = avs1[j];
+
+            typename M::vector_type normal = bLinear ? normalsLinear[j] : normalize(cross(av1.position() - av0.position(), av3.position() - av0.position()));
+
+            id_type idFace = nfBand + j;
+            id_type idSubmesh = idSurface == nullid ? nullid : mesh.surface(idSurface).submesh_id();
+            mesh.face_store()[idFace] = {mesh, idFace, idSurface, idSubmesh, j0, {normal}};
+
+            id_type idPartner = j0 - 2 * nAzimuth;
+            mesh.halfedge(j0) = {mesh, j0, idPartner, j1, j3, j0, idFace};
+            idPartner = (j < nAzimuth - 1 ? j3 + 1 : (bClosed ? j3 - nAzimuth + 1 : nullid));
+            mesh.halfedge(j1) = {mesh, j1, idPartner, j2, j0, j1, idFace};
+            idPartner = (k < nBands - 1 ? j2 + 2 * nAzimuth : nullid);
+            mesh.halfedge(j2) = {mesh, j2, idPartner, j3, j1, j2, idFace};
+            idPartner = (j > 0 ? j1 - 1 : (bClosed ? j1 + nAzimuth - 1 : nullid));
+            mesh.halfedge(j3) = {mesh, j3, idPartner, j0, j2, j3, idFace};
+
+            mesh.vertex(j0) = {mesh, j0, j0, av0};
+            mesh.vertex(j1) = {mesh, j1, j1, av1};
+            mesh.vertex(j2) = {mesh, j2, j2, av2};
+            mesh.vertex(j3) = {mesh, j3, j3, av3};
+
+            if (bSurfacesDistinct)
+            {
+                mesh.vertex(j0).attributes().set_normal(normal);
+                mesh.vertex(j1).attributes().set_normal(normal);
+                mesh.vertex(j2).attributes().set_normal(normal);
+                mesh.vertex(j3).attributes().set_normal(normal);
+
+                mesh.vertex(j2).attributes().texcoord().set_x(tsProtos[k][1]);
+                mesh.vertex(j3).attributes().texcoord().set_x(tsProtos[k][0]);
+            }
+        }
+    });
+
+    mesh.link_faces(nf);
+    return;
+}
+
 //------------------------------------------------------------------------------
 template<typename M>
 void quetzal::model::connect_antiband(M& mesh, size_type nAzimuth, value_type<M> r1, value_type<M> z1, value_type<M> ty1, id_type idSurface0, bool bSurfacesDistinct)
@@ -914,7 +1044,7 @@ void quetzal::model::connect_antiband(M& mesh, size_type nAzimuth, value_type<M>
 
     assert(nAzimuth > 2);
     assert(r1 >= T(0));
-    assert(mesh.halfedge_count() >= 6 * nAzimuth);
+    assert(mesh.halfedge_store_count() >= 6 * nAzimuth);
 
     size_type nh = mesh.halfedge_store_count();
 
@@ -942,7 +1072,7 @@ void quetzal::model::connect_antiband(M& mesh, const vertices_attributes_type<M>
 
     size_type nAzimuth = avs1.size() - 1;
     assert(nAzimuth > 2);
-    assert(mesh.halfedge_count() >= 6 * nAzimuth);
+    assert(mesh.halfedge_store_count() >= 6 * nAzimuth);
 
     size_type nh = mesh.halfedge_store_count();
 
@@ -2217,32 +2347,40 @@ void quetzal::model::triangulate_rows(M& mesh, id_type idHalfedge, size_type n)
 template<typename ForwardIterator>
 void quetzal::model::project_vertices(ForwardIterator first, ForwardIterator last, typename ForwardIterator::value_type::attributes_type::value_type radius)
 {
-    using T = ForwardIterator::value_type::attributes_type::value_type;
-
     for (auto i = first; i != last; ++i)
     {
-        auto& av = i->attributes();
-        auto normal = normalize(av.position());
+        project_vertex(i->attributes(), radius);
+    }
 
-        av.set_position(radius * normal);
-        av.set_normal(normal);
+    return;
+}
 
-        // Derive texture coordinates from spherical coordinates of position
-        T phi = atan2(av.position().y(), av.position().x());
-        if (errno == EDOM) // Both x and y are 0
-        {
-            phi = math::Pi<T>;
-        }
-        if (phi < T(0))
-        {
-            phi += math::PiTwo<T>;
-        }
+//------------------------------------------------------------------------------
+template<typename A>
+void quetzal::model::project_vertex(A& av, typename A::value_type radius)
+{
+    using T = A::value_type;
+
+    auto normal = normalize(av.position());
+
+    av.set_position(radius * normal);
+    av.set_normal(normal);
 
-        // theta [0, Pi] -> texcoord [0, 1]
-        T theta = acos(std::clamp(av.position().z() / radius, T(-1), T(1)));
-        av.set_texcoord({phi / math::PiTwo<T>, theta / math::Pi<T>});
+    // Derive texture coordinates from spherical coordinates of position
+    T phi = atan2(av.position().y(), av.position().x());
+    if (errno == EDOM) // Both x and y are 0
+    {
+        phi = math::Pi<T>;
+    }
+    if (phi < T(0))
+    {
+        phi += math::PiTwo<T>;
     }
 
+    // theta [0, Pi] -> texcoord [0, 1]
+    T theta = acos(std::clamp(av.position().z() / radius, T(-1), T(1)));
+    av.set_texcoord({phi / math::PiTwo<T>, theta / math::Pi<T>});
+
     return;
 }
 
@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------------
+// triangulation
+// Triangulator.cpp
+//------------------------------------------------------------------------------
+
+#include "Triangulator.hpp"
+#include <cassert>
+
+//------------------------------------------------------------------------------
+quetzal::triangulation::Triangulator::Triangulator() :
+    m_context(),
+    m_sweep()
+{
+}
+
+//------------------------------------------------------------------------------
+void quetzal::triangulation::Triangulator::clear()
+{
+    m_context.Clear();
+    return;
+}
+
+//------------------------------------------------------------------------------
+void quetzal::triangulation::Triangulator::add_vertex(size_t id, double x, double y)
+{
+    m_context.AddContourPoint(id, x, y);
+    return;
+}
+
+//------------------------------------------------------------------------------
+void quetzal::triangulation::Triangulator::close_contour()
+{
+    m_context.CloseContour();
+    return;
+}
+
+//------------------------------------------------------------------------------
+void quetzal::triangulation::Triangulator::add_point(size_t id, double x, double y)
+{
+    m_context.AddPoint(id, x, y);
+    return;
+}
+
+//------------------------------------------------------------------------------
+void quetzal::triangulation::Triangulator::set_front_index(p2t::FrontIndex frontIndex)
+{
+    m_context.set_front_index(frontIndex);
+    return;
+}
+
+//------------------------------------------------------------------------------
+void quetzal::triangulation::Triangulator::set_predicates(p2t::Predicates predicates)
+{
+    m_sweep.set_predicates(predicates);
+    return;
+}
+
+//------------------------------------------------------------------------------
+void quetzal::triangulation::Triangulator::triangulate()
+{
+    assert(m_context.triangle_count() == 0);
+    m_sweep.Triangulate(m_context);
+    return;
+}
+
+//------------------------------------------------------------------------------
+size_t quetzal::triangulation::Triangulator::triangle_count() const
+{
+    return m_context.triangle_count();
+}
+
+//------------------------------------------------------------------------------
+size_t quetzal::triangulation::Triangulator::vertex_id(size_t n, size_t i) const
+{
+    assert(i < 3);
+    return m_context.GetTriangle(n).GetPoint(i)->m_id;
+}
+
+//------------------------------------------------------------------------------
+size_t quetzal::triangulation::Triangulator::neighbor(size_t n, size_t i) const
+{
+    assert(i < 3);
+    p2t::Triangle& triangle = m_context.GetTriangle(n);
+    const p2t::Triangle* pNeighbor = triangle.GetNeighbor(i);
+    if (triangle.m_bEdgeConstrained[i] || pNeighbor == nullptr)
+    {
+        return nullindex;
+    }
+
+    // Exterior triangles keep m_interior == nullindex
+    return pNeighbor->m_interior;
+}
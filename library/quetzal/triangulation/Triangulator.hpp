@@ -0,0 +1,69 @@
+#if !defined(QUETZAL_TRIANGULATION_TRIANGULATOR_HPP)
+#define QUETZAL_TRIANGULATION_TRIANGULATOR_HPP
+//------------------------------------------------------------------------------
+// triangulation
+// Triangulator.hpp
+//------------------------------------------------------------------------------
+
+// Reusable constrained Delaunay triangulator of polygons with holes
+// Points, edges, triangles, and advancing front nodes live in pools that clear keeps, so once warmed up a triangulator reused across polygons of similar size does not allocate
+// Results are indexed by integer, vertices by the caller's ids and neighbors by triangle index
+// Not thread safe, use one instance per thread
+
+#include "cdt/SweepContext.hpp"
+#include "cdt/Sweep.hpp"
+#include <cstddef>
+
+namespace quetzal::triangulation
+{
+
+    //--------------------------------------------------------------------------
+    class Triangulator
+    {
+    public:
+
+        static constexpr size_t nullindex = static_cast<size_t>(-1);
+
+        Triangulator();
+        Triangulator(const Triangulator&) = delete;
+        ~Triangulator() = default;
+
+        Triangulator& operator=(const Triangulator&) = delete;
+
+        // Discards the current polygon and results, keeping allocated storage
+        void clear();
+
+        // Appends a vertex to the contour under construction
+        void add_vertex(size_t id, double x, double y);
+
+        // Closes the contour under construction, the first contour is the boundary and the rest are holes
+        void close_contour();
+
+        // Steiner point, added between contours
+        void add_point(size_t id, double x, double y);
+
+        // Whether the sweep indexes its advancing front, by default only for large inputs
+        void set_front_index(p2t::FrontIndex frontIndex);
+
+        // Exact by default, inexact only to measure the cost of exact predicates
+        void set_predicates(p2t::Predicates predicates);
+
+        void triangulate();
+
+        size_t triangle_count() const;
+
+        // Id of vertex i of triangle n, counterclockwise
+        size_t vertex_id(size_t n, size_t i) const;
+
+        // Triangle across the edge opposite vertex i of triangle n, or nullindex on the boundary
+        size_t neighbor(size_t n, size_t i) const;
+
+    private:
+
+        mutable p2t::SweepContext m_context;
+        p2t::Sweep m_sweep;
+    };
+
+} // namespace quetzal::triangulation
+
+#endif // QUETZAL_TRIANGULATION_TRIANGULATOR_HPP
@@ -4,15 +4,52 @@
 p2t::AdvancingFront::AdvancingFront() :
     head_(nullptr),
     tail_(nullptr),
-    search_node_(nullptr)
+    search_node_(nullptr),
+    indexed_(false),
+    skip_pool_(),
+    random_(0)
 {
 }
 
-void p2t::AdvancingFront::init(Node& head, Node& tail)
+void p2t::AdvancingFront::clear()
 {
+    head_ = nullptr;
+    tail_ = nullptr;
+    search_node_ = nullptr;
+    indexed_ = false;
+    skip_pool_.clear();
+}
+
+void p2t::AdvancingFront::init(Node& head, Node& tail, bool indexed)
+{
+    clear();
     head_ = &head;
     tail_ = &tail;
     search_node_ = &head;
+    indexed_ = indexed;
+    random_ = 0x9e3779b97f4a7c15ull;
+
+    head.next = &tail;
+    head.prev = nullptr;
+    tail.prev = &head;
+    tail.next = nullptr;
+
+    if (!indexed_)
+    {
+        return;
+    }
+
+    head.skip = &skip_pool_.create();
+    tail.skip = &skip_pool_.create();
+    head.skip->height = kSkipLevels;
+    tail.skip->height = kSkipLevels;
+    for (size_t l = 0; l < kSkipLevels; ++l)
+    {
+        head.skip->next[l] = &tail;
+        head.skip->prev[l] = nullptr;
+        tail.skip->next[l] = nullptr;
+        tail.skip->prev[l] = &head;
+    }
 }
 
 p2t::Node* p2t::AdvancingFront::head()
@@ -43,40 +80,140 @@ void p2t::AdvancingFront::set_search(Node* node)
   search_node_ = node;
 }
 
+void p2t::AdvancingFront::InsertAfter(Node& position, Node& node)
+{
+    assert(&position != tail_);
+
+    node.next = position.next;
+    node.prev = &position;
+    position.next->prev = &node;
+    position.next = &node;
+
+    if (!indexed_)
+    {
+        return;
+    }
+
+    // At each level the predecessor is the nearest node to the left that is at least as tall, found by walking back along the level below
+    node.skip = &skip_pool_.create();
+    node.skip->height = RandomHeight();
+    Node* p = &position;
+    for (size_t l = 0; l < node.skip->height; ++l)
+    {
+        while (p->skip->height <= l)
+        {
+            p = l == 0 ? p->prev : p->skip->prev[l - 1];
+        }
+
+        node.skip->next[l] = p->skip->next[l];
+        node.skip->prev[l] = p;
+        p->skip->next[l]->skip->prev[l] = &node;
+        p->skip->next[l] = &node;
+    }
+}
+
+void p2t::AdvancingFront::Remove(Node& node)
+{
+    assert(&node != head_ && &node != tail_);
+
+    node.prev->next = node.next;
+    node.next->prev = node.prev;
+
+    if (indexed_)
+    {
+        for (size_t l = 0; l < node.skip->height; ++l)
+        {
+            node.skip->prev[l]->skip->next[l] = node.skip->next[l];
+            node.skip->next[l]->skip->prev[l] = node.skip->prev[l];
+        }
+    }
+
+    if (search_node_ == &node)
+    {
+        search_node_ = node.prev;
+    }
+}
+
 p2t::Node* p2t::AdvancingFront::LocateNode(double x)
 {
-  Node* node = search_node_;
+    if (!indexed_)
+    {
+        Node* node = search_node_;
 
-  if (x < node->value)
-  {
-    while ((node = node->prev) != nullptr)
+        if (x < node->value)
+        {
+            while ((node = node->prev) != nullptr)
+            {
+                if (x >= node->value)
+                {
+                    search_node_ = node;
+                    return node;
+                }
+            }
+        }
+        else
+        {
+            while ((node = node->next) != nullptr)
+            {
+                if (x < node->value)
+                {
+                    search_node_ = node->prev;
+                    return node->prev;
+                }
+            }
+        }
+
+        return nullptr;
+    }
+
+    if (x < head_->value)
     {
-      if (x >= node->value)
-      {
-        search_node_ = node;
-        return node;
-      }
+        return nullptr;
     }
-  }
-  else
-  {
-    while ((node = node->next) != nullptr)
+
+    Node* node = head_;
+    for (size_t l = kSkipLevels; l-- > 0;)
     {
-      if (x < node->value)
-      {
-        search_node_ = node->prev;
-        return node->prev;
-      }
+        while (node->skip->next[l] != nullptr && node->skip->next[l]->value <= x)
+        {
+            node = node->skip->next[l];
+        }
     }
-  }
-  return nullptr;
+
+    while (node->next != nullptr && node->next->value <= x)
+    {
+        node = node->next;
+    }
+
+    search_node_ = node;
+    return node;
 }
 
 p2t::Node* p2t::AdvancingFront::FindSearchNode(double x)
 {
-  x;
-  // TODO: implement BST index
-  return search_node_;
+    if (!indexed_)
+    {
+        return search_node_;
+    }
+
+    Node* node = LocateNode(x);
+    return node != nullptr ? node : head_;
+}
+
+size_t p2t::AdvancingFront::RandomHeight()
+{
+    random_ ^= random_ << 13;
+    random_ ^= random_ >> 7;
+    random_ ^= random_ << 17;
+
+    // Promoted to each further level with probability 1/4
+    size_t height = 0;
+    for (uint64_t r = random_; height < kSkipLevels && (r & 3) == 0; r >>= 2)
+    {
+        ++height;
+    }
+
+    return height;
 }
 
 p2t::Node* p2t::AdvancingFront::LocatePoint(const Point& point)
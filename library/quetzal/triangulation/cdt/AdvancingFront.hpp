@@ -1,11 +1,34 @@
 #if !defined(CDT_ADVANCINGFRONT_HPP)
 #define CDT_ADVANCINGFRONT_HPP
 
+#include "Pool.hpp"
 #include "shapes.hpp"
+#include <cstdint>
 
 namespace p2t
 {
 
+    // Levels of the skip list index above the front itself, with one node in four promoted per level this covers fronts of 4^12 nodes
+    constexpr size_t kSkipLevels = 12;
+
+    // Automatic indexes the fronts of large inputs, where walks from the previous search get long
+    enum class FrontIndex
+    {
+        Automatic,
+        Indexed,
+        Walked
+    };
+
+    struct Node;
+
+    // Skip list links of an indexed front node, level l links the nodes with height > l
+    struct SkipLinks
+    {
+        Node* next[kSkipLevels];
+        Node* prev[kSkipLevels];
+        size_t height;
+    };
+
     // Advancing front node
     struct Node
     {
@@ -15,6 +38,7 @@ namespace p2t
             triangle(nullptr),
             next(nullptr),
             prev(nullptr),
+            skip(nullptr),
             value(p.x)
         {
         }
@@ -24,6 +48,7 @@ namespace p2t
             triangle(&t),
             next(nullptr),
             prev(nullptr),
+            skip(nullptr),
             value(p.x)
         {
         }
@@ -34,17 +59,29 @@ namespace p2t
         Node* next;
         Node* prev;
 
+        SkipLinks* skip; // null unless the front is indexed
+
         double value;
     };
 
+    // Nodes are ordered by value, the front is x-monotone
+    // An indexed front threads a skip list through the nodes, so locating a node is O(log n) regardless of where the previous search ended
+    // Otherwise a node is located by walking from the previous search, which is faster unless the front is very long and the walks are long
     class AdvancingFront
     {
     public:
 
         AdvancingFront();
+        AdvancingFront(const AdvancingFront&) = delete;
         ~AdvancingFront() = default;
 
-        void init(Node& head, Node& tail);
+        AdvancingFront& operator=(const AdvancingFront&) = delete;
+
+        // Forgets the front, keeping the index storage for reuse
+        void clear();
+
+        // head and tail are linked to each other and, if indexed, span all index levels
+        void init(Node& head, Node& tail, bool indexed);
 
         Node* head();
         void set_head(Node* node);
@@ -53,7 +90,13 @@ namespace p2t
         Node* search();
         void set_search(Node* node);
 
-        // Locate insertion point along advancing front
+        // Links node into the front after position
+        void InsertAfter(Node& position, Node& node);
+
+        // Unlinks node from the front, it must be neither head nor tail
+        void Remove(Node& node);
+
+        // Locate insertion point along advancing front, the last node with value <= x
         Node* LocateNode(double x);
 
         Node* LocatePoint(const Point& point);
@@ -62,9 +105,14 @@ namespace p2t
 
         Node* FindSearchNode(double x);
 
+        size_t RandomHeight();
+
         Node* head_;
         Node* tail_;
         Node* search_node_;
+        bool indexed_;
+        Pool<SkipLinks> skip_pool_;
+        uint64_t random_; // xorshift state, reset by init so results are reproducible
     };
 
 }
@@ -0,0 +1,102 @@
+#if !defined(CDT_POOL_HPP)
+#define CDT_POOL_HPP
+
+#include <utility>
+#include <vector>
+#include <cassert>
+
+namespace p2t
+{
+
+    // Resettable arena of objects with stable addresses, stored in fixed capacity blocks that are never reallocated
+    // clear destroys the objects but keeps the blocks, so a reused pool stops allocating once it has reached its peak size
+    // Objects are also addressable by their creation index
+    template<typename T, size_t N = 256>
+    class Pool
+    {
+    public:
+
+        Pool();
+        Pool(const Pool&) = delete;
+        ~Pool() = default;
+
+        Pool& operator=(const Pool&) = delete;
+
+        template<typename... Args>
+        T& create(Args&&... args);
+
+        T& operator[](size_t i);
+        const T& operator[](size_t i) const;
+
+        size_t size() const;
+        void clear();
+
+    private:
+
+        std::vector<std::vector<T>> blocks_;
+        size_t block_; // block receiving new objects
+        size_t size_;
+    };
+
+}
+
+template<typename T, size_t N>
+p2t::Pool<T, N>::Pool() :
+    blocks_(),
+    block_(0),
+    size_(0)
+{
+}
+
+template<typename T, size_t N>
+template<typename... Args>
+T& p2t::Pool<T, N>::create(Args&&... args)
+{
+    if (block_ < blocks_.size() && blocks_[block_].size() == N)
+    {
+        ++block_;
+    }
+
+    if (block_ == blocks_.size())
+    {
+        blocks_.emplace_back();
+        blocks_.back().reserve(N);
+    }
+
+    ++size_;
+    return blocks_[block_].emplace_back(std::forward<Args>(args)...);
+}
+
+template<typename T, size_t N>
+T& p2t::Pool<T, N>::operator[](size_t i)
+{
+    assert(i < size_);
+    return blocks_[i / N][i % N];
+}
+
+template<typename T, size_t N>
+const T& p2t::Pool<T, N>::operator[](size_t i) const
+{
+    assert(i < size_);
+    return blocks_[i / N][i % N];
+}
+
+template<typename T, size_t N>
+size_t p2t::Pool<T, N>::size() const
+{
+    return size_;
+}
+
+template<typename T, size_t N>
+void p2t::Pool<T, N>::clear()
+{
+    for (size_t i = 0; i <= block_ && i < blocks_.size(); ++i)
+    {
+        blocks_[i].clear();
+    }
+
+    block_ = 0;
+    size_ = 0;
+}
+
+#endif // CDT_POOL_HPP
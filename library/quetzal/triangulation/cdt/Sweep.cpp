@@ -2,8 +2,11 @@
 #include "AdvancingFront.hpp"
 #include "Sweep.hpp"
 #include "SweepContext.hpp"
+#include "quetzal/geometry/predicates.hpp"
+#include "quetzal/math/VectorTraits.hpp"
 #include "quetzal/math/floating_point.hpp"
 #include "quetzal/math/math_util.hpp"
+#include <cmath>
 
 using namespace quetzal;
 
@@ -12,17 +15,29 @@ namespace
 
     const double PiThreeFourth = 0.75 * math::Pi<double>;
 
-    /**
-     * Forumla to calculate signed area<br>
-     * Positive if CCW<br>
-     * Negative if CW<br>
-     * 0 if colinear<br>
-     * <pre>
-     * A[P1,P2,P3]  =  (x1*y2 - y1*x2) + (x2*y3 - y2*x3) + (x3*y1 - y3*x1)
-     *              =  (x1-x3)*(y2-y3) - (y1-y3)*(x2-x3)
-     * </pre>
-     */
-    p2t::Orientation Orient2d(const p2t::Point& pa, const p2t::Point& pb, const p2t::Point& pc)
+    using point_type = geometry::Point<math::VectorTraits<double, 2>>;
+
+    // Exact sign of the signed area
+    // Positive if CCW
+    // Negative if CW
+    // 0 if colinear
+    p2t::Orientation Orient2dExact(const p2t::Point& pa, const p2t::Point& pb, const p2t::Point& pc)
+    {
+        int o = geometry::orient2d(point_type(pa.x, pa.y), point_type(pb.x, pb.y), point_type(pc.x, pc.y));
+        if (o == 0)
+        {
+            return p2t::Orientation::COLINEAR;
+        }
+        else if (o > 0)
+        {
+            return p2t::Orientation::CCW;
+        }
+        return p2t::Orientation::CW;
+    }
+
+    // Signed area in floating point, colinear within float_eq0
+    // A[P1,P2,P3] = (x1-x3)*(y2-y3) - (y1-y3)*(x2-x3)
+    p2t::Orientation Orient2dInexact(const p2t::Point& pa, const p2t::Point& pb, const p2t::Point& pc)
     {
         double detleft = (pa.x - pc.x) * (pb.y - pc.y);
         double detright = (pa.y - pc.y) * (pb.x - pc.x);
@@ -38,7 +53,25 @@ namespace
         return p2t::Orientation::CW;
     }
 
-    bool InScanArea(const p2t::Point& pa, const p2t::Point& pb, const p2t::Point& pc, const p2t::Point& pd)
+    bool InScanAreaExact(const p2t::Point& pa, const p2t::Point& pb, const p2t::Point& pc, const p2t::Point& pd)
+    {
+        point_type a(pa.x, pa.y);
+        point_type d(pd.x, pd.y);
+
+        if (geometry::orient2d(a, d, point_type(pb.x, pb.y)) >= 0)
+        {
+            return false;
+        }
+
+        if (geometry::orient2d(a, d, point_type(pc.x, pc.y)) <= 0)
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    bool InScanAreaInexact(const p2t::Point& pa, const p2t::Point& pb, const p2t::Point& pc, const p2t::Point& pd)
     {
         double oadb = (pa.x - pb.x)*(pd.y - pb.y) - (pd.x - pb.x)*(pa.y - pb.y);
         if (math::float_ge0(oadb))
@@ -55,19 +88,110 @@ namespace
         return true;
     }
 
+    // The orientation tests share their differences with the incircle determinant, the exact predicates are called only when a floating point sign is in doubt
+    bool IncircleExact(const p2t::Point& pa, const p2t::Point& pb, const p2t::Point& pc, const p2t::Point& pd)
+    {
+        constexpr double bound = geometry::PredicateBounds<double>::orient2d;
+
+        point_type a(pa.x, pa.y);
+        point_type b(pb.x, pb.y);
+        point_type c(pc.x, pc.y);
+        point_type d(pd.x, pd.y);
+
+        double adx = pa.x - pd.x;
+        double ady = pa.y - pd.y;
+        double bdx = pb.x - pd.x;
+        double bdy = pb.y - pd.y;
+
+        // pd must lie inside the angle at pa formed by pb and pc
+        double adxbdy = adx * bdy;
+        double bdxady = bdx * ady;
+        double oabd = adxbdy - bdxady;
+        if (std::abs(oabd) < bound * (std::abs(adxbdy) + std::abs(bdxady)) ? geometry::orient2d(a, b, d) <= 0 : oabd <= 0)
+        {
+            return false;
+        }
+
+        double cdx = pc.x - pd.x;
+        double cdy = pc.y - pd.y;
+
+        double cdxady = cdx * ady;
+        double adxcdy = adx * cdy;
+        double ocad = cdxady - adxcdy;
+        if (std::abs(ocad) < bound * (std::abs(cdxady) + std::abs(adxcdy)) ? geometry::orient2d(c, a, d) <= 0 : ocad <= 0)
+        {
+            return false;
+        }
+
+        double bdxcdy = bdx * cdy;
+        double cdxbdy = cdx * bdy;
+
+        double alift = adx * adx + ady * ady;
+        double blift = bdx * bdx + bdy * bdy;
+        double clift = cdx * cdx + cdy * cdy;
+
+        double det = alift * (bdxcdy - cdxbdy) + blift * ocad + clift * oabd;
+        double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift
+            + (std::abs(cdxady) + std::abs(adxcdy)) * blift
+            + (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+
+        if (std::abs(det) > geometry::PredicateBounds<double>::incircle * permanent)
+        {
+            return det > 0;
+        }
+
+        return geometry::incircle(a, b, c, d) > 0;
+    }
+
+    bool IncircleInexact(const p2t::Point& pa, const p2t::Point& pb, const p2t::Point& pc, const p2t::Point& pd)
+    {
+        double adx = pa.x - pd.x;
+        double ady = pa.y - pd.y;
+        double bdx = pb.x - pd.x;
+        double bdy = pb.y - pd.y;
+
+        double adxbdy = adx * bdy;
+        double bdxady = bdx * ady;
+        double oabd = adxbdy - bdxady;
+
+        if (oabd <= 0)
+            return false;
+
+        double cdx = pc.x - pd.x;
+        double cdy = pc.y - pd.y;
+
+        double cdxady = cdx * ady;
+        double adxcdy = adx * cdy;
+        double ocad = cdxady - adxcdy;
+
+        if (ocad <= 0)
+            return false;
+
+        double bdxcdy = bdx * cdy;
+        double cdxbdy = cdx * bdy;
+
+        double alift = adx * adx + ady * ady;
+        double blift = bdx * bdx + bdy * bdy;
+        double clift = cdx * cdx + cdy * cdy;
+
+        double det = alift * (bdxcdy - cdxbdy) + blift * ocad + clift * oabd;
+        return det > 0;
+    }
+
 } // namespace
 
 p2t::Sweep::Sweep() :
-    nodes_()
+    predicates_(Predicates::Exact)
 {
 }
 
 p2t::Sweep::~Sweep()
 {
-    for(size_t i = 0; i < nodes_.size(); ++i)
-    {
-        delete nodes_[i];
-    }
+}
+
+void p2t::Sweep::set_predicates(Predicates predicates)
+{
+    predicates_ = predicates;
 }
 
 void p2t::Sweep::Triangulate(SweepContext& tcx)
@@ -83,7 +207,7 @@ void p2t::Sweep::SweepPoints(SweepContext& tcx)
     {
         const Point& point = *tcx.GetPoint(i);
         Node* node = &PointEvent(tcx, point);
-        for (size_t j = 0; j < point.edge_list.size(); ++j)
+        for (size_t j = 0; j < point.edge_count; ++j)
         {
             EdgeEvent(tcx, point.edge_list[j], node);
         }
@@ -224,17 +348,13 @@ bool p2t::Sweep::IsEdgeSideOfTriangle(Triangle& triangle, const Point& ep, const
 
 p2t::Node& p2t::Sweep::NewFrontTriangle(SweepContext& tcx, const Point& point, Node& node)
 {
-    Triangle* triangle = new Triangle(point, *node.point, *node.next->point);
+    Triangle* triangle = &tcx.NewTriangle(point, *node.point, *node.next->point);
 
     triangle->MarkNeighbor(*node.triangle);
 
-    Node* new_node = new Node(point);
-    nodes_.push_back(new_node);
+    Node* new_node = &tcx.NewNode(point);
 
-    new_node->next = node.next;
-    new_node->prev = &node;
-    node.next->prev = new_node;
-    node.next = new_node;
+    tcx.front().InsertAfter(node, *new_node);
 
     if (!Legalize(tcx, *triangle))
     {
@@ -246,7 +366,7 @@ p2t::Node& p2t::Sweep::NewFrontTriangle(SweepContext& tcx, const Point& point, N
 
 void p2t::Sweep::Fill(SweepContext& tcx, Node& node)
 {
-    Triangle* triangle = new Triangle(*node.prev->point, *node.point, *node.next->point);
+    Triangle* triangle = &tcx.NewTriangle(*node.prev->point, *node.point, *node.next->point);
 
     // TODO: should copy the constrained_edge value from neighbor triangles
     //       for now constrained_edge values are copied during the legalize
@@ -254,8 +374,7 @@ void p2t::Sweep::Fill(SweepContext& tcx, Node& node)
     triangle->MarkNeighbor(*node.triangle);
 
     // Update the advancing front
-    node.prev->next = node.next;
-    node.next->prev = node.prev;
+    tcx.front().Remove(node);
 
     // If it was legalized the triangle has already been mapped
     if (!Legalize(tcx, *triangle))
@@ -446,37 +565,17 @@ bool p2t::Sweep::Legalize(SweepContext& tcx, Triangle& t)
 
 bool p2t::Sweep::Incircle(const Point& pa, const Point& pb, const Point& pc, const Point& pd)
 {
-    double adx = pa.x - pd.x;
-    double ady = pa.y - pd.y;
-    double bdx = pb.x - pd.x;
-    double bdy = pb.y - pd.y;
-
-    double adxbdy = adx * bdy;
-    double bdxady = bdx * ady;
-    double oabd = adxbdy - bdxady;
-
-    if (oabd <= 0)
-        return false;
-
-    double cdx = pc.x - pd.x;
-    double cdy = pc.y - pd.y;
-
-    double cdxady = cdx * ady;
-    double adxcdy = adx * cdy;
-    double ocad = cdxady - adxcdy;
-
-    if (ocad <= 0)
-        return false;
-
-    double bdxcdy = bdx * cdy;
-    double cdxbdy = cdx * bdy;
+    return predicates_ == Predicates::Exact ? IncircleExact(pa, pb, pc, pd) : IncircleInexact(pa, pb, pc, pd);
+}
 
-    double alift = adx * adx + ady * ady;
-    double blift = bdx * bdx + bdy * bdy;
-    double clift = cdx * cdx + cdy * cdy;
+p2t::Orientation p2t::Sweep::Orient2d(const Point& pa, const Point& pb, const Point& pc)
+{
+    return predicates_ == Predicates::Exact ? Orient2dExact(pa, pb, pc) : Orient2dInexact(pa, pb, pc);
+}
 
-    double det = alift * (bdxcdy - cdxbdy) + blift * ocad + clift * oabd;
-    return det > 0;
+bool p2t::Sweep::InScanArea(const Point& pa, const Point& pb, const Point& pc, const Point& pd)
+{
+    return predicates_ == Predicates::Exact ? InScanAreaExact(pa, pb, pc, pd) : InScanAreaInexact(pa, pb, pc, pd);
 }
 
 void p2t::Sweep::RotateTrianglePair(Triangle& t, const Point& p, Triangle& ot, const Point& op)
@@ -20,6 +20,13 @@ namespace p2t
         COLINEAR
     };
 
+    // Exact uses the adaptive predicates, Inexact the plain floating point determinants with a tolerance, kept for comparison
+    enum class Predicates
+    {
+        Exact,
+        Inexact
+    };
+
     class SweepContext;
     struct Node;
     struct Point;
@@ -35,6 +42,8 @@ namespace p2t
 
         void Triangulate(SweepContext& tcx);
 
+        void set_predicates(Predicates predicates);
+
     private:
 
         // Start sweeping the Y-sorted point set from bottom to top
@@ -85,6 +94,12 @@ namespace p2t
         */
         bool Incircle(const Point& pa, const Point& pb, const Point& pc, const Point& pd);
 
+        // Sign of the area of pa, pb, pc
+        Orientation Orient2d(const Point& pa, const Point& pb, const Point& pc);
+
+        // Whether pd lies strictly between the rays from pa through pb and pc
+        bool InScanArea(const Point& pa, const Point& pb, const Point& pc, const Point& pd);
+
         /**
         * Rotates a triangle pair one vertex CW
         *<pre>
@@ -193,7 +208,7 @@ namespace p2t
 
         void FinalizationPolygon(SweepContext& tcx);
 
-        std::vector<Node*> nodes_;
+        Predicates predicates_;
     };
 
 }
@@ -9,6 +9,9 @@ namespace
     // Inital triangle factor, seed triangle will extend 30% of PointSet width to both left and right.
     const double kAlpha = 0.3;
 
+    // Below this many points walking the front from the previous search is faster than maintaining the index
+    const size_t kIndexedFrontPoints = size_t(1) << 19;
+
     bool cmp(const p2t::Point* a, const p2t::Point* b)
     {
         if (a->y < b->y)
@@ -30,9 +33,16 @@ namespace
 } // namespace
 
 p2t::SweepContext::SweepContext() :
+    point_pool_(),
+    edge_pool_(),
+    triangle_pool_(),
+    node_pool_(),
     points_(),
     triangles_(),
+    stack_(),
+    contour_(0),
     front_(),
+    front_index_(FrontIndex::Automatic),
     head_(nullptr),
     tail_(nullptr),
     af_head_(nullptr),
@@ -43,44 +53,92 @@ p2t::SweepContext::SweepContext() :
 {
 }
 
-p2t::SweepContext::~SweepContext()
+void p2t::SweepContext::Clear()
+{
+    point_pool_.clear();
+    edge_pool_.clear();
+    triangle_pool_.clear();
+    node_pool_.clear();
+    points_.clear();
+    triangles_.clear();
+    stack_.clear();
+    contour_ = 0;
+    front_.clear();
+    head_ = nullptr;
+    tail_ = nullptr;
+    af_head_ = nullptr;
+    af_middle_ = nullptr;
+    af_tail_ = nullptr;
+    basin.Clear();
+    edge_event = EdgeEvent();
+}
+
+void p2t::SweepContext::AddFace(const std::vector<Point>& polygon)
+{
+    for (const auto& point : polygon)
+    {
+        AddContourPoint(point.m_id, point.x, point.y);
+    }
+
+    CloseContour();
+}
+
+void p2t::SweepContext::AddHole(const std::vector<Point>& polygon)
+{
+    AddFace(polygon);
+}
+
+void p2t::SweepContext::AddContourPoint(size_t id, double x, double y)
 {
-    delete head_;
-    delete tail_;
-    delete af_head_;
-    delete af_middle_;
-    delete af_tail_;
+    points_.push_back(&point_pool_.create(id, x, y));
+}
 
-    for(unsigned int i = 0; i < edge_list.size(); ++i)
+void p2t::SweepContext::CloseContour()
+{
+    size_t i0 = contour_;
+    size_t n = point_pool_.size();
+    for (size_t i = i0; i < n; ++i)
     {
-        delete edge_list[i];
+        size_t j = i < n - 1 ? i + 1 : i0;
+        edge_pool_.create(point_pool_[i], point_pool_[j]);
     }
+
+    contour_ = n;
 }
 
-void p2t::SweepContext::AddFace(std::vector<Point*> points)
+void p2t::SweepContext::AddPoint(size_t id, double x, double y)
 {
-    points_ = points;
-    InitEdges(points_);
+    assert(contour_ == point_pool_.size()); // Not within a contour
+    points_.push_back(&point_pool_.create(id, x, y));
+    contour_ = point_pool_.size();
 }
 
-void p2t::SweepContext::AddHole(std::vector<Point*> points)
+p2t::Triangle& p2t::SweepContext::NewTriangle(const Point& a, const Point& b, const Point& c)
 {
-    InitEdges(points);
-//    for(unsigned int i = 0; i < points.size(); ++i)
-//    {
-//        points_.push_back(pollyline[i]);
-//    }
-    points_.insert(end(points_), begin(points), end(points));
+    size_t index = triangle_pool_.size();
+    Triangle& triangle = triangle_pool_.create(a, b, c);
+    triangle.m_index = index;
+    return triangle;
 }
 
-void p2t::SweepContext::AddPoint(Point* point)
+p2t::Node& p2t::SweepContext::NewNode(const Point& p)
 {
-    points_.push_back(point);
+    return node_pool_.create(p);
 }
 
-const std::vector<p2t::Triangle>& p2t::SweepContext::GetTriangles()
+p2t::Node& p2t::SweepContext::NewNode(const Point& p, Triangle& t)
 {
-    return triangles_;
+    return node_pool_.create(p, t);
+}
+
+size_t p2t::SweepContext::triangle_count()
+{
+    return triangles_.size();
+}
+
+p2t::Triangle& p2t::SweepContext::GetTriangle(size_t n)
+{
+    return triangle_pool_[triangles_[n]];
 }
 
 p2t::AdvancingFront& p2t::SweepContext::front()
@@ -136,8 +194,8 @@ void p2t::SweepContext::InitTriangulation()
 
     double dx = kAlpha * (xmax - xmin);
     double dy = kAlpha * (ymax - ymin);
-    head_ = new Point(static_cast<size_t>(-1), xmax + dx, ymin - dy);
-    tail_ = new Point(static_cast<size_t>(-1), xmin - dx, ymin - dy);
+    head_ = &point_pool_.create(static_cast<size_t>(-1), xmax + dx, ymin - dy);
+    tail_ = &point_pool_.create(static_cast<size_t>(-1), xmin - dx, ymin - dy);
 
     // Sort points along y-axis
     std::sort(points_.begin(), points_.end(), cmp);
@@ -145,16 +203,6 @@ void p2t::SweepContext::InitTriangulation()
     CreateAdvancingFront();
 }
 
-void p2t::SweepContext::InitEdges(std::vector<Point*> points)
-{
-    size_t num_points = points.size();
-    for (size_t i = 0; i < num_points; ++i)
-    {
-        size_t j = i < num_points - 1 ? i + 1 : 0;
-        edge_list.push_back(new Edge(*points[i], *points[j]));
-    }
-}
-
 const p2t::Point* p2t::SweepContext::GetPoint(size_t n)
 {
     return points_[n];
@@ -162,26 +210,27 @@ const p2t::Point* p2t::SweepContext::GetPoint(size_t n)
 
 p2t::Node& p2t::SweepContext::LocateNode(const Point& point)
 {
-  // TODO implement search tree
     return *front_.LocateNode(point.x);
 }
 
 void p2t::SweepContext::CreateAdvancingFront()
 {
   // Initial triangle
-    Triangle* triangle = new Triangle(*points_[0], *tail_, *head_);
-
-    af_head_ = new Node(*triangle->GetPoint(1), *triangle);
-    af_middle_ = new Node(*triangle->GetPoint(0), *triangle);
-    af_tail_ = new Node(*triangle->GetPoint(2));
-    front_.init(*af_head_, *af_tail_);
+    Triangle* triangle = &NewTriangle(*points_[0], *tail_, *head_);
 
+    af_head_ = &NewNode(*triangle->GetPoint(1), *triangle);
+    af_middle_ = &NewNode(*triangle->GetPoint(0), *triangle);
+    af_tail_ = &NewNode(*triangle->GetPoint(2));
     // TODO: More intuitive if head is middles next and not previous?
     //       so swap head and tail
-    af_head_->next = af_middle_;
-    af_middle_->next = af_tail_;
-    af_middle_->prev = af_head_;
-    af_tail_->prev = af_middle_;
+    bool indexed = front_index_ == FrontIndex::Indexed || (front_index_ == FrontIndex::Automatic && points_.size() >= kIndexedFrontPoints);
+    front_.init(*af_head_, *af_tail_, indexed);
+    front_.InsertAfter(*af_head_, *af_middle_);
+}
+
+void p2t::SweepContext::set_front_index(FrontIndex front_index)
+{
+    front_index_ = front_index;
 }
 
 void p2t::SweepContext::MapTriangleToNodes(Triangle& t)
@@ -199,23 +248,24 @@ void p2t::SweepContext::MapTriangleToNodes(Triangle& t)
 
 void p2t::SweepContext::MeshClean(Triangle& triangle)
 {
-    std::vector<Triangle*> triangles;
-    triangles.push_back(&triangle);
+    stack_.clear();
+    stack_.push_back(&triangle);
 
-    while(!triangles.empty())
+    while(!stack_.empty())
     {
-        Triangle *t = triangles.back();
-        triangles.pop_back();
+        Triangle *t = stack_.back();
+        stack_.pop_back();
 
         if (t != nullptr && !t->IsInterior())
         {
             t->set_interior(true);
-            triangles_.push_back(*t);
+            t->m_interior = triangles_.size();
+            triangles_.push_back(t->m_index);
             for (int i = 0; i < 3; ++i)
             {
                 if (!t->m_bEdgeConstrained[i])
                 {
-                    triangles.push_back(t->GetNeighbor(i));
+                    stack_.push_back(t->GetNeighbor(i));
                 }
             }
         }
@@ -2,7 +2,7 @@
 #define CDT_SWEEPCONTEXT_HPP
 
 #include "AdvancingFront.hpp"
-#include <list>
+#include "Pool.hpp"
 #include <vector>
 
 namespace p2t
@@ -19,7 +19,10 @@ namespace p2t
     public:
 
         SweepContext();
-        ~SweepContext();
+        ~SweepContext() = default;
+
+        // Discards all points, edges, triangles, and front nodes, keeping their storage for reuse
+        void Clear();
 
         void set_head(Point* p1);
 
@@ -35,22 +38,37 @@ namespace p2t
 
         void CreateAdvancingFront();
 
+        // Persists across Clear
+        void set_front_index(FrontIndex front_index);
+
         // Try to map a node to all sides of this triangle that don't have a neighbor
         void MapTriangleToNodes(Triangle& t);
 
         const Point* GetPoint(size_t n);
 
-        void AddFace(std::vector<Point*> points);
-        void AddHole(std::vector<Point*> points);
-        void AddPoint(Point* point);
+        void AddFace(const std::vector<Point>& polygon);
+        void AddHole(const std::vector<Point>& polygon);
+
+        // Appends a point to the contour under construction
+        void AddContourPoint(size_t id, double x, double y);
+
+        // Closes the contour under construction, the first contour is the boundary and the rest are holes
+        void CloseContour();
+
+        // Add a steiner point
+        void AddPoint(size_t id, double x, double y);
+
+        Triangle& NewTriangle(const Point& a, const Point& b, const Point& c);
+        Node& NewNode(const Point& p);
+        Node& NewNode(const Point& p, Triangle& t);
 
         AdvancingFront& front();
 
         void MeshClean(Triangle& triangle);
 
-        const std::vector<Triangle>& GetTriangles();
-
-        std::vector<Edge*> edge_list;
+        // Interior triangles, indexed by Triangle::m_interior
+        size_t triangle_count();
+        Triangle& GetTriangle(size_t n);
 
         struct Basin
         {
@@ -96,14 +114,21 @@ namespace p2t
     private:
 
         void InitTriangulation();
-        void InitEdges(std::vector<Point*> points);
 
         friend class Sweep;
 
-        std::vector<Point*> points_;
-        std::vector<Triangle> triangles_;
+        Pool<Point> point_pool_;
+        Pool<Edge> edge_pool_;
+        Pool<Triangle> triangle_pool_;
+        Pool<Node> node_pool_;
+
+        std::vector<Point*> points_; // sorted for the sweep
+        std::vector<size_t> triangles_; // interior triangles, indices into triangle_pool_
+        std::vector<Triangle*> stack_; // MeshClean traversal
+        size_t contour_; // index in point_pool_ of the first point of the contour under construction
 
         AdvancingFront front_;
+        FrontIndex front_index_;
         Point* head_; // head point used with advancing front
         Point* tail_; // tail point used with advancing front
 
@@ -6,29 +6,28 @@
 namespace p2t
 {
 
+    // Single use interface, see quetzal::triangulation::Triangulator for reuse across polygons
     class CDT
     {
     public:
 
         CDT(const std::vector<Point>& polygon);
-        ~CDT();
+        ~CDT() = default;
 
         void AddHole(const std::vector<Point>& polygon);
 
         // Add a steiner point
-        void AddPoint(Point* point);
+        void AddPoint(const Point& point);
 
         // Triangulate - do this AFTER you've added the points, holes, and Steiner points
         void Triangulate();
 
         // Get resulting triangles
-        const std::vector<Triangle>& GetTriangles();
+        std::vector<Triangle> GetTriangles();
 
     private:
 
         SweepContext sweep_context_;
-        std::vector<p2t::Point*> m_face;
-        std::vector<std::vector<p2t::Point*>> m_holes;
     };
 
 }
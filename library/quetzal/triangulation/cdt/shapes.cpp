@@ -9,6 +9,8 @@ p2t::Triangle::Triangle(const Point& a, const Point& b, const Point& c)
     m_bEdgeConstrained[0] = m_bEdgeConstrained[1] = m_bEdgeConstrained[2] = false;
     m_bEdgeDelaunay[0] = m_bEdgeDelaunay[1] = m_bEdgeDelaunay[2] = false;
     m_bInterior = false;
+    m_index = static_cast<size_t>(-1);
+    m_interior = static_cast<size_t>(-1);
 }
 
 const p2t::Point* p2t::Triangle::GetPoint(size_t n)
@@ -15,14 +15,18 @@ namespace p2t
         Point() :
             m_id(static_cast<size_t>(-1)), // nullid
             x(0.0),
-            y(0.0)
+            y(0.0),
+            edge_list{nullptr, nullptr},
+            edge_count(0)
         {
         }
 
         Point(size_t id, double xx, double yy) :
             m_id(id),
             x(xx),
-            y(yy)
+            y(yy),
+            edge_list{nullptr, nullptr},
+            edge_count(0)
         {
         }
 
@@ -30,7 +34,9 @@ namespace p2t
         double x, y;
 
         // The edges this point constitutes an upper ending point
-        mutable std::vector<Edge*> edge_list; // don't like this mutable ...
+        // A point belongs to a single contour, so it is the upper end of at most two edges
+        mutable Edge* edge_list[2]; // don't like this mutable ...
+        mutable size_t edge_count;
 
     };
 
@@ -68,7 +74,8 @@ namespace p2t
                 }
             }
 
-            q->edge_list.push_back(this);
+            assert(q->edge_count < 2);
+            q->edge_list[q->edge_count++] = this;
         }
 
         const Point* p;
@@ -130,6 +137,10 @@ namespace p2t
 
         void DebugPrint();
 
+        // Position in the triangle pool, and among the interior triangles once collected or -1
+        size_t m_index;
+        size_t m_interior;
+
         // Flags to determine if an edge is a Constrained edge
         bool m_bEdgeConstrained[3];
         // Flags to determine if an edge is a Delauney edge
@@ -0,0 +1,32 @@
+//------------------------------------------------------------------------------
+// triangulation
+// delaunay.cpp
+//------------------------------------------------------------------------------
+
+#include "delaunay.hpp"
+#include <utility>
+
+//------------------------------------------------------------------------------
+uint64_t quetzal::triangulation::internal::hilbert_index(uint32_t x, uint32_t y)
+{
+    uint64_t d = 0;
+    for (uint32_t s = uint32_t(1) << 15; s > 0; s >>= 1)
+    {
+        uint32_t rx = (x & s) > 0 ? 1 : 0;
+        uint32_t ry = (y & s) > 0 ? 1 : 0;
+        d += uint64_t(s) * uint64_t(s) * ((3 * rx) ^ ry);
+
+        if (ry == 0)
+        {
+            if (rx == 1)
+            {
+                x = 65535 - x;
+                y = 65535 - y;
+            }
+
+            std::swap(x, y);
+        }
+    }
+
+    return d;
+}
@@ -0,0 +1,506 @@
+#if !defined(QUETZAL_TRIANGULATION_DELAUNAY_HPP)
+#define QUETZAL_TRIANGULATION_DELAUNAY_HPP
+//------------------------------------------------------------------------------
+// triangulation
+// delaunay.hpp
+//------------------------------------------------------------------------------
+
+// Delaunay triangulation of unconstrained 2d point clouds, incremental Bowyer-Watson insertion with exact orient2d and incircle
+// Points are inserted in biased randomized insertion order (BRIO), rounds of doubling size each sorted along a Hilbert curve, and located by a visibility walk from the last created triangle
+// The triangulation is closed by ghost triangles joining hull edges to a vertex at infinity, so points outside the current hull need no special treatment and the hull is exact
+// Duplicate points are inserted once and are not referenced by the result
+
+#include "Triangulator.hpp"
+#include "quetzal/geometry/AxisAlignedBoundingBox.hpp"
+#include "quetzal/geometry/Point.hpp"
+#include "quetzal/geometry/predicates.hpp"
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+namespace quetzal::triangulation
+{
+
+    // Triangle vertex indices into points, three per triangle, counterclockwise
+    // Empty if there are fewer than three distinct points or all points are colinear
+    // If pNeighbors is given, it receives the triangle across the edge opposite each vertex, Triangulator::nullindex on the hull
+    template<typename Traits> requires (Traits::dimension == 2)
+    std::vector<size_t> delaunay(std::span<const geometry::Point<Traits>> points, std::vector<size_t>* pNeighbors = nullptr);
+
+namespace internal
+{
+
+    //--------------------------------------------------------------------------
+    template<typename Traits>
+    class Delaunay
+    {
+    public:
+
+        using point_type = geometry::Point<Traits>;
+
+        Delaunay(std::span<const point_type> points);
+        Delaunay(const Delaunay&) = delete;
+        ~Delaunay() = default;
+
+        Delaunay& operator=(const Delaunay&) = delete;
+
+        void triangulate();
+
+        // Compacts the real triangles, dropping the ghosts
+        std::vector<size_t> indices(std::vector<size_t>* pNeighbors) const;
+
+    private:
+
+        struct BoundaryEdge
+        {
+            size_t a;
+            size_t b;
+            size_t outer;
+        };
+
+        std::vector<size_t> insertion_order() const;
+
+        bool start(const std::vector<size_t>& order, std::array<size_t, 3>& initial);
+        void insert(size_t ip);
+
+        // Triangle containing point ip or a ghost triangle whose hull edge sees it, nullindex if ip duplicates a vertex
+        size_t locate(size_t ip);
+
+        bool conflict(size_t t, size_t ip) const;
+
+        bool ghost(size_t t) const;
+        bool coincident(size_t i, size_t j) const;
+
+        std::span<const point_type> m_points;
+        size_t m_ghost; // vertex at infinity, always last in a ghost triangle
+
+        std::vector<std::array<size_t, 3>> m_vertices;
+        std::vector<std::array<size_t, 3>> m_neighbors; // neighbor i is across the edge opposite vertex i
+        std::vector<uint64_t> m_marks;
+        uint64_t m_mark;
+
+        // Insertion scratch, kept across insertions
+        std::vector<size_t> m_stack;
+        std::vector<size_t> m_cavity;
+        std::vector<BoundaryEdge> m_boundary;
+        std::vector<size_t> m_fan; // new triangle starting at each cavity boundary vertex
+
+        size_t m_last;
+        uint64_t m_random;
+    };
+
+    // Position along the Hilbert curve of order 16 of grid cell x, y
+    uint64_t hilbert_index(uint32_t x, uint32_t y);
+
+} // namespace internal
+
+} // namespace quetzal::triangulation
+
+//------------------------------------------------------------------------------
+template<typename Traits> requires (Traits::dimension == 2)
+std::vector<size_t> quetzal::triangulation::delaunay(std::span<const geometry::Point<Traits>> points, std::vector<size_t>* pNeighbors)
+{
+    internal::Delaunay<Traits> builder(points);
+    builder.triangulate();
+    return builder.indices(pNeighbors);
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+quetzal::triangulation::internal::Delaunay<Traits>::Delaunay(std::span<const point_type> points) :
+    m_points(points),
+    m_ghost(points.size()),
+    m_vertices(),
+    m_neighbors(),
+    m_marks(),
+    m_mark(0),
+    m_stack(),
+    m_cavity(),
+    m_boundary(),
+    m_fan(points.size() + 1, Triangulator::nullindex),
+    m_last(0),
+    m_random(0x9e3779b97f4a7c15)
+{
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+void quetzal::triangulation::internal::Delaunay<Traits>::triangulate()
+{
+    std::vector<size_t> order = insertion_order();
+
+    std::array<size_t, 3> initial;
+    if (!start(order, initial))
+    {
+        return;
+    }
+
+    // A triangulation of n points has at most 2n triangles including ghosts
+    m_vertices.reserve(2 * m_points.size());
+    m_neighbors.reserve(2 * m_points.size());
+    m_marks.reserve(2 * m_points.size());
+
+    for (size_t ip : order)
+    {
+        if (ip != initial[0] && ip != initial[1] && ip != initial[2])
+        {
+            insert(ip);
+        }
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+std::vector<size_t> quetzal::triangulation::internal::Delaunay<Traits>::indices(std::vector<size_t>* pNeighbors) const
+{
+    std::vector<size_t> compact(m_vertices.size(), Triangulator::nullindex);
+    size_t n = 0;
+    for (size_t t = 0; t < m_vertices.size(); ++t)
+    {
+        if (!ghost(t))
+        {
+            compact[t] = n++;
+        }
+    }
+
+    std::vector<size_t> indices;
+    indices.reserve(3 * n);
+    for (size_t t = 0; t < m_vertices.size(); ++t)
+    {
+        if (!ghost(t))
+        {
+            indices.insert(indices.end(), m_vertices[t].begin(), m_vertices[t].end());
+        }
+    }
+
+    if (pNeighbors != nullptr)
+    {
+        pNeighbors->clear();
+        pNeighbors->reserve(3 * n);
+        for (size_t t = 0; t < m_vertices.size(); ++t)
+        {
+            if (!ghost(t))
+            {
+                for (size_t i = 0; i < 3; ++i)
+                {
+                    pNeighbors->push_back(compact[m_neighbors[t][i]]);
+                }
+            }
+        }
+    }
+
+    return indices;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+std::vector<size_t> quetzal::triangulation::internal::Delaunay<Traits>::insertion_order() const
+{
+    using T = Traits::value_type;
+
+    size_t n = m_points.size();
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), size_t(0));
+    if (n == 0)
+    {
+        return order;
+    }
+
+    // Fixed seed, the result is reproducible
+    std::mt19937_64 engine(n);
+    std::shuffle(order.begin(), order.end(), engine);
+
+    point_type lower = m_points[0];
+    point_type upper = m_points[0];
+    geometry::bounds(m_points, lower, upper);
+
+    T scaleX = upper.x() > lower.x() ? T(65535) / (upper.x() - lower.x()) : T(0);
+    T scaleY = upper.y() > lower.y() ? T(65535) / (upper.y() - lower.y()) : T(0);
+
+    std::vector<uint64_t> keys(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint32_t x = static_cast<uint32_t>((m_points[i].x() - lower.x()) * scaleX);
+        uint32_t y = static_cast<uint32_t>((m_points[i].y() - lower.y()) * scaleY);
+        keys[i] = hilbert_index(std::min(x, uint32_t(65535)), std::min(y, uint32_t(65535)));
+    }
+
+    // Rounds [n / 2, n), [n / 4, n / 2), ... of the shuffled order, the first holding at most 64 points, each sorted along the curve
+    size_t end = n;
+    while (end > 0)
+    {
+        size_t begin = end > 64 ? end / 2 : 0;
+        std::sort(order.begin() + begin, order.begin() + end, [&keys](size_t i, size_t j) { return keys[i] < keys[j]; });
+        end = begin;
+    }
+
+    return order;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+bool quetzal::triangulation::internal::Delaunay<Traits>::start(const std::vector<size_t>& order, std::array<size_t, 3>& initial)
+{
+    if (order.size() < 3)
+    {
+        return false;
+    }
+
+    size_t j = 1;
+    while (j < order.size() && coincident(order[0], order[j]))
+    {
+        ++j;
+    }
+
+    if (j == order.size())
+    {
+        return false;
+    }
+
+    size_t k = j + 1;
+    while (k < order.size() && geometry::orient2d(m_points[order[0]], m_points[order[j]], m_points[order[k]]) == 0)
+    {
+        ++k;
+    }
+
+    if (k >= order.size())
+    {
+        return false;
+    }
+
+    size_t a0 = order[0];
+    size_t a1 = order[j];
+    size_t a2 = order[k];
+    if (geometry::orient2d(m_points[a0], m_points[a1], m_points[a2]) < 0)
+    {
+        std::swap(a1, a2);
+    }
+
+    initial = {a0, a1, a2};
+
+    // The triangle and a ghost across each of its edges
+    m_vertices = {{a0, a1, a2}, {a2, a1, m_ghost}, {a0, a2, m_ghost}, {a1, a0, m_ghost}};
+    m_neighbors = {{1, 2, 3}, {3, 2, 0}, {1, 3, 0}, {2, 1, 0}};
+    m_marks.assign(4, 0);
+    m_last = 0;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+void quetzal::triangulation::internal::Delaunay<Traits>::insert(size_t ip)
+{
+    size_t t0 = locate(ip);
+    if (t0 == Triangulator::nullindex)
+    {
+        return;
+    }
+
+    // Cavity of triangles in conflict with the point, grown from the located triangle, marked 2m if in conflict and 2m + 1 if not
+    m_mark += 2;
+    uint64_t markConflict = m_mark;
+    uint64_t markClear = m_mark + 1;
+
+    m_cavity.clear();
+    m_boundary.clear();
+    m_stack.clear();
+    m_stack.push_back(t0);
+    m_marks[t0] = markConflict;
+
+    while (!m_stack.empty())
+    {
+        size_t t = m_stack.back();
+        m_stack.pop_back();
+        m_cavity.push_back(t);
+
+        for (size_t i = 0; i < 3; ++i)
+        {
+            size_t u = m_neighbors[t][i];
+            if (m_marks[u] != markConflict && m_marks[u] != markClear)
+            {
+                m_marks[u] = conflict(u, ip) ? markConflict : markClear;
+                if (m_marks[u] == markConflict)
+                {
+                    m_stack.push_back(u);
+                    continue;
+                }
+            }
+
+            if (m_marks[u] == markClear)
+            {
+                m_boundary.push_back({m_vertices[t][(i + 1) % 3], m_vertices[t][(i + 2) % 3], u});
+            }
+        }
+    }
+
+    // The cavity has no interior vertices, its k triangles are replaced by a fan of k + 2, reusing their slots
+    assert(m_boundary.size() == m_cavity.size() + 2);
+
+    for (size_t e = 0; e < m_boundary.size(); ++e)
+    {
+        const BoundaryEdge& edge = m_boundary[e];
+
+        size_t t;
+        if (e < m_cavity.size())
+        {
+            t = m_cavity[e];
+        }
+        else
+        {
+            t = m_vertices.size();
+            m_vertices.emplace_back();
+            m_neighbors.emplace_back();
+            m_marks.push_back(0);
+        }
+
+        m_vertices[t] = {edge.a, edge.b, ip};
+        m_neighbors[t][2] = edge.outer;
+
+        std::array<size_t, 3>& outer = m_vertices[edge.outer];
+        size_t j = (outer[0] != edge.a && outer[0] != edge.b) ? 0 : (outer[1] != edge.a && outer[1] != edge.b) ? 1 : 2;
+        m_neighbors[edge.outer][j] = t;
+
+        m_fan[edge.a] = t;
+    }
+
+    for (const BoundaryEdge& edge : m_boundary)
+    {
+        size_t t = m_fan[edge.a];
+        size_t tNext = m_fan[edge.b];
+        m_neighbors[t][0] = tNext;
+        m_neighbors[tNext][1] = t;
+    }
+
+    // Rotate ghosts so the vertex at infinity is last, and keep a real triangle to start the next walk
+    for (const BoundaryEdge& edge : m_boundary)
+    {
+        size_t t = m_fan[edge.a];
+        std::array<size_t, 3>& vertices = m_vertices[t];
+        std::array<size_t, 3>& neighbors = m_neighbors[t];
+        if (vertices[0] == m_ghost)
+        {
+            vertices = {vertices[1], vertices[2], vertices[0]};
+            neighbors = {neighbors[1], neighbors[2], neighbors[0]};
+        }
+        else if (vertices[1] == m_ghost)
+        {
+            vertices = {vertices[2], vertices[0], vertices[1]};
+            neighbors = {neighbors[2], neighbors[0], neighbors[1]};
+        }
+        else
+        {
+            m_last = t;
+        }
+    }
+
+    return;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+size_t quetzal::triangulation::internal::Delaunay<Traits>::locate(size_t ip)
+{
+    const point_type& p = m_points[ip];
+
+    // Visibility walk, starting each step at a random edge so it cannot cycle
+    size_t t = m_last;
+    for (;;)
+    {
+        const std::array<size_t, 3>& vertices = m_vertices[t];
+        if (vertices[2] == m_ghost)
+        {
+            if (geometry::orient2d(m_points[vertices[0]], m_points[vertices[1]], p) > 0)
+            {
+                return t;
+            }
+
+            t = m_neighbors[t][2];
+            continue;
+        }
+
+        m_random ^= m_random << 13;
+        m_random ^= m_random >> 7;
+        m_random ^= m_random << 17;
+        size_t i0 = static_cast<size_t>(m_random % 3);
+
+        size_t tNext = t;
+        for (size_t k = 0; k < 3 && tNext == t; ++k)
+        {
+            size_t i = (i0 + k) % 3;
+            if (geometry::orient2d(m_points[vertices[(i + 1) % 3]], m_points[vertices[(i + 2) % 3]], p) < 0)
+            {
+                tNext = m_neighbors[t][i];
+            }
+        }
+
+        if (tNext == t)
+        {
+            break;
+        }
+
+        t = tNext;
+    }
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        if (coincident(m_vertices[t][i], ip))
+        {
+            return Triangulator::nullindex;
+        }
+    }
+
+    return t;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+bool quetzal::triangulation::internal::Delaunay<Traits>::conflict(size_t t, size_t ip) const
+{
+    const std::array<size_t, 3>& vertices = m_vertices[t];
+    const point_type& p = m_points[ip];
+
+    if (vertices[2] != m_ghost)
+    {
+        return geometry::incircle(m_points[vertices[0]], m_points[vertices[1]], m_points[vertices[2]], p) > 0;
+    }
+
+    // A ghost conflicts if its hull edge sees the point, or the point lies strictly within the edge
+    const point_type& a = m_points[vertices[0]];
+    const point_type& b = m_points[vertices[1]];
+    int orientation = geometry::orient2d(a, b, p);
+    if (orientation != 0)
+    {
+        return orientation > 0;
+    }
+
+    auto less = [](const point_type& u, const point_type& v) -> bool
+    {
+        return u.x() < v.x() || (u.x() == v.x() && u.y() < v.y());
+    };
+
+    return (less(a, p) && less(p, b)) || (less(b, p) && less(p, a));
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+bool quetzal::triangulation::internal::Delaunay<Traits>::ghost(size_t t) const
+{
+    return m_vertices[t][2] == m_ghost;
+}
+
+//------------------------------------------------------------------------------
+template<typename Traits>
+bool quetzal::triangulation::internal::Delaunay<Traits>::coincident(size_t i, size_t j) const
+{
+    return m_points[i].x() == m_points[j].x() && m_points[i].y() == m_points[j].y();
+}
+
+#endif // QUETZAL_TRIANGULATION_DELAUNAY_HPP
@@ -5,6 +5,8 @@
 // triangulation.hpp
 //------------------------------------------------------------------------------
 
+#include "Triangulator.hpp"
+#include "delaunay.hpp"
 #include "cdt/cdt.hpp"
 
 namespace quetzal::triangulation
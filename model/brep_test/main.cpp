@@ -0,0 +1,1222 @@
+//------------------------------------------------------------------------------
+// brep_test
+// main.cpp
+//------------------------------------------------------------------------------
+
+#include "quetzal/brep/Mesh.hpp"
+#include "quetzal/brep/MeshTraits.hpp"
+#include "quetzal/brep/Validator.hpp"
+#include "quetzal/brep/mesh_boolean.hpp"
+#include "quetzal/brep/mesh_clip.hpp"
+#include "quetzal/brep/mesh_components.hpp"
+#include "quetzal/brep/mesh_connection.hpp"
+#include "quetzal/brep/mesh_decimation.hpp"
+#include "quetzal/brep/mesh_geometry.hpp"
+#include "quetzal/brep/mesh_subdivision.hpp"
+#include "quetzal/brep/mesh_slice.hpp"
+#include "quetzal/brep/mesh_texcoord.hpp"
+#include "quetzal/geometry/AxisAlignedBoundingBox.hpp"
+#include "quetzal/geometry/AxisAlignedBoundingBoxArray.hpp"
+#include "quetzal/geometry/HalfSpace.hpp"
+#include "quetzal/geometry/Ray.hpp"
+#include "quetzal/geometry/triangle_intersection.hpp"
+#include "quetzal/math/Matrix.hpp"
+#include "quetzal/math/VectorTraits.hpp"
+#include "quetzal/math/transformation_matrix.hpp"
+#include "quetzal/model/Deformation.hpp"
+#include "quetzal/model/mesh_attributes.hpp"
+#include "quetzal/model/primitives.hpp"
+#include "quetzal/model/transforms.hpp"
+#include "quetzal/triangulation/Triangulator.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <numbers>
+#include <random>
+#include <span>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+using namespace quetzal;
+
+namespace
+{
+
+    using value_type = double;
+    using vector_traits = math::VectorTraits<value_type, 3>;
+    using mesh_type = brep::Mesh<brep::MeshTraits<vector_traits>>;
+
+    size_t nFailures = 0;
+
+    //--------------------------------------------------------------------------
+    void check(bool b, const string& name)
+    {
+        cout << (b ? "    ok " : "    FAILED ") << name << endl;
+        nFailures += b ? 0 : 1;
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    void check_valid(const mesh_type& mesh, const string& name)
+    {
+        auto errors = brep::validate(mesh, brep::ValidationMode::Full);
+        for (size_t i = 0; i < errors.size() && i < 4; ++i)
+        {
+            cout << "        " << errors[i] << endl;
+        }
+
+        check(errors.empty(), name + " valid, " + to_string(errors.size()) + " errors");
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    double milliseconds_since(chrono::steady_clock::time_point t0)
+    {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    }
+
+    //--------------------------------------------------------------------------
+    // Radius varied by a smooth function of position, so that quadric minima fall off the edges collapsed
+    void perturb(mesh_type& mesh, value_type amplitude)
+    {
+        for (auto& vertex : mesh.vertices())
+        {
+            const auto position = vertex.attributes().position();
+            vertex.attributes().set_position(position * (value_type(1) + amplitude * sin(17.0 * position.x() + 13.0 * position.y() + 11.0 * position.z())));
+        }
+
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    void test_decimation()
+    {
+        cout << "decimation" << endl;
+
+        for (auto [nSubdivisions, nFaces, amplitude] : {tuple<size_t, size_t, value_type>{40, 2000, 0.0}, {40, 2000, 0.2}, {100, 20000, 0.05}})
+        {
+            string name = "geodesic_sphere_" + to_string(nSubdivisions) + "_" + to_string(nFaces) + (amplitude > 0.0 ? "_perturbed" : "");
+
+            mesh_type mesh;
+            model::create_geodesic_sphere(mesh, name, 1.0, nSubdivisions, true, true);
+            perturb(mesh, amplitude);
+
+            auto t0 = chrono::steady_clock::now();
+            size_t nCollapses = brep::decimate(mesh, nFaces);
+            cout << "    " << name << " " << milliseconds_since(t0) << " ms, " << nCollapses << " collapses" << endl;
+
+            check(mesh.face_count() == nFaces, name + " face count");
+            check_valid(mesh, name);
+        }
+
+        // Every edge of a faceted sphere is a seam between surfaces, so no point is movable
+        mesh_type mesh;
+        model::create_geodesic_sphere(mesh, "geodesic_sphere_faceted", 1.0, 8, true, false);
+        size_t nFaces = mesh.face_count();
+        check(brep::decimate(mesh, nFaces / 4) == 0 && mesh.face_count() == nFaces, "geodesic_sphere_faceted unchanged");
+        check_valid(mesh, "geodesic_sphere_faceted");
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Every corner texcoord equal
+    bool texcoords_equal(const mesh_type& a, const mesh_type& b)
+    {
+        if (a.halfedge_store_count() != b.halfedge_store_count())
+        {
+            return false;
+        }
+
+        for (id_type id = 0; id < a.halfedge_store_count(); ++id)
+        {
+            if (a.halfedge(id).attributes().texcoord() != b.halfedge(id).attributes().texcoord())
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    // The all surfaces overload against the single surface one, applied to planar surfaces only
+    void test_texcoords()
+    {
+        cout << "texcoords" << endl;
+
+        mesh_type cylinder;
+        model::create_cylinder(cylinder, "cylinder", 12, 4, 5.0, 5.0, -10.0, 10.0);
+        mesh_type expected = cylinder;
+        for (const auto& surface : cylinder.surfaces())
+        {
+            if (surface.name() != model::SurfaceName::Body)
+            {
+                brep::calculate_planar_surface_texcoords(expected, surface.id());
+            }
+        }
+
+        brep::calculate_planar_surface_texcoords(cylinder);
+        check(texcoords_equal(cylinder, expected), "cylinder ends set, side unchanged");
+
+        mesh_type sphere;
+        model::create_geodesic_sphere(sphere, "geodesic_sphere_faceted", 1.0, 4, true, false);
+        expected = sphere;
+        for (const auto& surface : sphere.surfaces())
+        {
+            brep::calculate_planar_surface_texcoords(expected, surface.id());
+        }
+
+        brep::calculate_planar_surface_texcoords(sphere);
+        check(texcoords_equal(sphere, expected), "geodesic_sphere_faceted every surface set");
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    void add_sphere(mesh_type& mesh, const string& name, value_type radius, const mesh_type::point_type& center)
+    {
+        mesh_type m;
+        model::create_sphere(m, name, 16, 8, radius);
+        for (auto& vertex : m.vertices())
+        {
+            vertex.attributes().set_position(vertex.attributes().position() + center);
+        }
+
+        mesh.append(m);
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    void add_box(mesh_type& mesh, const string& name, value_type size, const mesh_type::point_type& center)
+    {
+        mesh_type m;
+        model::create_box(m, name, size, size, size);
+        for (auto& vertex : m.vertices())
+        {
+            vertex.attributes().set_position(vertex.attributes().position() + center);
+        }
+
+        mesh.append(m);
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    void check_closed(const mesh_type& mesh, const string& name)
+    {
+        size_t nBorder = 0;
+        for (const auto& halfedge : mesh.halfedges())
+        {
+            nBorder += halfedge.border() ? 1 : 0;
+        }
+
+        check(nBorder == 0, name + " closed, " + to_string(nBorder) + " border halfedges");
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Grid candidates against every pair of faces
+    void test_face_intersections()
+    {
+        cout << "face intersections" << endl;
+
+        mesh_type mesh;
+        add_sphere(mesh, "a", 1.0, {0.0, 0.0, 0.0});
+        add_sphere(mesh, "b", 1.0, {1.0, 0.3, 0.2});
+        id_type idSubmeshA = mesh.submesh_id("a");
+        id_type idSubmeshB = mesh.submesh_id("b");
+        brep::triangulate_submesh(mesh, idSubmeshA);
+        brep::triangulate_submesh(mesh, idSubmeshB);
+
+        auto t0 = chrono::steady_clock::now();
+        auto intersections = brep::face_intersections(mesh, idSubmeshA, idSubmeshB);
+        cout << "    " << milliseconds_since(t0) << " ms, " << intersections.size() << " pairs" << endl;
+
+        size_t n = 0;
+        for (const auto& faceA : mesh.submesh(idSubmeshA).faces())
+        {
+            for (const auto& faceB : mesh.submesh(idSubmeshB).faces())
+            {
+                const auto& a = faceA.halfedge();
+                const auto& b = faceB.halfedge();
+                n += geometry::triangle_intersection(a.attributes().position(), a.next().attributes().position(), a.prev().attributes().position(),
+                    b.attributes().position(), b.next().attributes().position(), b.prev().attributes().position()).empty() ? 0 : 1;
+            }
+        }
+
+        check(!intersections.empty() && intersections.size() == n, "pairs match all pairs tested");
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Classification only, groups that cross each other are inside another operand or A lies inside a cutter, so no binary operation runs
+    void test_boolean_operands()
+    {
+        cout << "boolean operands" << endl;
+
+        {
+            // Crossing group s1 c1 inside s0
+            mesh_type mesh;
+            add_sphere(mesh, "s0", 1.0, {0.0, 0.0, 0.0});
+            add_sphere(mesh, "s1", 0.3, {0.1, 0.05, 0.02});
+            add_sphere(mesh, "c1", 0.3, {0.35, 0.05, 0.02});
+            add_sphere(mesh, "s2", 0.5, {5.0, 0.0, 0.0});
+            vector<id_type> ids = {mesh.submesh_id("s0"), mesh.submesh_id("s1"), mesh.submesh_id("c1"), mesh.submesh_id("s2")};
+            check(brep::crossing_operands(mesh, ids) == vector<array<size_t, 2>>{{1, 2}}, "s1 c1 cross");
+
+            id_type idResult = brep::boolean_union(mesh, ids, "u");
+            check(mesh.submesh_count() == 1 && mesh.submesh(idResult).name() == "u", "union of enclosed crossing group, one result");
+            check(abs(brep::winding_number(mesh, idResult, {0.35, 0.05, 0.02}) - 1.0) < 1.0e-6, "union contains c1");
+            check(abs(brep::winding_number(mesh, idResult, {5.0, 0.0, 0.0}) - 1.0) < 1.0e-6, "union contains s2");
+            check_valid(mesh, "union");
+        }
+
+        {
+            // Cavity b0 in A, crossing group s1 c1 inside b0 deleted rather than subtracted
+            mesh_type mesh;
+            add_sphere(mesh, "a", 1.0, {0.0, 0.0, 0.0});
+            add_sphere(mesh, "b0", 0.8, {0.0, 0.0, 0.0});
+            add_sphere(mesh, "s1", 0.3, {0.1, 0.05, 0.02});
+            add_sphere(mesh, "c1", 0.3, {0.35, 0.05, 0.02});
+            id_type idResult = brep::boolean_difference(mesh, mesh.submesh_id("a"), {mesh.submesh_id("b0"), mesh.submesh_id("s1"), mesh.submesh_id("c1")}, "d");
+            check(mesh.submesh_count() == 1 && idResult == mesh.submesh_id("d"), "difference with enclosed crossing group, one result");
+            check(abs(brep::winding_number(mesh, idResult, {0.9, 0.0, 0.0}) - 1.0) < 1.0e-6, "difference contains shell");
+            check(abs(brep::winding_number(mesh, idResult, {0.1, 0.05, 0.02})) < 1.0e-6, "difference excludes cavity");
+            check_valid(mesh, "difference");
+        }
+
+        {
+            // A inside b0, also crossed by c0, leaves nothing
+            mesh_type mesh;
+            add_sphere(mesh, "a", 0.3, {0.0, 0.0, 0.0});
+            add_sphere(mesh, "b0", 1.0, {0.0, 0.0, 0.0});
+            add_sphere(mesh, "c0", 0.2, {0.3, 0.0, 0.0});
+            id_type idResult = brep::boolean_difference(mesh, mesh.submesh_id("a"), {mesh.submesh_id("b0"), mesh.submesh_id("c0")}, "d");
+            check(idResult == nullid && mesh.submesh_count() == 0, "difference of enclosed A is empty");
+        }
+
+        {
+            // Crossing group s0 s1 s2, each overlapping the next, and s3 apart
+            mesh_type mesh;
+            add_box(mesh, "s0", 1.0, {0.0, 0.0, 0.0});
+            add_box(mesh, "s1", 1.0, {0.6, 0.11, 0.07});
+            add_box(mesh, "s2", 1.0, {1.2, 0.2, 0.13});
+            add_box(mesh, "s3", 1.0, {6.0, 0.0, 0.0});
+            vector<id_type> ids = {mesh.submesh_id("s0"), mesh.submesh_id("s1"), mesh.submesh_id("s2"), mesh.submesh_id("s3")};
+            check(brep::crossing_operands(mesh, ids) == vector<array<size_t, 2>>{{0, 1}, {1, 2}}, "overlapping boxes cross");
+
+            id_type idResult = brep::boolean_union(mesh, ids, "u");
+            check(idResult != nullid && mesh.submesh_count() == 1 && mesh.face_count() == 24, "union of overlapping boxes, one result");
+            bool bInside = true;
+            for (const mesh_type::point_type& point : {mesh_type::point_type(-0.4, 0.0, 0.0), mesh_type::point_type(0.3, 0.1, 0.05), mesh_type::point_type(1.6, 0.2, 0.13), mesh_type::point_type(6.0, 0.0, 0.0)})
+            {
+                bInside = bInside && abs(brep::winding_number(mesh, idResult, point) - 1.0) < 1.0e-6;
+            }
+
+            check(bInside, "union contains every box");
+            check(abs(brep::winding_number(mesh, idResult, {0.55, -0.45, 0.0})) < 1.0e-6, "union excludes the notch between s0 and s1");
+            check_valid(mesh, "overlapping union");
+            check_closed(mesh, "overlapping union");
+        }
+
+        {
+            // Cutters b0 and c each cross A at a corner, d is apart from A
+            mesh_type mesh;
+            add_box(mesh, "a", 1.0, {0.0, 0.0, 0.0});
+            add_box(mesh, "b0", 0.5, {0.5, 0.5, 0.5});
+            add_box(mesh, "c", 0.4, {-0.5, -0.47, -0.49});
+            add_box(mesh, "d", 0.5, {3.0, 0.0, 0.0});
+            id_type idResult = brep::boolean_difference(mesh, mesh.submesh_id("a"), {mesh.submesh_id("b0"), mesh.submesh_id("c"), mesh.submesh_id("d")}, "d");
+            check(idResult != nullid && mesh.submesh_count() == 1, "difference of corner cutters, one result");
+            check(abs(brep::winding_number(mesh, idResult, {0.0, 0.0, 0.0}) - 1.0) < 1.0e-6, "difference keeps the center");
+            check(abs(brep::winding_number(mesh, idResult, {0.4, 0.4, 0.4})) < 1.0e-6 && abs(brep::winding_number(mesh, idResult, {-0.4, -0.4, -0.4})) < 1.0e-6, "difference removes both corners");
+            check_valid(mesh, "corner difference");
+            check_closed(mesh, "corner difference");
+        }
+
+        {
+            // Curves the splitter cannot cut are reported rather than asserted on, the operands are kept
+            mesh_type mesh;
+            add_sphere(mesh, "s0", 1.0, {0.0, 0.0, 0.0});
+            add_sphere(mesh, "s1", 1.0, {0.6, 0.11, 0.07});
+            id_type idResult = brep::boolean_union(mesh, {mesh.submesh_id("s0"), mesh.submesh_id("s1")}, "u");
+            check(idResult == nullid && mesh.submesh_count() == 2, "union of crossing UV spheres fails, operands kept");
+            check_valid(mesh, "failed union");
+            check_closed(mesh, "failed union");
+        }
+
+        {
+            // Cutters b0 and b1 cross each other and A
+            mesh_type mesh;
+            add_box(mesh, "a", 1.0, {0.0, 0.0, 0.0});
+            add_box(mesh, "b0", 0.5, {0.5, 0.5, 0.5});
+            add_box(mesh, "b1", 0.5, {0.62, 0.41, 0.37});
+            id_type idResult = brep::boolean_difference(mesh, mesh.submesh_id("a"), {mesh.submesh_id("b0"), mesh.submesh_id("b1")}, "d");
+            check(idResult == nullid && mesh.submesh_id("d") != nullid, "difference of a crossing cutter group fails, A kept and named for the result");
+            check_valid(mesh, "failed difference");
+            check_closed(mesh, "failed difference");
+        }
+
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Newell's method over the corners of the face, independent of the fan used by face_area_normal
+    mesh_type::vector_type newell_normal(const mesh_type::face_type& face)
+    {
+        mesh_type::vector_type normal;
+        for (const auto& halfedge : face.halfedges())
+        {
+            const auto a = halfedge.attributes().position();
+            const auto b = halfedge.next().attributes().position();
+            normal += mesh_type::vector_type((a.y() - b.y()) * (a.z() + b.z()), (a.z() - b.z()) * (a.x() + b.x()), (a.x() - b.x()) * (a.y() + b.y()));
+        }
+
+        return normal;
+    }
+
+    //--------------------------------------------------------------------------
+    // Every corner normal bit-identical
+    bool normals_equal(const mesh_type& a, const mesh_type& b)
+    {
+        for (id_type id = 0; id < a.halfedge_store_count(); ++id)
+        {
+            if (a.halfedge(id).attributes().normal() != b.halfedge(id).attributes().normal())
+            {
+                return false;
+            }
+        }
+
+        for (id_type id = 0; id < a.face_store_count(); ++id)
+        {
+            if (a.face(id).attributes().normal() != b.face(id).attributes().normal())
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    // Non-planar quads take the Newell normal, border vertices sum the faces on both sides, and the result does not depend on face order
+    void test_normals()
+    {
+        cout << "normals" << endl;
+
+        {
+            // Quad with one corner raised, the Newell normal tilts away from it where the first corner cross product did not
+            mesh_type mesh;
+            model::create_grid(mesh, "quad", 1, 1, 1.0, 1.0, false);
+            auto& face = *mesh.faces().begin();
+            mesh_type::point_type positionUpper = face.halfedge().attributes().position();
+            for (const auto& halfedge : face.halfedges())
+            {
+                positionUpper = max(positionUpper, halfedge.attributes().position());
+            }
+
+            const value_type h = 0.5;
+            for (auto& halfedge : face.halfedges())
+            {
+                if (halfedge.attributes().position() == positionUpper)
+                {
+                    halfedge.vertex().attributes().set_position(positionUpper + mesh_type::vector_type(0.0, 0.0, h));
+                }
+            }
+
+            const auto& halfedge = face.halfedge();
+            auto normalCorner = normalize(cross(halfedge.next().attributes().position() - halfedge.attributes().position(), halfedge.prev().attributes().position() - halfedge.attributes().position()));
+            auto normalExpected = normalize(newell_normal(face));
+
+            model::calculate_face_normals(mesh);
+            const auto normal = face.attributes().normal();
+            check((normal - normalExpected).norm() < 1.0e-12 && (normal - normalCorner).norm() > 0.1, "non-planar quad has the Newell normal");
+
+            bool bCorners = true;
+            for (const auto& h : face.halfedges())
+            {
+                bCorners = bCorners && h.attributes().normal() == normal;
+            }
+
+            check(bCorners, "non-planar quad corners share the face normal");
+        }
+
+        {
+            // Open bumped grid, expected vertex normals sum every face with a corner at the vertex position, including border vertices
+            mesh_type mesh;
+            model::create_grid(mesh, "grid", 8, 8, 1.0, 1.0, false);
+            for (auto& vertex : mesh.vertices())
+            {
+                auto position = vertex.attributes().position();
+                position.set_z(0.3 * sin(4.0 * position.x()) * cos(3.0 * position.y()));
+                vertex.attributes().set_position(position);
+            }
+
+            for (bool bAreaWeighted : {false, true})
+            {
+                map<array<value_type, 3>, mesh_type::vector_type> normalsExpected;
+                for (const auto& face : mesh.faces())
+                {
+                    auto normalArea = newell_normal(face);
+                    for (const auto& halfedge : face.halfedges())
+                    {
+                        const auto position = halfedge.attributes().position();
+                        value_type weight = angle(halfedge.next().attributes().position() - position, halfedge.prev().attributes().position() - position);
+                        normalsExpected[{position.x(), position.y(), position.z()}] += bAreaWeighted ? normalArea : weight * normalize(normalArea);
+                    }
+                }
+
+                model::calculate_surface_normals(mesh, bAreaWeighted);
+
+                size_t nBorder = 0;
+                bool bMatch = true;
+                for (const auto& halfedge : mesh.halfedges())
+                {
+                    const auto position = halfedge.attributes().position();
+                    const auto normalExpected = normalize(normalsExpected[{position.x(), position.y(), position.z()}]);
+                    bMatch = bMatch && (halfedge.attributes().normal() - normalExpected).norm() < 1.0e-9;
+                    nBorder += halfedge.border() ? 1 : 0;
+                }
+
+                check(nBorder > 0 && bMatch, string("grid ") + (bAreaWeighted ? "area" : "angle") + " weighted vertex normals, " + to_string(nBorder) + " border corners");
+            }
+        }
+
+        // Swirled torus with non-planar quads, benchmark then compare against reversed and shuffled face orders
+        mesh_type mesh;
+        model::create_torus(mesh, "torus", 1000, 250, 4.0, 1.0);
+        model::swirl(mesh, 2.0);
+
+        mesh_type meshFace = mesh;
+        auto t0 = chrono::steady_clock::now();
+        model::calculate_face_normals(meshFace);
+        cout << "    " << mesh.halfedge_count() << " corners, calculate_face_normals " << milliseconds_since(t0) << " ms" << endl;
+
+        vector<id_type> idFaces;
+        for (const auto& face : mesh.faces())
+        {
+            idFaces.push_back(face.id());
+        }
+
+        for (bool bAreaWeighted : {false, true})
+        {
+            string name = bAreaWeighted ? "area" : "angle";
+
+            mesh_type meshSurface = mesh;
+            t0 = chrono::steady_clock::now();
+            model::calculate_surface_normals(meshSurface, bAreaWeighted);
+            cout << "    calculate_surface_normals " << name << " weighted " << milliseconds_since(t0) << " ms" << endl;
+
+            vector<id_type> idFacesReordered(idFaces.rbegin(), idFaces.rend());
+            for (size_t i = 0; i < 2; ++i)
+            {
+                mesh_type meshReordered = mesh;
+                model::internal::calculate_surface_normals(meshReordered, idFacesReordered, bAreaWeighted);
+                check(normals_equal(meshSurface, meshReordered), "torus " + name + " weighted " + (i == 0 ? "reversed" : "shuffled") + " faces bit-identical");
+                shuffle(idFacesReordered.begin(), idFacesReordered.end(), mt19937_64(11));
+            }
+        }
+
+        mesh_type meshFaceAgain = mesh;
+        model::calculate_face_normals(meshFaceAgain);
+        check(normals_equal(meshFace, meshFaceAgain), "torus face normals bit-identical when repeated");
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Every vertex position and normal within tolerance
+    bool vertices_near(const mesh_type& a, const mesh_type& b, value_type tolerance)
+    {
+        for (id_type id = 0; id < a.vertex_store_count(); ++id)
+        {
+            const auto& aa = a.vertex(id).attributes();
+            const auto& ab = b.vertex(id).attributes();
+            if ((aa.position() - ab.position()).norm() > tolerance || (aa.normal() - ab.normal()).norm() > tolerance)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    // Reference transform, applies the matrix f(z, z0, z1) to each vertex with the z extent of the mesh as it is now
+    template<typename F>
+    void transform_vertices(mesh_type& mesh, F f, bool bNormals)
+    {
+        value_type z0 = numeric_limits<value_type>::max();
+        value_type z1 = numeric_limits<value_type>::lowest();
+        for (const auto& vertex : mesh.vertices())
+        {
+            z0 = min(z0, vertex.attributes().position().z());
+            z1 = max(z1, vertex.attributes().position().z());
+        }
+
+        for (auto& vertex : mesh.vertices())
+        {
+            auto& av = vertex.attributes();
+            math::Matrix<value_type> matrix = f(av.position().z(), z0, z1);
+            av.position() *= matrix;
+            if (bNormals)
+            {
+                av.normal() *= matrix;
+            }
+        }
+
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Deformation pipelines against rotation and scaling matrices applied one transform at a time, each measuring the z extent of the mesh as it is then
+    void test_deformation()
+    {
+        cout << "deformation" << endl;
+
+        const auto axis = mesh_type::vector_type(1.0, 0.0, 0.0);
+        const auto axisZ = mesh_type::vector_type(0.0, 0.0, 1.0);
+        const value_type amplitude = 6.0;
+        const value_type period = 1.0;
+        const value_type tolerance = 1.0e-12;
+
+        mesh_type mesh;
+        model::create_cylinder(mesh, "cylinder", 512, 250, 1.0, 1.0, 0.0, 4.0);
+
+        auto swirl = [&](value_type angle)
+        {
+            return [=](value_type z, value_type z0, value_type z1) { return math::rotation_axis_unit(axisZ, angle * (z - z0) / (z1 - z0)); };
+        };
+
+        auto tuskify = [&](value_type angle)
+        {
+            return [=](value_type z, value_type z0, value_type z1) { return math::rotation_axis_unit(axis, -angle * (0.5 * z - z0) / (z1 - z0)); };
+        };
+
+        auto undulate = [&](value_type z, value_type z0, value_type z1)
+        {
+            value_type zRelative = (z - z0) / (z1 - z0);
+            value_type rScale = 1.0 - 0.5 * sin(zRelative * amplitude * 0.3333333) * (1.0 - zRelative);
+            return math::scaling(rScale, rScale, 1.0);
+        };
+
+        // tuskify moves z, so undulate and swirl after it see the extent of the tuskified mesh
+        mesh_type meshReference = mesh;
+        auto t0 = chrono::steady_clock::now();
+        transform_vertices(meshReference, swirl(1.0), false);
+        transform_vertices(meshReference, tuskify(0.5), true);
+        transform_vertices(meshReference, undulate, false);
+        transform_vertices(meshReference, swirl(2.0), false);
+        model::calculate_face_normals(meshReference);
+        cout << "    " << mesh.vertex_count() << " vertices, matrices one at a time " << milliseconds_since(t0) << " ms" << endl;
+
+        mesh_type meshPipeline = mesh;
+        t0 = chrono::steady_clock::now();
+        model::Deformation<mesh_type>().swirl(1.0).tuskify(axis, 0.5).undulate(amplitude, period).swirl(2.0).apply(meshPipeline);
+        cout << "    pipeline " << milliseconds_since(t0) << " ms" << endl;
+
+        check(vertices_near(meshReference, meshPipeline, tolerance), "swirl, tuskify, undulate, swirl pipeline matches matrices one at a time");
+
+        mesh_type meshSingle = mesh;
+        model::swirl(meshSingle, 1.0);
+        model::tuskify(meshSingle, axis, 0.5);
+        meshReference = mesh;
+        transform_vertices(meshReference, swirl(1.0), false);
+        transform_vertices(meshReference, tuskify(0.5), true);
+        model::calculate_face_normals(meshReference);
+        check(vertices_near(meshReference, meshSingle, tolerance), "swirl and tuskify functions match matrices");
+
+        // A custom stage moves z unless declared otherwise
+        auto lift = [](mesh_type::vertex_attributes_type& av, value_type, value_type)
+        {
+            av.position().set_z(2.0 * av.position().z() + 1.0);
+        };
+
+        meshReference = mesh;
+        transform_vertices(meshReference, [](value_type, value_type, value_type) { return math::scaling(1.0, 1.0, 2.0) * math::translation(0.0, 0.0, 1.0); }, false);
+        transform_vertices(meshReference, swirl(1.5), false);
+
+        meshPipeline = mesh;
+        model::Deformation<mesh_type>().add(lift).swirl(1.5).apply(meshPipeline, false);
+        check(vertices_near(meshReference, meshPipeline, tolerance), "custom stage moving z, then swirl, matches matrices");
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Best of several runs of f
+    template<typename F>
+    double best_milliseconds(size_t nRuns, F f)
+    {
+        double milliseconds = numeric_limits<double>::max();
+        for (size_t i = 0; i < nRuns; ++i)
+        {
+            auto t0 = chrono::steady_clock::now();
+            f();
+            milliseconds = min(milliseconds, milliseconds_since(t0));
+        }
+
+        return milliseconds;
+    }
+
+    //--------------------------------------------------------------------------
+    // Scalar slab test of a single box, the reference for the batched ray test
+    bool ray_hits(const geometry::AxisAlignedBoundingBox<vector_traits>& box, const geometry::Ray<vector_traits>& ray)
+    {
+        const auto origin = ray.endpoint();
+        const auto direction = ray.direction();
+        const auto lower = box.lower();
+        const auto upper = box.upper();
+
+        value_type tNear = 0.0;
+        value_type tFar = numeric_limits<value_type>::max();
+        for (size_t k = 0; k < vector_traits::dimension; ++k)
+        {
+            if (direction[k] == 0.0)
+            {
+                if (origin[k] < lower[k] || origin[k] > upper[k])
+                {
+                    return false;
+                }
+
+                continue;
+            }
+
+            value_type t0 = (lower[k] - origin[k]) / direction[k];
+            value_type t1 = (upper[k] - origin[k]) / direction[k];
+            tNear = max(tNear, min(t0, t1));
+            tFar = min(tFar, max(t0, t1));
+        }
+
+        return tNear <= tFar;
+    }
+
+    //--------------------------------------------------------------------------
+    // Batched kernels against the virtual insert and per box tests they replace, results must agree
+    void test_bounding_boxes()
+    {
+        cout << "bounding boxes" << endl;
+
+        using point_type = geometry::Point<vector_traits>;
+        using box_type = geometry::AxisAlignedBoundingBox<vector_traits>;
+        using array_type = geometry::AxisAlignedBoundingBoxArray<vector_traits>;
+
+        mt19937_64 generator(3);
+        uniform_real_distribution<value_type> distribution(-100.0, 100.0);
+        auto random_point = [&]() -> point_type
+        {
+            return {distribution(generator), distribution(generator), distribution(generator)};
+        };
+
+        vector<point_type> points(1000000);
+        for (auto& point : points)
+        {
+            point = random_point();
+        }
+
+        box_type boxVirtual;
+        double millisecondsVirtual = best_milliseconds(5, [&]()
+        {
+            geometry::BoundingVolume<vector_traits>& volume = boxVirtual;
+            volume.clear();
+            for (const auto& point : points)
+            {
+                volume.insert(point);
+            }
+        });
+
+        point_type lower = point_type::max();
+        point_type upper = point_type::min();
+        double millisecondsKernel = best_milliseconds(5, [&]()
+        {
+            lower = point_type::max();
+            upper = point_type::min();
+            geometry::bounds<vector_traits>(span<const point_type>(points), lower, upper);
+        });
+
+        cout << "    bounds of " << points.size() << " points, virtual insert " << millisecondsVirtual << " ms, kernel " << millisecondsKernel << " ms" << endl;
+        check(lower == boxVirtual.lower() && upper == boxVirtual.upper(), "bounds equal");
+
+        // Few enough boxes to stay in cache, so that the tests rather than memory bandwidth are measured
+        vector<box_type> boxes;
+        array_type array;
+        for (size_t i = 0; i < 10000; ++i)
+        {
+            point_type point = random_point();
+            boxes.emplace_back(point, point + random_point() * 0.02);
+            array.push_back(boxes.back());
+        }
+
+        vector<box_type> queries;
+        for (size_t i = 0; i < 256; ++i)
+        {
+            point_type point = random_point();
+            queries.emplace_back(point, point + random_point() * 0.1);
+        }
+
+        vector<array_type::mask_type> masksBox(queries.size());
+        millisecondsVirtual = best_milliseconds(5, [&]()
+        {
+            for (size_t j = 0; j < queries.size(); ++j)
+            {
+                masksBox[j].assign(array.mask_size(), 0);
+                for (size_t i = 0; i < boxes.size(); ++i)
+                {
+                    masksBox[j][i / array_type::block_size] |= uint64_t(boxes[i].overlaps(queries[j])) << (i % array_type::block_size);
+                }
+            }
+        });
+
+        vector<array_type::mask_type> masks(queries.size());
+        millisecondsKernel = best_milliseconds(5, [&]()
+        {
+            for (size_t j = 0; j < queries.size(); ++j)
+            {
+                array.overlaps(queries[j], masks[j]);
+            }
+        });
+
+        cout << "    " << queries.size() << " overlap queries of " << boxes.size() << " boxes, per box " << millisecondsVirtual << " ms, batched " << millisecondsKernel << " ms" << endl;
+        check(masks == masksBox, "overlap masks equal");
+
+        bool bContains = true;
+        bool bIntersects = true;
+        size_t nHits = 0;
+        for (size_t j = 0; j < queries.size(); ++j)
+        {
+            point_type point = random_point();
+            geometry::Ray<vector_traits> ray(point, normalize(random_point() - point));
+
+            array_type::mask_type mask;
+            array.contains(boxes[j].lower(), mask);
+            for (size_t i = 0; i < boxes.size(); ++i)
+            {
+                bContains = bContains && array_type::mask_test(mask, i) == boxes[i].contains(boxes[j].lower());
+            }
+
+            array.intersects(ray, mask);
+            nHits += array_type::mask_count(mask);
+            for (size_t i = 0; i < boxes.size(); ++i)
+            {
+                bIntersects = bIntersects && array_type::mask_test(mask, i) == ray_hits(boxes[i], ray);
+            }
+        }
+
+        check(bContains, "contains masks match per box tests");
+        check(bIntersects && nHits > 0, "ray masks match scalar slab tests, " + to_string(nHits) + " hits");
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Half the points on a jagged outer contour, the rest on square holes in a jittered grid
+    void add_contours(triangulation::Triangulator& triangulator, size_t nPoints)
+    {
+        mt19937_64 generator(42);
+        uniform_real_distribution<double> distribution(0.0, 1.0);
+
+        size_t id = 0;
+        size_t nOuter = nPoints / 2;
+        for (size_t i = 0; i < nOuter; ++i)
+        {
+            double angle = 2.0 * numbers::pi * double(i) / double(nOuter);
+            double r = 100.0 * (0.9 + 0.1 * distribution(generator));
+            triangulator.add_vertex(id++, r * cos(angle), r * sin(angle));
+        }
+
+        triangulator.close_contour();
+
+        size_t nHoles = (nPoints - nOuter) / 4;
+        size_t n = size_t(ceil(sqrt(double(nHoles))));
+        double sizeCell = 120.0 / double(n);
+        for (size_t i = 0; i < nHoles; ++i)
+        {
+            double s = sizeCell * 0.2 * (0.5 + 0.5 * distribution(generator));
+            double x = -60.0 + (double(i % n) + 0.5 + 0.4 * (distribution(generator) - 0.5)) * sizeCell;
+            double y = -60.0 + (double(i / n) + 0.5 + 0.4 * (distribution(generator) - 0.5)) * sizeCell;
+            triangulator.add_vertex(id++, x - s, y - s);
+            triangulator.add_vertex(id++, x - s, y + s);
+            triangulator.add_vertex(id++, x + s, y + s);
+            triangulator.add_vertex(id++, x + s, y - s);
+            triangulator.close_contour();
+        }
+
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Circular contour of 4096 points filled with uniformly distributed Steiner points
+    void add_points(triangulation::Triangulator& triangulator, size_t nPoints)
+    {
+        mt19937_64 generator(7);
+        uniform_real_distribution<double> distribution(-90.0, 90.0);
+
+        size_t id = 0;
+        size_t nOuter = 4096;
+        for (size_t i = 0; i < nOuter; ++i)
+        {
+            double angle = 2.0 * numbers::pi * double(i) / double(nOuter);
+            triangulator.add_vertex(id++, 100.0 * cos(angle), 100.0 * sin(angle));
+        }
+
+        triangulator.close_contour();
+
+        while (id < nPoints)
+        {
+            double x = distribution(generator);
+            double y = distribution(generator);
+            if (x * x + y * y < 90.0 * 90.0)
+            {
+                triangulator.add_point(id++, x, y);
+            }
+        }
+
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Vertex ids of every triangle in order
+    vector<size_t> triangle_vertex_ids(const triangulation::Triangulator& triangulator)
+    {
+        vector<size_t> ids;
+        ids.reserve(3 * triangulator.triangle_count());
+        for (size_t n = 0; n < triangulator.triangle_count(); ++n)
+        {
+            for (size_t i = 0; i < 3; ++i)
+            {
+                ids.push_back(triangulator.vertex_id(n, i));
+            }
+        }
+
+        return ids;
+    }
+
+    //--------------------------------------------------------------------------
+    // Sweep with the advancing front walked and indexed, the triangulations must be identical
+    void test_sweep_front()
+    {
+        cout << "sweep front" << endl;
+
+        using add_type = void (*)(triangulation::Triangulator&, size_t);
+        for (auto [name, add] : {pair<string, add_type>{"contours", add_contours}, {"points", add_points}})
+        {
+            for (size_t nPoints : {10000, 100000, 1000000})
+            {
+                triangulation::Triangulator triangulator;
+                vector<size_t> ids[2];
+                double milliseconds[2];
+                for (size_t i = 0; i < 2; ++i)
+                {
+                    triangulator.clear();
+                    triangulator.set_front_index(i == 0 ? p2t::FrontIndex::Walked : p2t::FrontIndex::Indexed);
+                    add(triangulator, nPoints);
+
+                    auto t0 = chrono::steady_clock::now();
+                    triangulator.triangulate();
+                    milliseconds[i] = milliseconds_since(t0);
+                    ids[i] = triangle_vertex_ids(triangulator);
+                }
+
+                string label = name + "_" + to_string(nPoints);
+                cout << "    " << label << " walked " << milliseconds[0] << " ms, indexed " << milliseconds[1] << " ms" << endl;
+                check(!ids[0].empty() && ids[0] == ids[1], label + " identical");
+            }
+        }
+
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Sweep with exact and with inexact predicates, the cost of exact predicates
+    void test_predicates()
+    {
+        cout << "predicates" << endl;
+
+        using add_type = void (*)(triangulation::Triangulator&, size_t);
+        for (auto [name, add] : {pair<string, add_type>{"contours", add_contours}, {"points", add_points}})
+        {
+            for (size_t nPoints : {100000, 1000000})
+            {
+                // Runs alternate between the two so that both see the same machine state, best of several each as the difference is small
+                triangulation::Triangulator triangulator;
+                size_t nTriangles[2];
+                double milliseconds[2] = {numeric_limits<double>::max(), numeric_limits<double>::max()};
+                size_t nRuns = nPoints > 100000 ? 5 : 15;
+                for (size_t n = 0; n < 2 * nRuns; ++n)
+                {
+                    size_t i = n % 2;
+                    triangulator.set_predicates(i == 0 ? p2t::Predicates::Exact : p2t::Predicates::Inexact);
+                    triangulator.clear();
+                    add(triangulator, nPoints);
+
+                    auto t0 = chrono::steady_clock::now();
+                    triangulator.triangulate();
+                    milliseconds[i] = min(milliseconds[i], milliseconds_since(t0));
+                    nTriangles[i] = triangulator.triangle_count();
+                }
+
+                string label = name + "_" + to_string(nPoints);
+                cout << "    " << label << " exact " << milliseconds[0] << " ms, inexact " << milliseconds[1] << " ms, overhead " << 100.0 * (milliseconds[0] / milliseconds[1] - 1.0) << "%" << endl;
+                check(nTriangles[0] > 0 && nTriangles[0] == nTriangles[1], label + " same triangle count");
+            }
+        }
+
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Signed area of a planar contour about normal
+    value_type contour_area(const geometry::Polygon<vector_traits>& polygon, const mesh_type::vector_type& normal)
+    {
+        mesh_type::vector_type sum;
+        for (size_t i = 0; i < polygon.vertex_count(); ++i)
+        {
+            sum += cross(polygon.vertex(i), polygon.vertex((i + 1) % polygon.vertex_count()));
+        }
+
+        return 0.5 * dot(normal, sum);
+    }
+
+    //--------------------------------------------------------------------------
+    // Cross-sections of shapes whose contours are known
+    void test_slice()
+    {
+        cout << "slice" << endl;
+
+        {
+            // Each layer of a cylinder is its regular polygon
+            mesh_type mesh;
+            size_t nAzimuth = 64;
+            model::create_cylinder(mesh, "cylinder", nAzimuth, 4, 1.0, 1.0, 0.0, 4.0);
+            auto slices = brep::slice(mesh, geometry::Plane<vector_traits>({0.0, 0.0, 0.5}, {0.0, 0.0, 1.0}), 1.0, 4);
+
+            value_type areaExpected = 0.5 * value_type(nAzimuth) * sin(2.0 * numbers::pi / value_type(nAzimuth));
+            bool bAreas = slices.size() == 4;
+            for (const auto& slice : slices)
+            {
+                bAreas = bAreas && slice.size() == 1 && slice[0].hole_count() == 0 && abs(contour_area(slice[0].polygon(), {0.0, 0.0, 1.0}) - areaExpected) < 1.0e-9;
+            }
+
+            check(bAreas, "cylinder cross-section area");
+        }
+
+        {
+            // A torus about z is an annulus across its axis and two disks along it
+            mesh_type mesh;
+            model::create_torus(mesh, "torus", 32, 16, 2.0, 0.5);
+
+            auto slicesAcross = brep::slice(mesh, geometry::Plane<vector_traits>({0.0, 0.0, 0.1}, {0.0, 0.0, 1.0}), 1.0, 1);
+            check(slicesAcross.size() == 1 && slicesAcross[0].size() == 1 && slicesAcross[0][0].hole_count() == 1, "torus across axis one contour one hole");
+
+            auto slicesAlong = brep::slice(mesh, geometry::Plane<vector_traits>({0.1, 0.0, 0.0}, {1.0, 0.0, 0.0}), 1.0, 1);
+            check(slicesAlong.size() == 1 && slicesAlong[0].size() == 2 && slicesAlong[0][0].hole_count() == 0 && slicesAlong[0][1].hole_count() == 0, "torus along axis two contours no holes");
+        }
+
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Vertex positions in lexicographic order
+    vector<mesh_type::point_type> sorted_positions(const mesh_type& mesh)
+    {
+        vector<mesh_type::point_type> positions;
+        for (const auto& vertex : mesh.vertices())
+        {
+            positions.push_back(vertex.attributes().position());
+        }
+
+        sort(positions.begin(), positions.end(), [](const auto& a, const auto& b) { return tuple(a.x(), a.y(), a.z()) < tuple(b.x(), b.y(), b.z()); });
+        return positions;
+    }
+
+    //--------------------------------------------------------------------------
+    // Clipping to several halfspaces at once must match clipping to each in turn
+    void test_clip()
+    {
+        cout << "clip" << endl;
+
+        using halfspace_type = geometry::HalfSpace<vector_traits>;
+        using plane_type = geometry::Plane<vector_traits>;
+        vector<halfspace_type> halfspaces = {plane_type({0.5, 0.0, 0.0}, {1.0, 0.0, 0.0}), plane_type({0.0, 0.4, 0.0}, {0.0, 1.0, 0.0}), plane_type({0.0, 0.0, -0.3}, {0.0, 0.0, -1.0})};
+
+        mesh_type meshSequential;
+        add_sphere(meshSequential, "sphere", 1.0, {0.0, 0.0, 0.0});
+        mesh_type meshMultiple = meshSequential;
+
+        for (const auto& halfspace : halfspaces)
+        {
+            brep::clip(meshSequential, halfspace);
+        }
+
+        brep::clip(meshMultiple, span<const halfspace_type>(halfspaces));
+
+        check(meshMultiple.face_count() == meshSequential.face_count() && meshMultiple.vertex_count() == meshSequential.vertex_count(), "multiple halfspaces face and vertex counts");
+
+        auto positionsSequential = sorted_positions(meshSequential);
+        auto positionsMultiple = sorted_positions(meshMultiple);
+        bool bNear = positionsMultiple.size() == positionsSequential.size();
+        for (size_t i = 0; bNear && i < positionsMultiple.size(); ++i)
+        {
+            bNear = (positionsMultiple[i] - positionsSequential[i]).norm() < 1.0e-12;
+        }
+
+        check(bNear, "multiple halfspaces vertex positions");
+        check_valid(meshMultiple, "multiple halfspaces");
+        check_closed(meshMultiple, "multiple halfspaces");
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Two boxes stacked and welded at their shared face form one closed body
+    void test_weld()
+    {
+        cout << "weld" << endl;
+
+        mesh_type mesh;
+        add_box(mesh, "a", 1.0, {0.0, 0.0, 0.0});
+        add_box(mesh, "b", 1.0, {0.0, 0.0, 1.0});
+
+        auto result = brep::weld(mesh, "a/top", "b/bottom");
+        check(result.nFaces == 1 && result.idFacesA.empty() && result.idFacesB.empty() && result.idFacesMismatched.empty(), "stacked boxes one face pair welded");
+        check(mesh.face_count() == 10, "stacked boxes shared faces removed");
+        check_valid(mesh, "stacked boxes");
+        check_closed(mesh, "stacked boxes");
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Stacked boxes welded across two submeshes and a separate box moved into the first, repartitioned by component
+    void test_components()
+    {
+        cout << "components" << endl;
+
+        mesh_type mesh;
+        add_box(mesh, "a", 1.0, {0.0, 0.0, 0.0});
+        add_box(mesh, "b", 1.0, {0.0, 0.0, 1.0});
+        add_box(mesh, "c", 1.0, {3.0, 0.0, 0.0});
+        brep::weld(mesh, "a/top", "b/bottom");
+        for (const string& name : {"bottom", "right", "front", "left", "back", "top"})
+        {
+            mesh.move_surface("c/" + name, "a/c_" + name);
+        }
+
+        vector<id_type> idComponents;
+        check(brep::face_components(mesh, idComponents) == 2, "boxes two components");
+
+        vector<id_type> idSubmeshes = brep::partition_components(mesh);
+        check(idSubmeshes.size() == 2 && idSubmeshes[0] == mesh.submesh_id("a") && idSubmeshes[1] == mesh.submesh_id("a_1"), "boxes component submeshes");
+
+        bool bPartitioned = idSubmeshes.size() == 2;
+        for (const auto& face : mesh.faces())
+        {
+            bPartitioned = bPartitioned && face.submesh_id() == idSubmeshes[idComponents[face.id()]];
+        }
+
+        check(bPartitioned, "boxes each component in its own submesh");
+        check(mesh.submesh("a").face_count() == 10 && mesh.submesh("a_1").face_count() == 6, "boxes submesh face counts");
+        check_valid(mesh, "boxes partitioned");
+        check_closed(mesh, "boxes partitioned");
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Every face has nSides sides
+    bool faces_sided(const mesh_type& mesh, size_t nSides)
+    {
+        return all_of(mesh.faces().begin(), mesh.faces().end(), [&](const auto& face) { return face.halfedge_count() == nSides; });
+    }
+
+    //--------------------------------------------------------------------------
+    // Every vertex on the surface of a box of the given size centered at the origin
+    bool vertices_on_box(const mesh_type& mesh, value_type size)
+    {
+        return all_of(mesh.vertices().begin(), mesh.vertices().end(), [&](const auto& vertex)
+        {
+            const auto& position = vertex.attributes().position();
+            return abs(max({abs(position.x()), abs(position.y()), abs(position.z())}) - 0.5 * size) < 1.0e-12;
+        });
+    }
+
+    //--------------------------------------------------------------------------
+    // Box faces are separate surfaces, so every box edge is a crease and the box keeps its shape
+    void test_subdivision()
+    {
+        cout << "subdivision" << endl;
+
+        {
+            mesh_type mesh;
+            add_box(mesh, "box", 1.0, {0.0, 0.0, 0.0});
+            brep::triangulate_submesh(mesh, mesh.submesh_id("box"));
+
+            for (size_t nFaces : {48, 192})
+            {
+                brep::subdivide_loop(mesh);
+                string name = "loop_box_" + to_string(nFaces);
+                check(mesh.face_count() == nFaces && faces_sided(mesh, 3), name + " face count");
+                check(vertices_on_box(mesh, 1.0), name + " on box");
+                check_valid(mesh, name);
+                check_closed(mesh, name);
+            }
+        }
+
+        {
+            mesh_type mesh;
+            add_box(mesh, "box", 1.0, {0.0, 0.0, 0.0});
+
+            for (size_t nFaces : {24, 96})
+            {
+                brep::subdivide_catmull_clark(mesh);
+                string name = "catmull_clark_box_" + to_string(nFaces);
+                check(mesh.face_count() == nFaces && faces_sided(mesh, 4), name + " face count");
+                check(vertices_on_box(mesh, 1.0), name + " on box");
+                check_valid(mesh, name);
+                check_closed(mesh, name);
+            }
+        }
+
+        {
+            // Triangles at the poles and quads elsewhere, each face of n sides becomes n quads
+            mesh_type mesh;
+            add_sphere(mesh, "sphere", 1.0, {0.0, 0.0, 0.0});
+            size_t nFaces = 0;
+            for (const auto& face : mesh.faces())
+            {
+                nFaces += face.halfedge_count();
+            }
+
+            brep::subdivide(mesh);
+            check(mesh.face_count() == nFaces && faces_sided(mesh, 4), "catmull_clark_sphere face count");
+            check_valid(mesh, "catmull_clark_sphere");
+            check_closed(mesh, "catmull_clark_sphere");
+        }
+
+        return;
+    }
+
+} // namespace
+
+//------------------------------------------------------------------------------
+int main(int argc, char* argv)
+{
+    argc;
+    argv;
+
+    test_decimation();
+    test_texcoords();
+    test_normals();
+    test_deformation();
+    test_face_intersections();
+    test_boolean_operands();
+    test_bounding_boxes();
+    test_sweep_front();
+    test_predicates();
+    test_slice();
+    test_clip();
+    test_weld();
+    test_components();
+    test_subdivision();
+
+    cout << (nFailures == 0 ? "all passed" : to_string(nFailures) + " failed") << endl;
+    return nFailures == 0 ? 0 : 1;
+}